@@ -45,16 +45,26 @@ extern "C" {
 
 
 
-#if EM_CORE_MASK_SIZE != 64
-#error Core mask functions support only 64 bit mask size
+#if (EM_CORE_MASK_SIZE % 64) != 0
+#error Core mask size must be a multiple of 64 bits
 #endif
 
+#if defined(EM_32_BIT) && (EM_CORE_MASK_SIZE != 64)
+#error 32 bit core mask functions support only 64 bit mask size
+#endif
+
+
+/**
+ * Number of 64 bit words in a core mask
+ */
+#define EM_CORE_MASK_WORDS  (EM_CORE_MASK_SIZE / 64)
+
 
 
-#ifdef EM_64_BIT
+#if defined(EM_64_BIT) && (EM_CORE_MASK_SIZE == 64)
 /*
  *
- * 64 bit versions.
+ * 64 bit versions, single word mask (up to 64 cores).
  * --------------------------------------------
  */
 
@@ -104,7 +114,7 @@ static inline void em_core_mask_clr(int core, em_core_mask_t* mask)
  */
 static inline int em_core_mask_isset(int core, const em_core_mask_t* mask)
 {
-  return (mask->u64[0] & ((uint64_t)1 << core));
+  return ((mask->u64[0] & ((uint64_t)1 << core)) != 0);
 }
 
 
@@ -143,7 +153,14 @@ static inline int em_core_mask_equal(const em_core_mask_t* mask1, const em_core_
  */
 static inline void em_core_mask_set_count(int count, em_core_mask_t* mask)
 {
-  mask->u64[0] |= (((uint64_t)1 << count) - 1);
+  if(count >= 64)
+  {
+    mask->u64[0] = ~((uint64_t)0);
+  }
+  else
+  {
+    mask->u64[0] |= (((uint64_t)1 << count) - 1);
+  }
 }
 
 
@@ -181,8 +198,232 @@ static inline int em_core_mask_count(const em_core_mask_t* mask)
 }
 
 
+/**
+ * Bitwise AND of two masks.
+ *
+ * @param dest      Destination core mask (can be one of the sources)
+ * @param src1      First source core mask
+ * @param src2      Second source core mask
+ */
+static inline void em_core_mask_and(em_core_mask_t* dest, const em_core_mask_t* src1, const em_core_mask_t* src2)
+{
+  dest->u64[0] = src1->u64[0] & src2->u64[0];
+}
+
+
+/**
+ * Bitwise OR of two masks.
+ *
+ * @param dest      Destination core mask (can be one of the sources)
+ * @param src1      First source core mask
+ * @param src2      Second source core mask
+ */
+static inline void em_core_mask_or(em_core_mask_t* dest, const em_core_mask_t* src1, const em_core_mask_t* src2)
+{
+  dest->u64[0] = src1->u64[0] | src2->u64[0];
+}
+
+
+
+
+#elif defined(EM_64_BIT)
+/*
+ *
+ * 64 bit versions, multi-word mask (more than 64 cores).
+ * Core id 'core' is bit (core % 64) of word u64[core / 64].
+ * --------------------------------------------
+ */
+
+
+/**
+ * Zero the whole mask.
+ *
+ * @param mask      Core mask
+ */
+static inline void em_core_mask_zero(em_core_mask_t* mask)
+{
+  int i;
+  
+  for(i = 0; i < EM_CORE_MASK_WORDS; i++) {
+    mask->u64[i] = 0;
+  }
+}
 
 
+/**
+ * Set a bit in the mask.
+ *
+ * @param core      Core id
+ * @param mask      Core mask
+ */
+static inline void em_core_mask_set(int core, em_core_mask_t* mask)
+{
+  mask->u64[core >> 6] |= ((uint64_t)1 << (core & 63));
+}
+
+
+/**
+ * Clear a bit in the mask.
+ *
+ * @param core      Core id
+ * @param mask      Core mask
+ */
+static inline void em_core_mask_clr(int core, em_core_mask_t* mask)
+{
+  mask->u64[core >> 6] &= ~((uint64_t)1 << (core & 63));
+}
+
+
+/**
+ * Test if a bit is set in the mask.
+ *
+ * @param core      Core id
+ * @param mask      Core mask
+ *
+ * @return Non-zero if core id is set in the mask
+ */
+static inline int em_core_mask_isset(int core, const em_core_mask_t* mask)
+{
+  return ((mask->u64[core >> 6] & ((uint64_t)1 << (core & 63))) != 0);
+}
+
+
+/**
+ * Test if the mask is all zero.
+ *
+ * @param mask      Core mask
+ *
+ * @return Non-zero if the mask is all zero
+ */
+static inline int em_core_mask_iszero(const em_core_mask_t* mask)
+{
+  uint64_t n = 0;
+  int      i;
+  
+  for(i = 0; i < EM_CORE_MASK_WORDS; i++) {
+    n |= mask->u64[i];
+  }
+  
+  return (n == 0);
+}
+
+
+/**
+ * Test if two masks are equal
+ *
+ * @param mask1     First core mask
+ * @param mask2     Second core mask
+ *
+ * @return Non-zero if the two masks are equal
+ */
+static inline int em_core_mask_equal(const em_core_mask_t* mask1, const em_core_mask_t* mask2)
+{
+  uint64_t n = 0;
+  int      i;
+  
+  for(i = 0; i < EM_CORE_MASK_WORDS; i++) {
+    n |= (mask1->u64[i] ^ mask2->u64[i]);
+  }
+  
+  return (n == 0);
+}
+
+
+/**
+ * Set a range (0...count-1) of bits in the mask.
+ * 
+ * @param count     Number of bits to set
+ * @param mask      Core mask
+ */
+static inline void em_core_mask_set_count(int count, em_core_mask_t* mask)
+{
+  int i;
+  
+  for(i = 0; (i < EM_CORE_MASK_WORDS) && (count > 0); i++, count -= 64)
+  {
+    if(count >= 64) {
+      mask->u64[i] = ~((uint64_t)0);
+    }
+    else {
+      mask->u64[i] |= (((uint64_t)1 << count) - 1);
+    }
+  }
+}
+
+
+/**
+ * Copy core mask
+ *
+ * @param dest      Destination core mask
+ * @param src       Source core mask
+ */
+static inline void em_core_mask_copy(em_core_mask_t* dest, const em_core_mask_t* src)
+{
+  int i;
+  
+  for(i = 0; i < EM_CORE_MASK_WORDS; i++) {
+    dest->u64[i] = src->u64[i];
+  }
+}
+
+
+/**
+ * Count the number of bits set in the mask.
+ *
+ * @param mask      Core mask
+ *
+ * @return Number of bits set
+ */
+static inline int em_core_mask_count(const em_core_mask_t* mask)
+{
+  uint64_t n;
+  int      cnt, i;
+  
+  for(i = 0, cnt = 0; i < EM_CORE_MASK_WORDS; i++)
+  {
+    n = mask->u64[i];
+    
+    for(; n; cnt++) {
+      n &= (n - 1); // Clear the least significant bit set
+    }
+  }
+  
+  return cnt;
+}
+
+
+/**
+ * Bitwise AND of two masks.
+ *
+ * @param dest      Destination core mask (can be one of the sources)
+ * @param src1      First source core mask
+ * @param src2      Second source core mask
+ */
+static inline void em_core_mask_and(em_core_mask_t* dest, const em_core_mask_t* src1, const em_core_mask_t* src2)
+{
+  int i;
+  
+  for(i = 0; i < EM_CORE_MASK_WORDS; i++) {
+    dest->u64[i] = src1->u64[i] & src2->u64[i];
+  }
+}
+
+
+/**
+ * Bitwise OR of two masks.
+ *
+ * @param dest      Destination core mask (can be one of the sources)
+ * @param src1      First source core mask
+ * @param src2      Second source core mask
+ */
+static inline void em_core_mask_or(em_core_mask_t* dest, const em_core_mask_t* src1, const em_core_mask_t* src2)
+{
+  int i;
+  
+  for(i = 0; i < EM_CORE_MASK_WORDS; i++) {
+    dest->u64[i] = src1->u64[i] | src2->u64[i];
+  }
+}
 #elif defined(EM_32_BIT)
 /*
  *
@@ -346,6 +587,34 @@ static inline int em_core_mask_count(const em_core_mask_t* mask)
   return cnt;
 }
 
+
+/**
+ * Bitwise AND of two masks.
+ *
+ * @param dest      Destination core mask (can be one of the sources)
+ * @param src1      First source core mask
+ * @param src2      Second source core mask
+ */
+static inline void em_core_mask_and(em_core_mask_t* dest, const em_core_mask_t* src1, const em_core_mask_t* src2)
+{
+  dest->u32[0] = src1->u32[0] & src2->u32[0];
+  dest->u32[1] = src1->u32[1] & src2->u32[1];
+}
+
+
+/**
+ * Bitwise OR of two masks.
+ *
+ * @param dest      Destination core mask (can be one of the sources)
+ * @param src1      First source core mask
+ * @param src2      Second source core mask
+ */
+static inline void em_core_mask_or(em_core_mask_t* dest, const em_core_mask_t* src1, const em_core_mask_t* src2)
+{
+  dest->u32[0] = src1->u32[0] | src2->u32[0];
+  dest->u32[1] = src1->u32[1] | src2->u32[1];
+}
+
 #endif
 
 
@@ -354,8 +623,6 @@ static inline int em_core_mask_count(const em_core_mask_t* mask)
 /*
  *  These mask functions could be added also
  *
- *  void em_core_mask_and(em_core_mask_t* dest, const em_core_mask_t* src1, const em_core_mask_t* src2);
- *  void em_core_mask_or(em_core_mask_t* dest, const em_core_mask_t* src1, const em_core_mask_t* src2);
  *  void em_core_mask_xor(em_core_mask_t* dest, const em_core_mask_t* src1, const em_core_mask_t* src2);
  *
  */
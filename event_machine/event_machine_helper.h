@@ -103,6 +103,24 @@ int em_core_id_get_physical(int core);
 void em_core_mask_get_physical(em_core_mask_t* phys, const em_core_mask_t* logic);
 
 
+/**
+ * Length of a string buffer that fits any core mask printed by em_core_mask_tostr()
+ */
+#define EM_CORE_MASK_STRLEN  ((EM_CORE_MASK_SIZE / 4) + 3)
+
+
+/**
+ * Formats a core mask into a hex string, e.g. "0xF0" - leading zero words are left out.
+ *
+ * @param mask_str Output string buffer
+ * @param len      Length of 'mask_str', EM_CORE_MASK_STRLEN fits any mask
+ * @param mask     Core mask
+ *
+ * @return 'mask_str'
+ */
+char *em_core_mask_tostr(char* mask_str, int len, const em_core_mask_t* mask);
+
+
 
 
 
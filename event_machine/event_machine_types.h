@@ -285,6 +285,10 @@ typedef uint32_t em_escope_t;
 #define EM_ESCOPE_QUEUE_GET_PRIORITY              (EM_ESCOPE_API_MASK | 0x000B)
 #define EM_ESCOPE_QUEUE_GET_TYPE                  (EM_ESCOPE_API_MASK | 0x000C)
 #define EM_ESCOPE_QUEUE_GET_GROUP                 (EM_ESCOPE_API_MASK | 0x000D)
+#define EM_ESCOPE_QUEUE_CREATE_ORDERED            (EM_ESCOPE_API_MASK | 0x000E)
+#define EM_ESCOPE_QUEUE_ORDER_STATS               (EM_ESCOPE_API_MASK | 0x000F)
+#define EM_ESCOPE_QUEUE_CREATE_ATOMIC             (EM_ESCOPE_API_MASK | 0x0010)
+#define EM_ESCOPE_QUEUE_DIRECT_DISPATCH_SET       (EM_ESCOPE_API_MASK | 0x0011)
 
 #define EM_ESCOPE_QUEUE_GROUP_CREATE              (EM_ESCOPE_API_MASK | 0x0101)
 #define EM_ESCOPE_QUEUE_GROUP_DELETE              (EM_ESCOPE_API_MASK | 0x0102)
@@ -301,6 +305,7 @@ typedef uint32_t em_escope_t;
 #define EM_ESCOPE_EO_UNREGISTER_ERROR_HANDLER     (EM_ESCOPE_API_MASK | 0x0207)
 #define EM_ESCOPE_EO_START                        (EM_ESCOPE_API_MASK | 0x0208)
 #define EM_ESCOPE_EO_STOP                         (EM_ESCOPE_API_MASK | 0x0209)
+#define EM_ESCOPE_EO_CREATE_MULTIRCV              (EM_ESCOPE_API_MASK | 0x020A)
 
 #define EM_ESCOPE_CORE_ID                         (EM_ESCOPE_API_MASK | 0x0301)
 #define EM_ESCOPE_CORE_COUNT                      (EM_ESCOPE_API_MASK | 0x0302)
@@ -309,6 +314,8 @@ typedef uint32_t em_escope_t;
 #define EM_ESCOPE_FREE                            (EM_ESCOPE_API_MASK | 0x0402)
 #define EM_ESCOPE_SEND                            (EM_ESCOPE_API_MASK | 0x0403)
 #define EM_ESCOPE_ATOMIC_PROCESSING_END           (EM_ESCOPE_API_MASK | 0x0404)
+#define EM_ESCOPE_ALLOC_MULTI                     (EM_ESCOPE_API_MASK | 0x0405)
+#define EM_ESCOPE_FREE_MULTI                      (EM_ESCOPE_API_MASK | 0x0406)
 
 #define EM_ESCOPE_REGISTER_ERROR_HANDLER          (EM_ESCOPE_API_MASK | 0x0501)
 #define EM_ESCOPE_UNREGISTER_ERROR_HANDLER        (EM_ESCOPE_API_MASK | 0x0502)
@@ -357,9 +364,13 @@ typedef uint32_t em_pool_id_t;
 
 
 /**
- * Size of the core mask in bits
+ * Size of the core mask in bits, a multiple of 64.
+ * Override at build time (e.g. -DEM_CORE_MASK_SIZE=128) to run more than 64 cores,
+ * the default 64 keeps all core mask operations single word.
  */
+#ifndef EM_CORE_MASK_SIZE
 #define EM_CORE_MASK_SIZE  64
+#endif
 
 
 /**
@@ -367,7 +378,7 @@ typedef uint32_t em_pool_id_t;
  * Each bit represents one core, core 0 is the lsb (1 << em_core_id())
  * Note, that EM will enumerate the core identifiers to always start from 0 and
  * be contiguous meaning the core numbers are not necessarily physical.
- * This type can handle up to 64 cores.
+ * This type can handle up to EM_CORE_MASK_SIZE cores (64 by default).
  *
  * Use the functions in event_machine_core_mask.h to manipulate the core masks.
  * 
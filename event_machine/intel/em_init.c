@@ -91,6 +91,7 @@ em_init(em_conf_t *conf)
 { 
   em_status_t          em_ret;
   sem_t               *sem;
+  em_core_mask_t       core_mask;
   
   char em_shared_conf_name[RTE_MEMZONE_NAMESIZE];
   
@@ -139,7 +140,8 @@ em_init(em_conf_t *conf)
     }
     
     /* Create barrier to synchronize calls to em_init_global() later */
-    env_barrier_init(&em_internal_conf.shared->barrier, env_core_mask_count(conf->core_count));
+    env_core_mask_count(conf->core_count, &core_mask);
+    env_barrier_init(&em_internal_conf.shared->barrier, &core_mask);
     
     /* Store the EM-instance ID */                                      
     em_internal_conf.shared->em_instance_id = conf->em_instance_id;
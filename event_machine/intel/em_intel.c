@@ -73,7 +73,9 @@
  */
  
 #define EM_Q_BASENAME          "EM_Q_"
-#define EM_EVENT_POOL_NAME     "EM-EventPool"
+#define EM_EVENT_POOL_NAME     "EM-EventPool" // Pool-id N>0: "EM-EventPool<N>"
+
+#define EM_EVENT_BULK_MAX      (64) // Max nbr of events to get/put from/to the pool at once in em_alloc_multi()/em_free_multi()
 
 
 /*
@@ -96,7 +98,7 @@
 /**
  * EM data
  */
-em_data_t  em  ENV_CACHE_LINE_ALIGNED = {{.shm = NULL, .event_pool = NULL}};
+em_data_t  em  ENV_CACHE_LINE_ALIGNED = {{.shm = NULL, .event_pools = {{NULL}}, .event_pool_size = {0}}};
 
 
 /**
@@ -108,10 +110,10 @@ ENV_LOCAL  em_core_local_t  em_core_local  ENV_CACHE_LINE_ALIGNED
       /* Set in local init() */
       .current_q_elem            = NULL,
       .current_event_group       = EM_EVENT_GROUP_UNDEF,
-      .current_group_mask        = 0,
       .queue_create_count        = 0,
       .error_count               = 0,
-      .error_cond                = 0
+      .error_cond                = 0,
+      .current_group_mask        = {0}
       }
     };
 
@@ -124,6 +126,12 @@ ENV_LOCAL  em_core_local_t  em_core_local  ENV_CACHE_LINE_ALIGNED
 static inline em_eo_t eo_alloc(void);
 static inline void    eo_alloc_init(void);
 
+static inline void event_hdr_init(em_event_hdr_t *const ev_hdr, const em_event_type_t type);
+
+static em_eo_t eo_create(const char* name, em_start_func_t start, em_start_local_func_t local_start, 
+                         em_stop_func_t stop, em_stop_local_func_t local_stop, em_receive_func_t receive,
+                         em_receive_multi_func_t receive_multi, const void *eo_ctx, const em_escope_t escope);
+
 static inline void        queue_alloc_init(void);
 static inline em_queue_t  queue_alloc(void);
 
@@ -155,6 +163,14 @@ static em_status_t      queue_init__rings_init(void);
 static struct rte_ring *queue_init__ring_create(em_queue_type_e q_type);
 static void             queue_init__ring_flush(struct rte_ring *ring_p);
 static em_status_t      queue_delete__ring_free(struct rte_ring *ring_p, em_queue_type_e q_type);
+static int              atomic_ring_class(const uint32_t size);
+
+#if LOCKLESS_ORDERED_QUEUES == 1
+static order_window_t  *queue_init__order_window_create(void);
+static void             queue_init__order_window_flush(order_window_t *const win);
+static em_status_t      queue_init__order_window_conf(order_window_t *const win, const int capacity, const int overflow_mode);
+static em_status_t      queue_delete__order_window_free(order_window_t *const win);
+#endif
 
 
 /*
@@ -223,7 +239,7 @@ eo_alloc_init(void)
 
   printf("eo alloc init\n");
 
-  (void) memset(em.shm->em_eo_element_tbl, 0, sizeof(em_eo_element_t) * EM_MAX_EOS);
+  (void) memset(em.shm->em_eo_element_tbl, 0, sizeof(em_eo_element_t) * em.shm->limits.max_eos);
 
   (void) memset(em.shm->em_eo_pool, 0, sizeof(em_pool_t) * EO_POOLS);
 
@@ -240,7 +256,7 @@ eo_alloc_init(void)
     m_list_init(&em.shm->em_eo_pool[i].list_head);
 
 
-    for(j = 0; j < EOS_PER_POOL; j++)
+    for(j = 0; j < (int) em.shm->limits.eos_per_pool; j++)
     {
       em_eo_element_t* eo_elem;
 
@@ -265,8 +281,9 @@ static inline void
 eo_add_queue(em_eo_element_t    *eo_elem,
              em_queue_element_t *q_elem)
 {
-  q_elem->receive_func = eo_elem->receive_func;
-  q_elem->eo_ctx       = eo_elem->eo_ctx;
+  q_elem->receive_func       = eo_elem->receive_func;
+  q_elem->receive_multi_func = eo_elem->receive_multi_func;
+  q_elem->eo_ctx             = eo_elem->eo_ctx;
   q_elem->eo_elem      = eo_elem;
   q_elem->status       = EM_QUEUE_STATUS_BIND;
 
@@ -306,13 +323,13 @@ queue_alloc_init(void)
 
   printf("queue init\n");
 
-  (void) memset(em.shm->em_queue_element_tbl, 0, sizeof(em_queue_element_t) * EM_MAX_QUEUES);
+  (void) memset(em.shm->em_queue_element_tbl, 0, sizeof(em_queue_element_t) * em.shm->limits.max_queues);
 
   (void) memset(em.shm->em_dyn_queue_pool,    0, sizeof(em_pool_t) * DYN_QUEUE_POOLS);
 
   (void) memset(em.shm->em_static_queue_lock, 0, sizeof(em_spinlock_t) * STATIC_QUEUE_LOCKS);
 
-  (void) memset(em.shm->em_queue_name_tbl,    0, sizeof(char) * EM_MAX_QUEUES * EM_QUEUE_NAME_LEN);
+  (void) memset(em.shm->em_queue_name_tbl,    0, sizeof(char) * em.shm->limits.max_queues * EM_QUEUE_NAME_LEN);
 
 
   //
@@ -325,7 +342,7 @@ queue_alloc_init(void)
     m_list_init(&em.shm->em_dyn_queue_pool[i].list_head);
 
 
-    for(j = 0; j < DYN_QUEUES_PER_POOL; j++)
+    for(j = 0; j < (int) em.shm->limits.dyn_queues_per_pool; j++)
     {
       em_queue_element_t* q_elem;
 
@@ -403,10 +420,52 @@ queue_alloc(void)
 
 
 
+/**
+ * Queue id free: a static id is released, a dynamic id returned to its pool
+ */
+static inline void
+queue_free(em_queue_t queue)
+{
+  em_queue_element_t *const q_elem = get_queue_element(queue);
+  int                       pool;
+  
+  
+  // Zero queue name.
+  em.shm->em_queue_name_tbl[queue][0] = '\0';
+  
+  
+  if(queue <= EM_QUEUE_STATIC_MAX)
+  {
+    // No synchronisation needed. Queue should be freed from single core.
+    q_elem->status = EM_QUEUE_STATUS_INVALID;
+    env_sync_mem();
+
+    q_elem->static_allocated = 0;
+    env_sync_mem();
+  }
+  else
+  {
+    // Free queue back to the pool set in init
+    pool = q_elem->pool;
+
+    env_spinlock_lock(&em.shm->em_dyn_queue_pool[pool].lock);
+    
+    q_elem->status = EM_QUEUE_STATUS_INVALID;
+    m_list_add(&em.shm->em_dyn_queue_pool[pool].list_head, &q_elem->list_node);
+
+    env_spinlock_unlock(&em.shm->em_dyn_queue_pool[pool].lock);
+  }
+}
+
+
+
 /**
  * Initialize an allocated/created queue before use.
+ *
+ * @return EM_OK if successful. On an error nothing is left allocated for the queue,
+ *         the caller frees the queue id.
  */
-void
+em_status_t
 queue_init(const char*      name,
            em_queue_t       queue,
            em_queue_type_t  type,
@@ -415,6 +474,7 @@ queue_init(const char*      name,
 {
   em_queue_element_t *q_elem;
   char               *queue_name;
+  em_status_t         ret;
 
   q_elem     =  get_queue_element(queue);
   queue_name = &em.shm->em_queue_name_tbl[queue][0];
@@ -428,6 +488,9 @@ queue_init(const char*      name,
   q_elem->status         = EM_QUEUE_STATUS_INIT;
   q_elem->eo_elem        = NULL;
   
+  q_elem->last_core       = 0;
+  q_elem->direct_dispatch = 0;
+  
   q_elem->pkt_io_enabled  = 0;
   q_elem->pkt_io_proto    = 0;
   q_elem->pkt_io_ipv4_dst = 0;
@@ -448,6 +511,17 @@ queue_init(const char*      name,
 
 
 
+  /*
+   * The scheduling queues of the queue group are created on demand by the first EM-queue
+   * of each type (events can be sent to an EM-queue before it is enabled).
+   */
+  ret = sched_qs_create(type, group);
+  
+  RETURN_ERROR_IF(ret != EM_OK, ret, EM_ESCOPE_QUEUE_INIT,
+                  "sched_qs_create() failed for Q:%"PRI_QUEUE" (%s)\n", queue, queue_name);
+
+
+
   /*
    * ATOMIC and PARALLEL_ORDERED EM-queues have dedicated queues (=q_elem->rte_ring) in addition
    * to the shared atomic- and parallel-ordered- scheduling queues.
@@ -459,26 +533,42 @@ queue_init(const char*      name,
     env_spinlock_init(&q_elem->lock);
     q_elem->u.atomic.event_count = 0;
     q_elem->u.atomic.sched_count = 0;
+    q_elem->atomic_release       = 0;
+    q_elem->ring_class           = atomic_ring_class(EM_QUEUE_ATOMIC_RTE_RING_SIZE);
+    q_elem->ring_lazy            = 0;
+    q_elem->ring_refs            = 0;
     
-    q_elem->rte_ring = queue_init__ring_create(EM_QUEUE_TYPE_ATOMIC);
+    q_elem->rte_ring = atomic_ring_alloc(q_elem->ring_class);
     
-    ERROR_IF(q_elem->rte_ring == NULL, EM_ERR_ALLOC_FAILED, EM_ESCOPE_QUEUE_INIT,
-             "rte_ring_create() failed for atomic Q:%"PRI_QUEUE" (%s)\n", queue, queue_name);
+    RETURN_ERROR_IF(q_elem->rte_ring == NULL, EM_ERR_ALLOC_FAILED, EM_ESCOPE_QUEUE_INIT,
+                    "rte_ring_create() failed for atomic Q:%"PRI_QUEUE" (%s)\n", queue, queue_name);
   }
   else if(type == EM_QUEUE_TYPE_PARALLEL_ORDERED)
   {
     env_spinlock_init(&q_elem->lock);
+    
+#if LOCKLESS_ORDERED_QUEUES == 1
+    q_elem->rte_ring = NULL;
+    
+    q_elem->u.parallel_ord.order_win = queue_init__order_window_create();
+
+    RETURN_ERROR_IF(q_elem->u.parallel_ord.order_win == NULL, EM_ERR_ALLOC_FAILED, EM_ESCOPE_QUEUE_INIT,
+                    "Reorder window alloc failed for parallel-ordered Q:%"PRI_QUEUE" (%s)\n", queue, queue_name);
+#else
     q_elem->u.parallel_ord.order_first = NULL;
     
     q_elem->rte_ring = queue_init__ring_create(EM_QUEUE_TYPE_PARALLEL_ORDERED);
 
-    ERROR_IF(q_elem->rte_ring == NULL, EM_ERR_ALLOC_FAILED, EM_ESCOPE_QUEUE_INIT,
-             "rte_ring_create() failed for parallel-ordered Q:%"PRI_QUEUE" (%s)\n", queue, queue_name);
+    RETURN_ERROR_IF(q_elem->rte_ring == NULL, EM_ERR_ALLOC_FAILED, EM_ESCOPE_QUEUE_INIT,
+                    "rte_ring_create() failed for parallel-ordered Q:%"PRI_QUEUE" (%s)\n", queue, queue_name);
+#endif
   }
 
   env_sync_mem();
 
   // q_elem->static_allocated already set (for static queues)
+  
+  return EM_OK;
 }
 
 
@@ -496,31 +586,7 @@ queue_init__ring_create(em_queue_type_t q_type)
   
   if(q_type == EM_QUEUE_TYPE_ATOMIC)
   {
-    // Event Queue. multi-producer, single-consumer
-    // Only single core can dequeue an event,
-    // synchronized by scheduling queue dequeue - there's max one event queue pointer in sched queue.
-    // Create the RTE-ring only the first time a queue is created, a queue delete will not destoy the rte-ring.
-    
-    ret = rte_ring_dequeue(em.shm->queue_init_rings.atomic_rings, (void **) &rte_ring);
-    
-    if(!ret) {
-      queue_init__ring_flush(rte_ring);
-    }
-    else // rte_ring == NULL
-    { 
-      // Intel RTE-lib requires unique names for the rte-rings:
-      // "RingAtom" + core-id(where created) + running count => e.g. "RingAtom_4_012a"
-      (void) snprintf(&ring_name[0], RTE_RING_NAMESIZE, "RingAtom_%i_%"PRIx64"", em_core_id(), em_core_local.queue_create_count++);
-      ring_name[RTE_RING_NAMESIZE-1] = '\0';
-      
-      // Calls to rte_ring_create() needs to be serialized, use lock
-      env_spinlock_lock(&em.shm->queue_create_lock.lock);
-      
-      rte_ring = rte_ring_create(&ring_name[0], EM_QUEUE_ATOMIC_RTE_RING_SIZE, DEVICE_SOCKET, RING_F_SC_DEQ);
-      
-      env_spinlock_unlock(&em.shm->queue_create_lock.lock);
-    }
-    
+    rte_ring = atomic_ring_alloc(atomic_ring_class(EM_QUEUE_ATOMIC_RTE_RING_SIZE));
   }
   else if(q_type == EM_QUEUE_TYPE_PARALLEL_ORDERED)
   {
@@ -600,15 +666,7 @@ queue_delete__ring_free(struct rte_ring *ring_p, em_queue_type_t q_type)
   
   if(q_type == EM_QUEUE_TYPE_ATOMIC)
   {
-    if(ring_p == NULL) {
-      return EM_ERR_BAD_POINTER;
-    }
-    
-    ret = rte_ring_enqueue(em.shm->queue_init_rings.atomic_rings, ring_p);
-    
-    IF_UNLIKELY(ret == (-ENOBUFS)) {
-      return EM_ERR_LIB_FAILED;
-    }
+    return atomic_ring_free(ring_p, atomic_ring_class(EM_QUEUE_ATOMIC_RTE_RING_SIZE));
   }
   else if(q_type == EM_QUEUE_TYPE_PARALLEL_ORDERED)
   {
@@ -627,6 +685,271 @@ queue_delete__ring_free(struct rte_ring *ring_p, em_queue_type_t q_type)
 }
 
 
+/**
+ * Size class of an atomic event queue (rte_ring) with at least 'size' entries
+ */
+static int
+atomic_ring_class(const uint32_t size)
+{
+  int ring_class = 0;
+  
+  
+  while((ring_class < (EM_QUEUE_ATOMIC_RING_CLASSES - 1)) && 
+        ((((uint32_t) EM_QUEUE_ATOMIC_RING_SIZE_MIN) << ring_class) < size))
+  {
+    ring_class++;
+  }
+  
+  return ring_class;
+}
+
+
+/**
+ * Take an event queue (rte_ring) of the given size class for an atomic EM-queue (q_elem->rte_ring) from
+ * the size class pool or create a new one if the pool is empty. Also used by the scheduler to bind
+ * an event queue to a lazily bound atomic queue on the first send.
+ */
+struct rte_ring *
+atomic_ring_alloc(const int ring_class)
+{
+  struct rte_ring *rte_ring = NULL;
+  char ring_name[RTE_RING_NAMESIZE];
+  int ret;
+  
+  
+  // Event Queue. multi-producer, single-consumer
+  // Only single core can dequeue an event,
+  // synchronized by scheduling queue dequeue - there's max one event queue pointer in sched queue.
+  // Create the RTE-ring only the first time it's needed, a queue delete (or unbind) will not destoy the rte-ring.
+  
+  ret = rte_ring_dequeue(em.shm->queue_init_rings.atomic_rings[ring_class], (void **) &rte_ring);
+  
+  if(!ret) {
+    queue_init__ring_flush(rte_ring);
+  }
+  else // rte_ring == NULL
+  { 
+    // Intel RTE-lib requires unique names for the rte-rings:
+    // "RingAtom" + core-id(where created) + running count => e.g. "RingAtom_4_012a"
+    (void) snprintf(&ring_name[0], RTE_RING_NAMESIZE, "RingAtom_%i_%"PRIx64"", em_core_id(), em_core_local.queue_create_count++);
+    ring_name[RTE_RING_NAMESIZE-1] = '\0';
+    
+    // Calls to rte_ring_create() needs to be serialized, use lock
+    env_spinlock_lock(&em.shm->queue_create_lock.lock);
+    
+    rte_ring = rte_ring_create(&ring_name[0], EM_QUEUE_ATOMIC_RING_SIZE_MIN << ring_class, DEVICE_SOCKET, RING_F_SC_DEQ);
+    
+    env_spinlock_unlock(&em.shm->queue_create_lock.lock);
+  }
+  
+  return rte_ring;
+}
+
+
+/**
+ * Return the event queue (rte_ring) of an atomic EM-queue to the pool of its size class
+ */
+em_status_t
+atomic_ring_free(struct rte_ring *const ring, const int ring_class)
+{
+  int ret;
+  
+  
+  if(ring == NULL) {
+    return EM_ERR_BAD_POINTER;
+  }
+  
+  ret = rte_ring_enqueue(em.shm->queue_init_rings.atomic_rings[ring_class], ring);
+  
+  IF_UNLIKELY(ret == (-ENOBUFS)) {
+    return EM_ERR_LIB_FAILED;
+  }
+  
+  return EM_OK;
+}
+
+
+#if LOCKLESS_ORDERED_QUEUES == 1
+/**
+ * Create the reorder window needed by parallel-ordered EM-queues (q_elem->u.parallel_ord.order_win)
+ */
+static order_window_t *
+queue_init__order_window_create(void)
+{
+  order_window_t *win = NULL;
+  order_block_t  *blk;
+  int             ret;
+  
+  
+  // Allocate the window only the first time a queue is created, a queue delete will not free the window.
+  ret = rte_ring_dequeue(em.shm->queue_init_rings.parallel_ord_rings, (void **) &win);
+  
+  if(!ret) {
+    queue_init__order_window_flush(win);
+  }
+  else
+  {
+    win = env_shared_malloc(sizeof(order_window_t));
+    blk = order_window_block_alloc();
+    
+    if((win == NULL) || (blk == NULL))
+    {
+      if(win != NULL) {
+        env_shared_free(win);
+      }
+      if(blk != NULL) {
+        env_shared_free(blk);
+      }
+      return NULL;
+    }
+    
+    (void) memset(win, 0, sizeof(order_window_t));
+    
+    win->head_blk = blk;
+    win->tail_blk = blk;
+    win->blocks   = 1;
+  }
+  
+  if(queue_init__order_window_conf(win, EM_QUEUE_PARALLEL_ORD_WINDOW_SIZE, EM_ORDER_OVERFLOW_UNORDERED) != EM_OK)
+  {
+    (void) queue_delete__order_window_free(win);
+    return NULL;
+  }
+  
+  return win;
+}
+
+
+/**
+ * Flush the reorder window used by parallel-ordered EM-queues (q_elem->u.parallel_ord.order_win).
+ * Keeps the first block in the window and returns the others to the free list of the window.
+ */
+static void
+queue_init__order_window_flush(order_window_t *const win)
+{
+  order_block_t *const first = win->head_blk;
+  order_block_t       *blk   = first;
+  order_block_t       *next;
+  int                  i;
+  
+  
+  while(blk != NULL)
+  {
+    for(i = 0; i < EM_QUEUE_PARALLEL_ORD_BLOCK_SIZE; i++)
+    {
+      if(blk->slot[i] != NULL) {
+        intel_free(blk->slot[i]);
+        blk->slot[i] = NULL;
+      }
+    }
+    
+    next = blk->next;
+    
+    if(blk != first) {
+      blk->next      = win->free_blks;
+      win->free_blks = blk;
+    }
+    
+    blk = next;
+  }
+  
+  first->next = NULL;
+  first->base = 0;
+  
+  win->tail_blk        = first;
+  win->head            = 0;
+  win->tail            = 0;
+  win->releasing       = 0;
+  win->overflow_events = 0;
+  win->order_lost      = 0;
+}
+
+
+/**
+ * Set the capacity and overflow mode of a reorder window that has no events in processing.
+ * The blocks needed for 'capacity' events are allocated in advance.
+ */
+static em_status_t
+queue_init__order_window_conf(order_window_t *const win, const int capacity, const int overflow_mode)
+{
+  // Tickets in processing can span one block more than their count
+  const uint32_t blocks = ((capacity + EM_QUEUE_PARALLEL_ORD_BLOCK_SIZE - 1) / EM_QUEUE_PARALLEL_ORD_BLOCK_SIZE) + 1;
+  order_block_t *blk;
+  
+  
+  win->capacity      = (blocks - 1) * EM_QUEUE_PARALLEL_ORD_BLOCK_SIZE;
+  win->overflow_mode = overflow_mode;
+  win->blocks_max    = blocks;
+  
+  if(overflow_mode == EM_ORDER_OVERFLOW_GROW) 
+  {
+    // More blocks are allocated on demand by the scheduler
+    win->blocks_max = (EM_QUEUE_PARALLEL_ORD_WINDOW_MAX / EM_QUEUE_PARALLEL_ORD_BLOCK_SIZE) + 1;
+    
+    if(win->blocks_max < blocks) {
+      win->blocks_max = blocks;
+    }
+  }
+  
+  while(win->blocks < blocks)
+  {
+    blk = order_window_block_alloc();
+    
+    if(blk == NULL) {
+      return EM_ERR_ALLOC_FAILED;
+    }
+    
+    blk->next      = win->free_blks;
+    win->free_blks = blk;
+    win->blocks++;
+  }
+  
+  return EM_OK;
+}
+
+
+/**
+ * Allocate a (zeroed) block for a reorder window, see order_window_t
+ */
+order_block_t *
+order_window_block_alloc(void)
+{
+  order_block_t *const blk = env_shared_malloc(sizeof(order_block_t));
+  
+  
+  if(blk != NULL) {
+    (void) memset(blk, 0, sizeof(order_block_t));
+  }
+  
+  return blk;
+}
+
+
+/**
+ * Free the reorder window used by parallel-ordered EM-queues (q_elem->u.parallel_ord.order_win)
+ */
+static em_status_t
+queue_delete__order_window_free(order_window_t *const win)
+{
+  int ret;
+  
+  
+  if(win == NULL) {
+    return EM_ERR_BAD_POINTER;
+  }
+  
+  ret = rte_ring_enqueue(em.shm->queue_init_rings.parallel_ord_rings, win);
+  
+  IF_UNLIKELY(ret == (-ENOBUFS)) {
+    return EM_ERR_LIB_FAILED;
+  }
+  
+  return EM_OK;
+}
+#endif
+
+
+
 /**
  * Initialize the queues of free rte_rings (i.e. a queue of queues). The free rte_rings are taken into 
  * use (q_elem->rte_ring) in em_queue_create()/queue_init() and freed back in em_queue_delete()
@@ -634,13 +957,28 @@ queue_delete__ring_free(struct rte_ring *ring_p, em_queue_type_t q_type)
 static em_status_t
 queue_init__rings_init(void)
 { 
+  char     name[RTE_RING_NAMESIZE];
+  uint32_t ring_size = 1;
+  int      i;
   
-  em.shm->queue_init_rings.atomic_rings = rte_ring_create("ATOMIC q_elem rings",  EM_MAX_QUEUES, DEVICE_SOCKET, 0);  
-  if(em.shm->queue_init_rings.atomic_rings == NULL) {
-    return EM_ERR_BAD_POINTER;
+  
+  // Room for the rte_rings of all queues, rte_ring size must be a power of 2
+  while(ring_size < em.shm->limits.max_queues) {
+    ring_size <<= 1;
+  }
+  
+  for(i = 0; i < EM_QUEUE_ATOMIC_RING_CLASSES; i++)
+  {
+    (void) snprintf(name, RTE_RING_NAMESIZE, "ATOMIC q_elem rings %u", EM_QUEUE_ATOMIC_RING_SIZE_MIN << i);
+    name[RTE_RING_NAMESIZE-1] = '\0';
+    
+    em.shm->queue_init_rings.atomic_rings[i] = rte_ring_create(name, ring_size, DEVICE_SOCKET, 0);  
+    if(em.shm->queue_init_rings.atomic_rings[i] == NULL) {
+      return EM_ERR_BAD_POINTER;
+    }
   }
   
-  em.shm->queue_init_rings.parallel_ord_rings = rte_ring_create("PAR-ORD q_elem rings", EM_MAX_QUEUES, DEVICE_SOCKET, 0);
+  em.shm->queue_init_rings.parallel_ord_rings = rte_ring_create("PAR-ORD q_elem rings", ring_size, DEVICE_SOCKET, 0);
   if(em.shm->queue_init_rings.parallel_ord_rings == NULL) {
     return EM_ERR_BAD_POINTER;
   }
@@ -814,11 +1152,23 @@ em_queue_create(const char* name, em_queue_type_t type, em_queue_prio_t prio, em
 {
   em_queue_t queue;
 
+
+  IF_UNLIKELY(prio >= EM_QUEUE_PRIO_NUM)
+  {
+    (void) EM_INTERNAL_ERROR(EM_ERR_BAD_ID, EM_ESCOPE_QUEUE_CREATE, "Invalid queue priority %u", prio);
+    return EM_QUEUE_UNDEF;
+  }
+
   queue = queue_alloc(); // queue_alloc() logged errors.
   
   IF_LIKELY(queue != EM_QUEUE_UNDEF)
   {
-    queue_init(name, queue, type, prio, group);
+    IF_UNLIKELY(queue_init(name, queue, type, prio, group) != EM_OK)
+    {
+      // queue_init() logged errors.
+      queue_free(queue);
+      return EM_QUEUE_UNDEF;
+    }
     
     queue_group_add_queue_list(group, queue);    
   }
@@ -856,12 +1206,16 @@ em_queue_create_static(const char* name, em_queue_type_t type, em_queue_prio_t p
   int                 idx;
   env_spinlock_t     *lock;
   em_queue_element_t *q_elem;
+  em_status_t         ret;
 
 
   RETURN_ERROR_IF(queue > EM_QUEUE_STATIC_MAX /*|| queue < EM_QUEUE_STATIC_MIN */,
                   EM_ERR_BAD_ID, EM_ESCOPE_QUEUE_CREATE_STATIC,
                   "Invalid static EM queue id %"PRI_QUEUE"", queue);
 
+  RETURN_ERROR_IF(prio >= EM_QUEUE_PRIO_NUM, EM_ERR_BAD_ID, EM_ESCOPE_QUEUE_CREATE_STATIC,
+                  "Invalid queue priority %u", prio);
+
 
   idx    =  get_static_queue_lock_idx(queue);
   lock   = &em.shm->em_static_queue_lock[idx].lock;
@@ -882,7 +1236,14 @@ em_queue_create_static(const char* name, em_queue_type_t type, em_queue_prio_t p
   env_spinlock_unlock(lock);
 
 
-  queue_init(name, queue, type, prio, group);
+  ret = queue_init(name, queue, type, prio, group);
+  
+  IF_UNLIKELY(ret != EM_OK)
+  {
+    // queue_init() logged errors.
+    queue_free(queue);
+    return ret;
+  }
 
   return EM_OK;
 }
@@ -890,14 +1251,219 @@ em_queue_create_static(const char* name, em_queue_type_t type, em_queue_prio_t p
 
 
 /**
- * Delete a queue.
+ * Create a parallel-ordered queue with a dynamic queue id and an order restoration config (HW specific addition)
  *
- * Unallocates the queue id.
- * NOTE: this is an immediate deletion and can *only*
- * be done after the queue has been removed from scheduling
- * using em_eo_remove_queue() !
+ * @param name          Queue name for debugging purposes (optional, NULL ok)
+ * @param prio          Queue priority
+ * @param group         Queue group for this queue
+ * @param conf          Order restoration config (NULL = use defaults)
  *
- * @param queue         Queue id to delete
+ * @return New queue id or EM_QUEUE_UNDEF on an error
+ *
+ * @see em_queue_create(), em_queue_order_stats()
+ */
+em_queue_t
+em_queue_create_ordered(const char* name, em_queue_prio_t prio, em_queue_group_t group, const em_queue_order_conf_t *conf)
+{
+  em_queue_t          queue;
+#if LOCKLESS_ORDERED_QUEUES == 1
+  em_queue_element_t *q_elem;
+  em_status_t         ret;
+#endif
+
+
+  IF_UNLIKELY((conf != NULL) && ((conf->capacity < 0) || (conf->capacity > EM_QUEUE_PARALLEL_ORD_WINDOW_MAX) ||
+                                 ((conf->overflow_mode != EM_ORDER_OVERFLOW_UNORDERED) && 
+                                  (conf->overflow_mode != EM_ORDER_OVERFLOW_GROW))))
+  {
+    (void) EM_INTERNAL_ERROR(EM_ERR_TOO_LARGE, EM_ESCOPE_QUEUE_CREATE_ORDERED,
+                             "Invalid order conf: capacity=%i (max %i) overflow_mode=%i",
+                             conf->capacity, EM_QUEUE_PARALLEL_ORD_WINDOW_MAX, conf->overflow_mode);
+    return EM_QUEUE_UNDEF;
+  }
+
+  queue = em_queue_create(name, EM_QUEUE_TYPE_PARALLEL_ORDERED, prio, group);
+  
+#if LOCKLESS_ORDERED_QUEUES == 1
+  IF_LIKELY((queue != EM_QUEUE_UNDEF) && (conf != NULL))
+  {
+    q_elem = get_queue_element(queue);
+    
+    ret = queue_init__order_window_conf(q_elem->u.parallel_ord.order_win,
+                                        (conf->capacity > 0) ? conf->capacity : EM_QUEUE_PARALLEL_ORD_WINDOW_SIZE,
+                                        conf->overflow_mode);
+    
+    IF_UNLIKELY(ret != EM_OK)
+    {
+      (void) em_queue_delete(queue);
+      (void) EM_INTERNAL_ERROR(ret, EM_ESCOPE_QUEUE_CREATE_ORDERED, "Reorder window alloc failed, capacity=%i", conf->capacity);
+      return EM_QUEUE_UNDEF;
+    }
+  }
+#else
+  // The order-queue size is fixed (EM_QUEUE_PARALLEL_ORD_RTE_RING_SIZE), 'conf' is not used.
+#endif
+
+  return queue;
+}
+
+
+
+/**
+ * Read the order restoration counters of a parallel-ordered queue (HW specific addition)
+ *
+ * @param queue         Parallel-ordered queue
+ * @param stats         Counters (output)
+ *
+ * @return EM_OK if successful.
+ *
+ * @see em_queue_create_ordered()
+ */
+em_status_t
+em_queue_order_stats(em_queue_t queue, em_queue_order_stats_t *stats)
+{
+  em_queue_element_t *q_elem;
+  
+  
+  RETURN_ERROR_IF(invalid_queue(queue), EM_ERR_BAD_ID, EM_ESCOPE_QUEUE_ORDER_STATS,
+                  "Invalid EM queue id %"PRI_QUEUE"", queue);
+  
+  RETURN_ERROR_IF(stats == NULL, EM_ERR_BAD_POINTER, EM_ESCOPE_QUEUE_ORDER_STATS,
+                  "Stats pointer NULL");
+  
+  q_elem = get_queue_element(queue);
+  
+  RETURN_ERROR_IF(q_elem->scheduler_type != EM_QUEUE_TYPE_PARALLEL_ORDERED, EM_ERR_BAD_STATE, EM_ESCOPE_QUEUE_ORDER_STATS,
+                  "EM queue %"PRI_QUEUE" is not parallel-ordered", queue);
+  
+#if LOCKLESS_ORDERED_QUEUES == 1
+  {
+    order_window_t *const win = q_elem->u.parallel_ord.order_win;
+    
+    stats->overflow_events = win->overflow_events;
+    stats->order_lost      = win->order_lost;
+    stats->capacity        = win->capacity;
+    stats->window_size     = (win->blocks - 1) * EM_QUEUE_PARALLEL_ORD_BLOCK_SIZE;
+  }
+#else
+  stats->overflow_events = 0;
+  stats->order_lost      = 0; // Not counted by the order-queues
+  stats->capacity        = EM_QUEUE_PARALLEL_ORD_RTE_RING_SIZE;
+  stats->window_size     = EM_QUEUE_PARALLEL_ORD_RTE_RING_SIZE;
+#endif
+
+  return EM_OK;
+}
+
+
+
+/**
+ * Create an atomic queue with a dynamic queue id and an event queue config (HW specific addition)
+ *
+ * @param name          Queue name for debugging purposes (optional, NULL ok)
+ * @param prio          Queue priority
+ * @param group         Queue group for this queue
+ * @param conf          Event queue config (NULL = use defaults)
+ *
+ * @return New queue id or EM_QUEUE_UNDEF on an error
+ *
+ * @see em_queue_create()
+ */
+em_queue_t
+em_queue_create_atomic(const char* name, em_queue_prio_t prio, em_queue_group_t group, const em_queue_atomic_conf_t *conf)
+{
+  em_queue_t          queue;
+  em_queue_element_t *q_elem;
+  em_status_t         ret;
+  
+  
+  IF_UNLIKELY((conf != NULL) && ((conf->ring_size < 0) || (conf->ring_size > EM_QUEUE_ATOMIC_RING_SIZE_MAX)))
+  {
+    (void) EM_INTERNAL_ERROR(EM_ERR_TOO_LARGE, EM_ESCOPE_QUEUE_CREATE_ATOMIC,
+                             "Invalid atomic conf: ring_size=%i (max %i)", conf->ring_size, EM_QUEUE_ATOMIC_RING_SIZE_MAX);
+    return EM_QUEUE_UNDEF;
+  }
+  
+  queue = em_queue_create(name, EM_QUEUE_TYPE_ATOMIC, prio, group);
+  
+  IF_LIKELY((queue != EM_QUEUE_UNDEF) && (conf != NULL))
+  {
+    q_elem = get_queue_element(queue);
+    
+    // Replace the default size event queue, the queue is not yet in use (not enabled)
+    ret = atomic_ring_free(q_elem->rte_ring, q_elem->ring_class);
+    
+    q_elem->rte_ring   = NULL;
+    q_elem->ring_class = atomic_ring_class((conf->ring_size > 0) ? conf->ring_size : EM_QUEUE_ATOMIC_RTE_RING_SIZE);
+    q_elem->ring_lazy  = (conf->lazy_ring != 0);
+    
+    if((ret == EM_OK) && (!q_elem->ring_lazy))
+    {
+      q_elem->rte_ring = atomic_ring_alloc(q_elem->ring_class);
+      
+      if(q_elem->rte_ring == NULL) {
+        ret = EM_ERR_ALLOC_FAILED;
+      }
+    }
+    
+    IF_UNLIKELY(ret != EM_OK)
+    {
+      q_elem->ring_lazy = 1; // nothing to free on delete
+      (void) em_queue_delete(queue);
+      (void) EM_INTERNAL_ERROR(ret, EM_ESCOPE_QUEUE_CREATE_ATOMIC, "Event queue alloc failed, ring_size=%i", conf->ring_size);
+      return EM_QUEUE_UNDEF;
+    }
+    
+    env_sync_mem();
+  }
+  
+  return queue;
+}
+
+
+
+/**
+ * Enable or disable the direct dispatch of a queue (HW specific addition)
+ *
+ * @param queue         Queue id
+ * @param enable        Direct dispatch: enable=1, disable=0
+ *
+ * @return EM_OK if successful.
+ *
+ * @see em_queue_create()
+ */
+em_status_t
+em_queue_direct_dispatch_set(em_queue_t queue, int enable)
+{
+  em_queue_element_t *q_elem;
+  
+  
+  RETURN_ERROR_IF(invalid_queue(queue), EM_ERR_BAD_ID, EM_ESCOPE_QUEUE_DIRECT_DISPATCH_SET,
+                  "Invalid EM queue id %"PRI_QUEUE"", queue);
+  
+  q_elem = get_queue_element(queue);
+  
+  RETURN_ERROR_IF(q_elem->status == EM_QUEUE_STATUS_INVALID, EM_ERR_BAD_STATE, EM_ESCOPE_QUEUE_DIRECT_DISPATCH_SET,
+                  "EM queue %"PRI_QUEUE" not created", queue);
+  
+  q_elem->direct_dispatch = (enable != 0);
+  
+  env_sync_mem();
+  
+  return EM_OK;
+}
+
+
+
+/**
+ * Delete a queue.
+ *
+ * Unallocates the queue id.
+ * NOTE: this is an immediate deletion and can *only*
+ * be done after the queue has been removed from scheduling
+ * using em_eo_remove_queue() !
+ *
+ * @param queue         Queue id to delete
  *
  * @return EM_OK if successful.
  *
@@ -907,7 +1473,6 @@ em_status_t
 em_queue_delete(em_queue_t queue)
 {
   em_queue_element_t *q_elem;
-  int                 pool;
   em_status_t         ret;
 
 
@@ -921,36 +1486,23 @@ em_queue_delete(em_queue_t queue)
   queue_group_rem_queue_list(q_elem->queue_group, queue);
   
   
-  ret = queue_delete__ring_free(q_elem->rte_ring, q_elem->scheduler_type);
+  if(q_elem->scheduler_type == EM_QUEUE_TYPE_ATOMIC) {
+    // A lazily bound queue might currently have no event queue
+    ret = ((q_elem->rte_ring == NULL) && q_elem->ring_lazy) ? EM_OK : atomic_ring_free(q_elem->rte_ring, q_elem->ring_class);
+  }
+#if LOCKLESS_ORDERED_QUEUES == 1
+  else if(q_elem->scheduler_type == EM_QUEUE_TYPE_PARALLEL_ORDERED) {
+    ret = queue_delete__order_window_free(q_elem->u.parallel_ord.order_win);
+  }
+#endif
+  else {
+    ret = queue_delete__ring_free(q_elem->rte_ring, q_elem->scheduler_type);
+  }
   RETURN_ERROR_IF(ret != EM_OK, EM_FATAL(ret), EM_ESCOPE_QUEUE_DELETE, 
                   "queue_delete__ring_free() failed (%i)", ret);
   
   
-  // Zero queue name.
-  em.shm->em_queue_name_tbl[queue][0] = '\0';
-  
-  
-  if(queue <= EM_QUEUE_STATIC_MAX)
-  {
-    // No synchronisation needed. Queue should be freed from single core.
-    q_elem->status = EM_QUEUE_STATUS_INVALID;
-    env_sync_mem();
-
-    q_elem->static_allocated = 0;
-    env_sync_mem();
-  }
-  else
-  {
-    // Free queue back to the pool set in init
-    pool = q_elem->pool;
-
-    env_spinlock_lock(&em.shm->em_dyn_queue_pool[pool].lock);
-    
-    q_elem->status = EM_QUEUE_STATUS_INVALID;
-    m_list_add(&em.shm->em_dyn_queue_pool[pool].list_head, &q_elem->list_node);
-
-    env_spinlock_unlock(&em.shm->em_dyn_queue_pool[pool].lock);
-  }
+  queue_free(queue);
 
 
   return EM_OK;
@@ -1050,6 +1602,7 @@ em_queue_disable(em_queue_t queue, int num_notif, const em_notif_t* notif_tbl)
 {
   em_status_t          ret;
   em_core_mask_t       core_mask;
+  char                 mask_str[EM_CORE_MASK_STRLEN];
   em_queue_element_t  *q_elem;
   em_event_t           event;
   em_internal_event_t *i_event;
@@ -1096,7 +1649,7 @@ em_queue_disable(em_queue_t queue, int num_notif, const em_notif_t* notif_tbl)
     ret = em_internal_notif(&core_mask, event, NULL, NULL, num_notif, notif_tbl);
 
     RETURN_ERROR_IF(ret != EM_OK, ret, EM_ESCOPE_QUEUE_DISABLE,
-                    "em_internal_notif(core_mask=%"PRIX64") failed", core_mask.u64);
+                    "em_internal_notif(core_mask=%s) failed", em_core_mask_tostr(mask_str, sizeof(mask_str), &core_mask));
   }
   
   
@@ -1384,11 +1937,6 @@ em_eo_create(const char*            name,
              em_receive_func_t      receive,
              const void            *eo_ctx)
 {
-  em_eo_t          eo;
-  em_eo_element_t* eo_elem;
-  size_t           nlen;
-
-
   ERROR_IF((start == NULL) || (stop == NULL) || (receive == NULL),
            EM_ERR_BAD_POINTER, EM_ESCOPE_EO_CREATE,
            "Mandatory function pointer(s) NULL!")
@@ -1396,10 +1944,72 @@ em_eo_create(const char*            name,
     return EM_EO_UNDEF;
   }
   
+  return eo_create(name, start, local_start, stop, local_stop, receive, NULL, eo_ctx, EM_ESCOPE_EO_CREATE);
+}
+
+
+
+/**
+ * Create Execution Object (EO) with a multi-event receive function.
+ * 
+ * As em_eo_create(), but EM calls the given 'receive_multi' function with a batch of
+ * events from one queue instead of calling a receive function for each event separately.
+ *
+ * @param name          Name of the EO (NULL if no name)
+ * @param start         Start function
+ * @param local_start   Core local start function (NULL if no local start)
+ * @param stop          Stop function
+ * @param local_stop    Core local stop function (NULL if no local stop)
+ * @param receive_multi Multi-event receive function
+ * @param eo_ctx        User defined EO context data, EM just passes the pointer (NULL if not context)
+ *
+ * @return New EO id if successful, otherwise EM_EO_UNDEF
+ *
+ * @see em_eo_create(), em_receive_multi_func_t()
+ */
+em_eo_t
+em_eo_create_multircv(const char*             name,
+                      em_start_func_t         start,
+                      em_start_local_func_t   local_start,
+                      em_stop_func_t          stop,
+                      em_stop_local_func_t    local_stop,
+                      em_receive_multi_func_t receive_multi,
+                      const void             *eo_ctx)
+{
+  ERROR_IF((start == NULL) || (stop == NULL) || (receive_multi == NULL),
+           EM_ERR_BAD_POINTER, EM_ESCOPE_EO_CREATE_MULTIRCV,
+           "Mandatory function pointer(s) NULL!")
+  {
+    return EM_EO_UNDEF;
+  }
+  
+  return eo_create(name, start, local_start, stop, local_stop, NULL, receive_multi, eo_ctx, EM_ESCOPE_EO_CREATE_MULTIRCV);
+}
+
+
+
+/**
+ * Allocate and initialize a new EO, either 'receive' or 'receive_multi' is set.
+ */
+static em_eo_t
+eo_create(const char*             name,
+          em_start_func_t         start,
+          em_start_local_func_t   local_start,
+          em_stop_func_t          stop,
+          em_stop_local_func_t    local_stop,
+          em_receive_func_t       receive,
+          em_receive_multi_func_t receive_multi,
+          const void             *eo_ctx,
+          const em_escope_t       escope)
+{
+  em_eo_t          eo;
+  em_eo_element_t* eo_elem;
+  size_t           nlen;
+
 
   eo = eo_alloc();
 
-  ERROR_IF(invalid_eo(eo), EM_ERR_ALLOC_FAILED, EM_ESCOPE_EO_CREATE,
+  ERROR_IF(invalid_eo(eo), EM_ERR_ALLOC_FAILED, escope,
            "EO alloc failed")
   {
      return EM_EO_UNDEF;
@@ -1422,7 +2032,8 @@ em_eo_create(const char*            name,
   eo_elem->start_local_func = local_start;
   eo_elem->stop_func        = stop;
   eo_elem->stop_local_func  = local_stop;
-  eo_elem->receive_func     = receive;
+  eo_elem->receive_func       = receive;
+  eo_elem->receive_multi_func = receive_multi;
   eo_elem->eo_ctx           = (void *) eo_ctx;
   eo_elem->id               = eo;
 
@@ -1578,6 +2189,7 @@ em_eo_remove_queue(em_eo_t eo, em_queue_t queue, int num_notif, const em_notif_t
   em_queue_element_t *q_elem;
   em_status_t         ret;
   em_core_mask_t      core_mask;
+  char                mask_str[EM_CORE_MASK_STRLEN];
   int                 send_notifs;
 
   
@@ -1634,7 +2246,7 @@ em_eo_remove_queue(em_eo_t eo, em_queue_t queue, int num_notif, const em_notif_t
     ret = em_internal_notif(&core_mask, event, NULL, NULL, num_notif, notif_tbl);
     
     RETURN_ERROR_IF(ret != EM_OK, ret, EM_ESCOPE_EO_REMOVE_QUEUE,
-                    "em_internal_notif(core_mask=%"PRIX64") failed", core_mask.u64);
+                    "em_internal_notif(core_mask=%s) failed", em_core_mask_tostr(mask_str, sizeof(mask_str), &core_mask));
   }
 
   return EM_OK;
@@ -1727,6 +2339,7 @@ em_eo_start(em_eo_t eo, em_status_t *result, int num_notif, const em_notif_t* no
     if((num_notif > 0) && (num_notif < EM_EVENT_GROUP_MAX_NOTIF))
     {
       em_core_mask_t      core_mask;
+      char                mask_str[EM_CORE_MASK_STRLEN];
       em_event_t          event;
       em_internal_event_t *i_event;
       
@@ -1747,7 +2360,7 @@ em_eo_start(em_eo_t eo, em_status_t *result, int num_notif, const em_notif_t* no
       ret = em_internal_notif(&core_mask, event, NULL, NULL, num_notif, notif_tbl);
       
       IF_UNLIKELY(ret != EM_OK) {
-        return EM_INTERNAL_ERROR(ret, EM_ESCOPE_EO_START, "em_internal_notif(core_mask=%"PRIX64") failed", core_mask.u64); 
+        return EM_INTERNAL_ERROR(ret, EM_ESCOPE_EO_START, "em_internal_notif(core_mask=%s) failed", em_core_mask_tostr(mask_str, sizeof(mask_str), &core_mask)); 
       }
     }
   }
@@ -1855,6 +2468,7 @@ em_eo_stop(em_eo_t eo, int num_notif, const em_notif_t* notif_tbl)
     if((num_notif > 0) && (num_notif < EM_EVENT_GROUP_MAX_NOTIF))
     {
       em_core_mask_t      core_mask;
+      char                mask_str[EM_CORE_MASK_STRLEN];
       em_event_t          event;
       em_internal_event_t *i_event;
       
@@ -1875,7 +2489,7 @@ em_eo_stop(em_eo_t eo, int num_notif, const em_notif_t* notif_tbl)
       ret = em_internal_notif(&core_mask, event, NULL, NULL, num_notif, notif_tbl);
 
       IF_UNLIKELY(ret != EM_OK) {
-        return EM_INTERNAL_ERROR(ret, EM_ESCOPE_EO_STOP, "em_internal_notif(core_mask=%"PRIX64") failed", core_mask.u64); 
+        return EM_INTERNAL_ERROR(ret, EM_ESCOPE_EO_STOP, "em_internal_notif(core_mask=%s) failed", em_core_mask_tostr(mask_str, sizeof(mask_str), &core_mask)); 
       }
     }
   }
@@ -2026,6 +2640,123 @@ em_core_mask_get_physical(em_core_mask_t       *phys,
 
 
 
+/**
+ * Formats a core mask into a hex string, e.g. "0xF0" - leading zero words are left out.
+ *
+ * @param mask_str Output string buffer
+ * @param len      Length of 'mask_str', EM_CORE_MASK_STRLEN fits any mask
+ * @param mask     Core mask
+ *
+ * @return 'mask_str'
+ */
+char *
+em_core_mask_tostr(char* mask_str, int len, const em_core_mask_t* mask)
+{
+  int i, n;
+  
+
+  // Highest non-zero word, always print at least u64[0]
+  for(i = (EM_CORE_MASK_SIZE / 64) - 1; (i > 0) && (mask->u64[i] == 0); i--) {
+    ;
+  }
+  
+  n = snprintf(mask_str, len, "0x%"PRIX64"", mask->u64[i]);
+  
+  for(i--; (i >= 0) && (n > 0) && (n < len); i--) {
+    n += snprintf(&mask_str[n], len - n, "%016"PRIX64"", mask->u64[i]);
+  }
+  
+  if(len > 0) {
+    mask_str[len-1] = '\0';
+  }
+  
+  return mask_str;
+}
+
+
+
+
+/**
+ * Select the event pool for an allocation of 'size' bytes.
+ *
+ * EM_POOL_DEFAULT: the smallest pool (size class) that fits 'size'.
+ * Other pool ids:  the given pool, if large enough.
+ *
+ * @return the pool index or -1 on an error (error reported with 'escope')
+ */
+static inline int
+event_pool_select(size_t size, em_pool_id_t pool_id, em_escope_t escope)
+{
+  int                 pool_idx = -1;
+  uint32_t            min_size = UINT32_MAX;
+  int                 i;
+  
+  
+  if(pool_id == EM_POOL_DEFAULT)
+  {
+    for(i = 0; i < EM_MAX_POOLS; i++)
+    {
+      if((size <= em.event_pool_size[i]) && (em.event_pool_size[i] < min_size))
+      {
+        pool_idx = i;
+        min_size = em.event_pool_size[i];
+      }
+    }
+    
+    IF_UNLIKELY(pool_idx < 0) {
+      (void) EM_INTERNAL_ERROR(EM_ERR_TOO_LARGE, escope, "No event pool for size(%u)", size);
+    }
+  }
+  else
+  {
+    IF_UNLIKELY(pool_id >= EM_MAX_POOLS) {
+      (void) EM_INTERNAL_ERROR(EM_ERR_BAD_ID, escope, "Invalid pool id:%u", pool_id);
+    }
+    else IF_UNLIKELY(size > em.event_pool_size[pool_id]) {
+      (void) EM_INTERNAL_ERROR(EM_ERR_TOO_LARGE, escope, "size(%u) > pool(%u) size(%u)",
+                               size, pool_id, em.event_pool_size[pool_id]);
+    }
+    else {
+      pool_idx = pool_id;
+    }
+  }
+  
+  return pool_idx;
+}
+
+
+
+/**
+ * Get 'n' buffers from the event pool 'pool_idx' of another socket with EM cores,
+ * used when the socket local pool is empty (em_conf_t.numa_policy EM_NUMA_LOCAL_FIRST).
+ * The buffers return to their own pool when freed.
+ *
+ * @return 0 on success, -1 if all pools are empty or the policy is EM_NUMA_LOCAL_ONLY
+ */
+static int
+event_get_bulk_remote(void **objs, const int n, const int pool_idx)
+{
+  const int local_socket = em_core_local.socket_id;
+  int       socket;
+  
+  
+  IF_UNLIKELY(em_internal_conf.conf.numa_policy == EM_NUMA_LOCAL_ONLY) {
+    return -1;
+  }
+  
+  for(socket = 0; socket < EM_MAX_SOCKETS; socket++)
+  {
+    if((socket != local_socket) && (numa_home_socket(socket) == socket) &&
+       (rte_mempool_get_bulk((struct rte_mempool *) em.event_pools[socket][pool_idx], objs, (unsigned) n) == 0))
+    {
+      return 0;
+    }
+  }
+  
+  return -1;
+}
+
+
 
 /**
  * Allocate an event.
@@ -2044,7 +2775,8 @@ em_core_mask_get_physical(em_core_mask_t       *phys,
  * the given size (no HW specific descriptors etc are visible).
  *
  * EM_POOL_DEFAULT can be used as pool id if there's no need to 
- * use any specific memory pool.
+ * use any specific memory pool - the smallest pool (size class) that
+ * fits the requested size is then used.
  *
  * Additionally it is guaranteed, that two separate buffers
  * never share a cache line to avoid false sharing.
@@ -2065,44 +2797,36 @@ em_alloc(size_t size, em_event_type_t type, em_pool_id_t pool_id)
    *   - NULL if allocation failed
    */
 
-  IF_UNLIKELY(size > MBUF_SIZE)
+  const int pool_idx = event_pool_select(size, pool_id, EM_ESCOPE_ALLOC);
+  
+  
+  IF_UNLIKELY(pool_idx < 0)
   {
-    (void) EM_INTERNAL_ERROR(EM_ERR_TOO_LARGE, EM_ESCOPE_ALLOC, "size(%u) > MBUF_SIZE(%u)", size, MBUF_SIZE);
     return EM_EVENT_UNDEF;
   }
   else
   {
-    struct rte_mbuf *const m = rte_pktmbuf_alloc((struct rte_mempool *) em.event_pool);
+  #if EVENT_CACHE == 1
+    struct rte_mbuf *m = event_cache_alloc(pool_idx);
+  #else
+    struct rte_mbuf *m = rte_pktmbuf_alloc((struct rte_mempool *) em.event_pools[em_core_local.socket_id][pool_idx]);
+  #endif
 
     IF_UNLIKELY(m == NULL)
     {
-      (void) EM_INTERNAL_ERROR(EM_ERR_ALLOC_FAILED, EM_ESCOPE_ALLOC, "rte_pktmbuf_alloc() failed");
-      return EM_EVENT_UNDEF;
-    }
-    else {
-      /* Need to init the src_q_type so that em_send() does not misinterpret.
-       * The event hdr starts after the 'struct mbuf' (RTE_PKTMBUF_HEADROOM)
-       */
-      em_event_hdr_t *const ev_hdr = mbuf_to_event_hdr(m);
-
-      ev_hdr->q_elem      = em_core_local.current_q_elem; // Direct Tx after alloc expects q_elem set
-      ev_hdr->src_q_type  = EM_QUEUE_TYPE_UNDEF;
-      ev_hdr->event_type  = type;
-      ev_hdr->event_group = EM_EVENT_GROUP_UNDEF;
-
-      // ev_hdr->lock_p          = NULL;
-      // ev_hdr->dst_q_elem      = NULL;
-      // ev_hdr->processing_done = 0;
-      // ev_hdr->operation       = 0;
-      // ev_hdr->io_port         = 0;
-      
-    
-    #ifdef EVENT_TIMER
-      if(em_internal_conf.conf.evt_timer) {
-        rte_timer_init(&ev_hdr->event_timer);
+      // Socket local pool empty - try the other sockets
+      IF_UNLIKELY(event_get_bulk_remote((void **) &m, 1, pool_idx) != 0)
+      {
+        (void) EM_INTERNAL_ERROR(EM_ERR_ALLOC_FAILED, EM_ESCOPE_ALLOC, "event pool %i empty", pool_idx);
+        return EM_EVENT_UNDEF;
       }
-    #endif  
+      
+      // Init the mbuf as rte_pktmbuf_alloc() would
+      rte_mbuf_refcnt_set(m, 1);
+      rte_pktmbuf_reset(m);
     }
+    
+    event_hdr_init(mbuf_to_event_hdr(m), type);
 
     return mbuf_to_event(m);
   }
@@ -2110,6 +2834,107 @@ em_alloc(size_t size, em_event_type_t type, em_pool_id_t pool_id)
 
 
 
+/**
+ * Allocate multiple events (HW specific addition)
+ *
+ * As em_alloc() for each event, but the buffers are taken from the pool in bulk.
+ * Either all 'num' events are allocated or none.
+ *
+ * @param events        Array for the allocated events
+ * @param num           Number of events to allocate
+ * @param size          Event size in octets
+ * @param type          Event type to allocate
+ * @param pool_id       Event pool id 
+ *
+ * @return The number of allocated events: 'num' on success, 0 on an error
+ *
+ * @see em_alloc(), em_free_multi()
+ */
+int
+em_alloc_multi(em_event_t events[], int num, size_t size, em_event_type_t type, em_pool_id_t pool_id)
+{
+  const int                 pool_idx = event_pool_select(size, pool_id, EM_ESCOPE_ALLOC_MULTI);
+  struct rte_mempool       *mp;
+  struct rte_mbuf          *mbufs[EM_EVENT_BULK_MAX];
+  int                       allocated = 0;
+  int                       ret;
+  int                       i;
+  
+
+  IF_UNLIKELY(pool_idx < 0)
+  {
+    return 0;
+  }
+  
+  mp = (struct rte_mempool *) em.event_pools[em_core_local.socket_id][pool_idx];
+  
+
+  while(allocated < num)
+  {
+    const int n = ((num - allocated) > EM_EVENT_BULK_MAX) ? EM_EVENT_BULK_MAX : (num - allocated);
+    
+    ret = rte_mempool_get_bulk(mp, (void **) mbufs, n);
+    
+    IF_UNLIKELY(ret != 0) {
+      // Socket local pool empty - try the other sockets
+      ret = event_get_bulk_remote((void **) mbufs, n, pool_idx);
+    }
+    
+    IF_UNLIKELY(ret != 0)
+    {
+      // All or nothing: return the already allocated events
+      em_free_multi(events, allocated);
+      
+      (void) EM_INTERNAL_ERROR(EM_ERR_ALLOC_FAILED, EM_ESCOPE_ALLOC_MULTI, "rte_mempool_get_bulk() failed, num=%i", num);
+      return 0;
+    }
+    
+    // Init the mbufs as rte_pktmbuf_alloc() would, then the event headers
+    for(i = 0; i < n; i++)
+    {
+      struct rte_mbuf *const m = mbufs[i];
+      
+      rte_mbuf_refcnt_set(m, 1);
+      rte_pktmbuf_reset(m);
+      
+      event_hdr_init(mbuf_to_event_hdr(m), type);
+      
+      events[allocated + i] = mbuf_to_event(m);
+    }
+    
+    allocated += n;
+  }
+
+  return allocated;
+}
+
+
+
+/**
+ * Init the event header of a newly allocated event
+ */
+static inline void
+event_hdr_init(em_event_hdr_t *const ev_hdr, const em_event_type_t type)
+{
+  /* Need to init the src_q_type so that em_send() does not misinterpret.
+   * The event hdr starts after the 'struct mbuf' (RTE_PKTMBUF_HEADROOM)
+   */
+  ev_hdr->q_elem      = em_core_local.current_q_elem; // Direct Tx after alloc expects q_elem set
+  ev_hdr->src_q_type  = EM_QUEUE_TYPE_UNDEF;
+  ev_hdr->event_type  = type;
+  ev_hdr->event_group = EM_EVENT_GROUP_UNDEF;
+
+  // ev_hdr->lock_p          = NULL;
+  // ev_hdr->dst_q_elem      = NULL;
+  // ev_hdr->processing_done = 0;
+  // ev_hdr->operation       = 0;
+  // ev_hdr->io_port         = 0;
+  
+  // No timer state in the event header, see event_timer.c
+}
+
+
+
 /**
  * Free an event.
  *
@@ -2162,6 +2987,104 @@ em_free(em_event_t event)
 
 
 
+/**
+ * Free multiple events (HW specific addition)
+ *
+ * As em_free() for each event, but single segment buffers are returned to their
+ * pool in bulk. Events originating from the same parallel-ordered queue are marked
+ * free with one order-queue lock operation.
+ * 
+ * @param events        Events to be freed
+ * @param num           Number of events
+ *
+ * @see em_free(), em_alloc_multi()
+ */
+void
+em_free_multi(em_event_t events[], int num)
+{
+  em_event_hdr_t     *ev_hdrs[EM_EVENT_BULK_MAX];
+  void               *objs[EM_EVENT_BULK_MAX];
+  struct rte_mempool *mp       = NULL;
+  int                 num_objs = 0;
+  int                 i        = 0;
+
+
+  while(i < num)
+  {
+    em_event_hdr_t *ev_hdr;
+    
+    IF_UNLIKELY(events[i] == NULL)
+    {
+      (void) EM_INTERNAL_ERROR(EM_ERR_BAD_POINTER, EM_ESCOPE_FREE_MULTI, "event ptr NULL! (idx=%i)", i);
+      i++;
+      continue;
+    }
+    
+    ev_hdr = event_to_event_hdr(events[i]);
+    
+    if(ev_hdr->src_q_type == EM_QUEUE_TYPE_PARALLEL_ORDERED)
+    {
+      /*
+       * Special handling for parallel-ordered _originated_ events, see em_free().
+       * Mark all consecutive events from the same parallel-ordered queue at once.
+       */
+      em_queue_element_t *const src_q_elem = ev_hdr->q_elem;
+      int                       n          = 0;
+      
+      do {
+        ev_hdrs[n++] = ev_hdr;
+        
+        if((++i == num) || (n == EM_EVENT_BULK_MAX) || (events[i] == NULL)) {
+          break;
+        }
+        
+        ev_hdr = event_to_event_hdr(events[i]);
+        
+      } while((ev_hdr->src_q_type == EM_QUEUE_TYPE_PARALLEL_ORDERED) && (ev_hdr->q_elem == src_q_elem));
+      
+      (void) em_send_from_parallel_ord_q_multi(ev_hdrs, n, NULL, EM_QUEUE_UNDEF, OPERATION_MARK_FREE);
+    }
+    else
+    {
+      struct rte_mbuf *m = event_hdr_to_mbuf(ev_hdr);
+      
+      i++;
+      
+      IF_UNLIKELY(m->pkt.next != NULL)
+      {
+        // Multi-segment packet, free normally
+        rte_pktmbuf_free(m);
+        continue;
+      }
+      
+      // Drop the reference, returns NULL if the mbuf is still in use elsewhere
+      m = __rte_pktmbuf_prefree_seg(m);
+      
+      IF_UNLIKELY(m == NULL) {
+        continue;
+      }
+      
+      // Put the collected bufs if this one is from another pool or the table is full
+      if((num_objs > 0) && ((m->pool != mp) || (num_objs == EM_EVENT_BULK_MAX)))
+      {
+        rte_mempool_put_bulk(mp, objs, num_objs);
+        num_objs = 0;
+      }
+      
+      mp               = m->pool;
+      objs[num_objs++] = m;
+    }
+  }
+  
+  
+  if(num_objs > 0)
+  {
+    rte_mempool_put_bulk(mp, objs, num_objs);
+  }
+}
+
+
+
 
 /*
  * EM initialisation
@@ -2169,28 +3092,186 @@ em_free(em_event_t event)
  */
 
 
+/*
+ * Event pool (size class) configuration, indexed by em_pool_id_t
+ */
+static const intel_pool_cfg_t pool_cfg[] = INTEL_POOL_CFG_INIT;
+
+COMPILE_TIME_ASSERT((sizeof(pool_cfg) / sizeof(pool_cfg[0])) == EM_MAX_POOLS, INTEL_POOL_CFG_INIT__SIZE_ERROR);
+
+
+
+/*
+ * Event pool name: pool-id 0 keeps the original name, the pools of socket 0 keep the names without a socket suffix
+ */
+static void
+event_pool_name(char pool_name[RTE_MEMPOOL_NAMESIZE], int pool_id, int socket)
+{
+  if(pool_id == 0) {
+    (void) snprintf(pool_name, RTE_MEMPOOL_NAMESIZE, "%s", EM_EVENT_POOL_NAME);
+  }
+  else {
+    (void) snprintf(pool_name, RTE_MEMPOOL_NAMESIZE, "%s%i", EM_EVENT_POOL_NAME, pool_id);
+  }
+  
+  if(socket != SOCKET0)
+  {
+    const size_t len = strlen(pool_name);
+    
+    (void) snprintf(&pool_name[len], RTE_MEMPOOL_NAMESIZE - len, "_S%i", socket);
+  }
+  
+  pool_name[RTE_MEMPOOL_NAMESIZE-1] = '\0';
+}
+
+
+
+/*
+ * Sockets without EM cores use the event pools of their home socket (buffers freed there, e.g. by
+ * a Eth Tx on a remote socket, still return to the right pool)
+ */
+static void
+event_pools_alias(void)
+{
+  int socket, i;
+  
+  
+  for(socket = 0; socket < EM_MAX_SOCKETS; socket++)
+  {
+    const int home = numa_home_socket(socket);
+    
+    if(home != socket)
+    {
+      for(i = 0; i < EM_MAX_POOLS; i++) {
+        em.event_pools[socket][i] = em.event_pools[home][i];
+      }
+    }
+  }
+}
+
+
+
+/*
+ * Table sizes of the EM shared data from the EM config, 0 in the config = use the compile-time max
+ */
+static em_status_t
+shared_data_limits(const em_conf_t *const conf, em_shared_limits_t *const limits)
+{
+  uint32_t max_queues, max_eos;
+  
+  
+  RETURN_ERROR_IF((conf->max_queues < 0) || (conf->max_queues > EM_MAX_QUEUES) ||
+                  (conf->max_eos    < 0) || (conf->max_eos    > EM_MAX_EOS) ||
+                  (conf->max_event_groups < 0) || (conf->max_event_groups > EM_MAX_EVENT_GROUPS) ||
+                  (conf->max_eth_ports    < 0) || (conf->max_eth_ports    > MAX_ETH_PORTS),
+                  EM_ERR_TOO_LARGE, EM_ESCOPE_INIT_GLOBAL,
+                  "Invalid conf: max_queues=%i(%i) max_eos=%i(%i) max_event_groups=%i(%i) max_eth_ports=%i(%i)",
+                  conf->max_queues, EM_MAX_QUEUES, conf->max_eos, EM_MAX_EOS,
+                  conf->max_event_groups, EM_MAX_EVENT_GROUPS, conf->max_eth_ports, MAX_ETH_PORTS);
+  
+  // Static and EM internal queues always included, fill all dynamic queue id pools evenly
+  max_queues = (conf->max_queues > 0) ? conf->max_queues : EM_MAX_QUEUES;
+  max_queues = ROUND_UP(MAX(max_queues, FIRST_DYN_QUEUE + DYN_QUEUE_POOLS), DYN_QUEUE_POOLS);
+  max_queues = MIN(max_queues, EM_MAX_QUEUES);
+  
+  max_eos    = (conf->max_eos > 0) ? conf->max_eos : EM_MAX_EOS;
+  max_eos    = MIN(ROUND_UP(max_eos, EO_POOLS), EM_MAX_EOS);
+  
+  (void) memset(limits, 0, sizeof(em_shared_limits_t));
+  
+  limits->max_queues          = max_queues;
+  limits->dyn_queues_per_pool = (max_queues - FIRST_DYN_QUEUE) / DYN_QUEUE_POOLS;
+  limits->max_eos             = max_eos;
+  limits->eos_per_pool        = max_eos / EO_POOLS;
+  limits->max_event_groups    = (conf->max_event_groups > 0) ? conf->max_event_groups : EM_MAX_EVENT_GROUPS;
+  limits->max_eth_ports       = (conf->max_eth_ports    > 0) ? conf->max_eth_ports    : MAX_ETH_PORTS;
+  
+  return EM_OK;
+}
+
+
+
+/*
+ * Layout of the EM shared memory: em_shared_data_t followed by the tables sized by 'limits'.
+ * Sets the table pointers if 'shm' is given.
+ *
+ * @return Total size of the EM shared memory
+ */
+static size_t
+shared_data_layout(em_shared_data_t *const shm, const em_shared_limits_t *const limits)
+{
+  const size_t eo_tbl_size     = ROUND_UP(sizeof(em_eo_element_t)        * limits->max_eos,          ENV_CACHE_LINE_SIZE);
+  const size_t q_tbl_size      = ROUND_UP(sizeof(em_queue_element_t)     * limits->max_queues,       ENV_CACHE_LINE_SIZE);
+  const size_t q_name_tbl_size = ROUND_UP(EM_QUEUE_NAME_LEN              * limits->max_queues,       ENV_CACHE_LINE_SIZE);
+  const size_t egrp_tbl_size   = ROUND_UP(sizeof(em_event_group_entry_t) * limits->max_event_groups, ENV_CACHE_LINE_SIZE);
+  const size_t eth_tx_tbl_size = ROUND_UP(sizeof(eth_tx_mbuf_table_t) * MAX_ETH_TX_MBUF_TABLES * limits->max_eth_ports,
+                                          ENV_CACHE_LINE_SIZE);
+  size_t       offset          = sizeof(em_shared_data_t);
+  
+  
+  if(shm != NULL)
+  {
+    uint8_t *const base = (uint8_t *) shm;
+    
+    shm->em_eo_element_tbl        = (em_eo_element_t *)        &base[offset];  offset += eo_tbl_size;
+    shm->em_queue_element_tbl     = (em_queue_element_t *)     &base[offset];  offset += q_tbl_size;
+    shm->em_queue_name_tbl        = (char (*)[EM_QUEUE_NAME_LEN]) &base[offset];  offset += q_name_tbl_size;
+    shm->em_event_group_entry_tbl = (em_event_group_entry_t *) &base[offset];  offset += egrp_tbl_size;
+    shm->eth_tx_mbuf_tables       = (eth_tx_mbuf_table_t (*)[MAX_ETH_TX_MBUF_TABLES]) &base[offset];  offset += eth_tx_tbl_size;
+  }
+  else {
+    offset += eo_tbl_size + q_tbl_size + q_name_tbl_size + egrp_tbl_size + eth_tx_tbl_size;
+  }
+  
+  return offset;
+}
+
+
+
 /*
  * Event machine process initialization. Run once per process.
  */
 em_status_t
 em_init_global(const em_internal_conf_t *const em_internal_conf)
 {
-  em_status_t ret;
-  char       *name = "EMSharedData";
+  em_status_t        ret;
+  char              *name = "EMSharedData";
+  char               pool_name[RTE_MEMPOOL_NAMESIZE];
+  em_shared_limits_t limits;
+  size_t             shm_size;
+  int                socket;
+  int                i;
 
   
   (void) memset(&em, 0, sizeof(em));
   
   if(em_internal_conf->conf.proc_idx == 0)
   { 
-    em.shm = env_shared_reserve(name, sizeof(em_shared_data_t));
+    ret = shared_data_limits(&em_internal_conf->conf, &limits);
+    RETURN_ERROR_IF(ret != EM_OK, ret, EM_ESCOPE_INIT_GLOBAL, "shared_data_limits() returned error");
+    
+    RETURN_ERROR_IF((em_internal_conf->conf.numa_policy != EM_NUMA_LOCAL_FIRST) &&
+                    (em_internal_conf->conf.numa_policy != EM_NUMA_LOCAL_ONLY), EM_ERR_BAD_ID, EM_ESCOPE_INIT_GLOBAL,
+                    "Invalid conf: numa_policy=%i", em_internal_conf->conf.numa_policy);
+    
+    // One region for the shared data and all tables
+    shm_size = shared_data_layout(NULL, &limits);
+    
+    em.shm = env_shared_reserve(name, shm_size);
     
     RETURN_ERROR_IF(em.shm == NULL, EM_ERR_ALLOC_FAILED, EM_ESCOPE_INIT_GLOBAL,
                     "env_shared_reserve(%s, sizeof(%lu)) failed!",
-                    name, (unsigned long)sizeof(em_shared_data_t));
+                    name, (unsigned long)shm_size);
     
+    // Only the fixed part is cleared here, the tables are initialized (and touched) by their init functions
     (void) memset(em.shm, 0, sizeof(em_shared_data_t));
     
+    em.shm->limits = limits;
+    (void) shared_data_layout(em.shm, &limits);
+    
+    printf("EM shared data: %lu bytes, queues:%u EOs:%u event groups:%u eth ports:%u\n", (unsigned long) shm_size,
+           limits.max_queues, limits.max_eos, limits.max_event_groups, limits.max_eth_ports);
+    
     // store a pointer to the shared memory (as seen by the primary process) to verify that secondary processes
     // see exactly the same virtual memory addresses (ptrs inside the shmem do not work otherwise).
     em.shm->this_shm = em.shm;
@@ -2205,16 +3286,39 @@ em_init_global(const em_internal_conf_t *const em_internal_conf)
     /* Initialize the error handling */
     em_error_init();
   
-    /* Initialise the event pool */
-    em.event_pool = intel_pool_init(EM_EVENT_POOL_NAME);
-    RETURN_ERROR_IF(em.event_pool == NULL, EM_ERR_ALLOC_FAILED, EM_ESCOPE_INIT_GLOBAL,
-                    "EM Event Pool creation failed!");
+    /* 
+     * Initialise the event pools on each socket with EM cores, 
+     * the configured number of buffers is split between the sockets.
+     */
+    for(socket = 0; socket < EM_MAX_SOCKETS; socket++)
+    {
+      if(numa_home_socket(socket) != socket) {
+        continue; // No EM cores on this socket
+      }
+      
+      for(i = 0; i < EM_MAX_POOLS; i++)
+      {
+        intel_pool_cfg_t cfg = pool_cfg[i];
+        
+        cfg.nbr_bufs = pool_cfg[i].nbr_bufs / em.shm->em_core_map.socket_count;
+        cfg.socket   = socket;
+        
+        event_pool_name(pool_name, i, socket);
+        
+        em.event_pools[socket][i] = intel_pool_init(pool_name, &cfg);
+        em.event_pool_size[i]     = pool_cfg[i].data_size;
+        RETURN_ERROR_IF(em.event_pools[socket][i] == NULL, EM_ERR_ALLOC_FAILED, EM_ESCOPE_INIT_GLOBAL,
+                        "EM Event Pool %s creation failed!", pool_name);
+      }
+    }
+    
+    event_pools_alias();
   
     // Init EM data structures
     queue_alloc_init();
     eo_alloc_init();
   
-    // staged init: need to memset & init vars that are used in e.g. queue_group_init_global()
+    // need to memset & init vars that are used in e.g. queue_group_init_global()
     sched_init_global_1(); 
    
     env_spinlock_init(&em.shm->queue_create_lock.lock);
@@ -2226,10 +3330,6 @@ em_init_global(const em_internal_conf_t *const em_internal_conf)
     event_group_alloc_init();
     queue_group_init_global();
   
-    // 2nd stage sched init
-    ret = sched_init_global_2();
-    RETURN_ERROR_IF(ret != EM_OK, ret, EM_ESCOPE_INIT_GLOBAL, "sched_init_global() returned error");
-  
       
     
   #ifdef EVENT_PACKET
@@ -2259,10 +3359,25 @@ em_init_global(const em_internal_conf_t *const em_internal_conf)
     /* Init error handling for child processes */
     em_error_init_secondary();
     
-    /* Initialise the event pool */
-    em.event_pool = intel_pool_lookup(EM_EVENT_POOL_NAME);
-    RETURN_ERROR_IF(em.event_pool == NULL, EM_ERR_NOT_FOUND, EM_ESCOPE_INIT_GLOBAL,
-                    "EM Event Pool lookup failed! (0x%"PRIx64")", (uint64_t)em.event_pool);
+    /* Look up the event pools */
+    for(socket = 0; socket < EM_MAX_SOCKETS; socket++)
+    {
+      if(numa_home_socket(socket) != socket) {
+        continue; // No EM cores on this socket
+      }
+      
+      for(i = 0; i < EM_MAX_POOLS; i++)
+      {
+        event_pool_name(pool_name, i, socket);
+        
+        em.event_pools[socket][i] = intel_pool_lookup(pool_name);
+        em.event_pool_size[i]     = pool_cfg[i].data_size;
+        RETURN_ERROR_IF(em.event_pools[socket][i] == NULL, EM_ERR_NOT_FOUND, EM_ESCOPE_INIT_GLOBAL,
+                        "EM Event Pool %s lookup failed! (0x%"PRIx64")", pool_name, (uint64_t)em.event_pools[socket][i]);
+      }
+    }
+    
+    event_pools_alias();
   }
 
 
@@ -2303,6 +3418,9 @@ em_init_local(const em_internal_conf_t *const em_internal_conf)
 
   printf("em_init_local() on em-core %u\n", core_id); fflush(NULL);
 
+  // Allocate from the event pools of the own socket
+  em_core_local.socket_id = em.shm->em_core_map.socket[core_id];
+
   // Don't memset em_core_local anymore, use static initialization at declaration,
   // because EM-core 0 might use these vars during global startup - thus avoid dual initialization.
   //(void) memset(&em_core_local, 0, sizeof(em_core_local));
@@ -2444,9 +3562,25 @@ core_map_init(em_core_map_t *const em_core_map, int core_count, const em_core_ma
   while((logic_id < core_count) && (phys_id < EM_MAX_CORES))
   {
     if(em_core_mask_isset(phys_id, &em_core_map->phys_mask))
-    {    
-      em_core_map->logic[phys_id] = logic_id;
-      em_core_map->phys[logic_id] = phys_id;
+    {
+      int socket = (int) rte_lcore_to_socket_id((unsigned) phys_id);
+      
+      if(socket >= EM_MAX_SOCKETS)
+      {
+        printf("%s(): lcore %i on socket %i, max %i sockets - using socket %i\n",
+               __func__, phys_id, socket, EM_MAX_SOCKETS, SOCKET0);
+        socket = SOCKET0;
+      }
+      
+      em_core_map->logic[phys_id]   = logic_id;
+      em_core_map->phys[logic_id]   = phys_id;
+      em_core_map->socket[logic_id] = (uint8_t) socket;
+      
+      if(em_core_mask_iszero(&em_core_map->socket_mask[socket])) {
+        em_core_map->socket_count++;
+      }
+      em_core_mask_set(logic_id, &em_core_map->socket_mask[socket]);
+      
       logic_id++;
     }
     phys_id++;
@@ -2456,6 +3590,63 @@ core_map_init(em_core_map_t *const em_core_map, int core_count, const em_core_ma
 
 
 
+/**
+ * The socket whose resources (event pools, Eth Rx queues) are used for 'socket':
+ * 'socket' itself if it has EM cores, otherwise the first socket with EM cores.
+ */
+int
+numa_home_socket(const int socket)
+{
+  const em_core_map_t *const em_core_map = &em.shm->em_core_map;
+  int i;
+  
+  
+  if((socket >= 0) && (socket < EM_MAX_SOCKETS) && !em_core_mask_iszero(&em_core_map->socket_mask[socket])) {
+    return socket;
+  }
+  
+  for(i = 0; i < EM_MAX_SOCKETS; i++)
+  {
+    if(!em_core_mask_iszero(&em_core_map->socket_mask[i])) {
+      return i;
+    }
+  }
+  
+  return SOCKET0;
+}
+
+
+
+/**
+ * The socket of the logical EM cores in 'mask' if they all are on the same socket,
+ * SOCKET_ID_ANY otherwise.
+ */
+int
+numa_cores_socket(const em_core_mask_t *const mask)
+{
+  const em_core_map_t *const em_core_map = &em.shm->em_core_map;
+  em_core_mask_t             on_socket;
+  int                        i;
+  
+  
+  if(em_core_mask_iszero(mask)) {
+    return SOCKET_ID_ANY;
+  }
+  
+  for(i = 0; i < EM_MAX_SOCKETS; i++)
+  {
+    em_core_mask_and(&on_socket, mask, &em_core_map->socket_mask[i]);
+    
+    if(em_core_mask_equal(&on_socket, mask)) {
+      return i;
+    }
+  }
+  
+  return SOCKET_ID_ANY;
+}
+
+
+
 static inline int
 logic_to_phys_core_id(const int logic_core)
 {
@@ -2503,6 +3694,7 @@ eo_local_func_call_req(em_eo_element_t *const eo_elem,
   em_internal_event_t *i_event;
   int                 core_count;
   em_core_mask_t      core_mask;
+  char                mask_str[EM_CORE_MASK_STRLEN];
 
   
   event = em_alloc(sizeof(em_internal_event_t), EM_EVENT_TYPE_SW, EM_POOL_DEFAULT);
@@ -2523,7 +3715,7 @@ eo_local_func_call_req(em_eo_element_t *const eo_elem,
   err = em_internal_notif(&core_mask, event, f_done_callback, f_done_arg_ptr, num_notif, notif_tbl);
   
   RETURN_ERROR_IF(err != EM_OK, err, EM_ESCOPE_EO_LOCAL_FUNC_CALL_REQ,
-                  "em_internal_notif(core_mask=%"PRIX64") failed", core_mask.u64);
+                  "em_internal_notif(core_mask=%s) failed", em_core_mask_tostr(mask_str, sizeof(mask_str), &core_mask));
   
   return EM_OK;
 }
@@ -59,8 +59,31 @@ extern "C" {
 
 // Max number of EM cores supported
 #define EM_MAX_CORES           (RTE_MAX_LCORE)
-// Keep smaller than 64 to fit in uint64_t core_mask
-COMPILE_TIME_ASSERT(EM_MAX_CORES <= 64, TOO_MANY_CORES);
+// Must fit in em_core_mask_t, build with a larger EM_CORE_MASK_SIZE for more than 64 cores
+COMPILE_TIME_ASSERT(EM_MAX_CORES <= EM_CORE_MASK_SIZE, TOO_MANY_CORES);
+// Core ids are stored as uint8_t in the core map
+COMPILE_TIME_ASSERT(EM_MAX_CORES <= 256, TOO_MANY_CORES_FOR_CORE_MAP);
+
+// Max number of CPU sockets (NUMA nodes), socket ids are stored as uint8_t in the core map
+#define EM_MAX_SOCKETS         (RTE_MAX_NUMA_NODES)
+COMPILE_TIME_ASSERT(EM_MAX_SOCKETS <= 256, TOO_MANY_SOCKETS_FOR_CORE_MAP);
+
+
+/**
+ * Queue group mask, two levels: leaf[w] has a bit per queue group (w * 64 + bit)
+ * and 'summary' has bit w set when leaf[w] (possibly) has bits set.
+ * Searches only touch the leaf words marked in the summary, see em_intel_queue_group.h.
+ */
+#define GROUP_MASK_WORDS       ((EM_MAX_QUEUE_GROUPS + 63) / 64)
+COMPILE_TIME_ASSERT(GROUP_MASK_WORDS <= 64, TOO_MANY_QUEUE_GROUPS);
+
+typedef struct
+{
+  volatile uint64_t  summary;
+  
+  volatile uint64_t  leaf[GROUP_MASK_WORDS];
+  
+} group_mask_t;
 
 
 // EO pools
@@ -89,7 +112,8 @@ COMPILE_TIME_ASSERT(EM_MAX_EOS == (EOS_PER_POOL * EO_POOLS), EOS_PER_POOL__TRUNK
 
 #define PREFETCH_RTE_RING(rte_ring) {ENV_PREFETCH(&((rte_ring)->prod)); ENV_PREFETCH(&((rte_ring)->cons)); /*ENV_PREFETCH(&(rte_ring)->ring);*/}
 
-#define PREFETCH_Q_ELEM(q_elem)     {ENV_PREFETCH((q_elem)); ENV_PREFETCH(&(((em_queue_element_t*)(q_elem))->lock));}
+// Only the first (hot) cache line of the q_elem is needed by the scheduler, see em_queue_element_t
+#define PREFETCH_Q_ELEM(q_elem)     {ENV_PREFETCH((q_elem));}
 
 
 
@@ -127,12 +151,12 @@ COMPILE_TIME_ASSERT(POWEROF2(STATIC_QUEUE_LOCKS), STATIC_QUEUE_LOCKS__NOT_POWER_
 /*
  * Macros
  */
-#define invalid_queue(queue)   (ENV_UNLIKELY((queue) >= EM_MAX_QUEUES))
+#define invalid_queue(queue)   (ENV_UNLIKELY((queue) >= em.shm->limits.max_queues))
 
 #define invalid_q_elem(q_elem) (ENV_UNLIKELY( (((uint64_t)(q_elem)) < ((uint64_t)&em.shm->em_queue_element_tbl[0])) \
-                                           || (((uint64_t)(q_elem)) > ((uint64_t)&em.shm->em_queue_element_tbl[EM_MAX_QUEUES-1])) ))
+                                           || (((uint64_t)(q_elem)) > ((uint64_t)&em.shm->em_queue_element_tbl[em.shm->limits.max_queues-1])) ))
 
-#define invalid_eo(eo)         (ENV_UNLIKELY((eo) >= EM_MAX_EOS))
+#define invalid_eo(eo)         (ENV_UNLIKELY((eo) >= em.shm->limits.max_eos))
 
 
 
@@ -174,11 +198,11 @@ typedef union
     /* Add further internal config */
   };
   
-  uint8_t u8[ENV_CACHE_LINE_SIZE];
+  uint8_t u8[2*ENV_CACHE_LINE_SIZE];
   
 } em_internal_conf_t;
 
-COMPILE_TIME_ASSERT(sizeof(em_internal_conf_t) == ENV_CACHE_LINE_SIZE, EM_INTERNAL_CONF_T__SIZE_ERROR);
+COMPILE_TIME_ASSERT(sizeof(em_internal_conf_t) == (2*ENV_CACHE_LINE_SIZE), EM_INTERNAL_CONF_T__SIZE_ERROR);
 
 
 
@@ -204,6 +228,8 @@ typedef struct
   em_stop_local_func_t    stop_local_func;
 
   em_receive_func_t       receive_func; // Note: copy of this in q_elem for perf
+  
+  em_receive_multi_func_t receive_multi_func; // Set instead of receive_func if created with em_eo_create_multircv()
 
   em_error_handler_t      error_handler_func;
   
@@ -228,50 +254,123 @@ typedef struct
 #define EM_QUEUE_STATUS_BIND    2
 #define EM_QUEUE_STATUS_READY   3
 
-#define EM_QUEUE_ATOMIC_RTE_RING_SIZE        (4*1024) // Atomic: Event queue
+#define EM_QUEUE_ATOMIC_RTE_RING_SIZE        (4*1024) // Atomic: Event queue (default size)
+#define EM_QUEUE_ATOMIC_RING_SIZE_MIN        (32)     // Atomic: Event queue size classes are EM_QUEUE_ATOMIC_RING_SIZE_MIN << class
+#define EM_QUEUE_ATOMIC_RING_CLASSES         (12)     // 32 ... 64k
+#define EM_QUEUE_ATOMIC_RING_SIZE_MAX        (EM_QUEUE_ATOMIC_RING_SIZE_MIN << (EM_QUEUE_ATOMIC_RING_CLASSES - 1))
 #define EM_QUEUE_PARALLEL_ORD_RTE_RING_SIZE  (1024)// (512)    // Parallel-Ordered: Order queue
 
 /**
- * Queue element
+ * Select a lock-free reorder window (=1) or a spinlock protected order-queue (=0) to restore
+ * the event order of parallel-ordered queues
  */
+#define LOCKLESS_ORDERED_QUEUES              (1)  // 1=On, 0=Off
 
-typedef struct
+// Parallel-Ordered: default max number of events in processing per queue kept in order (capacity)
+#define EM_QUEUE_PARALLEL_ORD_WINDOW_SIZE    (EM_QUEUE_PARALLEL_ORD_RTE_RING_SIZE)
+// Parallel-Ordered: limit for the window size with EM_ORDER_OVERFLOW_GROW
+#define EM_QUEUE_PARALLEL_ORD_WINDOW_MAX     (64*1024)
+// Parallel-Ordered: the reorder window is built from blocks of this many events (power of 2)
+#define EM_QUEUE_PARALLEL_ORD_BLOCK_SIZE     (256)
+COMPILE_TIME_ASSERT(POWEROF2(EM_QUEUE_PARALLEL_ORD_BLOCK_SIZE), EM_QUEUE_PARALLEL_ORD_BLOCK_SIZE__NOT_POWER_OF_TWO);
+
+
+/**
+ * Reorder window block: slots for the completed events of EM_QUEUE_PARALLEL_ORD_BLOCK_SIZE consecutive tickets
+ */
+typedef struct order_block_
 {
+  // Completed events (headers) waiting for output, indexed by 'ticket - base'
+  void *volatile               slot[EM_QUEUE_PARALLEL_ORD_BLOCK_SIZE]  ENV_CACHE_LINE_ALIGNED;
+  
   /* --------- CACHE LINE ----------- */
-
-  // Actual Queue (ring buf) - Atomic: event-queue, Parallel-Ordered: order-queue, Parallel: not used
-  struct rte_ring           *rte_ring  ENV_CACHE_LINE_ALIGNED;
   
-  // Atomic, parallel or parallel-ordered queue
-  em_queue_type_t            scheduler_type;
+  // Next block in ticket order (in the window) or next free block (in the free list)
+  struct order_block_ *volatile next  ENV_CACHE_LINE_ALIGNED;
   
-  // Queue priority
-  em_queue_prio_t            priority;
-
-  // The queue group idx for this queue
-  em_queue_group_t           queue_group;
+  // Ticket of slot[0]
+  volatile uint32_t             base;
   
-  // Queue status
-  uint32_t                   status;
+} order_block_t;
 
-  // Queue-ID (queue table index)
-  em_queue_t                 id;
+COMPILE_TIME_ASSERT((sizeof(order_block_t) % ENV_CACHE_LINE_SIZE) == 0, ORDER_BLOCK_T__SIZE_ERROR);
 
-  // Copy of receive the function and object pointer for better performance
-  em_receive_func_t          receive_func;
+
+/**
+ * Reorder window of a parallel-ordered queue (LOCKLESS_ORDERED_QUEUES == 1)
+ *
+ * The scheduler hands out consecutive tickets to the events in dequeue order (window tail).
+ * A core done with an event stores it into the slot of its ticket and then outputs, in ticket
+ * order, all events found from the window head onwards - if no other core is doing it
+ * already (release token). No core ever waits for another one.
+ *
+ * The slots are kept in a chain of blocks: the ticket side links a block from the free list
+ * (or a newly allocated one) to the tail when needed and the releasing side returns passed
+ * blocks to the free list. Up to 'capacity' events are kept in order, events beyond that are
+ * handled according to the overflow mode of the queue.
+ */
+typedef struct
+{
+  /* --------- CACHE LINE ----------- */
   
-  // User defined eo context (can be NULL)
-  void                      *eo_ctx;        
+  /* Ticket side - serialized by the scheduling queue lock of the queue */
   
-  // User defined queue context (can be NULL)
-  void                      *context;       
+  // Block of the next ticket
+  order_block_t     *tail_blk  ENV_CACHE_LINE_ALIGNED;
+  
+  // Next ticket to hand out
+  uint32_t           tail;
+  
+  // Max number of events in processing kept in order
+  uint32_t           capacity;
+  
+  // EM_ORDER_OVERFLOW_UNORDERED or EM_ORDER_OVERFLOW_GROW
+  int                overflow_mode;
+  
+  // Number of blocks allocated / allowed
+  uint32_t           blocks;
+  uint32_t           blocks_max;
+  
+  // Counters: events beyond 'capacity' kept in order (window grown) / sent without restoring order
+  uint64_t           overflow_events;
+  uint64_t           order_lost;
+  
+  /* --------- CACHE LINE ----------- */
+  
+  /* Release side - release token holder */
+  
+  // Block of the next ticket to output
+  order_block_t     *volatile head_blk  ENV_CACHE_LINE_ALIGNED;
+  
+  // Next ticket to output
+  volatile uint32_t  head;
+  
+  // Release token: set while a core is outputting events
+  volatile int       releasing;
   
-
   /* --------- CACHE LINE ----------- */
+  
+  // Free blocks: pushed by the release side, popped by the ticket side
+  order_block_t     *volatile free_blks  ENV_CACHE_LINE_ALIGNED;
+  
+} order_window_t;
+
+COMPILE_TIME_ASSERT((sizeof(order_window_t) % ENV_CACHE_LINE_SIZE) == 0, ORDER_WINDOW_T__SIZE_ERROR);
+
+/**
+ * Queue element
+ *
+ * The first cache line holds everything needed to send to and dispatch from the queue (hot),
+ * the lock and the control fields used by the API calls are in the following lines (cold).
+ */
 
-  // Queue specific lock (needed by atomic and parallel-ordered queues)
-  env_spinlock_t    lock  ENV_CACHE_LINE_ALIGNED;
+typedef struct
+{
+  /* --------- CACHE LINE (hot) ----------- */
 
+  // Actual Queue (ring buf) - Atomic: event-queue, Parallel-Ordered: order-queue, Parallel: not used
+  struct rte_ring           *rte_ring  ENV_CACHE_LINE_ALIGNED;
+  
   union
   {
     // for Atomic queues:
@@ -292,18 +391,71 @@ typedef struct
     // for Parallel-Ordered queues:
     struct 
     {
-      // pointer to the event that was received "first"
-      void *volatile order_first;
+      union {
+        // pointer to the event that was received "first" (LOCKLESS_ORDERED_QUEUES == 0)
+        void *volatile order_first;
+        
+        // Reorder window (LOCKLESS_ORDERED_QUEUES == 1)
+        order_window_t *order_win;
+      };
 	  
     } parallel_ord;
   } u;
 
+  // Queue-ID (queue table index)
+  em_queue_t                 id;
 
+  // Copy of receive the function and object pointer for better performance
+  em_receive_func_t          receive_func;
+  
+  // Copy of the EO multi-event receive function (NULL if EO uses 'receive_func')
+  em_receive_multi_func_t    receive_multi_func;
+  
+  // User defined eo context (can be NULL)
+  void                      *eo_ctx;        
+  
+  // User defined queue context (can be NULL)
+  void                      *context;       
+  
+  // Atomic, parallel or parallel-ordered queue (em_queue_type_t)
+  uint8_t                    scheduler_type  : 2;
+  
+  // Queue priority (em_queue_prio_t)
+  uint8_t                    priority        : 3;
+  
+  // Atomic queues: lazily bound event queue (rte_ring), taken from the size class pool
+  // on the first send and returned when the queue drains
+  uint8_t                    ring_lazy       : 1;
+  
+  // Events sent from an EO on a core serving the queue group are dispatched inline (em_queue_direct_dispatch_set())
+  uint8_t                    direct_dispatch : 1;
+  
+  // Queue status
+  uint8_t                    status;
+  
+  // The queue group idx for this queue (em_queue_group_t)
+  uint16_t                   queue_group;
+  
+  // Atomic queues with 'ring_lazy': number of senders using the event queue, -1 while unbinding it
+  volatile int16_t           ring_refs;
+  
+  // Atomic queues: em_atomic_processing_end() used by the EO, schedule one event at a time
+  volatile uint8_t           atomic_release;
+  
+  // Atomic queues: EM core that served the previous burst (cache affinity hint)
+  uint8_t                    last_core;
+  
 
-  /* init/ctrl functions read/write */
+  /* --------- CACHE LINE (cold) ----------- */
+
+  // Queue specific lock (used by atomic and parallel-ordered queues only with the lock based scheduling options)
+  env_spinlock_t             lock  ENV_CACHE_LINE_ALIGNED;
   
-  // Internal eo context
-  em_eo_element_t           *eo_elem;           
+  // Atomic queues: size class of the event queue (rte_ring), read only when (re)binding a lazy event queue
+  uint8_t                    ring_class;
+
+
+  /* init/ctrl functions read/write */
   
   // Queue pool index
   uint8_t                    pool;              
@@ -315,8 +467,11 @@ typedef struct
   uint8_t                    pkt_io_enabled;
   // If pkt_io_enabled set: contains the configured pkt-io params
   uint8_t                    pkt_io_proto;
-  uint32_t                   pkt_io_ipv4_dst;
   uint16_t                   pkt_io_port_dst;
+  uint32_t                   pkt_io_ipv4_dst;
+  
+  // Internal eo context
+  em_eo_element_t           *eo_elem;           
 
   // Linked-list of q_elems
   m_list_head_t              list_node;
@@ -332,6 +487,10 @@ typedef struct
 
 COMPILE_TIME_ASSERT(sizeof(em_queue_element_t) <= (3*ENV_CACHE_LINE_SIZE),      EM_QUEUE_ELEMENT_T__SIZE_ERROR);
 COMPILE_TIME_ASSERT(offsetof(em_queue_element_t, lock) == ENV_CACHE_LINE_SIZE, EM_QUEUE_ELEMENT_T__ALIGN_ERROR);
+COMPILE_TIME_ASSERT(offsetof(em_queue_element_t, last_core) < ENV_CACHE_LINE_SIZE, EM_QUEUE_ELEMENT_T__HOT_LINE_ERROR);
+COMPILE_TIME_ASSERT(offsetof(em_queue_element_t, ring_refs) < ENV_CACHE_LINE_SIZE, EM_QUEUE_ELEMENT_T__HOT_LINE_ERROR2);
+COMPILE_TIME_ASSERT(EM_QUEUE_TYPE_PARALLEL_ORDERED <= 3, EM_QUEUE_ELEMENT_T__SCHED_TYPE_BITS_ERROR);
+COMPILE_TIME_ASSERT(EM_QUEUE_PRIO_NUM <= 8, EM_QUEUE_ELEMENT_T__PRIORITY_BITS_ERROR);
 COMPILE_TIME_ASSERT(offsetof(em_queue_element_t, qgrp_node) == (2*ENV_CACHE_LINE_SIZE), EM_QUEUE_ELEMENT_T__ALIGN_ERROR2);
 
 
@@ -339,12 +498,15 @@ COMPILE_TIME_ASSERT(offsetof(em_queue_element_t, qgrp_node) == (2*ENV_CACHE_LINE
  * Event header
  *
  * SW & I/O originated events.
+ * One cache line at the start of the mbuf headroom, the rest of the headroom (EM_EVENT_HDR_PREPEND_ROOM)
+ * in front of the event data is free for packet prepends. Timer state is kept in separate timer objects
+ * (event_timer.c), only for events with a pending timeout.
  */
 
 typedef union em_event_hdr_
 {
-  // 128 bytes reserved for event header
-  uint8_t u8[RTE_PKTMBUF_HEADROOM];
+  // One cache line reserved for event header
+  uint8_t u8[ENV_CACHE_LINE_SIZE];
 
   struct
   {
@@ -354,32 +516,29 @@ typedef union em_event_hdr_
     em_event_group_t     event_group;
    
     // Parallel-ordered only
-    env_spinlock_t      *volatile lock_p;
+    union {
+      env_spinlock_t    *volatile lock_p;       // Order-queue lock  (LOCKLESS_ORDERED_QUEUES == 0)
+      order_block_t               *order_blk;    // Reorder window block of the ticket (LOCKLESS_ORDERED_QUEUES == 1)
+    };
     em_queue_element_t  *volatile dst_q_elem;
-    volatile int         processing_done;
+    union {
+      volatile int       processing_done;       // (LOCKLESS_ORDERED_QUEUES == 0)
+      uint32_t           order_ticket;          // Reorder window ticket (LOCKLESS_ORDERED_QUEUES == 1)
+    };
     volatile int         operation;   
     
     // Packet-io only
     int                  io_port;
-    
-  #ifdef EVENT_TIMER
-    struct rte_timer     event_timer  ENV_CACHE_LINE_ALIGNED; // Keep cache line aligned!
-    em_queue_t           timer_dst_queue;
-  #endif
   };
 
 } em_event_hdr_t;
 
 
-COMPILE_TIME_ASSERT(sizeof(em_event_hdr_t) == RTE_PKTMBUF_HEADROOM, EM_EVENT_HDR_SIZE_ERROR1);
-#ifdef EVENT_TIMER
-  // Note: 'timer_dst_queue' is assumed to be the LAST field in the struct!
-  COMPILE_TIME_ASSERT((offsetof(em_event_hdr_t, timer_dst_queue) + sizeof(em_queue_t)) <= (2*ENV_CACHE_LINE_SIZE), EM_EVENT_HDR_SIZE_ERROR2);
-  COMPILE_TIME_ASSERT(offsetof(em_event_hdr_t, event_timer) == ENV_CACHE_LINE_SIZE, EM_EVENT_HDR_SIZE_ERROR3);
-#else
-  // Note: 'io_port' is assumed to be the LAST field in the struct!
-  COMPILE_TIME_ASSERT((offsetof(em_event_hdr_t, io_port) + sizeof(int)) <= ENV_CACHE_LINE_SIZE, EM_EVENT_HDR_SIZE_ERROR2);
-#endif
+COMPILE_TIME_ASSERT(sizeof(em_event_hdr_t) == ENV_CACHE_LINE_SIZE, EM_EVENT_HDR_SIZE_ERROR1);
+COMPILE_TIME_ASSERT(sizeof(em_event_hdr_t) <= RTE_PKTMBUF_HEADROOM, EM_EVENT_HDR_SIZE_ERROR2);
+
+// Headroom left in front of the event data (packet prepends)
+#define EM_EVENT_HDR_PREPEND_ROOM  (RTE_PKTMBUF_HEADROOM - sizeof(em_event_hdr_t))
 
 
 
@@ -414,6 +573,10 @@ COMPILE_TIME_ASSERT(sizeof(em_pool_t) == ENV_CACHE_LINE_SIZE, EM_POOL_T__SIZE_ER
 
 
 
+// Cache lines needed for em_core_map_t: counts, logic[], phys[] & socket[] tables, alignment pad and the core masks
+#define EM_CORE_MAP_LINES  ((2 * sizeof(int) + (3 * EM_MAX_CORES) + 8 + ((2 + EM_MAX_SOCKETS) * sizeof(em_core_mask_t)) + \
+                             ENV_CACHE_LINE_SIZE - 1) / ENV_CACHE_LINE_SIZE)
+
 // Number of EM cores
 typedef union
 {
@@ -428,16 +591,26 @@ typedef union
     // From logical EM core ids to physical core ids
     uint8_t phys[EM_MAX_CORES];
 
+    // From logical EM core ids to CPU socket (NUMA node) ids
+    uint8_t socket[EM_MAX_CORES];
+
+    // Number of sockets with EM cores
+    int socket_count;
+
 
     // Mask of logic core IDs
     em_core_mask_t logic_mask;
 
     // Mask of phys core IDs
     em_core_mask_t phys_mask;
+
+    // Masks of the logic core IDs on each socket
+    em_core_mask_t socket_mask[EM_MAX_SOCKETS];
   };
 
 
-  uint8_t u8[2 * ENV_CACHE_LINE_SIZE];
+  // Room for the struct above rounded up to full cache lines, grows with EM_MAX_CORES
+  uint8_t u8[EM_CORE_MAP_LINES * ENV_CACHE_LINE_SIZE];
 
 } em_core_map_t;
 
@@ -449,6 +622,9 @@ COMPILE_TIME_ASSERT((sizeof(em_core_map_t) % ENV_CACHE_LINE_SIZE) == 0, EM_CORE_
  *  EM core local variables
  */
 
+// Cache lines for em_core_local_t: the pointer & counter fields (40 bytes) followed by the queue group mask
+#define EM_CORE_LOCAL_LINES  ((40 + sizeof(group_mask_t) + ENV_CACHE_LINE_SIZE - 1) / ENV_CACHE_LINE_SIZE)
+
 typedef union
 {
   // Core local variables:
@@ -460,9 +636,6 @@ typedef union
     // Points to the current queue element during a receive call
     em_event_group_t       current_event_group;
     
-    // Current group mask for this core
-    uint64_t               current_group_mask;
-    
     // The number of times queue create has been called
     uint64_t               queue_create_count;
     
@@ -472,15 +645,23 @@ typedef union
     // Error condition (true/false) used by the ERROR_IF() macro
     int                    error_cond;
     
+    // CPU socket (NUMA node) of this core, selects the socket local event pools
+    int                    socket_id;
+    
+    // Current group mask for this core
+    group_mask_t           current_group_mask;
+    
   };
   
-  // Guarantees that size is 1*cache-line-size
-  uint8_t u8[ENV_CACHE_LINE_SIZE];
+  // Guarantees that size is a multiple of cache-line-size (1 line up to 64 queue groups)
+  uint8_t u8[EM_CORE_LOCAL_LINES * ENV_CACHE_LINE_SIZE];
 
 } em_core_local_t;
 
 
 COMPILE_TIME_ASSERT((sizeof(em_core_local_t) % ENV_CACHE_LINE_SIZE) == 0, EM_CORE_LOCAL_DATA_SIZE_ERROR);  
+COMPILE_TIME_ASSERT((offsetof(em_core_local_t, current_group_mask) + sizeof(group_mask_t)) <= 
+                    (EM_CORE_LOCAL_LINES * ENV_CACHE_LINE_SIZE), EM_CORE_LOCAL_LINES_ERROR);
 
 
 
@@ -504,7 +685,9 @@ COMPILE_TIME_ASSERT(sizeof(em_spinlock_t) == ENV_CACHE_LINE_SIZE, EM_STATIC_QUEU
 
 /**
  * Queues/rings containing free rte_rings for em_queue_create()/queue_init() to
- * use as q_elem->rte_rings for atomic and parallel-ordered EM queues.
+ * use as q_elem->rte_rings for atomic and parallel-ordered EM queues
+ * (for parallel-ordered queues free reorder windows if LOCKLESS_ORDERED_QUEUES == 1).
+ * Atomic event queues are pooled per size class.
  * Parallel EM queues do not require EM queue specific rings - all events are 
  * handled directly through the scheduling queues.
  */
@@ -512,14 +695,16 @@ typedef union
 {
   struct
   {
-    struct rte_ring *atomic_rings;
+    struct rte_ring *atomic_rings[EM_QUEUE_ATOMIC_RING_CLASSES];
     struct rte_ring *parallel_ord_rings;
   };
   
-  uint8_t u8[ENV_CACHE_LINE_SIZE];
+  uint8_t u8[2*ENV_CACHE_LINE_SIZE];
   
 } queue_init_rings_t;
 
+COMPILE_TIME_ASSERT(sizeof(queue_init_rings_t) == (2*ENV_CACHE_LINE_SIZE), QUEUE_INIT_RINGS_T__SIZE_ERROR);
+
 
 
 /*
@@ -555,7 +740,7 @@ em_status_t
 em_init_local(const em_internal_conf_t *const em_internal_conf);
 
 
-void
+em_status_t
 queue_init(const char*      name,
            em_queue_t       queue,
            em_queue_type_t  type,
@@ -563,6 +748,24 @@ queue_init(const char*      name,
            em_queue_group_t group);
 
 
+#if LOCKLESS_ORDERED_QUEUES == 1
+order_block_t *
+order_window_block_alloc(void);
+#endif
+
+
+struct rte_ring *
+atomic_ring_alloc(const int ring_class);
+
+int
+numa_home_socket(const int socket);
+
+int
+numa_cores_socket(const em_core_mask_t *const mask);
+
+em_status_t
+atomic_ring_free(struct rte_ring *const ring, const int ring_class);
+
 
 void em_print_info(void);
                 
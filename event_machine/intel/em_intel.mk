@@ -62,6 +62,7 @@ EM_SRCS   = $(EVENT_MACHINE_DIR)/intel/em_init.c
 EM_SRCS  += $(EVENT_MACHINE_DIR)/intel/em_intel.c
 EM_SRCS  += $(EVENT_MACHINE_DIR)/intel/em_intel_sched.c
 EM_SRCS  += $(EVENT_MACHINE_DIR)/intel/em_intel_event_group.c
+EM_SRCS  += $(EVENT_MACHINE_DIR)/intel/em_intel_event_cache.c
 EM_SRCS  += $(EVENT_MACHINE_DIR)/intel/em_intel_queue_group.c
 EM_SRCS  += $(EVENT_MACHINE_DIR)/intel/em_internal_event.c
 EM_SRCS  += $(EVENT_MACHINE_DIR)/intel/em_error.c
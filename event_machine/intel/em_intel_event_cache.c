@@ -0,0 +1,128 @@
+/*
+ *   Copyright (c) 2012, Nokia Siemens Networks
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions are met:
+ *       * Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *       * Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *       * Neither the name of Nokia Siemens Networks nor the
+ *         names of its contributors may be used to endorse or promote products
+ *         derived from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *   ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY
+ *   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ *   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ *   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+ 
+/**
+ * @file
+ *
+ * Event Machine Intel per-core event cache, see em_intel_event_cache.h
+ *
+ */
+
+#include "environment.h"
+
+#include "em_intel_event_cache.h"
+#include "em_error.h"
+
+#include "em_shared_data.h"
+
+
+
+/**
+ * Core local event caches, one per event pool
+ */
+ENV_LOCAL  event_cache_t  event_cache[EM_MAX_POOLS]  ENV_CACHE_LINE_ALIGNED;
+
+
+
+/**
+ * Both magazines empty: refill the loaded magazine from the event pool (slow path
+ * of event_cache_alloc()).
+ *
+ * @return An mbuf taken from the refilled magazine, NULL if the pool is empty
+ */
+struct rte_mbuf *
+event_cache_refill(event_cache_t *const cache, struct rte_mempool *const mp)
+{
+  event_mag_t *const mag = &cache->mags[cache->loaded];
+  void              *obj;
+  int                ret;
+
+
+  cache->stats.alloc_miss++;
+
+  ret = rte_mempool_get_bulk(mp, mag->objs, EVENT_CACHE_MAG_SIZE);
+
+  IF_LIKELY(ret == 0)
+  {
+    mag->count = EVENT_CACHE_MAG_SIZE - 1;
+    return (struct rte_mbuf *) mag->objs[EVENT_CACHE_MAG_SIZE - 1];
+  }
+
+  // Less than a magazine left in the pool, try to get one buffer
+  ret = rte_mempool_get(mp, &obj);
+
+  IF_UNLIKELY(ret != 0) {
+    return NULL;
+  }
+
+  return (struct rte_mbuf *) obj;
+}
+
+
+
+/**
+ * Both magazines full: return the loaded magazine to the event pool (slow path
+ * of event_cache_free()). The magazine is left empty and loaded.
+ */
+void
+event_cache_flush(event_cache_t *const cache, struct rte_mempool *const mp)
+{
+  event_mag_t *const mag = &cache->mags[cache->loaded];
+
+
+  cache->stats.free_miss++;
+
+  rte_mempool_put_bulk(mp, mag->objs, mag->count);
+  mag->count = 0;
+}
+
+
+
+/**
+ * Print the event cache counters of the calling EM-core (HW specific addition)
+ */
+void
+em_event_cache_stats_print(void)
+{
+  int i;
+
+
+  printf("EM-core%02i event cache (magazine size %u):\n", em_core_id(), EVENT_CACHE_MAG_SIZE);
+
+  for(i = 0; i < EM_MAX_POOLS; i++)
+  {
+    const event_cache_stats_t *const stats = &event_cache[i].stats;
+    const uint64_t alloc = stats->alloc_hit + stats->alloc_miss;
+    const uint64_t free  = stats->free_hit  + stats->free_miss;
+
+    printf("  pool %i (%5u B): alloc:%"PRIu64" hit-rate:%3"PRIu64"%%  free:%"PRIu64" hit-rate:%3"PRIu64"%%\n",
+           i, em.event_pool_size[i],
+           alloc, (alloc > 0) ? ((stats->alloc_hit * 100) / alloc) : 0,
+           free,  (free  > 0) ? ((stats->free_hit  * 100) / free)  : 0);
+  }
+}
+
@@ -0,0 +1,232 @@
+/*
+ *   Copyright (c) 2012, Nokia Siemens Networks
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions are met:
+ *       * Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *       * Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *       * Neither the name of Nokia Siemens Networks nor the
+ *         names of its contributors may be used to endorse or promote products
+ *         derived from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *   ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY
+ *   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ *   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ *   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+ 
+ 
+/**
+ * @file
+ *
+ * Event Machine Intel per-core event cache (magazines) in front of the event pools
+ *
+ * Each EM-core keeps two magazines (arrays of free buffers) per event pool:
+ * 'loaded' and 'prev'. em_alloc() and em_free() normally only pop from or push to
+ * the loaded magazine - no atomic operations on the shared mempool ring. Buffers
+ * freed on another core than they were allocated on (normal in a pipeline) are
+ * collected into the magazines of the freeing core and returned to, or taken from,
+ * the shared pool (the depot) a full magazine at a time with one bulk operation.
+ * The magazines only hold buffers of the socket local event pools, buffers from
+ * the pools of other sockets are returned directly to their own pool.
+ */
+
+#ifndef EM_INTEL_EVENT_CACHE_H_
+#define EM_INTEL_EVENT_CACHE_H_
+
+
+#include <rte_mbuf.h>
+#include <rte_mempool.h>
+
+#include "em_intel.h"
+#include "em_shared_data.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * Select the per-core event cache (=1) or allocate/free directly from/to the event pools (=0)
+ */
+#define EVENT_CACHE            (1)  // 1=On, 0=Off
+
+// Number of buffers in a magazine, i.e. in one bulk get/put from/to the event pool
+#define EVENT_CACHE_MAG_SIZE   (32)
+
+
+
+typedef struct
+{
+  uint32_t  count;
+  void     *objs[EVENT_CACHE_MAG_SIZE];
+  
+} event_mag_t;
+
+
+/**
+ * Event cache counters (per core, per pool)
+ */
+typedef struct
+{
+  uint64_t  alloc_hit;   // Allocated from a magazine
+  uint64_t  alloc_miss;  // Magazine refilled from the pool
+  uint64_t  free_hit;    // Freed into a magazine
+  uint64_t  free_miss;   // Magazine flushed into the pool
+  
+} event_cache_stats_t;
+
+
+/**
+ * Per-core cache of one event pool.
+ * The loaded magazine is mags[loaded], the previous one mags[loaded ^ 1] - 
+ * no pointers, so that the zero-initialized core local data is ready for use.
+ */
+typedef struct
+{
+  uint32_t             loaded;
+  
+  event_cache_stats_t  stats;
+  
+  event_mag_t          mags[2];
+  
+} ENV_CACHE_LINE_ALIGNED  event_cache_t;
+
+COMPILE_TIME_ASSERT((sizeof(event_cache_t) % ENV_CACHE_LINE_SIZE) == 0, EVENT_CACHE_T__SIZE_ERROR);
+
+
+
+/*
+ * Externs
+ */
+extern ENV_LOCAL  event_cache_t  event_cache[EM_MAX_POOLS]  ENV_CACHE_LINE_ALIGNED;
+
+
+
+/*
+ * Functions
+ */
+struct rte_mbuf *
+event_cache_refill(event_cache_t *const cache, struct rte_mempool *const mp);
+
+void
+event_cache_flush(event_cache_t *const cache, struct rte_mempool *const mp);
+
+
+
+/**
+ * Allocate an mbuf from the event pool 'pool_idx' through the core local cache.
+ * 
+ * @return The initialized mbuf, NULL if the pool is empty
+ */
+static inline struct rte_mbuf *
+event_cache_alloc(int pool_idx)
+{
+  struct rte_mempool *const mp    = (struct rte_mempool *) em.event_pools[em_core_local.socket_id][pool_idx];
+  event_cache_t      *const cache = &event_cache[pool_idx];
+  event_mag_t              *mag   = &cache->mags[cache->loaded];
+  struct rte_mbuf          *m;
+  
+  
+  IF_UNLIKELY(mag->count == 0)
+  {
+    // Loaded magazine empty, try the previous one
+    cache->loaded ^= 1;
+    mag = &cache->mags[cache->loaded];
+  }
+  
+  IF_LIKELY(mag->count > 0)
+  {
+    m = mag->objs[--mag->count];
+    cache->stats.alloc_hit++;
+  }
+  else
+  {
+    m = event_cache_refill(cache, mp);
+    
+    IF_UNLIKELY(m == NULL) {
+      return NULL;
+    }
+  }
+  
+  // Init the mbuf as rte_pktmbuf_alloc() would
+  rte_mbuf_refcnt_set(m, 1);
+  rte_pktmbuf_reset(m);
+  
+  return m;
+}
+
+
+
+/**
+ * Free a single segment mbuf, whose reference count has already been dropped
+ * (see __rte_pktmbuf_prefree_seg()), through the core local cache.
+ */
+static inline void
+event_cache_free(struct rte_mbuf *const m)
+{
+  struct rte_mempool *const mp          = m->pool;
+  em_event_pool_t    *const local_pools = em.event_pools[em_core_local.socket_id];
+  event_cache_t            *cache;
+  event_mag_t              *mag;
+  int                       i;
+  
+  
+  // Find the owning event pool (size class) of the mbuf
+  for(i = 0; i < EM_MAX_POOLS; i++)
+  {
+    if(mp == (struct rte_mempool *) local_pools[i]) {
+      break;
+    }
+  }
+  
+  IF_UNLIKELY(i == EM_MAX_POOLS)
+  {
+    // Not from a socket local EM event pool
+    rte_mempool_put(mp, m);
+    return;
+  }
+  
+  
+  cache = &event_cache[i];
+  mag   = &cache->mags[cache->loaded];
+  
+  IF_UNLIKELY(mag->count == EVENT_CACHE_MAG_SIZE)
+  {
+    // Loaded magazine full, try the previous one
+    cache->loaded ^= 1;
+    mag = &cache->mags[cache->loaded];
+  }
+  
+  IF_LIKELY(mag->count < EVENT_CACHE_MAG_SIZE)
+  {
+    cache->stats.free_hit++;
+  }
+  else
+  {
+    // Both magazines full: return one to the pool and start filling it again
+    event_cache_flush(cache, mp);
+  }
+  
+  mag->objs[mag->count++] = m;
+}
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // EM_INTEL_EVENT_CACHE_H_
+
@@ -44,7 +44,7 @@ event_group_alloc_init(void)
 {
   printf("event group init\n");
 
-  (void) memset(em.shm->em_event_group_entry_tbl, 0, sizeof(em_event_group_entry_t) * EM_MAX_EVENT_GROUPS);
+  (void) memset(em.shm->em_event_group_entry_tbl, 0, sizeof(em_event_group_entry_t) * em.shm->limits.max_event_groups);
 
   env_spinlock_init(&em.shm->em_event_group_entry_tbl_lock.u.lock);
 }
@@ -69,7 +69,7 @@ event_group_next_free(void)
   env_spinlock_lock(&em.shm->em_event_group_entry_tbl_lock.u.lock);
 
 
-  for(i = 0; i < EM_MAX_EVENT_GROUPS; i++)
+  for(i = 0; i < (int) em.shm->limits.max_event_groups; i++)
   {
     if(em.shm->em_event_group_entry_tbl[i].allocated == 0)
     {
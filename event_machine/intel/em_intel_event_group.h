@@ -79,7 +79,7 @@ COMPILE_TIME_ASSERT(sizeof(em_event_group_entry_tbl_lock_t) == ENV_CACHE_LINE_SI
 /*
  * Macros
  */
-#define invalid_egrp(event_group)  (ENV_UNLIKELY((event_group) >= EM_MAX_EVENT_GROUPS))
+#define invalid_egrp(event_group)  (ENV_UNLIKELY((event_group) >= em.shm->limits.max_event_groups))
 
 
 
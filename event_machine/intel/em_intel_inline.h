@@ -48,6 +48,7 @@
 
 
 #include "em_shared_data.h"
+#include "em_intel_event_cache.h"
 
 
 #ifdef __cplusplus
@@ -131,7 +132,7 @@ event_to_mbuf(em_event_t event)
 static inline em_queue_element_t*
 get_queue_element(const em_queue_t queue)
 {
-  IF_LIKELY(queue < EM_MAX_QUEUES) {
+  IF_LIKELY(queue < em.shm->limits.max_queues) {
     return &(em.shm->em_queue_element_tbl[queue]);
   }
   else {
@@ -145,7 +146,7 @@ static inline
 em_eo_element_t*
 get_eo_element(const em_eo_t eo)
 {
-  IF_LIKELY(eo < EM_MAX_EOS) {
+  IF_LIKELY(eo < em.shm->limits.max_eos) {
     return &(em.shm->em_eo_element_tbl[eo]);
   }
   else {
@@ -173,9 +174,25 @@ get_current_eo_elem(void)
 static inline void
 intel_free(void *const ev_hdr)
 {
-  struct rte_mbuf *const m = event_hdr_to_mbuf(ev_hdr);
+  struct rte_mbuf *m = event_hdr_to_mbuf(ev_hdr);
   
+#if EVENT_CACHE == 1
+  IF_UNLIKELY(m->pkt.next != NULL)
+  {
+    // Multi-segment packet, free normally
+    rte_pktmbuf_free(m);
+    return;
+  }
+  
+  // Drop the reference, returns NULL if the mbuf is still in use elsewhere
+  m = __rte_pktmbuf_prefree_seg(m);
+  
+  IF_LIKELY(m != NULL) {
+    event_cache_free(m);
+  }
+#else
   rte_pktmbuf_free(m);
+#endif
 }
 
 
@@ -367,6 +367,27 @@ eth_tx_packets_timed__no_order(void);
  
 
 
+/**
+ * The socket of an Eth port (its PCI device), or the home socket if there are no EM cores on it
+ */
+static int
+eth_port_socket(const uint8_t portid)
+{
+  struct rte_eth_dev_info  dev_info;
+  int                      socket = SOCKET0;
+  
+  
+  rte_eth_dev_info_get(portid, &dev_info);
+  
+  if(dev_info.pci_dev != NULL) {
+    socket = dev_info.pci_dev->numa_node; // -1 if unknown
+  }
+  
+  return numa_home_socket(socket);
+}
+
+
+
 /**
  * Initialize the Intel NICs (once at startup on one core)
  */
@@ -397,13 +418,33 @@ intel_eth_init(void)
   memset(&em.shm->eth_rx_queue_info[0], 0, sizeof(em.shm->eth_rx_queue_info));
   memset(&em.shm->rdmostly.eth_rx_queue_access, 0, sizeof(em.shm->rdmostly.eth_rx_queue_access));
   
-  /* Eth Rx queue aceess control - queue is multi-consumer and multi-producer */
-  em.shm->rdmostly.eth_rx_queue_access.queue = rte_ring_create("EthRxPortAccess", MAX_ETH_RX_QUEUES, DEVICE_SOCKET, 0);
+  /* Eth Rx queue aceess control - queues are multi-consumer and multi-producer, one per socket with EM cores */
+  for(i = 0; i < EM_MAX_SOCKETS; i++)
+  {
+    char  name[sizeof("EthRxPortAccess_S000")];
+    
+    if(numa_home_socket(i) != i) {
+      continue;
+    }
+    
+    if(i == SOCKET0) {
+      (void) snprintf(name, sizeof(name), "EthRxPortAccess");
+    }
+    else {
+      (void) snprintf(name, sizeof(name), "EthRxPortAccess_S%i", i);
+    }
+    name[sizeof(name)-1] = '\0';
+    
+    em.shm->rdmostly.eth_rx_queue_access.queue[i] = rte_ring_create(name, MAX_ETH_RX_QUEUES, i, 0);
+    
+    ERROR_IF(em.shm->rdmostly.eth_rx_queue_access.queue[i] == NULL, EM_FATAL(EM_ERR_ALLOC_FAILED), EM_ESCOPE_PACKETIO_INTEL_ETH_INIT,
+             "Eth Rx access queue %s creation failed!", name);
+  }
   
   
-  memset(em.shm->eth_tx_mbuf_tables, 0, sizeof(em.shm->eth_tx_mbuf_tables));
+  memset(em.shm->eth_tx_mbuf_tables, 0, sizeof(em.shm->eth_tx_mbuf_tables[0]) * em.shm->limits.max_eth_ports);
   
-  for(j = 0; j < MAX_ETH_PORTS; j++)
+  for(j = 0; j < (int) em.shm->limits.max_eth_ports; j++)
   {
     char  def_name[] = "m_burst_";
     char  name[sizeof("m_burst_00000000")];
@@ -429,6 +470,13 @@ intel_eth_init(void)
   
   ERROR_IF(nb_ports <= 0, EM_FATAL(EM_ERR_LIB_FAILED), EM_ESCOPE_PACKETIO_INTEL_ETH_INIT,
            "Cannot init Eth pmd, retval nb_ports=%i", nb_ports);
+  
+  // Use only the ports that have Tx buffers (em_conf_t.max_eth_ports)
+  if(nb_ports > (int) em.shm->limits.max_eth_ports)
+  {
+    printf("%s(): Using %u of %i Eth ports\n", __func__, em.shm->limits.max_eth_ports, nb_ports);
+    nb_ports = em.shm->limits.max_eth_ports;
+  }
 
   
   /* Get number of running cores */
@@ -482,20 +530,22 @@ intel_eth_init(void)
 
   
   
-  /* Allocate the packet buffers from the EM event pool - events and frames/packets can be interchanged */
-  eth_mempool = (struct rte_mempool *) em.event_pool;
-  
-  ERROR_IF(eth_mempool == NULL, EM_FATAL(EM_ERR_LIB_FAILED), EM_ESCOPE_PACKETIO_INTEL_ETH_INIT,
-           "eth_mempool==NULL!");
-
-  
   /* 
    * Initialise each eth port 
    */
   for(portid = 0; portid < nb_ports; portid++)
   {
+    /* Rx & Tx queues and packet buffers on the socket of the port (or the home socket if it has no EM cores) */
+    const int socket = eth_port_socket((uint8_t) portid);
+    
+    /* Allocate the packet buffers from the EM event pool - events and frames/packets can be interchanged */
+    eth_mempool = (struct rte_mempool *) em.event_pools[socket][EM_POOL_DEFAULT];
+  
+    ERROR_IF(eth_mempool == NULL, EM_FATAL(EM_ERR_LIB_FAILED), EM_ESCOPE_PACKETIO_INTEL_ETH_INIT,
+             "eth_mempool==NULL!");
+    
     /* Init port */
-    printf("Initializing Eth port %u  RxQs:%u TxQs:%u ", portid, n_rx_queue, n_tx_queue);
+    printf("Initializing Eth port %u  Socket:%i RxQs:%u TxQs:%u ", portid, socket, n_rx_queue, n_tx_queue);
   
     ret = rte_eth_dev_configure((uint8_t) portid, n_rx_queue, n_tx_queue, &eth_port_conf);
 
@@ -514,7 +564,7 @@ intel_eth_init(void)
     /* Init several RX queues per port */
     for(queueid = 0; queueid < n_rx_queue; queueid++)
     {
-      ret = rte_eth_rx_queue_setup((uint8_t) portid, queueid, ETH_RX_DESC_DEFAULT, DEVICE_SOCKET, &eth_rx_conf, eth_mempool);
+      ret = rte_eth_rx_queue_setup((uint8_t) portid, queueid, ETH_RX_DESC_DEFAULT, socket, &eth_rx_conf, eth_mempool);
       
       ERROR_IF(ret < 0, EM_FATAL(EM_ERR_LIB_FAILED), EM_ESCOPE_PACKETIO_INTEL_ETH_INIT,
              "rte_eth_rx_queue_setup(): err=%d, port=%u", ret, portid);
@@ -524,7 +574,7 @@ intel_eth_init(void)
     /* Init a TX queue for each each port on each core */
     for(queueid = 0; queueid < n_tx_queue; queueid++)
     { 
-      ret = rte_eth_tx_queue_setup((uint8_t) portid, (uint16_t) queueid, ETH_TX_DESC_DEFAULT, DEVICE_SOCKET, &eth_tx_conf);
+      ret = rte_eth_tx_queue_setup((uint8_t) portid, (uint16_t) queueid, ETH_TX_DESC_DEFAULT, socket, &eth_tx_conf);
 
       ERROR_IF(ret < 0, EM_FATAL(EM_ERR_LIB_FAILED), EM_ESCOPE_PACKETIO_INTEL_ETH_INIT,
               "rte_eth_tx_queue_setup(): err=%d, port=%u queue=%u", ret, portid, queueid);
@@ -573,17 +623,20 @@ intel_eth_init(void)
   for(i = 0, j = 0; i < em.shm->rdmostly.eth_ports_link_up.n_link_up; i++)
   {
     int k;
+    int socket;
     
     assert(em.shm->rdmostly.eth_ports_link_up.port[i].n_rx_queue <= UINT8_MAX);
+    assert(em.shm->rdmostly.eth_ports_link_up.port[i].portid <= UINT8_MAX);
+    
+    socket = eth_port_socket((uint8_t) em.shm->rdmostly.eth_ports_link_up.port[i].portid);
     
     for(k = 0; k < em.shm->rdmostly.eth_ports_link_up.port[i].n_rx_queue; k++, j++)
     {
-      assert(em.shm->rdmostly.eth_ports_link_up.port[i].portid <= UINT8_MAX);
-      
       em.shm->eth_rx_queue_info[j].port_id  = (uint8_t) em.shm->rdmostly.eth_ports_link_up.port[i].portid;
       em.shm->eth_rx_queue_info[j].queue_id = (uint8_t) k;
+      em.shm->eth_rx_queue_info[j].socket   = (uint8_t) socket;
       
-      ret = rte_ring_enqueue(em.shm->rdmostly.eth_rx_queue_access.queue, &em.shm->eth_rx_queue_info[j]);
+      ret = rte_ring_enqueue(em.shm->rdmostly.eth_rx_queue_access.queue[socket], &em.shm->eth_rx_queue_info[j]);
       assert(ret == 0);
     }
   }
@@ -1116,6 +1169,41 @@ eth_tx_packets_timed__no_order(void)
 
 
 
+/**
+ * Get exclusive access to an Eth Rx port:queue - the ones on the own socket first, 
+ * then the ones on other sockets (em_conf_t.numa_policy EM_NUMA_LOCAL_FIRST)
+ *
+ * @return 0 on success
+ */
+static inline int
+eth_rx_queue_acquire(eth_rx_queue_info_t **const rx_queue_info)
+{
+  struct rte_ring *const *const access_queue = em.shm->rdmostly.eth_rx_queue_access.queue;
+  const int                     local_socket = em_core_local.socket_id;
+  int                           socket;
+  int                           ret;
+  
+  
+  ret = rte_ring_dequeue(access_queue[local_socket], (void **) rx_queue_info);
+  
+  IF_LIKELY((ret == 0) || (em_internal_conf.conf.numa_policy == EM_NUMA_LOCAL_ONLY)) {
+    return ret;
+  }
+  
+  for(socket = 0; socket < EM_MAX_SOCKETS; socket++)
+  {
+    if((socket != local_socket) && (access_queue[socket] != NULL) &&
+       (rte_ring_dequeue(access_queue[socket], (void **) rx_queue_info) == 0))
+    {
+      return 0;
+    }
+  }
+  
+  return ret;
+}
+
+
+
 /**
  * Read frames from the Eth RX queues
  */ 
@@ -1132,7 +1220,7 @@ em_eth_rx_packets(void)
   
   IF_UNLIKELY(local.curr_rx_queue_info.access_cnt == 0)
   {
-    ret = rte_ring_dequeue(em.shm->rdmostly.eth_rx_queue_access.queue, (void **) &local.curr_rx_queue_info.current_info);
+    ret = eth_rx_queue_acquire(&local.curr_rx_queue_info.current_info);
     owns_rx_queue = !ret;
   }
     
@@ -1160,7 +1248,8 @@ em_eth_rx_packets(void)
     IF_UNLIKELY((local.curr_rx_queue_info.access_cnt == ETH_RX_IDX_CNT_MAX) || (nb_rx == 0))
     {
       // Unlock ONLY when count==ETH_RX_IDX_CNT_MAX or no frames was received here
-      ret = rte_ring_enqueue(em.shm->rdmostly.eth_rx_queue_access.queue, local.curr_rx_queue_info.current_info);
+      ret = rte_ring_enqueue(em.shm->rdmostly.eth_rx_queue_access.queue[local.curr_rx_queue_info.current_info->socket],
+                             local.curr_rx_queue_info.current_info);
       
       // Advance to the next Rx-queue for the next iteration if little data was seen here or we have received 'enough'
       local.curr_rx_queue_info.access_cnt = 0;
@@ -1339,7 +1428,8 @@ em_packet_lookup_enqueue(struct rte_mbuf *const mbufs[], const int n_mbuf, const
  *
  * Note: RX_DIRECT_DISPATCH is a performance optimization that dispatches the event directly
  * for processing on the receiving core if possible. By bypassing the EM-queue enqueue+dequeue
- * a potential speedup can be achieved.
+ * a potential speedup can be achieved. Without it the same is done per queue for the queues
+ * set with em_queue_direct_dispatch_set().
  */
 static inline void
 packet_enqueue(em_event_hdr_t *const ev_hdr, em_queue_element_t *const q_elem, const int input_port)
@@ -1367,6 +1457,12 @@ packet_enqueue(em_event_hdr_t *const ev_hdr, em_queue_element_t *const q_elem, c
     em_direct_dispatch(event, ev_hdr, q_elem, q_elem->id);
   }
   #else
+  IF_UNLIKELY(q_elem->direct_dispatch)
+  {
+    // Rx Optimized version for this queue only
+    em_direct_dispatch(event, ev_hdr, q_elem, q_elem->id);
+  }
+  else
   {
     // Enqueue to an EM queue - NORMAL Operation
     em_status_t err = em_send_switch(ev_hdr, q_elem, q_elem->id);
@@ -32,6 +32,7 @@
 #include <stdint.h>
 #include "environment.h"
 #include "event_machine_types.h"
+#include "em_intel.h"
 
 
 /**
@@ -180,6 +181,8 @@ typedef struct
   uint8_t         port_id; 
   
   uint8_t         queue_id;
+  
+  uint8_t         socket;   // Home socket of the port, i.e. the access FIFO of the port:queue
 
 } eth_rx_queue_info_t;
 
@@ -202,12 +205,13 @@ COMPILE_TIME_ASSERT((sizeof(eth_tx_mbuf_table_t) % ENV_CACHE_LINE_SIZE) == 0, ET
 
 
 /**
- * The Eth Rx port:queue access FIFO - a core dequeues a 'eth_rx_queue_info_t' and uses that port exclusively.
+ * The Eth Rx port:queue access FIFOs - a core dequeues a 'eth_rx_queue_info_t' and uses that port exclusively.
  * When the core is done with the port it will enqueue it again for some other core to use.
+ * One FIFO per socket with EM cores (NULL for other sockets), holding the port:queues of the ports on that socket.
  */
 typedef union
 {
-  struct rte_ring *queue;
+  struct rte_ring *queue[EM_MAX_SOCKETS];
     
 } eth_rx_queue_access_t;
 
@@ -62,10 +62,10 @@ typedef struct
 
 
 static inline void
-group_mask_set(volatile uint64_t *const group_mask, const em_queue_group_t queue_group);
+group_mask_set(group_mask_t *const group_mask, const em_queue_group_t queue_group);
 
 static inline void
-group_mask_clr(volatile uint64_t *const group_mask, const em_queue_group_t queue_group);
+group_mask_clr(group_mask_t *const group_mask, const em_queue_group_t queue_group);
 
 
 static void 
@@ -177,15 +177,23 @@ queue_group_init_global(void)
   //
   // Create a shared internal queue, belongs to the default queue group
   //
-  queue_init("EM shared internal", SHARED_INTERNAL_QUEUE, EM_QUEUE_TYPE_ATOMIC, INTERNAL_QUEUE_PRIORITY, EM_QUEUE_GROUP_DEFAULT);
+  IF_UNLIKELY(queue_init("EM shared internal", SHARED_INTERNAL_QUEUE, EM_QUEUE_TYPE_ATOMIC,
+                         INTERNAL_QUEUE_PRIORITY, EM_QUEUE_GROUP_DEFAULT) != EM_OK)
+  {
+    EM_INTERNAL_ERROR(EM_FATAL(EM_ERR_ALLOC_FAILED), EM_ESCOPE_QUEUE_GROUP_INIT_GLOBAL,
+                      "Shared internal queue init failed.");
+    return;
+  }
+  
   (void) sched_masks_add_queue(SHARED_INTERNAL_QUEUE, EM_QUEUE_TYPE_ATOMIC, EM_QUEUE_GROUP_DEFAULT);
 
   // Bind the shared internal queue
   q_elem = get_queue_element(SHARED_INTERNAL_QUEUE);
 
-  q_elem->receive_func  = em_internal_event_receive_func;
-  q_elem->eo_ctx        = NULL;
-  q_elem->status        = EM_QUEUE_STATUS_READY;
+  q_elem->receive_func       = em_internal_event_receive_func;
+  q_elem->receive_multi_func = NULL;
+  q_elem->eo_ctx             = NULL;
+  q_elem->status             = EM_QUEUE_STATUS_READY;
 
 
   //
@@ -218,18 +226,29 @@ queue_group_init_global(void)
   
     // Set queue group masks manually, em_queue_group_modify() cannot be used yet
     em_core_mask_copy(&em.shm->em_queue_group[group].mask, &mask);
+    
+    em.shm->core_local_group[i] = group;
+    
+    // Only one internal queue per core local group: use a single, small scheduling queue per type
+    sched_qs_group_init(group, 1, SCHED_Q_CORE_LOCAL_RING_SIZE);
   
     (void) snprintf(&queue_name[14], EM_QUEUE_NAME_LEN-14, "%"PRI_QUEUE"", queue);
     queue_name[EM_QUEUE_NAME_LEN-1] = '\0';
     
-    queue_init(queue_name, queue, EM_QUEUE_TYPE_ATOMIC, INTERNAL_QUEUE_PRIORITY, group);
+    IF_UNLIKELY(queue_init(queue_name, queue, EM_QUEUE_TYPE_ATOMIC, INTERNAL_QUEUE_PRIORITY, group) != EM_OK)
+    {
+      EM_INTERNAL_ERROR(EM_FATAL(EM_ERR_ALLOC_FAILED), EM_ESCOPE_QUEUE_GROUP_INIT_GLOBAL,
+                        "Core local internal queue init failed.");
+      return;
+    }
 
     // Bind internal queue
     q_elem = get_queue_element(queue);
 
-    q_elem->receive_func  = em_internal_event_receive_func;
-    q_elem->eo_ctx        = NULL;
-    q_elem->status        = EM_QUEUE_STATUS_READY;
+    q_elem->receive_func       = em_internal_event_receive_func;
+    q_elem->receive_multi_func = NULL;
+    q_elem->eo_ctx             = NULL;
+    q_elem->status             = EM_QUEUE_STATUS_READY;
     
     // Manually set the scheduling masks, cannot use em_queue_group_modify() yet
     (void) sched_masks_add_queue(queue, EM_QUEUE_TYPE_ATOMIC, group);
@@ -254,6 +273,7 @@ queue_group_init_local(void)
   em_queue_group_t  local_group;
   em_core_mask_t    mask, mask_group;
   char              q_grp_name[] = EM_QUEUE_GROUP_CORE_LOCAL_BASE_NAME;
+  char              mask_str[EM_CORE_MASK_STRLEN];
   
 
   logic_core = em_core_id();
@@ -273,15 +293,15 @@ queue_group_init_local(void)
   em_queue_group_mask(local_group, &mask_group);
 
   RETURN_ERROR_IF(!em_core_mask_equal(&mask, &mask_group), EM_ERROR, EM_ESCOPE_QUEUE_GROUP_INIT_LOCAL,
-                  "Bad core mask (0x%lx) for logic core %i", mask_group.u64[0], logic_core);
+                  "Bad core mask (%s) for logic core %i", em_core_mask_tostr(mask_str, sizeof(mask_str), &mask_group), logic_core);
 
 
 
   // Add core local queue group to the core's group mask
-  em_core_local.current_group_mask |= ( ((uint64_t)0x1) << local_group );
+  group_mask_set(&em_core_local.current_group_mask, local_group);
   
   // Add the default group to the core's group mask
-  em_core_local.current_group_mask |= ( ((uint64_t)0x1) << EM_QUEUE_GROUP_DEFAULT );
+  group_mask_set(&em_core_local.current_group_mask, EM_QUEUE_GROUP_DEFAULT);
   
 
 
@@ -341,6 +361,7 @@ em_queue_group_create(const char* name, const em_core_mask_t* mask, int num_noti
   int              i;
   em_queue_group_t queue_group;
   em_status_t      err;
+  char             mask_str[EM_CORE_MASK_STRLEN];
 
 
   ERROR_IF(name == NULL, EM_ERR_BAD_POINTER, EM_ESCOPE_QUEUE_GROUP_CREATE,
@@ -407,8 +428,8 @@ em_queue_group_create(const char* name, const em_core_mask_t* mask, int num_noti
   err = em_queue_group_modify(queue_group, mask, num_notif, notif_tbl);
   
   ERROR_IF(err != EM_OK, err, EM_ESCOPE_QUEUE_GROUP_CREATE,
-          "Queue group create: mask modification failed (err=%u, mask=0x%"PRIX64")",
-          err, mask->u64[0])
+          "Queue group create: mask modification failed (err=%u, mask=%s)",
+          err, em_core_mask_tostr(mask_str, sizeof(mask_str), mask))
   {
     err = em_queue_group_delete(queue_group, 0, NULL);
     ERROR_IF(err != EM_OK, err, EM_ESCOPE_QUEUE_GROUP_CREATE,
@@ -467,7 +488,9 @@ em_queue_group_modify(em_queue_group_t group, const em_core_mask_t* new_mask, in
 static em_status_t
 queue_group_modify(em_queue_group_t group, const em_core_mask_t* new_mask, int num_notif, const em_notif_t* notif_tbl, int is_delete)
 {
-  em_core_mask_t       old_mask, max_mask;
+  em_core_mask_t       old_mask, max_mask, valid_mask;
+  char                 mask_str[EM_CORE_MASK_STRLEN];
+  char                 max_mask_str[EM_CORE_MASK_STRLEN];
   em_event_group_t     event_group;
   int                  adds, rems, i;
   uint8_t              add_core[EM_MAX_CORES];
@@ -498,9 +521,12 @@ queue_group_modify(em_queue_group_t group, const em_core_mask_t* new_mask, int n
   em_core_mask_set_count(em_core_count(), &max_mask);
   
   // Can only set core mask bits for running cores - veify this.
-  RETURN_ERROR_IF(new_mask->u64[0] > max_mask.u64[0], EM_ERR_TOO_LARGE, EM_ESCOPE_QUEUE_GROUP_MODIFY,
-                  "Queue group:%"PRI_QGRP" - Invalid new mask: 0x%"PRIX64" (max valid is: 0x%"PRIX64")",
-                  group, new_mask->u64[0], max_mask.u64[0]);
+  em_core_mask_and(&valid_mask, new_mask, &max_mask);
+  
+  RETURN_ERROR_IF(!em_core_mask_equal(&valid_mask, new_mask), EM_ERR_TOO_LARGE, EM_ESCOPE_QUEUE_GROUP_MODIFY,
+                  "Queue group:%"PRI_QGRP" - Invalid new mask: %s (max valid is: %s)",
+                  group, em_core_mask_tostr(mask_str, sizeof(mask_str), new_mask),
+                  em_core_mask_tostr(max_mask_str, sizeof(max_mask_str), &max_mask));
   
   
   RETURN_ERROR_IF(((uint64_t) num_notif) > EM_EVENT_GROUP_MAX_NOTIF,
@@ -828,8 +854,8 @@ i_event__queue_group_add_req(em_internal_event_t *const i_ev, const em_queue_t q
   
   
   // printf("EM-core%02i: QUEUE_GROUP_ADD_REQ internal event from queue %"PRI_QUEUE". "
-  //        "Core-local Queue Group Mask updated to 0x%"PRIX64"\n",
-  //        em_core_id(), queue, em_core_local.current_group_mask); fflush(NULL);
+  //        "Core-local Queue Group Mask updated to %i groups\n",
+  //        em_core_id(), queue, group_mask_cnt(&em_core_local.current_group_mask)); fflush(NULL);
 }
 
 
@@ -849,8 +875,8 @@ i_event__queue_group_rem_req(em_internal_event_t *const i_ev, const em_queue_t q
   
   
   // printf("EM-core%02i: QUEUE_GROUP_REM_REQ internal event from queue %"PRI_QUEUE". "
-  //        "Core-local Queue Group Mask updated to 0x%"PRIX64"\n",
-  //        em_core_id(), queue, em_core_local.current_group_mask); fflush(NULL);
+  //        "Core-local Queue Group Mask updated to %i groups\n",
+  //        em_core_id(), queue, group_mask_cnt(&em_core_local.current_group_mask)); fflush(NULL);
 }
 
 
@@ -936,6 +962,9 @@ q_grp_delete_done(em_queue_group_t queue_group)
   }  
   
   
+  // Release the scheduling queues of the group, no core schedules from them anymore
+  sched_qs_free(queue_group);
+  
   // Clear the Queue Group data
   (void) memset(&em.shm->em_queue_group[queue_group], 0, sizeof(em.shm->em_queue_group[0]));
 
@@ -979,7 +1008,8 @@ queue_group_rem_queue_list(em_queue_group_t queue_group, em_queue_t queue)
 void 
 print_queue_groups(void)
 {
-  int i;
+  int  i;
+  char mask_str[EM_CORE_MASK_STRLEN];
 
   printf("\nQueue groups\n------------\n");
   printf("  id      name mask\n");
@@ -988,7 +1018,8 @@ print_queue_groups(void)
   {
     if(em.shm->em_queue_group[i].allocated)
     {
-      printf("  %2i  %8s 0x%lx\n", i, em.shm->em_queue_group[i].name, em.shm->em_queue_group[i].mask.u64[0]);
+      printf("  %2i  %8s %s\n", i, em.shm->em_queue_group[i].name,
+             em_core_mask_tostr(mask_str, sizeof(mask_str), &em.shm->em_queue_group[i].mask));
     }
   }
 
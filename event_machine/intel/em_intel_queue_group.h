@@ -120,57 +120,82 @@ queue_group_rem_queue_list(em_queue_group_t queue_group, em_queue_t queue);
 
 
 
+/*
+ * Queue group masks (group_mask_t): the leaf bit is set before the summary bit and
+ * the summary bit is cleared only after the leaf word was seen empty, followed by
+ * a re-check - a summary bit may be set for an empty leaf word, never clear for
+ * a leaf word with bits set (except transiently).
+ */
 static inline void
-group_mask_set(volatile uint64_t *const group_mask, const em_queue_group_t queue_group)
+group_mask_set(group_mask_t *const group_mask, const em_queue_group_t queue_group)
 {
-  uint64_t  old, new;
-  int       ret;  
+  const uint32_t word     = queue_group >> 6;
+  const uint64_t bit      = ((uint64_t)0x1) << (queue_group & 63);
+  const uint64_t word_bit = ((uint64_t)0x1) << word;
   
   
-  ret = 0;
-
-  do
-  {
-    old = *group_mask;
-    new = old | (((uint64_t)0x1) << queue_group);
-
-    ret = rte_atomic64_cmpset(group_mask, old, new);
+  // Read first to avoid bouncing the cache line when already set
+  if(!(group_mask->leaf[word] & bit)) {
+    (void) __sync_fetch_and_or(&group_mask->leaf[word], bit);
+  }
+  
+  if(!(group_mask->summary & word_bit)) {
+    (void) __sync_fetch_and_or(&group_mask->summary, word_bit);
   }
-  while(ret == 0);
 }
 
 
 static inline void
-group_mask_clr(volatile uint64_t *const group_mask, const em_queue_group_t queue_group)
+group_mask_clr(group_mask_t *const group_mask, const em_queue_group_t queue_group)
 {
-  uint64_t  old, new;
-  int       ret;  
+  const uint32_t word     = queue_group >> 6;
+  const uint64_t bit      = ((uint64_t)0x1) << (queue_group & 63);
+  const uint64_t word_bit = ((uint64_t)0x1) << word;
   
   
-  ret = 0;
-
-  do
+  (void) __sync_fetch_and_and(&group_mask->leaf[word], ~bit);
+  
+  if(group_mask->leaf[word] == 0)
   {
-    old = *group_mask;
-    new = old & (~(((uint64_t)0x1) << queue_group));
-
-    ret = rte_atomic64_cmpset(group_mask, old, new);
+    (void) __sync_fetch_and_and(&group_mask->summary, ~word_bit);
+    
+    // Re-check - a concurrent group_mask_set() sets the leaf bit before the summary bit
+    if(group_mask->leaf[word] != 0) {
+      (void) __sync_fetch_and_or(&group_mask->summary, word_bit);
+    }
   }
-  while(ret == 0);
+}
+
+
+static inline int
+group_mask_isset(const group_mask_t *const group_mask, const em_queue_group_t queue_group)
+{
+  return ((group_mask->leaf[queue_group >> 6] & (((uint64_t)0x1) << (queue_group & 63))) != 0);
+}
+
+
+static inline int
+group_mask_iszero(const group_mask_t *const group_mask)
+{
+  return (group_mask->summary == 0);
 }
 
 
 
 static inline int 
-group_mask_cnt(volatile uint64_t *const group_mask)
+group_mask_cnt(const group_mask_t *const group_mask)
 {
-  uint64_t n = *group_mask;
-  int      cnt;
+  uint64_t n;
+  int      cnt, i;
   
-
-  for(cnt = 0; n; cnt++)
+  
+  for(i = 0, cnt = 0; i < GROUP_MASK_WORDS; i++)
   {
-    n &= (n - 1); // Clear the least significant bit set
+    n = group_mask->leaf[i];
+    
+    for(; n; cnt++) {
+      n &= (n - 1); // Clear the least significant bit set
+    }
   }
   
   return cnt;
@@ -178,6 +203,91 @@ group_mask_cnt(volatile uint64_t *const group_mask)
 
 
 
+/**
+ * Return the lowest queue group index in the range [from, to) set in 'mask1' and in 'mask2',
+ * mask2=NULL uses 'mask1' only.
+ * Only the leaf words marked in the summaries are read.
+ *
+ * @return The queue group index, -1 if none
+ */
+static inline int
+group_mask_find(const group_mask_t *const mask1, const group_mask_t *const mask2, const uint32_t from, const uint32_t to)
+{
+  const uint32_t first_word = from >> 6;
+  const uint32_t last_word  = (to - 1) >> 6;
+  uint64_t       summary, bits;
+  uint32_t       word;
+  
+  
+  if(from >= to) {
+    return -1;
+  }
+  
+  summary = mask1->summary;
+  
+  if(mask2 != NULL) {
+    summary &= mask2->summary;
+  }
+  
+  // Only the words overlapping [from, to)
+  summary &= ~((((uint64_t)0x1) << first_word) - 1);
+  summary &=  (((uint64_t)0x2) << last_word)   - 1;
+  
+  
+  while(summary != 0)
+  {
+    word = __builtin_ctzll(summary);
+    bits = mask1->leaf[word];
+    
+    if(mask2 != NULL) {
+      bits &= mask2->leaf[word];
+    }
+    
+    if(word == first_word) {
+      bits &= ~((((uint64_t)0x1) << (from & 63)) - 1);
+    }
+    
+    if(word == last_word) {
+      bits &= (((uint64_t)0x2) << ((to - 1) & 63)) - 1;
+    }
+    
+    if(bits != 0) {
+      return (int) ((word << 6) + __builtin_ctzll(bits));
+    }
+    
+    summary &= (summary - 1);
+  }
+  
+  return -1;
+}
+
+
+
+/**
+ * Return the index of the next set bit in 'group_mask' after 'curr_idx' (round-robin, wraps around).
+ *
+ * @param curr_idx    Index of the last used queue group
+ * @param group_mask  Mask bits represent the queue groups that should be polled
+ *
+ * @return The next queue group index, 0 if the mask is empty
+ */
+static inline uint32_t
+group_mask_next(const group_mask_t *const group_mask, const uint32_t curr_idx)
+{
+  int next_idx;
+  
+  
+  next_idx = group_mask_find(group_mask, NULL, curr_idx + 1, EM_MAX_QUEUE_GROUPS);
+  
+  if(next_idx < 0) {
+    next_idx = group_mask_find(group_mask, NULL, 0, curr_idx + 1);
+  }
+  
+  return (next_idx >= 0) ? (uint32_t) next_idx : 0;
+}
+
+
+
 /**
  * Modify the EM_QUEUE_GROUP_CORE_LOCAL_BASE_NAME ("core00") for a core
  */
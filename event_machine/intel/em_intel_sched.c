@@ -61,12 +61,15 @@
 
 
 
-#define  SCHED_QS_MASK                       (SCHED_QS - 1)
 COMPILE_TIME_ASSERT(POWEROF2(SCHED_QS), SCHED_QS__NOT_POWER_OF_TWO);
 
 #define  SCHED_Q_QUEUE_MASK                  (SCHED_Q_MAX_QUEUES - 1)
 COMPILE_TIME_ASSERT(POWEROF2(SCHED_Q_MAX_QUEUES), SCHED_QS_MAX_QUEUES__NOT_POWER_OF_TWO);
 
+COMPILE_TIME_ASSERT(POWEROF2(SCHED_READY_RESCAN_ROUNDS), SCHED_READY_RESCAN_ROUNDS__NOT_POWER_OF_TWO);
+
+COMPILE_TIME_ASSERT(SCHED_PRIO_LEVELS == NUM_PRIORITIES, SCHED_PRIO_LEVELS__MULTIRING_PRIORITIES_ERROR);
+
 #define  SCHED_Q_ATOMIC_SELECT(q_elem)       (&em.shm->sched_qs_prio.sched_q_atomic[(q_elem)->queue_group])
 #define  SCHED_Q_PARALLEL_SELECT(q_elem)     (&em.shm->sched_qs_prio.sched_q_parallel[(q_elem)->queue_group])
 #define  SCHED_Q_PARALLEL_ORD_SELECT(q_elem) (&em.shm->sched_qs_prio.sched_q_parallel_ord[(q_elem)->queue_group])
@@ -74,6 +77,7 @@ COMPILE_TIME_ASSERT(POWEROF2(SCHED_Q_MAX_QUEUES), SCHED_QS_MAX_QUEUES__NOT_POWER
 
 
 #define PARALLEL_ORDERED__USE_SCHED_Q_LOCKS  (0) // 0=default=use Q-locks to maintain order, 1=use sched-Q locks to maintain order
+                                                 // (only if LOCKLESS_ORDERED_QUEUES == 0)
 
 
 
@@ -81,7 +85,7 @@ COMPILE_TIME_ASSERT(POWEROF2(SCHED_Q_MAX_QUEUES), SCHED_QS_MAX_QUEUES__NOT_POWER
  * Bulk dequeue buffers used in the schedule_...() functions.
  */
  
-// Multi-Ring
+// Multi-Ring (default bursts, adaptive bursts vary from SCHED_BURST_MIN to SCHED_BURST_MAX)
 #define MAX_Q_BULK_ATOMIC        (8)  // Max nbr of q_elems to bulk dequeue
 #define MAX_E_BULK_PARALLEL      (16) // Max nbr of event-hdrs to bulk dequeue
 #define MAX_E_BULK_PARALLEL_ORD  (16) // Max nbr of event-hdrs to bulk dequeue
@@ -89,9 +93,12 @@ COMPILE_TIME_ASSERT(POWEROF2(SCHED_Q_MAX_QUEUES), SCHED_QS_MAX_QUEUES__NOT_POWER
 // RTE-Ring
 #define MAX_E_BULK_ATOMIC        (16)  // Max nbr of events  to bulk dequeue
 
-#define BULK_DEQUEUE_BUF1_SIZE   (MAX_Q_BULK_ATOMIC)
+// em_send_multi() and order-queue output
+#define MAX_E_BULK_SEND          (64)  // Max nbr of events to bulk enqueue
+
+#define BULK_DEQUEUE_BUF1_SIZE   (SCHED_BURST_MAX)
 #define BULK_DEQUEUE_BUF2_SIZE   (MAX_E_BULK_ATOMIC)
-#define BULK_DEQUEUE_BUF_SIZE    (MAX(MAX_E_BULK_PARALLEL, MAX_E_BULK_PARALLEL_ORD))
+#define BULK_DEQUEUE_BUF_SIZE    (SCHED_BURST_MAX)
 
 
 typedef union
@@ -117,6 +124,158 @@ COMPILE_TIME_ASSERT((sizeof(bulk_dequeue_bufs) % ENV_CACHE_LINE_SIZE) == 0, BULK
 
 
 
+/*
+ * Buffers for passing a batch of events to an EO multi-event receive function.
+ */
+#define MULTI_RCV_BUF_SIZE       (MAX(MAX_E_BULK_ATOMIC, BULK_DEQUEUE_BUF_SIZE))
+
+typedef struct
+{
+  em_event_t       events[MULTI_RCV_BUF_SIZE];
+  
+  em_event_type_t  types[MULTI_RCV_BUF_SIZE];
+  
+} multi_rcv_bufs_t ENV_CACHE_LINE_ALIGNED;
+
+
+/**
+ * Multi-event receive buffers
+ */
+static ENV_LOCAL  multi_rcv_bufs_t  multi_rcv_bufs  ENV_CACHE_LINE_ALIGNED;
+
+
+
+/*
+ * Adaptive scheduling burst sizes, see sched_burst_adapt()
+ */
+COMPILE_TIME_ASSERT(POWEROF2(MAX_Q_BULK_ATOMIC) && (MAX_Q_BULK_ATOMIC >= SCHED_BURST_MIN) &&
+                    (MAX_Q_BULK_ATOMIC <= SCHED_BURST_MAX), MAX_Q_BULK_ATOMIC__NOT_A_BURST_SIZE);
+COMPILE_TIME_ASSERT(POWEROF2(MAX_E_BULK_PARALLEL) && (MAX_E_BULK_PARALLEL >= SCHED_BURST_MIN) &&
+                    (MAX_E_BULK_PARALLEL <= SCHED_BURST_MAX), MAX_E_BULK_PARALLEL__NOT_A_BURST_SIZE);
+COMPILE_TIME_ASSERT(POWEROF2(MAX_E_BULK_PARALLEL_ORD) && (MAX_E_BULK_PARALLEL_ORD >= SCHED_BURST_MIN) &&
+                    (MAX_E_BULK_PARALLEL_ORD <= SCHED_BURST_MAX), MAX_E_BULK_PARALLEL_ORD__NOT_A_BURST_SIZE);
+COMPILE_TIME_ASSERT((SCHED_TYPE_ATOMIC == EM_SCHED_BURST_ATOMIC) && (SCHED_TYPE_PARALLEL == EM_SCHED_BURST_PARALLEL) &&
+                    (SCHED_TYPE_PARALLEL_ORD == EM_SCHED_BURST_PARALLEL_ORD), SCHED_BURST_TYPES_ERROR);
+
+/**
+ * Burst control of one scheduling type
+ */
+typedef struct
+{
+  int                     burst;        // Current dequeue burst, SCHED_BURST_MIN << level
+  int                     revisit_max;  // Current max number of full bursts in a row from the same sched-q
+  int                     level;
+  int                     def_level;    // Level of the default burst (MAX_Q_BULK_ATOMIC etc.)
+  int                     def_revisit;  // Revisit count at the default level (SCHED_Q_ATOMIC_CNT_MAX etc.)
+  
+  // Current decision window
+  uint32_t                win_dequeues;
+  uint32_t                win_full;
+  uint32_t                win_busy;     // Dequeues that got events
+  uint64_t                win_cycles;   // Cycles spent serving the busy dequeues (only with a latency target)
+  
+  em_sched_burst_stats_t  stats;
+  
+} sched_burst_t;
+
+
+typedef struct
+{
+  sched_burst_t  type[SCHED_TYPES];
+  
+  // em_conf_t.sched_latency_target_us in cycles, 0 = no target (or fixed bursts)
+  uint64_t       target_cycles;
+  
+  int            adaptive;
+  
+} sched_burst_local_t;
+
+
+static ENV_LOCAL  sched_burst_local_t  sched_burst  ENV_CACHE_LINE_ALIGNED;
+
+
+
+/**
+ * Core local state of the hybrid poll/sleep dispatch
+ */
+typedef struct
+{
+  uint32_t                  idle_rounds;   // Empty rounds before backing off, 0 = always poll
+  
+  uint32_t                  sleep_us;      // Max sleep time
+  
+  uint32_t                  empty_rounds;  // Current number of empty rounds in a row
+  
+  uint32_t                  pause;         // Current pause length in the pause phase
+  
+  em_dispatch_idle_stats_t  stats;
+  
+} dispatch_idle_local_t;
+
+
+static ENV_LOCAL  dispatch_idle_local_t  dispatch_idle  ENV_CACHE_LINE_ALIGNED;
+
+
+
+/**
+ * Core local state of the work stealing
+ */
+typedef struct
+{
+  int                     policy;     // em_sched_steal_t
+  
+  unsigned                threshold;  // Min events in a parallel sched-q of the victim
+  
+  int                     victim;     // Next core to check
+  
+  em_sched_steal_stats_t  stats;
+  
+} sched_steal_local_t;
+
+
+static ENV_LOCAL  sched_steal_local_t  sched_steal  ENV_CACHE_LINE_ALIGNED;
+
+
+
+/**
+ * Core local state of the cache-affine atomic scheduling: atomic queues rescheduled by this
+ * core are kept in a private FIFO stash (still scheduled, sched_count=1) and served again by
+ * this core before the other cores see them, at most 'max_bursts' bursts in a row from the stash.
+ */
+typedef struct
+{
+  em_queue_element_t     *q_elem[SCHED_STICKY_STASH];
+  
+  struct multiring       *sched_q[SCHED_STICKY_STASH];
+  
+  uint32_t                bursts[SCHED_STICKY_STASH]; // Bursts in a row served from the stash, incl. the next one
+  
+  uint32_t                head;       // FIFO indexes, free running
+  
+  uint32_t                tail;
+  
+  uint32_t                max_bursts; // em_conf_t.sched_atomic_sticky, 0 = off
+  
+  uint32_t                serving;    // Bursts in a row from the stash of the queue being served (incl. the current one), 0 = not from the stash
+  
+  em_sched_sticky_stats_t stats;
+  
+} sched_sticky_local_t;
+
+
+static ENV_LOCAL  sched_sticky_local_t  sched_sticky  ENV_CACHE_LINE_ALIGNED;
+
+COMPILE_TIME_ASSERT(POWEROF2(SCHED_STICKY_STASH), SCHED_STICKY_STASH__NOT_POWER_OF_TWO);
+
+
+
+/** Nesting depth of the inline dispatches from EO sends to direct dispatch queues on this core */
+static ENV_LOCAL  int  direct_dispatch_depth = 0;
+
+
+
+// Cache lines for sched_core_local_t: the fields around 'sched_qs_info' (at most 48 bytes) and the per queue group indexes in it
+#define SCHED_CORE_LOCAL_LINES  ((48 + sizeof(sched_qs_info_local_t) + ENV_CACHE_LINE_SIZE - 1) / ENV_CACHE_LINE_SIZE)
 
 typedef union
 { 
@@ -124,14 +283,22 @@ typedef union
   {
     int64_t                  events_enqueued;  /**< Core local number of succesful event enqueues (for sched-rounds approx.) */
     
+    em_queue_element_t      *atomic_q_elem;    /**< Atomic queue whose context this core holds, NULL if none (or released) */
+    
+    int32_t                  atomic_e_count;   /**< Number of events dequeued in the current atomic burst */
+    
+    int32_t                  atomic_e_left;    /**< Number of events in the current atomic burst not yet dispatched */
+    
     core_sched_masks_t      *sched_masks;      /**< Core local pointer to &em.shm->core_sched_masks[core] */
 
     core_sched_add_counts_t *sched_add_counts; /**< Core local pointer to &em.shm->core_sched_add_counts[core] */
 
     sched_qs_info_local_t    sched_qs_info;    /**< Core local sched queue info (indexes, sched-counts etc.) */
+    
+    uint32_t                 sched_rounds;     /**< Scheduling round counter, every SCHED_READY_RESCAN_ROUNDS:th round re-marks the ready hints */
   };
   
-  uint8_t u8[4 * ENV_CACHE_LINE_SIZE];
+  uint8_t u8[SCHED_CORE_LOCAL_LINES * ENV_CACHE_LINE_SIZE];
   
 } sched_core_local_t;
 
@@ -139,6 +306,8 @@ typedef union
 static ENV_LOCAL  sched_core_local_t  sched_core_local  ENV_CACHE_LINE_ALIGNED;
 
 COMPILE_TIME_ASSERT((sizeof(sched_core_local) % ENV_CACHE_LINE_SIZE) == 0, EM_SCHED_CORE_LOCAL_SIZE_ERROR);
+COMPILE_TIME_ASSERT((offsetof(sched_core_local_t, sched_rounds) + sizeof(uint32_t)) <= (SCHED_CORE_LOCAL_LINES * ENV_CACHE_LINE_SIZE),
+                    EM_SCHED_CORE_LOCAL_LINES_ERROR);
 
 
 
@@ -149,20 +318,38 @@ COMPILE_TIME_ASSERT((sizeof(sched_core_local) % ENV_CACHE_LINE_SIZE) == 0, EM_SC
 static inline int
 em_schedule_queues(void);
 
+static inline int
+em_schedule__budget(const uint64_t cycle_end, const uint64_t max_events);
+
 static inline int
 em_schedule_atomic(sched_q_atomic_t              sched_q_atomic[],
                    sched_qs_info_local_t *const  sched_qs_info,
-                   sched_type_mask_t     *const  sched_masks);
+                   sched_type_mask_t     *const  sched_masks,
+                   sched_ready_type_t    *const  ready);
 
 static inline int
 em_schedule_parallel(sched_q_parallel_t           sched_q_parallel[],
                      sched_qs_info_local_t *const sched_qs_info,
-                     sched_type_mask_t     *const sched_masks);
+                     sched_type_mask_t     *const sched_masks,
+                     sched_ready_type_t    *const ready);
 
 static inline int
 em_schedule_parallel_ordered(sched_q_parallel_ord_t       sched_q_parallel_ord[],
                              sched_qs_info_local_t *const sched_qs_info,
-                             sched_type_mask_t     *const sched_masks);
+                             sched_type_mask_t     *const sched_masks,
+                             sched_ready_type_t    *const ready);
+
+static inline int
+em_schedule_strict_prio(void);
+
+static inline int
+schedule_atomic_dispatch(void* *const q_ptr, const int q_count, struct multiring *const sched_q);
+
+static inline int
+schedule_parallel_dispatch(void* *const ev_hdr_ptr, const int ev_hdr_count);
+
+static inline int
+schedule_parallel_ord_dispatch(void* *const ev_hdr_ptr, const int ev_hdr_count, env_spinlock_t *const lock);
 
 static inline em_status_t
 parallel_ordered_maintain_order(em_event_hdr_t *const ev_hdr, em_queue_element_t *const q_elem, env_spinlock_t *const lock);                             
@@ -173,12 +360,68 @@ parallel_ordered_maintain_order(em_event_hdr_t *const ev_hdr, em_queue_element_t
 static inline em_status_t
 em_send_atomic(em_event_hdr_t *const ev_hdr, em_queue_element_t *const q_elem, const em_queue_t queue);
 
+static inline struct rte_ring *
+atomic_ring_ref(em_queue_element_t *const q_elem);
+
+static inline void
+atomic_ring_unref(em_queue_element_t *const q_elem);
+
+static inline void
+atomic_ring_unbind(em_queue_element_t *const q_elem);
+
+static inline void
+atomic_context_release(em_queue_element_t *const q_elem, struct multiring *const sched_q,
+                       const int32_t e_count, const int sticky, const em_escope_t escope);
+
+static inline int
+atomic_context_reschedule(em_queue_element_t *const q_elem, struct multiring *const sched_q, const int sticky);
+
 static inline em_status_t
 em_send_parallel(em_event_hdr_t *const ev_hdr, em_queue_element_t *const q_elem, const em_queue_t queue);
 
 static inline em_status_t
 em_send_parallel_ordered(em_event_hdr_t *const ev_hdr, em_queue_element_t *const q_elem, const em_queue_t queue);
 
+static inline int
+em_send_atomic_multi(em_event_hdr_t *const ev_hdrs[], const int num, em_queue_element_t *const q_elem, const em_queue_t queue);
+
+static inline int
+em_send_parallel_multi(em_event_hdr_t *const ev_hdrs[], const int num, em_queue_element_t *const q_elem, const em_queue_t queue);
+
+static inline int
+em_send_parallel_ordered_multi(em_event_hdr_t *const ev_hdrs[], const int num, em_queue_element_t *const q_elem, const em_queue_t queue);
+
+static inline em_status_t
+order_queue_output(em_queue_element_t *const src_q_elem, em_event_hdr_t *const first_hdr, em_event_hdr_t *const in_hdr);
+
+static inline em_status_t
+order_queue_output__send(em_event_hdr_t *const send_hdrs[], const int num, em_event_hdr_t *const in_hdr);
+
+static inline int
+order_queue_output__event(em_queue_element_t *const src_q_elem, em_event_hdr_t *const ev_hdr,
+                          em_event_hdr_t *send_hdrs[], int send_num, em_event_hdr_t *const in_hdr,
+                          em_status_t *const ret_status);
+
+#if LOCKLESS_ORDERED_QUEUES == 1
+static inline int
+order_window_tickets(em_queue_element_t *const q_elem, em_event_hdr_t *const ev_hdrs[], const int num);
+
+static inline order_block_t *
+order_window_block_get(order_window_t *const win);
+
+static inline void
+order_window_block_put(order_window_t *const win, order_block_t *const blk);
+
+static inline int
+order_window_ready(order_window_t *const win);
+
+static inline em_status_t
+order_window_release(em_queue_element_t *const src_q_elem, em_event_hdr_t *const in_hdr);
+
+static inline em_status_t
+order_window_output(em_queue_element_t *const src_q_elem, order_window_t *const win, em_event_hdr_t *const in_hdr);
+#endif
+
 
 
 
@@ -187,29 +430,132 @@ dispatch_event(em_queue_element_t *const q_elem,
                em_event_t                event,
                const em_event_type_t     event_type);
 
-
-#if RX_DIRECT_DISPATCH == 1
+static inline void
+dispatch_event_multi(em_queue_element_t *const q_elem,
+                     em_event_t                events[],
+                     em_event_type_t           types[],
+                     const int                 num);
 
 static inline void
+dispatch_ev_hdrs(void* *const ev_hdr_ptr,
+                 const int    ev_hdr_count);
+
+
+static inline em_status_t
 em_direct_dispatch__atomic(em_queue_element_t *const q_elem,
                            em_event_t                event,
                            em_event_hdr_t     *const ev_hdr);
 
-static inline void
+static inline em_status_t
 em_direct_dispatch__parallel_ordered(em_queue_element_t *const q_elem,
                                      em_event_t                event,
                                      em_event_hdr_t     *const ev_hdr);
-#endif
 
+static inline int
+em_direct_dispatch_possible(em_queue_element_t *const q_elem);
+
+static inline em_status_t
+em_direct_dispatch_send(em_event_hdr_t *const ev_hdr, em_queue_element_t *const q_elem);
 
 
 
-static inline uint32_t
-sched_q_get_next_idx(const uint32_t curr_idx, const uint64_t group_mask);
 
 static inline uint16_t
 sched_q_get_next_qidx(const uint16_t curr_idx, const uint16_t mask);
 
+static inline uint16_t
+sched_q_qidx(const int sched_type, const em_queue_element_t *const q_elem);
+
+static inline int
+sched_q_enqueue(struct multiring *const sched_q, const int sched_type, em_queue_element_t *const q_elem, void *const obj);
+
+static inline int
+sched_q_enqueue_burst(struct multiring *const sched_q, const int sched_type, em_queue_element_t *const q_elem,
+                      void * const *obj_table, const int num);
+
+#if SCHED_READY_HINTS == 1
+static inline void
+sched_ready_set(sched_ready_type_t *const ready, const uint32_t grp, const uint16_t qidx);
+
+static inline void
+sched_ready_clear(sched_ready_type_t *const ready, const uint32_t grp, const uint16_t qidx, struct multiring *const sched_q);
+
+static inline void
+sched_ready_grp_clear(sched_ready_type_t *const ready, const uint32_t grp);
+
+static void
+sched_ready_rescan(sched_ready_hints_t *const ready_hints, sched_qs_t *const sched_qs, sched_masks_t *const sched_masks);
+
+static inline void
+sched_ready_rescan_grp(sched_ready_type_t *const ready, const uint32_t grp, uint16_t qidx_mask,
+                       struct multiring *const sched_q[]);
+
+static inline int
+sched_ready_select(sched_ready_type_t *const ready, const group_mask_t *const grp_mask, const volatile uint16_t qidx_masks[],
+                   uint32_t *const sched_idx, uint8_t qidx[]);
+#endif
+
+
+static inline uint32_t
+sched_ring_size_default(void);
+
+static void
+sched_qs_free__drain(struct multiring *const sched_q);
+
+static void
+sched_burst_init(void);
+
+static void
+sched_burst_level_set(sched_burst_t *const ctrl, const int level);
+
+static void
+sched_burst_adapt(sched_burst_t *const ctrl);
+
+static inline uint64_t
+sched_burst_start(void);
+
+static inline void
+sched_burst_update(sched_burst_t *const ctrl, const int count, const uint64_t start);
+
+static void
+sched_steal_init(void);
+
+static int
+sched_steal_events(void);
+
+static inline int
+sched_steal_parallel(const em_queue_group_t group);
+
+static inline int
+sched_steal_atomic(const em_queue_group_t group);
+
+static void
+sched_sticky_init(void);
+
+static inline int
+sched_sticky_put(em_queue_element_t *const q_elem, struct multiring *const sched_q);
+
+static int
+sched_sticky_serve(void);
+
+static void
+sched_sticky_flush(void);
+
+static void
+dispatch_idle_init(void);
+
+static void
+dispatch_idle_backoff(void);
+
+static int
+dispatch_idle_sleep(void);
+
+static inline void
+dispatch_idle_wake_check(const em_queue_group_t group);
+
+static void
+dispatch_idle_wake(const em_queue_group_t group);
+
 
 
 
@@ -224,6 +570,9 @@ sched_q_get_next_qidx(const uint16_t curr_idx, const uint16_t mask);
  * Called by each EM-core to dispatch events for EM processing.
  *
  * @param rounds  Dispatch rounds before returning, 0 means 'never return from dispatch'
+ *
+ * @note With em_conf_t.dispatch_idle_rounds (or em_dispatch_idle_set()) the 'forever' dispatch
+ *       backs off when there is no work: pauses first, then sleeps until woken up by a send.
  */
 void
 em_dispatch(uint32_t rounds)
@@ -238,14 +587,23 @@ em_dispatch(uint32_t rounds)
       /*
        * Schedule events to the core from queues
        */
-      em_schedule();
+      (void) em_schedule();
     }
+    
+    // Give the stashed atomic queues back to the other cores before returning
+    sched_sticky_flush();
   }
   else // rounds == 0 (== FOREVER)
   {
     for(;/*ever*/;)
     {
-      em_schedule();
+      IF_LIKELY(em_schedule() > 0) {
+        dispatch_idle.empty_rounds = 0;
+      }
+      else if(dispatch_idle.idle_rounds != 0) {
+        // Hybrid poll/sleep, re-checked every round: em_dispatch_idle_set() may change the mode
+        dispatch_idle_backoff();
+      }
     }
   }
   
@@ -254,149 +612,360 @@ em_dispatch(uint32_t rounds)
 
 
 
+/**
+ * Time or event budgeted event dispatch (HW specific addition)
+ *
+ * @param cycle_budget  Max core cycles to dispatch for, 0 = no time limit
+ * @param max_events    Max number of events to dispatch, 0 = no event limit
+ * @param stats         Statistics of the call (output), NULL if not needed
+ *
+ * @return Number of events dispatched
+ */
+uint64_t
+em_dispatch_ex(uint64_t cycle_budget, uint64_t max_events, em_dispatch_stats_t *const stats)
+{
+  const uint64_t start     = env_get_cycle();
+  const uint64_t cycle_end = (cycle_budget != 0) ? (start + cycle_budget) : 0;
+  uint64_t       now       = start;
+  uint64_t       events    = 0;
+  uint64_t       rounds    = 0;
+  uint64_t       idle      = 0;
+  uint64_t       round_start;
+  int            dispatched;
+  
+  
+  do {
+    round_start = now;
+    
+    // The budget also bounds the extra rounds em_schedule() runs for the events sent by this core
+    dispatched = em_schedule__budget(cycle_end, (max_events != 0) ? (max_events - events) : 0);
+    
+    now = env_get_cycle();
+    rounds++;
+    
+    if(dispatched > 0) {
+      events += dispatched;
+    }
+    else {
+      idle += now - round_start;
+    }
+    
+    if((max_events != 0) && (events >= max_events)) {
+      break;
+    }
+    
+  } while((cycle_budget != 0) ? ((now - start) < cycle_budget) : (max_events != 0));
+  
+  sched_sticky_flush();
+  
+  
+  if(stats != NULL)
+  {
+    stats->events      = events;
+    stats->rounds      = rounds;
+    stats->cycles      = now - start;
+    stats->idle_cycles = idle;
+  }
+  
+  return events;
+}
+
+
+
 /**
  * Global init of the scheduling queues
+ *
+ * Note: the scheduling queues (multirings) are created on demand by sched_qs_create()
+ *       when the first EM-queue of a certain type is created into a queue group.
  */
 void
 sched_init_global_1(void) 
 {
+  int i;
+  
+  
   (void) memset(&em.shm->sched_qs_prio,         0, sizeof(em.shm->sched_qs_prio));
   (void) memset( em.shm->core_sched_masks,      0, sizeof(em.shm->core_sched_masks));     
   (void) memset( em.shm->core_sched_add_counts, 0, sizeof(em.shm->core_sched_add_counts));
+  (void) memset(&em.shm->sched_prio_hints,      0, sizeof(em.shm->sched_prio_hints));
+  (void) memset(&em.shm->sched_ready_hints,     0, sizeof(em.shm->sched_ready_hints));
+  (void) memset(&em.shm->dispatch_sleep,        0, sizeof(em.shm->dispatch_sleep));
   
   env_spinlock_init(&em.shm->sched_add_counts_lock.lock);
+  env_spinlock_init(&em.shm->sched_qs_lock.lock);
+  
+  IF_UNLIKELY((em_internal_conf.conf.sched_ring_size != 0) &&
+              (sched_ring_size_default() != (uint32_t) em_internal_conf.conf.sched_ring_size))
+  {
+    printf("%s(): Invalid sched ring size %i (not a power of 2 or over %u), using default %u\n", __func__,
+           em_internal_conf.conf.sched_ring_size, MRING_SZ_MAX, sched_ring_size_default());
+  }
+  
+  if(em_internal_conf.conf.sched_strict_prio) {
+    printf("%s(): Strict priority scheduling over all queue groups enabled\n", __func__);
+  }
+  
+  IF_UNLIKELY((em_internal_conf.conf.sched_steal < EM_SCHED_STEAL_OFF) ||
+              (em_internal_conf.conf.sched_steal > EM_SCHED_STEAL_ATOMIC))
+  {
+    printf("%s(): Invalid work stealing policy %i, stealing disabled\n", __func__, em_internal_conf.conf.sched_steal);
+  }
+  else if(em_internal_conf.conf.sched_steal != EM_SCHED_STEAL_OFF)
+  {
+    printf("%s(): Work stealing from the core local queue groups enabled (%s)\n", __func__,
+           (em_internal_conf.conf.sched_steal == EM_SCHED_STEAL_ATOMIC) ? "parallel & atomic" : "parallel");
+  }
+  
+  /* Set the default sched-q nbr, mask and ring size for all queue groups */
+  for(i = 0; i < SCHED_QS; i++)
+  {
+    sched_qs_group_init(i, SCHED_Q_MAX_QUEUES, sched_ring_size_default());
+  }
 }
 
 
 
-em_status_t
-sched_init_global_2(void)
+/**
+ * Set the number of scheduling queues (per sched type) and their depth for a queue group.
+ * 
+ * Must be called before any EM-queues are created into the queue group, 
+ * i.e. before sched_qs_create() has been called for the group.
+ *
+ * @param group       Queue group
+ * @param nbr_queues  Number of scheduling queues per sched type (power of 2, max SCHED_Q_MAX_QUEUES)
+ * @param ring_size   Depth (per priority) of each scheduling queue (power of 2)
+ */
+void
+sched_qs_group_init(const em_queue_group_t group, const int nbr_queues, const uint32_t ring_size)
 {
-  char     sched_q_name[32];
-  int      num_cores;
-  int      i, j;
-
-  sched_q_atomic_t        *sched_q_atomic;
-  sched_q_parallel_t      *sched_q_parallel;
-  sched_q_parallel_ord_t  *sched_q_parallel_ord;
-
-
-  printf("%s():\n", __func__);
-
-  num_cores = em_core_count();
-
-
-  sched_q_atomic       = em.shm->sched_qs_prio.sched_q_atomic;
-  sched_q_parallel     = em.shm->sched_qs_prio.sched_q_parallel;
-  sched_q_parallel_ord = em.shm->sched_qs_prio.sched_q_parallel_ord;
-
-  printf("  Initialize SchedQs:\n");
-
-  /* Set the default sched-q nbr and mask... */
-  for(i = 0; i < SCHED_QS; i++)
-  {
-    sched_q_atomic[i].nbr_queues       = SCHED_Q_MAX_QUEUES;
-    sched_q_atomic[i].queue_mask       = SCHED_Q_QUEUE_MASK;
-
-    sched_q_parallel[i].nbr_queues     = SCHED_Q_MAX_QUEUES;
-    sched_q_parallel[i].queue_mask     = SCHED_Q_QUEUE_MASK;
+  sched_q_atomic_t       *const sched_q_atomic       = &em.shm->sched_qs_prio.sched_q_atomic[group];
+  sched_q_parallel_t     *const sched_q_parallel     = &em.shm->sched_qs_prio.sched_q_parallel[group];
+  sched_q_parallel_ord_t *const sched_q_parallel_ord = &em.shm->sched_qs_prio.sched_q_parallel_ord[group];
+  const uint64_t                queue_mask           = (uint64_t) (nbr_queues - 1);
+  
+  
+  sched_q_atomic->nbr_queues       = nbr_queues;
+  sched_q_atomic->queue_mask       = queue_mask;
+  sched_q_atomic->ring_size        = ring_size;
 
-    sched_q_parallel_ord[i].nbr_queues = SCHED_Q_MAX_QUEUES;
-    sched_q_parallel_ord[i].queue_mask = SCHED_Q_QUEUE_MASK;
-  }
+  sched_q_parallel->nbr_queues     = nbr_queues;
+  sched_q_parallel->queue_mask     = queue_mask;
+  sched_q_parallel->ring_size      = ring_size;
 
+  sched_q_parallel_ord->nbr_queues = nbr_queues;
+  sched_q_parallel_ord->queue_mask = queue_mask;
+  sched_q_parallel_ord->ring_size  = ring_size;
+}
 
-  /* ...and override the ones used by the internal messaging queue-groups */
-  for(i = 0; i < num_cores; i++)
-  {
-    em_core_mask_t    mask;
-    em_queue_group_t  local_group;
-    char              q_grp_name[] = EM_QUEUE_GROUP_CORE_LOCAL_BASE_NAME;
 
-    em_core_mask_zero(&mask);
-    em_core_mask_set(i, &mask);
 
-    core_queue_grp_name(q_grp_name, i);
-    local_group = em_queue_group_find(q_grp_name);
+/**
+ * Create the scheduling queues of the given type for a queue group, if not already created.
+ * 
+ * Called when an EM-queue is created - the scheduling queues must exist before
+ * events can be sent to the EM-queue.
+ *
+ * @param type   EM-queue scheduling type
+ * @param group  Queue group
+ *
+ * @return EM_OK if successful.
+ */
+em_status_t
+sched_qs_create(const em_queue_type_t type, const em_queue_group_t group)
+{
+  char               sched_q_name[32];
+  struct multiring **sched_q;
+  const char        *type_name;
+  int                nbr_queues;
+  uint32_t           ring_size;
+  unsigned           flags;
+  unsigned           weights[SCHED_PRIO_LEVELS];
+  int                socket;
+  int                j;
+  
+  
+  RETURN_ERROR_IF(invalid_qgrp(group), EM_ERR_BAD_ID, EM_ESCOPE_SCHED_QUEUE_INIT,
+                  "Invalid queue group: %"PRI_QGRP"", group);
+  
+  // Rings on the socket of the group's cores, any socket if the group spans several
+  socket = numa_cores_socket(&em.shm->em_queue_group[group].mask);
+  
+  for(j = 0; j < SCHED_PRIO_LEVELS; j++) {
+    weights[j] = em_internal_conf.conf.sched_prio_weights[j];
+  }
+  
+  
+  switch(type)
+  {
+    case EM_QUEUE_TYPE_ATOMIC:
+      {
+        sched_q_atomic_t *const sched_q_obj = &em.shm->sched_qs_prio.sched_q_atomic[group];
+        
+        sched_q    = sched_q_obj->sched_q;
+        nbr_queues = sched_q_obj->nbr_queues;
+        ring_size  = sched_q_obj->ring_size;
+        type_name  = "Atomic";
+        // Atomic scheduling queues - multi-producer, multi-consumer
+        flags      = 0;
+      }
+      break;
     
-    RETURN_ERROR_IF(local_group == EM_QUEUE_GROUP_UNDEF, EM_FATAL(EM_ERR_NOT_FOUND), EM_ESCOPE_SCHED_QUEUE_INIT,
-                    "Did not find a queue group for EM-core %i", i);
-                    
-    sched_q_atomic[local_group].nbr_queues       = 1;
-    sched_q_atomic[local_group].queue_mask       = 0x0;
-
-    sched_q_parallel[local_group].nbr_queues     = 1;
-    sched_q_parallel[local_group].queue_mask     = 0x0;
-
-    sched_q_parallel_ord[local_group].nbr_queues = 1;
-    sched_q_parallel_ord[local_group].queue_mask = 0x0;
+    case EM_QUEUE_TYPE_PARALLEL:
+      {
+        sched_q_parallel_t *const sched_q_obj = &em.shm->sched_qs_prio.sched_q_parallel[group];
+        
+        sched_q    = sched_q_obj->sched_q;
+        nbr_queues = sched_q_obj->nbr_queues;
+        ring_size  = sched_q_obj->ring_size;
+        type_name  = "Parallel";
+        // Parallel scheduling queues - multi-producer, multi-consumer
+        flags      = 0;
+      }
+      break;
+    
+    case EM_QUEUE_TYPE_PARALLEL_ORDERED:
+      {
+        sched_q_parallel_ord_t *const sched_q_obj = &em.shm->sched_qs_prio.sched_q_parallel_ord[group];
+        
+        sched_q    = sched_q_obj->sched_q;
+        nbr_queues = sched_q_obj->nbr_queues;
+        ring_size  = sched_q_obj->ring_size;
+        type_name  = "ParalOrd";
+        // Parallel-Ordered scheduling queues - multi-producer, single-consumer (spinlocks used to serialize access)
+        flags      = RING_F_SC_DEQ;
+      }
+      break;
+    
+    default:
+      return EM_INTERNAL_ERROR(EM_ERR_NOT_FOUND, EM_ESCOPE_SCHED_QUEUE_INIT,
+                               "Unknown EM-queue type (%u)", type);
   }
-
   
-  printf("    Atomic SchedQs...          ");
-  /* Initialize the atomic scheduling queues */
-  for(i = 0; i < SCHED_QS; i++)
+  
+  env_spinlock_lock(&em.shm->sched_qs_lock.lock);
+  
+  for(j = 0; j < nbr_queues; j++)
   {
-    /*
-     * Atomic scheduling queues - multi-producer, multi-consumer
-     * Multiple different atomic event queues can be enqeueud/dequeued simultaneously
-     */
-    for(j = 0; j < sched_q_atomic[i].nbr_queues; j++)
+    if(sched_q[j] != NULL) {
+      continue; // Already created by a previous EM-queue of this type in the group
+    }
+    
+    (void) snprintf(sched_q_name, sizeof(sched_q_name), "%s-ShedQ-%"PRI_QGRP"-%i", type_name, group, j);
+    sched_q_name[31] = '\0';
+    
+    if(type == EM_QUEUE_TYPE_PARALLEL_ORDERED) {
+      env_spinlock_init(&em.shm->sched_qs_prio.sched_q_parallel_ord[group].locks[j].lock);
+    }
+    
+    sched_q[j] = mring_create(sched_q_name, ring_size, socket, flags);
+    
+    IF_UNLIKELY(sched_q[j] == NULL)
     {
-      (void) snprintf(sched_q_name, sizeof(sched_q_name), "Atomic-ShedQ-%i-%i", i, j);
-      sched_q_name[31] = '\0';
-
-      sched_q_atomic[i].sched_q[j] = mring_create(sched_q_name, DEVICE_SOCKET, 0);
+      env_spinlock_unlock(&em.shm->sched_qs_lock.lock);
       
-      RETURN_ERROR_IF(sched_q_atomic[i].sched_q[j] == NULL, EM_FATAL(EM_ERR_ALLOC_FAILED), EM_ESCOPE_SCHED_QUEUE_INIT,
-                      "Atomic sched-queue-%i-%i alloc failed!", i, j);
+      return EM_INTERNAL_ERROR(EM_ERR_ALLOC_FAILED, EM_ESCOPE_SCHED_QUEUE_INIT,
+                               "%s sched-queue-%"PRI_QGRP"-%i alloc failed (ring size %u)!",
+                               type_name, group, j, ring_size);
     }
-
+    
+    // Priority quotas from em_conf_t (all zero weights select the multiring defaults)
+    mring_set_quota(sched_q[j], weights);
   }
-  printf(" done.\n");
+  
+  env_sync_mem();
+  
+  env_spinlock_unlock(&em.shm->sched_qs_lock.lock);
+  
+  return EM_OK;
+}
+
+
 
+/**
+ * Free all scheduling queues of a queue group and restore the group's default sched-q settings.
+ * 
+ * Called when the queue group is deleted, i.e. when no EM-queues belong to the group and
+ * no core schedules from it any more. Events left in the parallel(-ordered) scheduling
+ * queues are freed.
+ *
+ * @param group  Queue group
+ */
+void
+sched_qs_free(const em_queue_group_t group)
+{
+  sched_q_atomic_t       *const sched_q_atomic       = &em.shm->sched_qs_prio.sched_q_atomic[group];
+  sched_q_parallel_t     *const sched_q_parallel     = &em.shm->sched_qs_prio.sched_q_parallel[group];
+  sched_q_parallel_ord_t *const sched_q_parallel_ord = &em.shm->sched_qs_prio.sched_q_parallel_ord[group];
+  int                           j;
   
-  printf("    Parallel SchedQs...        ");
-  /* Initialize the parallel scheduling queues */
-  for(i = 0; i < SCHED_QS; i++)
+  
+  env_spinlock_lock(&em.shm->sched_qs_lock.lock);
+  
+  for(j = 0; j < SCHED_Q_MAX_QUEUES; j++)
   {
-    for(j = 0; j < sched_q_parallel[i].nbr_queues; j++)
-    {
-      (void) snprintf(sched_q_name, sizeof(sched_q_name), "Parallel-ShedQ-%i-%i", i, j);
-      sched_q_name[31] = '\0';
+    // Atomic sched queues contain q_elems only, nothing to free
+    mring_free(sched_q_atomic->sched_q[j]);
+    sched_q_atomic->sched_q[j] = NULL;
+    
+    sched_qs_free__drain(sched_q_parallel->sched_q[j]);
+    mring_free(sched_q_parallel->sched_q[j]);
+    sched_q_parallel->sched_q[j] = NULL;
+    
+    sched_qs_free__drain(sched_q_parallel_ord->sched_q[j]);
+    mring_free(sched_q_parallel_ord->sched_q[j]);
+    sched_q_parallel_ord->sched_q[j] = NULL;
+  }
+  
+  sched_qs_group_init(group, SCHED_Q_MAX_QUEUES, sched_ring_size_default());
+  
+  env_sync_mem();
+  
+  env_spinlock_unlock(&em.shm->sched_qs_lock.lock);
+}
 
-      sched_q_parallel[i].sched_q[j] = mring_create(sched_q_name, DEVICE_SOCKET, 0);
 
-      RETURN_ERROR_IF(sched_q_parallel[i].sched_q[j] == NULL, EM_FATAL(EM_ERR_ALLOC_FAILED), EM_ESCOPE_SCHED_QUEUE_INIT,
-                      "Parallel sched-queue-%i-%i alloc failed!", i, j);
-    }
 
+/**
+ * Free the events (event headers) left in a parallel(-ordered) scheduling queue.
+ */
+static void
+sched_qs_free__drain(struct multiring *const sched_q)
+{
+  void *ev_hdr_ptr[MAX_E_BULK_PARALLEL];
+  int   prio;
+  int   n, i;
+  
+  
+  if(sched_q == NULL) {
+    return;
   }
-  printf(" done. \n");
-
   
-  printf("    Parallel-Ordered SchedQs...");
-  /* Initialize the parallel ordered scheduling queues */
-  for(i = 0; i < SCHED_QS; i++)
+  for(prio = 0; prio < NUM_PRIORITIES; prio++)
   {
-    for(j = 0; j < sched_q_parallel_ord[i].nbr_queues; j++)
+    while((n = mring_dequeue_burst(sched_q, prio, ev_hdr_ptr, MAX_E_BULK_PARALLEL)) > 0)
     {
-      (void) snprintf(sched_q_name, sizeof(sched_q_name), "ParalOrd-ShedQ-%i-%i", i, j);
-      sched_q_name[31] = '\0';
-
-      /* Parallel-Ordered scheduling queues - multi-producer, single-consumer (spinlocks used to serialize access) */
-      sched_q_parallel_ord[i].sched_q[j] = mring_create(sched_q_name, DEVICE_SOCKET, RING_F_SC_DEQ);
+      for(i = 0; i < n; i++) {
+        intel_free((em_event_hdr_t *) ev_hdr_ptr[i]);
+      }
+    }
+  }
+}
 
-      RETURN_ERROR_IF(sched_q_parallel_ord[i].sched_q[j] == NULL, EM_FATAL(EM_ERR_ALLOC_FAILED), EM_ESCOPE_SCHED_QUEUE_INIT,
-                      "Parallel-Ordered sched-queue-%i-%i alloc failed!", i, j);
 
-      env_spinlock_init(&sched_q_parallel_ord[i].locks[j].lock);
-    }
 
+/**
+ * The default depth of the scheduling queues, given in em_conf_t (if valid)
+ */
+static inline uint32_t
+sched_ring_size_default(void)
+{
+  const int ring_size = em_internal_conf.conf.sched_ring_size;
+  
+  IF_LIKELY((ring_size > 0) && POWEROF2(ring_size) && (ring_size <= MRING_SZ_MAX)) {
+    return (uint32_t) ring_size;
   }
-  printf(" done. \n");
-
-  return EM_OK;
+  
+  return SCHED_Q_RING_SIZE;
 }
 
 
@@ -419,1471 +988,3727 @@ sched_init_local(void)
   
 
   sched_core_local.sched_qs_info.sched_q_atomic_idx 
-    = sched_q_get_next_idx(SCHED_QS - 1, sched_core_local.sched_masks->sched_masks_prio.atomic_masks.q_grp_mask);
+    = group_mask_next(&sched_core_local.sched_masks->sched_masks_prio.atomic_masks.q_grp_mask, SCHED_QS - 1);
     
   sched_core_local.sched_qs_info.sched_q_parallel_idx 
-    = sched_q_get_next_idx(SCHED_QS - 1, sched_core_local.sched_masks->sched_masks_prio.parallel_masks.q_grp_mask);
+    = group_mask_next(&sched_core_local.sched_masks->sched_masks_prio.parallel_masks.q_grp_mask, SCHED_QS - 1);
     
   sched_core_local.sched_qs_info.sched_q_parallel_ord_idx
-    = sched_q_get_next_idx(SCHED_QS - 1, sched_core_local.sched_masks->sched_masks_prio.parallel_ord_masks.q_grp_mask);
+    = group_mask_next(&sched_core_local.sched_masks->sched_masks_prio.parallel_ord_masks.q_grp_mask, SCHED_QS - 1);
+  
+  sched_burst_init();
+  
+  sched_steal_init();
+  
+  sched_sticky_init();
+  
+  dispatch_idle_init();
 }
 
 
 
-
-void
-em_schedule(void)
+/**
+ * Init the core local burst control: each scheduling type starts from its default burst
+ */
+static void
+sched_burst_init(void)
 {
-  int events_dispatched;
+  static const int def_burst[SCHED_TYPES]   = {MAX_Q_BULK_ATOMIC, MAX_E_BULK_PARALLEL, MAX_E_BULK_PARALLEL_ORD};
+  static const int def_revisit[SCHED_TYPES] = {SCHED_Q_ATOMIC_CNT_MAX, SCHED_Q_PARALLEL_CNT_MAX, SCHED_Q_PARALLEL_ORD_CNT_MAX};
+  int              i;
   
   
-  #ifdef EVENT_PACKET
-  if(em_internal_conf.conf.pkt_io)
-  {
-    /*
-     * Poll for Eth frames and enqueue.
-     */
-    em_eth_rx_packets();
+  (void) memset(&sched_burst, 0, sizeof(sched_burst));
+  
+  sched_burst.adaptive = (em_internal_conf.conf.sched_burst_adaptive != 0);
+  
+  if(sched_burst.adaptive && (em_internal_conf.conf.sched_latency_target_us > 0)) {
+    sched_burst.target_cycles = (uint64_t) em_internal_conf.conf.sched_latency_target_us * env_core_mhz();
   }
-  #endif
   
-
-  do {
+  for(i = 0; i < SCHED_TYPES; i++)
+  {
+    sched_burst_t *const ctrl = &sched_burst.type[i];
     
-    #ifdef EVENT_TIMER
-    if(em_internal_conf.conf.evt_timer)
-    {
-      /*
-       * Manage the event timer.
-       */
-      evt_timer_manage();
+    while((SCHED_BURST_MIN << ctrl->def_level) < def_burst[i]) {
+      ctrl->def_level++;
     }
-    #endif
     
+    ctrl->def_revisit = def_revisit[i];
     
-    /*
-     * Schedule & dispatch.
-     */
-    events_dispatched = em_schedule_queues();
+    sched_burst_level_set(ctrl, ctrl->def_level);
+  }
+}
 
 
-    #ifdef EVENT_PACKET
-    if(em_internal_conf.conf.pkt_io)
+
+/**
+ * Set the burst size and revisit count of a scheduling type
+ */
+static void
+sched_burst_level_set(sched_burst_t *const ctrl, const int level)
+{
+  ctrl->level = level;
+  ctrl->burst = SCHED_BURST_MIN << level;
+  
+  if(level >= ctrl->def_level) {
+    ctrl->revisit_max = ctrl->def_revisit << (level - ctrl->def_level);
+  }
+  else {
+    ctrl->revisit_max = MAX(ctrl->def_revisit >> (ctrl->def_level - level), 1);
+  }
+  
+  ctrl->stats.burst       = (uint32_t) ctrl->burst;
+  ctrl->stats.revisit_max = (uint32_t) ctrl->revisit_max;
+}
+
+
+
+/**
+ * Burst size decision at the end of a window of SCHED_BURST_WINDOW dequeues:
+ *
+ * - Shrink if serving a burst took longer than the latency target on average.
+ * - Grow if most bursts were full (the sched-queues hold more) and twice the
+ *   current burst still fits in the latency target.
+ * - Shrink if most bursts were partial - light load, smaller bursts keep the
+ *   scheduling fair and the latency low at no cost.
+ */
+static void
+sched_burst_adapt(sched_burst_t *const ctrl)
+{
+  const uint64_t target       = sched_burst.target_cycles;
+  const uint32_t fill         = (ctrl->win_full * 100) / ctrl->win_dequeues;
+  const uint64_t burst_cycles = (ctrl->win_busy > 0) ? (ctrl->win_cycles / ctrl->win_busy) : 0;
+  int            level        = ctrl->level;
+  
+  
+  ctrl->stats.windows[level]++;
+  
+  if(sched_burst.adaptive)
+  {
+    if((target != 0) && (burst_cycles > target) && (level > 0))
     {
-      /*
-       * Transmit Eth frames that have been in the output buffers for "too long".
-       */
-      em_eth_tx_packets_timed();
+      level--;
+      ctrl->stats.shrink_latency++;
     }
-    #endif        
-    
-    
-    /* 
-     * Approximate for the need for additional schduling rounds before new Eth-Rx events.
-     * Note: the approx is core-local and does not take into account what the other cores do.
-     */
-    if(events_dispatched == 0) {
-      break;
+    else if((fill >= SCHED_BURST_FILL_HIGH) && (level < (SCHED_BURST_LEVELS - 1)) &&
+            ((target == 0) || ((2 * burst_cycles) <= target)))
+    {
+      level++;
+      ctrl->stats.grow++;
     }
-    else {
-      sched_core_local.events_enqueued -= events_dispatched;
+    else if((fill < SCHED_BURST_FILL_LOW) && (level > 0))
+    {
+      level--;
+      ctrl->stats.shrink_fill++;
     }
     
-  } while(sched_core_local.events_enqueued > 0);
-  
+    if(level != ctrl->level) {
+      sched_burst_level_set(ctrl, level);
+    }
+  }
   
-  /* Reset count for the next round */
-  sched_core_local.events_enqueued = 0;
+  ctrl->win_dequeues = 0;
+  ctrl->win_full     = 0;
+  ctrl->win_busy     = 0;
+  ctrl->win_cycles   = 0;
 }
 
 
 
-
-static inline int
-em_schedule_queues(void)
+/**
+ * Timestamp before a dequeue, only needed with a latency target
+ */
+static inline uint64_t
+sched_burst_start(void)
 {
-  int ev_a = 0, ev_p = 0, ev_po = 0;
+  return (sched_burst.target_cycles != 0) ? env_get_cycle() : 0;
+}
 
-  sched_qs_t            *const sched_qs_ptr  = &em.shm->sched_qs_prio;
-  sched_qs_info_local_t *const sched_qs_info = &sched_core_local.sched_qs_info;
-  sched_masks_t         *const sched_masks   = &sched_core_local.sched_masks->sched_masks_prio;
 
 
-  if(sched_masks->atomic_masks.q_grp_mask)
+/**
+ * Account a dequeue of 'count' objects (events or atomic queues) and the time it took
+ * to serve them since 'start'
+ */
+static inline void
+sched_burst_update(sched_burst_t *const ctrl, const int count, const uint64_t start)
+{
+  ctrl->stats.dequeues++;
+  ctrl->stats.objs += count;
+  ctrl->win_dequeues++;
+  
+  if(count == ctrl->burst)
   {
-    ev_a = em_schedule_atomic(sched_qs_ptr->sched_q_atomic,
-                              sched_qs_info,
-                             &sched_masks->atomic_masks);
+    ctrl->stats.full++;
+    ctrl->win_full++;
   }
-
-
-  if(sched_masks->parallel_masks.q_grp_mask)
+  
+  if((start != 0) && (count > 0))
   {
-    ev_p = em_schedule_parallel(sched_qs_ptr->sched_q_parallel,
-                                sched_qs_info,
-                               &sched_masks->parallel_masks);
+    ctrl->win_busy++;
+    ctrl->win_cycles += env_get_cycle() - start;
   }
-
-
-  if(sched_masks->parallel_ord_masks.q_grp_mask)
-  {
-    ev_po = em_schedule_parallel_ordered(sched_qs_ptr->sched_q_parallel_ord,
-                                         sched_qs_info,
-                                        &sched_masks->parallel_ord_masks);
+  
+  IF_UNLIKELY(ctrl->win_dequeues == SCHED_BURST_WINDOW) {
+    sched_burst_adapt(ctrl);
   }
+}
 
 
-  return (ev_a + ev_p + ev_po);
-}
 
+/**
+ * Read the adaptive scheduling burst counters of the calling core (HW specific addition)
+ */
+void
+em_sched_burst_stats(em_sched_burst_stats_t stats[EM_SCHED_BURST_TYPES])
+{
+  int i;
+  
+  
+  for(i = 0; i < SCHED_TYPES; i++) {
+    stats[i] = sched_burst.type[i].stats;
+  }
+}
 
 
 
 /**
- * Select and schedule events from an atomic scheduling queue.
- *
- * The scheduling queues contain q_elems (not events!). Once a schedulable q_elem is dequeued
- * then an event associated with it is dequeued from q_elem->rte_ring.
+ * Print the adaptive scheduling burst counters of the calling core (HW specific addition)
  */
-static inline int
-em_schedule_atomic(sched_q_atomic_t              sched_q_atomic[],
-                   sched_qs_info_local_t *const  sched_qs_info,
-                   sched_type_mask_t     *const  sched_masks)
+void
+em_sched_burst_stats_print(void)
 {
-  struct multiring* sched_q;
-
-  uint32_t         sched_idx;
-  uint16_t         qidx, next_qidx;
+  static const char *const type_name[SCHED_TYPES] = {"atomic", "parallel", "paral-ord"};
+  int                      i;
+  
+  
+  printf("EM-core%02i sched bursts (%s, latency target %i us):\n", em_core_id(),
+         sched_burst.adaptive ? "adaptive" : "fixed", em_internal_conf.conf.sched_latency_target_us);
+  
+  for(i = 0; i < SCHED_TYPES; i++)
+  {
+    const em_sched_burst_stats_t *const stats = &sched_burst.type[i].stats;
+    
+    printf("  %-9s burst:%2u revisit:%2u dequeues:%"PRIu64" full:%"PRIu64" objs:%"PRIu64"\n"
+           "            grow:%"PRIu64" shrink-fill:%"PRIu64" shrink-latency:%"PRIu64
+           " windows@8/16/32/64:%"PRIu64"/%"PRIu64"/%"PRIu64"/%"PRIu64"\n",
+           type_name[i], stats->burst, stats->revisit_max, stats->dequeues, stats->full, stats->objs,
+           stats->grow, stats->shrink_fill, stats->shrink_latency,
+           stats->windows[0], stats->windows[1], stats->windows[2], stats->windows[3]);
+  }
+}
 
-  uint64_t         sched_mask;
-  uint16_t         qidx_mask;  
 
-  int              ret, j;
-  int              q_count;
-  void* *const     q_ptr = bulk_dequeue_bufs.buf1;
-  void* *const     e_ptr = bulk_dequeue_bufs.buf2;
-  int              events_dispatched = 0; // Return value
 
-  
 
-  sched_idx  = sched_qs_info->sched_q_atomic_idx;
+/**
+ * Init the core local hybrid poll/sleep dispatch from em_conf_t
+ */
+static void
+dispatch_idle_init(void)
+{
+  const int idle_rounds = em_internal_conf.conf.dispatch_idle_rounds;
+  const int sleep_us    = em_internal_conf.conf.dispatch_sleep_us;
   
-  sched_mask = sched_masks->q_grp_mask;
-  qidx_mask  = sched_masks->qidx_mask[sched_idx];
   
-  qidx = sched_qs_info->atomic_qidx[sched_idx];
+  (void) memset(&dispatch_idle, 0, sizeof(dispatch_idle));
   
-  sched_q = sched_q_atomic[sched_idx].sched_q[qidx];
+  em_dispatch_idle_set((idle_rounds > 0) ? idle_rounds : 0, (sleep_us > 0) ? sleep_us : 0);
+}
 
 
 
-  /*
-   * Dequeue q_elems from the sched-queue. Use the same sched-q up to
-   * 'SCHED_Q_ATOMIC_CNT_MAX' times if there's a lot of events in this sched-q.
-   */
-  q_count = mring_dequeue_mp_burst(sched_q, q_ptr, MAX_Q_BULK_ATOMIC);
+/**
+ * Set the hybrid poll/sleep dispatch mode of the calling core (HW specific addition)
+ */
+void
+em_dispatch_idle_set(uint32_t idle_rounds, uint32_t sleep_us)
+{
+  dispatch_idle.idle_rounds  = idle_rounds;
+  dispatch_idle.sleep_us     = (sleep_us > 0) ? sleep_us : DISPATCH_SLEEP_US_DEFAULT;
+  dispatch_idle.empty_rounds = 0;
+  dispatch_idle.pause        = 1;
   
-
-  if((q_count != MAX_Q_BULK_ATOMIC) ||
-     (++(sched_qs_info->sched_q_atomic_cnt)) == SCHED_Q_ATOMIC_CNT_MAX) // 'expr2' evaluated only if 'expr1' is false
+  if(idle_rounds > 0)
   {
-      next_qidx = sched_q_get_next_qidx(qidx, qidx_mask);
-
-      IF_UNLIKELY(next_qidx <= qidx) // Wrap
-      {
-        sched_qs_info->sched_q_atomic_idx = sched_q_get_next_idx(sched_idx, sched_mask); // Increment core/thread local var
-      }
-
-      sched_qs_info->atomic_qidx[sched_idx] = next_qidx;
-      sched_qs_info->sched_q_atomic_cnt     = 0;
+    // Senders start checking for sleeping cores
+    em.shm->dispatch_sleep.enabled = 1;
+    env_mem_barrier();
   }
+}
 
 
-  if(q_count > 0)
-  {
-    PREFETCH_Q_ELEM(q_ptr[0]);    
 
+/**
+ * An empty scheduling round in the hybrid mode: keep polling for 'idle_rounds' rounds,
+ * then pause between the rounds for another 'idle_rounds' rounds and finally sleep.
+ */
+static void
+dispatch_idle_backoff(void)
+{
+  const uint32_t idle_rounds = dispatch_idle.idle_rounds;
+  const uint32_t empty       = ++dispatch_idle.empty_rounds;
+  uint32_t       i;
+  
+  
+  // Always poll (idle_rounds == 0) or still within the polling rounds
+  if((idle_rounds == 0) || (empty <= idle_rounds)) {
+    return;
+  }
+  
+  if(empty <= (2 * idle_rounds))
+  {
+    if(empty == (idle_rounds + 1)) {
+      dispatch_idle.pause = 1;
+    }
+    
+    for(i = 0; i < dispatch_idle.pause; i++) {
+      env_pause();
+    }
+    
+    if(dispatch_idle.pause < DISPATCH_PAUSE_MAX) {
+      dispatch_idle.pause *= 2;
+    }
+    
+    dispatch_idle.stats.pause_rounds++;
+    return;
+  }
+  
+  if(dispatch_idle_sleep() > 0) {
+    // Woken up by a send (or found work): poll again
+    dispatch_idle.empty_rounds = 0;
+  }
+  else {
+    // Timeout: poll once (Eth Rx, timer) and go back to sleep if still idle
+    dispatch_idle.empty_rounds = 2 * idle_rounds;
+  }
+}
 
-    for(j = 0; j < q_count; j++)
-    {
-      em_queue_element_t *const q_elem = q_ptr[j];
-      unsigned                  e_count;
 
 
-      //e_count = rte_ring_count(q_elem->rte_ring);
-      e_count = q_elem->u.atomic.event_count;
+/**
+ * Sleep until a send into one of the core's queue groups claims this core, or at most 'sleep_us'
+ *
+ * @return >0 if woken up by a send or events were dispatched, 0 on timeout
+ */
+static int
+dispatch_idle_sleep(void)
+{
+  dispatch_sleep_t      *const ds    = &em.shm->dispatch_sleep;
+  dispatch_sleep_core_t *const slot  = &ds->core[em_core_id()];
+  const uint64_t               start = env_get_cycle();
+  uint64_t                     now;
+  int32_t                      futex;
+  int                          events;
+  
+  
+  // Read the futex word before announcing the sleep: a waker claiming this core after 'sleeping'
+  // is set increments the word, which then differs from 'futex' and the wait returns at once
+  futex = slot->futex;
+  
+  slot->sleeping = 1;
+  
+  // Full barrier: either the senders see this core sleeping or the re-check below sees their events
+  (void) __sync_fetch_and_add(&ds->sleepers, 1);
+  
+#if SCHED_READY_HINTS == 1
+  // Make the re-check a rescan round, it must not depend on the ready hints
+  sched_core_local.sched_rounds |= (SCHED_READY_RESCAN_ROUNDS - 1);
+#endif
+  
+  // Re-check for events sent before the senders could see this core sleeping
+  events = em_schedule();
+  
+  if(events == 0) {
+    (void) env_futex_wait(&slot->futex, futex, dispatch_idle.sleep_us);
+  }
+  
+  (void) __sync_fetch_and_sub(&ds->sleepers, 1);
+  
+  if(__sync_bool_compare_and_swap(&slot->sleeping, 1, 0))
+  {
+    // Not claimed by a sender
+    if(events > 0) {
+      return events;
+    }
+    
+    dispatch_idle.stats.timeouts++;
+  }
+  else
+  {
+    const uint64_t wake_tsc = slot->wake_tsc;
+    
+    // Claimed by a sender, the wakeup time is valid once the sender has updated it
+    now = env_get_cycle();
+    
+    if((wake_tsc >= start) && (now >= wake_tsc))
+    {
+      const uint64_t latency = now - wake_tsc;
       
-      if(e_count > MAX_E_BULK_ATOMIC) {
-         e_count = MAX_E_BULK_ATOMIC;
-      }
-
-
-      ret = rte_ring_dequeue_bulk(q_elem->rte_ring, e_ptr, e_count);
-
-      IF_LIKELY(ret == 0)
-      {
-        unsigned i;
-
-        //
-        // Dispatch events
-        //
-        for(i = 0; i < e_count; i++)
-        {
-          em_event_t            event  = e_ptr[i];
-          ENV_PREFETCH(event);
-          em_event_hdr_t *const ev_hdr = event_to_event_hdr(event);
-
-          // Mark that this event was received from an atomic queue
-          ev_hdr->src_q_type = EM_QUEUE_TYPE_ATOMIC;
-
-          dispatch_event(q_elem, event, ev_hdr->event_type);
-        }
-        
-        events_dispatched += e_count;
-        
-        
-        // Prefetch next q_elem
-        if((j+1) < q_count) {
-          PREFETCH_Q_ELEM(q_ptr[j+1])
-        }
-        
-
-        //
-        // Update counters
-        //
-        
-#if LOCKLESS_ATOMIC_QUEUES == 1
-
-        int32_t new_count = __sync_sub_and_fetch(&q_elem->u.atomic.event_count, e_count);
-        
-        ret = 1;
-        
-        if(new_count > 0)
-        {
-          ret = mring_enqueue(sched_q, q_elem->priority, q_elem);
-        }
-        else
-        {
-          // Nothing currently to be scheduled, lets clear the sched_count using atomic cmpset
-          union {
-            struct {
-              int32_t sched_count, event_count;
-            };
-            uint64_t atomic_counts;
-          } expected_value = {{.sched_count = 1, .event_count = 0}};
-
-          // If cmpset fails, then someone has modified event_count (upwards) so reschedule the queue
-          if(!rte_atomic64_cmpset(&q_elem->u.atomic.atomic_counts_u64, expected_value.atomic_counts, 0))
-          {
-            ret = mring_enqueue(sched_q, q_elem->priority, q_elem);
-          }
-        }
-
-        IF_UNLIKELY(ret != 1) {
-          // Should never happen
-          (void) EM_INTERNAL_ERROR(EM_FATAL(EM_ERR_LIB_FAILED), EM_ESCOPE_SCHEDULE_ATOMIC,
-                                   "Atomic sched queue enqueue failed, ret=%i!", ret);
-        }          
-        
-#else // LOCKLESS_ATOMIC_QUEUES == 0
-
-        env_spinlock_lock(&q_elem->lock);
-
-        if(q_elem->u.atomic.event_count > e_count)
-        {
-          // Continue scheduling.
-          q_elem->u.atomic.event_count -= e_count;
-
-          // MULTI PRODUCER
-          // NOTE: Atomic context lost after this. Another core can schedule/dispatch.
-          ret = mring_enqueue(sched_q, q_elem->priority, q_elem);
-
-          IF_UNLIKELY(ret != 1) {
-            // Should never happen
-            (void) EM_INTERNAL_ERROR(EM_FATAL(EM_ERR_LIB_FAILED), EM_ESCOPE_SCHEDULE_ATOMIC,
-                                     "Atomic sched queue enqueue failed, ret=%i!", ret);
-          }
-        }
-        else
-        {
-          // Last event. Don't schedule any more.
-          q_elem->u.atomic.sched_count = 0;          
-          q_elem->u.atomic.event_count = 0;
-        }
-
-        env_spinlock_unlock(&q_elem->lock);
-        
-#endif // #if LOCKLESS_ATOMIC_QUEUES == 1
-
-      }
-      else {
-        // Should never happen
-       (void) EM_INTERNAL_ERROR(EM_FATAL(EM_ERR_LIB_FAILED), EM_ESCOPE_SCHEDULE_ATOMIC,
-                                "Schedulable ATOMIC queue found but NO EVENTS in queue, ret=%i", ret);
+      dispatch_idle.stats.wake_cycles += latency;
+      
+      if(latency > dispatch_idle.stats.wake_cycles_max) {
+        dispatch_idle.stats.wake_cycles_max = latency;
       }
     }
+    
+    dispatch_idle.stats.wakeups++;
+    events = 1;
   }
-
-
-  return events_dispatched;
+  
+  dispatch_idle.stats.sleeps++;
+  dispatch_idle.stats.sleep_cycles += env_get_cycle() - start;
+  
+  return events;
 }
 
 
 
 /**
- * Select and schedule events from a parallel scheduling queue.
- *
- * The scheduling queues contain events in this case (cmp to atomic or parallel-ordered sched queues).
+ * After a successful send: wake up a sleeping core of the destination queue group, if any
  */
-static inline int
-em_schedule_parallel(sched_q_parallel_t           sched_q_parallel[],
-                     sched_qs_info_local_t *const sched_qs_info,
-                     sched_type_mask_t     *const sched_masks)
+static inline void
+dispatch_idle_wake_check(const em_queue_group_t group)
 {
-  struct multiring   *sched_q;
-
-  uint32_t            sched_idx;
-  uint16_t            qidx, next_qidx;
-
-  uint64_t            sched_mask;
-  uint16_t            qidx_mask;
-
-  int                 ev_hdr_count;
-  void* *const        ev_hdr_ptr        = bulk_dequeue_bufs.buf;
-  int                 events_dispatched = 0; // Return value
-
-
-
-  sched_idx = sched_qs_info->sched_q_parallel_idx;
-
-  sched_mask = sched_masks->q_grp_mask;
-  qidx_mask  = sched_masks->qidx_mask[sched_idx];
+  dispatch_sleep_t *const ds = &em.shm->dispatch_sleep;
   
-  qidx = sched_qs_info->parallel_qidx[sched_idx];
   
-  sched_q = sched_q_parallel[sched_idx].sched_q[qidx];
-
-
-  /*
-   * Get the number of events in the scheduling queue. Use the same sched-q up to
-   * 'SCHED_Q_PARALLEL_CNT_MAX' times if there's a lot of events in this sched-q.
-   */
-
-  ev_hdr_count = mring_dequeue_mp_burst(sched_q, ev_hdr_ptr, MAX_E_BULK_PARALLEL);
-
-  if((ev_hdr_count != MAX_E_BULK_PARALLEL) ||
-     (++(sched_qs_info->sched_q_parallel_cnt)) == SCHED_Q_PARALLEL_CNT_MAX) // 'expr2' evaluated only if 'expr1' is false
+  IF_UNLIKELY(ds->enabled)
   {
-      next_qidx = sched_q_get_next_qidx(qidx, qidx_mask);
-
-      IF_UNLIKELY(next_qidx <= qidx) // Wrap
-      {
-        sched_qs_info->sched_q_parallel_idx = sched_q_get_next_idx(sched_idx, sched_mask);
-      }
-
-      sched_qs_info->parallel_qidx[sched_idx] = next_qidx;
-      sched_qs_info->sched_q_parallel_cnt     = 0;
+    // The enqueue must be visible before reading the sleeper count (pairs with the sleeper's atomic increment)
+    env_mem_barrier();
+    
+    IF_UNLIKELY(ds->sleepers > 0) {
+      dispatch_idle_wake(group);
+    }
   }
+}
 
 
 
-  if(ev_hdr_count > 0) // Event hdrs dequeued:
+/**
+ * Claim and wake up one sleeping core of the queue group
+ */
+static void
+dispatch_idle_wake(const em_queue_group_t group)
+{
+  dispatch_sleep_t     *const ds    = &em.shm->dispatch_sleep;
+  const em_core_mask_t *const mask  = &em.shm->em_queue_group[group].mask;
+  const int                   self  = em_core_id();
+  const int                   count = em_core_count();
+  int                         core;
+  
+  
+  for(core = 0; core < count; core++)
   {
-    em_event_hdr_t     *ev_hdr;
-    em_queue_element_t *q_elem;
-    em_event_t          event;
-    int                 i;
+    dispatch_sleep_core_t *const slot = &ds->core[core];
+    
+    if(slot->sleeping && (core != self) && em_core_mask_isset(core, mask) &&
+       __sync_bool_compare_and_swap(&slot->sleeping, 1, 0))
+    {
+      slot->wake_tsc = env_get_cycle();
+      
+      (void) __sync_fetch_and_add(&slot->futex, 1);
+      (void) env_futex_wake(&slot->futex, 1);
+      return;
+    }
+  }
+}
 
 
-    for(i = 0; i < ev_hdr_count; i++)
-    {
-      ev_hdr = ev_hdr_ptr[i];
-      q_elem = ev_hdr->q_elem;
 
-      PREFETCH_Q_ELEM(q_elem);
-    }
+/**
+ * Read the hybrid poll/sleep dispatch counters of the calling core (HW specific addition)
+ */
+void
+em_dispatch_idle_stats(em_dispatch_idle_stats_t *const stats)
+{
+  *stats = dispatch_idle.stats;
+}
 
 
-    for(i = 0; i < ev_hdr_count; i++)
-    {
-      ev_hdr = ev_hdr_ptr[i];
-      q_elem = ev_hdr->q_elem;
-      event  = event_hdr_to_event(ev_hdr);
 
-      ev_hdr->src_q_type = EM_QUEUE_TYPE_PARALLEL;
+/**
+ * Print the hybrid poll/sleep dispatch counters of the calling core (HW specific addition)
+ */
+void
+em_dispatch_idle_stats_print(void)
+{
+  const em_dispatch_idle_stats_t *const stats = &dispatch_idle.stats;
+  const uint64_t                        mhz   = env_core_mhz();
+  
+  
+  printf("EM-core%02i dispatch idle (rounds %u, sleep %u us):\n", em_core_id(),
+         dispatch_idle.idle_rounds, dispatch_idle.sleep_us);
+  
+  printf("  pause-rounds:%"PRIu64" sleeps:%"PRIu64" wakeups:%"PRIu64" timeouts:%"PRIu64" slept:%"PRIu64" us\n"
+         "  wakeup latency avg:%"PRIu64" ns max:%"PRIu64" ns\n",
+         stats->pause_rounds, stats->sleeps, stats->wakeups, stats->timeouts,
+         (mhz > 0) ? (stats->sleep_cycles / mhz) : 0,
+         ((mhz > 0) && (stats->wakeups > 0)) ? ((stats->wake_cycles * 1000) / (mhz * stats->wakeups)) : 0,
+         (mhz > 0) ? ((stats->wake_cycles_max * 1000) / mhz) : 0);
+}
 
-      dispatch_event(q_elem, event, ev_hdr->event_type);
-    }
 
-    events_dispatched += ev_hdr_count;
-  }
 
 
-  return events_dispatched;
+/**
+ * Poll Eth Rx and the event timer and schedule events to the core
+ *
+ * @return Number of events (or atomic queues) dispatched
+ */
+int
+em_schedule(void)
+{
+  return em_schedule__budget(0, 0);
 }
 
 
 
 /**
- * Select and schedule events from a parallel-ordered scheduling queue.
- *
- * The scheduling queues contain event-headers (not directly events).
- * Event headers are stored in Order-Queues before dispatch to EO processing.
- * The order-queues maintain event input order for the output.
+ * em_schedule() with limits for em_dispatch_ex(): the scheduling rounds needed for the
+ * core's own sends stop when the core cycle counter reaches 'cycle_end' or 'max_events'
+ * events have been dispatched (0 = no limit).
  */
 static inline int
-em_schedule_parallel_ordered(sched_q_parallel_ord_t       sched_q_parallel_ord[],
-                             sched_qs_info_local_t *const sched_qs_info,
-                             sched_type_mask_t     *const sched_masks)
+em_schedule__budget(const uint64_t cycle_end, const uint64_t max_events)
 {
-  struct multiring *sched_q;
+  int events_dispatched;
+  int events_total = 0;
   
-  uint32_t          sched_idx, next_sched_idx;
-  uint16_t          qidx, next_qidx, save_qidx;
-  uint16_t          count;
-
-  uint64_t          sched_mask;
-  uint16_t          qidx_mask;  
   
-  env_spinlock_t   *lock;
-  int               ev_hdr_count;
-  void* *const      ev_hdr_ptr        = bulk_dequeue_bufs.buf;
-  int               events_dispatched = 0; // Return value
-
-
+  #ifdef EVENT_PACKET
+  if(em_internal_conf.conf.pkt_io)
+  {
+    /*
+     * Poll for Eth frames and enqueue.
+     */
+    em_eth_rx_packets();
+  }
+  #endif
+  
 
-  sched_mask = sched_masks->q_grp_mask;
+  do {
+    
+    #ifdef EVENT_TIMER
+    if(em_internal_conf.conf.evt_timer)
+    {
+      /*
+       * Manage the event timer.
+       */
+      evt_timer_manage();
+    }
+    #endif
+    
+    
+    /*
+     * Schedule & dispatch.
+     */
+    events_dispatched = em_schedule_queues();
 
-  /*
-   * Instead of busy-waiting for a lock, try-locks instead.
-   * Return on empty queue to be fair to atomic and parallel queue scheduling.
-   */
 
-  next_sched_idx = sched_qs_info->sched_q_parallel_ord_idx;
+    #ifdef EVENT_PACKET
+    if(em_internal_conf.conf.pkt_io)
+    {
+      /*
+       * Transmit Eth frames that have been in the output buffers for "too long".
+       */
+      em_eth_tx_packets_timed();
+    }
+    #endif        
+    
+    
+    /* 
+     * Approximate for the need for additional schduling rounds before new Eth-Rx events.
+     * Note: the approx is core-local and does not take into account what the other cores do.
+     */
+    if(events_dispatched == 0) {
+      break;
+    }
+    else {
+      sched_core_local.events_enqueued -= events_dispatched;
+      events_total += events_dispatched;
+    }
+    
+    if((max_events != 0) && ((uint64_t) events_total >= max_events)) {
+      break;
+    }
+    
+    if((cycle_end != 0) && (env_get_cycle() >= cycle_end)) {
+      break;
+    }
+    
+  } while(sched_core_local.events_enqueued > 0);
   
-  next_qidx      = sched_qs_info->parallel_ord_qidx[next_sched_idx];
-  count          = sched_qs_info->sched_q_parallel_ord_cnt;
   
+  /* Reset count for the next round */
+  sched_core_local.events_enqueued = 0;
   
-  do {
-    do {
-      sched_idx =  next_sched_idx;
-      qidx      =  next_qidx;
-
-      lock      = &sched_q_parallel_ord[sched_idx].locks[qidx].lock;
-      ENV_PREFETCH(lock);            
-      sched_q   =  sched_q_parallel_ord[sched_idx].sched_q[qidx];
-
-      sched_qs_info->sched_q_parallel_ord_cnt = count;
-      qidx_mask =  sched_masks->qidx_mask[sched_idx];
-
-      
-      next_qidx = sched_q_get_next_qidx(qidx, qidx_mask);
-      save_qidx = next_qidx;
-      count     = 0;
+  return events_total;
+}
 
-      IF_UNLIKELY(next_qidx <= qidx) // Wrap
-      {
-        next_sched_idx = sched_q_get_next_idx(sched_idx, sched_mask);
-        next_qidx      = sched_qs_info->parallel_ord_qidx[next_sched_idx];
-      }
-      
 
-      /* Avoid accessing the spinlock if there are no events */
-      IF_UNLIKELY(mring_empty(sched_q))
-      {
-        sched_qs_info->sched_q_parallel_ord_idx          = next_sched_idx;
-        sched_qs_info->parallel_ord_qidx[next_sched_idx] = next_qidx;
-        sched_qs_info->parallel_ord_qidx[sched_idx]      = save_qidx;
-        sched_qs_info->sched_q_parallel_ord_cnt          = 0;
-        return (0);
-      }
 
-    } while(env_spinlock_is_locked(lock));
 
-  } while(!env_spinlock_trylock(lock));
+static inline int
+em_schedule_queues(void)
+{
+  int ev_a = 0, ev_p = 0, ev_po = 0;
 
-  /* Lock Taken - continue */
+  sched_qs_t            *const sched_qs_ptr  = &em.shm->sched_qs_prio;
+  sched_qs_info_local_t *const sched_qs_info = &sched_core_local.sched_qs_info;
+  sched_masks_t         *const sched_masks   = &sched_core_local.sched_masks->sched_masks_prio;
+  sched_ready_hints_t   *ready_hints         = NULL;
 
 
-  ev_hdr_count = mring_dequeue_mp_burst(sched_q, ev_hdr_ptr, MAX_E_BULK_PARALLEL_ORD);
+#if SCHED_READY_HINTS == 1
+  // Poll only the scheduling queues marked ready. The hints are advisory, every SCHED_READY_RESCAN_ROUNDS:th
+  // round first re-marks all non-empty scheduling queues the core serves - a missed hint must not strand events.
+  ready_hints = &em.shm->sched_ready_hints;
   
-  if((ev_hdr_count < MAX_E_BULK_PARALLEL_ORD) ||
-     ((++(sched_qs_info->sched_q_parallel_ord_cnt)) == SCHED_Q_PARALLEL_ORD_CNT_MAX)) // 'expr2' evaluated only if 'expr1' is false
-  {
-      sched_qs_info->sched_q_parallel_ord_idx          = next_sched_idx;
-      sched_qs_info->parallel_ord_qidx[next_sched_idx] = next_qidx;
-      sched_qs_info->sched_q_parallel_ord_cnt          = 0;
-
-      IF_UNLIKELY(ev_hdr_count == 0)
-      {
-        // No event-hdrs - return
-        env_spinlock_unlock(lock);
-        return (0);
-      }
+  IF_UNLIKELY(((++sched_core_local.sched_rounds) & (SCHED_READY_RESCAN_ROUNDS - 1)) == 0) {
+    sched_ready_rescan(ready_hints, sched_qs_ptr, sched_masks);
   }
+#endif
 
 
-
-  if(ev_hdr_count > 0)
+  // Strict priority: serve the highest priority events over all queue groups & types first.
+  // Fall back to the normal round-robin scheduling if no hinted events were found.
+  IF_UNLIKELY(em_internal_conf.conf.sched_strict_prio)
   {
-#if PARALLEL_ORDERED__USE_SCHED_Q_LOCKS == 1 // Optional
-    int  i;
-
-    /*
-     * Record/store event order before dispatch to be able to
-     * restore order after parallel processing
-     */
-    for(i = 0; i < ev_hdr_count; i++)
-    {
-      em_event_hdr_t     *const ev_hdr = ev_hdr_ptr[i];
-      em_queue_element_t *const q_elem = ev_hdr->q_elem;
-
-      (void) parallel_ordered_maintain_order(ev_hdr, q_elem, lock);
+    const int ev = em_schedule_strict_prio();
+    
+    if(ev > 0) {
+      return ev;
     }
-#else // Default
-    /*
-     * Maintain queue order.
-     * Try to minimize the spinlock lock/unlock calls for events belonging to the same queue.
-     */
-    em_event_hdr_t     *ev_hdr   =  ev_hdr_ptr[0];
-    em_queue_element_t *q_elem   =  ev_hdr->q_elem;
-    env_spinlock_t     *q_lock   = &q_elem->lock;
-    env_spinlock_t     *tmp_lock =  q_lock;
-    int                 i        =  0;
-
-    env_spinlock_lock(q_lock);
-
-    do
-    {
-      ev_hdr = ev_hdr_ptr[i];
-      q_elem = ev_hdr->q_elem;
-      q_lock = &q_elem->lock;
-
-
-      if(q_lock != tmp_lock) {
-        env_spinlock_unlock(tmp_lock);
-        env_spinlock_lock(q_lock);
-        tmp_lock = q_lock;
-      }
-
-      (void) parallel_ordered_maintain_order(ev_hdr, q_elem, q_lock);
-
-      i++;
-    } while(i < ev_hdr_count);
+  }
+  
 
-    env_spinlock_unlock(q_lock);
+  // Cache-affine atomic scheduling: serve the atomic queues this core stashed during the previous rounds first
+  if(sched_sticky.head != sched_sticky.tail) {
+    ev_a = sched_sticky_serve();
+  }
 
-    /********/
-#endif
 
+  if(!group_mask_iszero(&sched_masks->atomic_masks.q_grp_mask))
+  {
+    ev_a += em_schedule_atomic(sched_qs_ptr->sched_q_atomic,
+                              sched_qs_info,
+                             &sched_masks->atomic_masks,
+                              ready_hints ? &ready_hints->ready[SCHED_TYPE_ATOMIC] : NULL);
+  }
 
-    /* Unlock the Scheduling-Queue lock */
-    env_spinlock_unlock(lock);
 
+  if(!group_mask_iszero(&sched_masks->parallel_masks.q_grp_mask))
+  {
+    ev_p = em_schedule_parallel(sched_qs_ptr->sched_q_parallel,
+                                sched_qs_info,
+                               &sched_masks->parallel_masks,
+                                ready_hints ? &ready_hints->ready[SCHED_TYPE_PARALLEL] : NULL);
+  }
 
-    /*
-     * Dispatch - parallel processing
-     */
-    for(i = 0; i < ev_hdr_count; i++)
-    {
-      em_event_hdr_t     *const ev_hdr = ev_hdr_ptr[i];
-      em_queue_element_t *const q_elem = ev_hdr->q_elem;
-      // PREFETCH_Q_ELEM(q_elem);
-      em_event_t                event  = event_hdr_to_event(ev_hdr);
 
-      dispatch_event(q_elem, event, ev_hdr->event_type);
-    }
+  if(!group_mask_iszero(&sched_masks->parallel_ord_masks.q_grp_mask))
+  {
+    ev_po = em_schedule_parallel_ordered(sched_qs_ptr->sched_q_parallel_ord,
+                                         sched_qs_info,
+                                        &sched_masks->parallel_ord_masks,
+                                         ready_hints ? &ready_hints->ready[SCHED_TYPE_PARALLEL_ORD] : NULL);
+  }
 
-    events_dispatched += ev_hdr_count;
 
-  }
-  else {
-    env_spinlock_unlock(lock);
+  // Nothing to do on this core: take work from the core local queue groups of busy cores
+  IF_UNLIKELY(((ev_a + ev_p + ev_po) == 0) && (sched_steal.policy != EM_SCHED_STEAL_OFF)) {
+    return sched_steal_events();
   }
 
 
-  return events_dispatched;
+  return (ev_a + ev_p + ev_po);
 }
 
 
 
 /**
- * Helper function to maintain order in parallel-ordered queues.
- * Call must be serialized by spinlock 'lock'.
+ * Init the core local work stealing from em_conf_t
  */
-static inline em_status_t
-parallel_ordered_maintain_order(em_event_hdr_t     *const ev_hdr,
-                                em_queue_element_t *const q_elem,
-                                env_spinlock_t     *const lock)
+static void
+sched_steal_init(void)
 {
-  int ret;
-
-
-  PREFETCH_RTE_RING(q_elem->rte_ring);
-
-  // Needed in em_send for re-ordering
-  ev_hdr->src_q_type      = EM_QUEUE_TYPE_PARALLEL_ORDERED;
-  ev_hdr->lock_p          = lock;
-  ev_hdr->processing_done = 0;
-  ev_hdr->dst_q_elem      = NULL;
-
-  if(q_elem->u.parallel_ord.order_first == NULL) {
-    q_elem->u.parallel_ord.order_first = ev_hdr;
+  const int policy    = em_internal_conf.conf.sched_steal;
+  const int threshold = em_internal_conf.conf.sched_steal_threshold;
+  
+  
+  (void) memset(&sched_steal, 0, sizeof(sched_steal));
+  
+  if((policy == EM_SCHED_STEAL_PARALLEL) || (policy == EM_SCHED_STEAL_ATOMIC)) {
+    sched_steal.policy = policy;
   }
   else {
-    // Order-Queue
-    ret = rte_ring_enqueue(q_elem->rte_ring, ev_hdr);
-
-    IF_UNLIKELY(ret) {
-      /* On enqueue-error: clear the src_q_type=EM_QUEUE_TYPE_PARALLEL_ORDERED
-       * to avoid never being sent if em_send() is called.
-       * Order is lost for this event however...
-       */
-      if(ret == (-ENOBUFS))
-      {
-        ev_hdr->src_q_type = EM_QUEUE_TYPE_UNDEF;
-        
-        return EM_ERR_LIB_FAILED;
-        //(void) EM_INTERNAL_ERROR(EM_ERR_LIB_FAILED, EM_ESCOPE_PARALLEL_ORDERED_MAINTAIN_ORDER,
-        //                         "Order-queue enequeue failed, ret=%i", ret);
-      }
-    }
+    sched_steal.policy = EM_SCHED_STEAL_OFF;
   }
   
-  return EM_OK;
+  sched_steal.threshold = (threshold > 0) ? threshold : SCHED_STEAL_THRESHOLD_DEFAULT;
+  sched_steal.victim    = em_core_id() + 1;
 }
 
 
 
-
 /**
- * Return the index of the next set bit in group_mask.
+ * Steal work from the core local queue groups of the other cores, check at most
+ * SCHED_STEAL_VICTIMS cores per call.
  *
- * @param curr_idx    Index of the last used sched_q-obj
- * @param group_mask  Mask bits represent sched_q-objs that should be polled
+ * Only the core local queue groups are stolen from: they are never deleted, so their
+ * scheduling queues stay valid although this core has no scheduling masks for them.
+ *
+ * @return Number of events dispatched
  */
-static inline uint32_t
-sched_q_get_next_idx(const uint32_t curr_idx, const uint64_t group_mask)
+static int
+sched_steal_events(void)
 {
-  uint32_t next_idx, tmp_idx;
-  uint64_t tmp_mask1, tmp_mask2;
-
-
-  // Example: curr_idx=5 => bit(5+1) => 01000000 => -1 => 00111111 => ~ => 11000000
-  tmp_mask1 = ~(((uint64_t)(1 << ((curr_idx + 1) & SCHED_QS_MASK))) - 1);
-  // clear bit for current index and lower
-  tmp_mask2 = group_mask & tmp_mask1;
-
-  if(tmp_mask2 == 0) {
-    tmp_mask2 = group_mask;
-  }
-
-  // Returns one plus the index of the least significant 1-bit of x, or if x is zero, returns zero.
-  tmp_idx  = (uint32_t) __builtin_ffsl(tmp_mask2);
-
-  next_idx = likely(tmp_idx > 0) ? (tmp_idx - 1) : 0;
-
-  return next_idx;
-}
-
-
+  const int count = em_core_count();
+  const int self  = em_core_id();
+  int       victim, i;
+  int       events = 0;
+  
+  
+  sched_steal.stats.attempts++;
+  
+  victim = sched_steal.victim;
+  
+  for(i = 0; (i < SCHED_STEAL_VICTIMS) && (i < count); i++, victim++)
+  {
+    em_queue_group_t group;
+    
+    
+    if(victim >= count) {
+      victim = 0;
+    }
+    
+    if(victim == self) {
+      continue;
+    }
+    
+    group  = em.shm->core_local_group[victim];
+    
+    events = sched_steal_parallel(group);
+    
+    if((events == 0) && (sched_steal.policy == EM_SCHED_STEAL_ATOMIC)) {
+      events = sched_steal_atomic(group);
+    }
+    
+    if(events > 0)
+    {
+      sched_steal.stats.steals++;
+      sched_steal.stats.events += events;
+      break; // Check the same core first next time
+    }
+  }
+  
+  sched_steal.victim = victim;
+  
+  return events;
+}
+
 
 
 /**
- * Return the index of the next set bit in the mask
- * 
- * @param curr_idx  Index of the last used sched-queue inside a sched_q-obj
- * @param mask      Mask bits represent sched-qs in a specific sched_q-obj that should be polled
+ * Steal at most half of the events in the parallel scheduling queue of a core local queue group
  */
-static inline uint16_t
-sched_q_get_next_qidx(const uint16_t curr_idx, const uint16_t mask)
+static inline int
+sched_steal_parallel(const em_queue_group_t group)
 {
-  uint16_t next_idx, tmp_idx;
-  uint16_t tmp_mask1, tmp_mask2;
-
-
-  // Example: curr_idx=5 => bit(5+1) => 01000000 => -1 => 00111111 => ~ => 11000000
-  tmp_mask1 = ~(((uint16_t)(1 << ((curr_idx + 1) & 0xF))) - 1);
-  // clear bit for current index and lower
-  tmp_mask2 = mask & tmp_mask1;
-
-  if(tmp_mask2 == 0) {
-    tmp_mask2 = mask;
+  struct multiring *const sched_q    = em.shm->sched_qs_prio.sched_q_parallel[group].sched_q[0];
+  void*            *const ev_hdr_ptr = bulk_dequeue_bufs.buf;
+  unsigned                queued;
+  int                     burst;
+  int                     ev_hdr_count;
+  
+  
+  if(sched_q == NULL) {
+    return 0; // No parallel queues in the group
   }
-
-  // Returns one plus the index of the least significant 1-bit of x, or if x is zero, returns zero.
-  tmp_idx  = (uint16_t) __builtin_ffsl(tmp_mask2);
-
-  next_idx = likely(tmp_idx > 0) ? (tmp_idx - 1) : 0;
-
-  return next_idx;
+  
+  queued = mring_count(sched_q);
+  
+  if(queued < sched_steal.threshold) {
+    return 0;
+  }
+  
+  // Largest supported burst within half of the backlog, the owner keeps the rest
+  burst = SCHED_BURST_MIN;
+  
+  while(((unsigned) (2 * burst) <= (queued / 2)) && (burst < SCHED_BURST_MAX)) {
+    burst *= 2;
+  }
+  
+  ev_hdr_count = mring_dequeue_mp_burst(sched_q, ev_hdr_ptr, burst);
+  
+  return schedule_parallel_dispatch(ev_hdr_ptr, ev_hdr_count);
 }
 
 
 
-
-
 /**
- * Set bits in the masks used by the scheduler.
- * Triggered by a call to em_queue_enable(_all).
+ * Steal one atomic queue from the atomic scheduling queue of a core local queue group, if the
+ * owner has more ready atomic queues. EM internal queues must be served by their own core and
+ * are put back.
  */
-em_status_t
-sched_masks_add_queue(const em_queue_t       queue,
-                      const em_queue_type_t  type,
-                      const em_queue_group_t group)
+static inline int
+sched_steal_atomic(const em_queue_group_t group)
 {
-  em_status_t        err;
-  em_core_mask_t     core_mask;
-  int                core_count;
-  int                core;
-  uint16_t           count, qidx_count;
-  uint64_t           qidx;
-  uint16_t           qidx_mask_bit;
-
-
-  err = em_queue_group_mask(group, &core_mask);
+  struct multiring   *const sched_q = em.shm->sched_qs_prio.sched_q_atomic[group].sched_q[0];
+  void*              *const q_ptr   = bulk_dequeue_bufs.buf1;
+  em_queue_element_t       *q_elem;
+  int                       prio;
   
-  RETURN_ERROR_IF(err != EM_OK, err, EM_ESCOPE_SCHED_MASKS_ADD,
-                  "em_queue_group_mask(group=%"PRI_QGRP", core_mask=%"PRIX64") returns %u",
-                   group, core_mask.u64, err);
-
-
-  RETURN_ERROR_IF(em_core_mask_iszero(&core_mask), EM_FATAL(EM_ERR_BAD_ID), EM_ESCOPE_SCHED_MASKS_ADD,
-                  "em_queue_group_mask(group=%"PRI_QGRP", core_mask=%"PRIX64") is zero!",
-                   group, core_mask.u64);
-
-  core_count = em_core_count();
-
-
-  env_spinlock_lock(&em.shm->sched_add_counts_lock.lock);
   
-  // printf("%s(): Core:%02i QGrp:%"PRI_QGRP" CoreMask:%"PRIX64"\n", __func__, em_core_id(), group, core_mask.u64[0]); fflush(NULL);
-
-  for(core = 0; core < core_count; core++)
+  if((sched_q == NULL) || (mring_count(sched_q) < SCHED_STEAL_ATOMIC_MIN)) {
+    return 0;
+  }
+  
+  for(prio = (NUM_PRIORITIES - 1); prio >= 0; prio--)
   {
-    if(em_core_mask_isset(core, &core_mask))
-    {
-      if(type == EM_QUEUE_TYPE_ATOMIC)
-      {
-        sched_q_atomic_t *const sched_q_obj = &em.shm->sched_qs_prio.sched_q_atomic[group];
-          
-        qidx = queue & (sched_q_obj->queue_mask);        
-        
-        qidx_count = em.shm->core_sched_add_counts[core].add_count.atomic_add_cnt[group].qidx_cnt[qidx];
-        em.shm->core_sched_add_counts[core].add_count.atomic_add_cnt[group].qidx_cnt[qidx] = qidx_count + 1;
-        
-        if(qidx_count == 0)
-        {
-          qidx_mask_bit = (uint16_t) (1 << qidx);
-          
-          // Set the bit QIDX bit, i.e. enable scheduling for the FIFO that the EM-queue is scheduled through
-          em.shm->core_sched_masks[core].sched_masks_prio.atomic_masks.qidx_mask[group] |= qidx_mask_bit;
-        }
-        
-        // Increase the queue count for this sched object
-        count = em.shm->core_sched_add_counts[core].add_count.atomic_add_cnt[group].q_grp_cnt;
-        em.shm->core_sched_add_counts[core].add_count.atomic_add_cnt[group].q_grp_cnt = count + 1;        
-        
-        if(count == 0)
-        {
-          // Set the mask bit for this sched object, i.e. enable scheduling for this type,group
-          group_mask_set(&em.shm->core_sched_masks[core].sched_masks_prio.atomic_masks.q_grp_mask, group);
-        }
-        
-      }
-      else if(type == EM_QUEUE_TYPE_PARALLEL)
-      {
-        sched_q_parallel_t *const sched_q_obj = &em.shm->sched_qs_prio.sched_q_parallel[group];
-          
-        qidx = queue & (sched_q_obj->queue_mask);        
-        
-        qidx_count = em.shm->core_sched_add_counts[core].add_count.parallel_add_cnt[group].qidx_cnt[qidx];
-        em.shm->core_sched_add_counts[core].add_count.parallel_add_cnt[group].qidx_cnt[qidx] = qidx_count + 1;
-        
-        if(qidx_count == 0)
-        {        
-          qidx_mask_bit = (uint16_t) (1 << qidx);
-          
-          // Set the bit QIDX bit, i.e. enable scheduling for the FIFO that the EM-queue is scheduled through
-          em.shm->core_sched_masks[core].sched_masks_prio.parallel_masks.qidx_mask[group] |= qidx_mask_bit;
-        }
-        
-        // Increase the queue count for this sched object
-        count = em.shm->core_sched_add_counts[core].add_count.parallel_add_cnt[group].q_grp_cnt;
-        em.shm->core_sched_add_counts[core].add_count.parallel_add_cnt[group].q_grp_cnt = count + 1;
-
-        if(count == 0) 
-        {
-          // Set the mask bit for this sched object, i.e. enable scheduling for this type,group
-          group_mask_set(&em.shm->core_sched_masks[core].sched_masks_prio.parallel_masks.q_grp_mask, group);
-        }
-
-      }
-      else if(type == EM_QUEUE_TYPE_PARALLEL_ORDERED)
-      {
-        sched_q_parallel_ord_t *const sched_q_obj = &em.shm->sched_qs_prio.sched_q_parallel_ord[group];
-
-        qidx = queue & (sched_q_obj->queue_mask);
-        
-        qidx_count = em.shm->core_sched_add_counts[core].add_count.parallel_ord_add_cnt[group].qidx_cnt[qidx];
-        em.shm->core_sched_add_counts[core].add_count.parallel_ord_add_cnt[group].qidx_cnt[qidx] = qidx_count + 1;
-        
-        if(qidx_count == 0)
-        {                
-          qidx_mask_bit = (uint16_t) (1 << qidx);
-
-          // Set the bit QIDX bit, i.e. enable scheduling for the FIFO that the EM-queue is scheduled through
-          em.shm->core_sched_masks[core].sched_masks_prio.parallel_ord_masks.qidx_mask[group] |= qidx_mask_bit;
-        }
-
-        // Increase the queue count for this sched object
-        count = em.shm->core_sched_add_counts[core].add_count.parallel_ord_add_cnt[group].q_grp_cnt;
-        em.shm->core_sched_add_counts[core].add_count.parallel_ord_add_cnt[group].q_grp_cnt = count + 1;
-
-        if(count == 0)
-        {
-          // Set the mask bit for this sched object, i.e. enable scheduling for this type,group
-          group_mask_set(&em.shm->core_sched_masks[core].sched_masks_prio.parallel_ord_masks.q_grp_mask, group);
-        }
-
-      }
-      else
-      {
-        env_spinlock_unlock(&em.shm->sched_add_counts_lock.lock);
-        
-        return EM_INTERNAL_ERROR(EM_ERR_NOT_FOUND, EM_ESCOPE_SCHED_MASKS_ADD,
-                                 "Unknown EM-queue type (%u)", type);
-      }
-
+    if(!mring_empty_prio(sched_q, prio) && (mring_dequeue(sched_q, prio, &q_ptr[0]) == 1)) {
+      break;
     }
-  } // for(;;)
+  }
+  
+  if(prio < 0) {
+    return 0;
+  }
+  
+  q_elem = q_ptr[0];
+  
+  IF_UNLIKELY((q_elem->id >= FIRST_INTERNAL_QUEUE) && (q_elem->id <= LAST_INTERNAL_QUEUE))
+  {
+    (void) sched_q_enqueue(sched_q, SCHED_TYPE_ATOMIC, q_elem, q_elem);
+    sched_steal.stats.put_back++;
+    return 0;
+  }
+  
+  sched_steal.stats.atomic_queues++;
+  
+  return schedule_atomic_dispatch(q_ptr, 1, sched_q);
+}
 
 
-  env_spinlock_unlock(&em.shm->sched_add_counts_lock.lock);
 
-  return EM_OK;
+/**
+ * Read the work stealing counters of the calling core (HW specific addition)
+ */
+void
+em_sched_steal_stats(em_sched_steal_stats_t *const stats)
+{
+  *stats = sched_steal.stats;
 }
 
 
 
 /**
- * Clear bits in the masks used by the scheduler.
- * Triggered by a call to em_queue_disable(_all)
+ * Print the work stealing counters of the calling core (HW specific addition)
  */
-em_status_t
-sched_masks_rem_queue(const em_queue_t       queue,
-                      const em_queue_type_t  type,
-                      const em_queue_group_t group)
+void
+em_sched_steal_stats_print(void)
 {
-  em_status_t        err;
-  em_core_mask_t     core_mask;
-  int                core_count;
-  int                core;
-  uint16_t           count, qidx_count;
-  uint64_t           qidx;
-  uint16_t           qidx_mask_bit;
+  const em_sched_steal_stats_t *const stats = &sched_steal.stats;
+  
+  
+  printf("EM-core%02i work stealing (policy %i, threshold %u):\n", em_core_id(), sched_steal.policy, sched_steal.threshold);
+  
+  printf("  attempts:%"PRIu64" steals:%"PRIu64" events:%"PRIu64" atomic-queues:%"PRIu64" put-back:%"PRIu64"\n",
+         stats->attempts, stats->steals, stats->events, stats->atomic_queues, stats->put_back);
+}
 
 
-  err = em_queue_group_mask(group, &core_mask);
 
-  RETURN_ERROR_IF(err != EM_OK, err, EM_ESCOPE_SCHED_MASKS_REM,
-                  "em_queue_group_mask(group=%"PRI_QGRP", core_mask=%"PRIX64") returns %u",
-                   group, core_mask.u64, err);
+/**
+ * Init the core local cache-affine atomic scheduling from em_conf_t
+ */
+static void
+sched_sticky_init(void)
+{
+  const int max_bursts = em_internal_conf.conf.sched_atomic_sticky;
+  
+  
+  (void) memset(&sched_sticky, 0, sizeof(sched_sticky));
+  
+  sched_sticky.max_bursts = (max_bursts > 0) ? max_bursts : 0;
+  
+  // Strict priority order over all queue groups wins, a stashed queue could bypass higher priorities
+  IF_UNLIKELY(em_internal_conf.conf.sched_strict_prio && (sched_sticky.max_bursts != 0))
+  {
+    printf("%s(): Cache-affine atomic scheduling not used with strict priority scheduling\n", __func__);
+    sched_sticky.max_bursts = 0;
+  }
+}
 
 
-  core_count = em_core_count();
+
+/**
+ * Keep a rescheduled atomic queue in the core local stash, called with the atomic context
+ * still held (the queue stays scheduled, no other core can see it until it is given back).
+ *
+ * Not stashed: queues already served 'max_bursts' bursts in a row from the stash, queues of
+ * groups this core does not serve (e.g. stolen ones) and queues not fitting into the stash.
+ *
+ * @return 1 if stashed, 0 if the caller must enqueue the queue into its scheduling queue
+ */
+static inline int
+sched_sticky_put(em_queue_element_t *const q_elem, struct multiring *const sched_q)
+{
+  uint32_t idx;
   
   
-  if(em_core_mask_iszero(&core_mask))
+  if(sched_sticky.serving >= sched_sticky.max_bursts)
   {
-    // The queue group is newly created or has been modified and removed from all cores.
-    // Set the core_mask to include all running cores and remove the queue from all. 
-    em_core_mask_set_count(core_count, &core_mask);
+    sched_sticky.stats.expired++;
+    return 0;
+  }
+  
+  IF_UNLIKELY(!group_mask_isset(&em_core_local.current_group_mask, q_elem->queue_group)) {
+    return 0;
+  }
+  
+  IF_UNLIKELY((sched_sticky.tail - sched_sticky.head) >= SCHED_STICKY_STASH)
+  {
+    sched_sticky.stats.stash_full++;
+    return 0;
   }
+  
+  idx = sched_sticky.tail & (SCHED_STICKY_STASH - 1);
+  
+  sched_sticky.q_elem[idx]  = q_elem;
+  sched_sticky.sched_q[idx] = sched_q;
+  sched_sticky.bursts[idx]  = sched_sticky.serving + 1;
+  
+  sched_sticky.tail++;
+  sched_sticky.stats.stashed++;
+  
+  return 1;
+}
 
 
-  env_spinlock_lock(&em.shm->sched_add_counts_lock.lock);
-  
 
-  for(core = 0; core < core_count; core++)
+/**
+ * Give a stashed atomic queue back to the other cores
+ */
+static inline void
+sched_sticky_release(em_queue_element_t *const q_elem, struct multiring *const sched_q)
+{
+  int ret;
+  
+  
+  ret = sched_q_enqueue(sched_q, SCHED_TYPE_ATOMIC, q_elem, q_elem);
+  
+  IF_UNLIKELY(ret != 1) {
+    // Should never happen
+    (void) EM_INTERNAL_ERROR(EM_FATAL(EM_ERR_LIB_FAILED), EM_ESCOPE_SCHEDULE_ATOMIC,
+                             "Atomic sched queue enqueue failed, ret=%i!", ret);
+  }
+  
+  sched_sticky.stats.released++;
+}
+
+
+
+/**
+ * Serve the oldest stashed atomic queue (one burst), give it back instead if its queue group
+ * is no longer served by this core or the queue is no longer ready. Continues with the next
+ * stashed queue until events were dispatched or the stash is empty - an idle core must not
+ * keep queues stashed.
+ *
+ * @return Number of events dispatched
+ */
+static int
+sched_sticky_serve(void)
+{
+  void* *const q_ptr  = bulk_dequeue_bufs.buf1;
+  int          events = 0;
+  
+  
+  while((events == 0) && (sched_sticky.head != sched_sticky.tail))
   {
-    if(em_core_mask_isset(core, &core_mask))
+    const uint32_t            idx     = sched_sticky.head & (SCHED_STICKY_STASH - 1);
+    em_queue_element_t *const q_elem  = sched_sticky.q_elem[idx];
+    struct multiring   *const sched_q = sched_sticky.sched_q[idx];
+    
+    
+    sched_sticky.head++;
+    
+    IF_UNLIKELY(!group_mask_isset(&em_core_local.current_group_mask, q_elem->queue_group) ||
+                (q_elem->status != EM_QUEUE_STATUS_READY))
     {
-      if(type == EM_QUEUE_TYPE_ATOMIC)
-      {
-        sched_q_atomic_t *const sched_q_obj = &em.shm->sched_qs_prio.sched_q_atomic[group];
-        
-        qidx = queue & (sched_q_obj->queue_mask);
+      sched_sticky_release(q_elem, sched_q);
+      continue;
+    }
+    
+    q_ptr[0] = q_elem;
+    
+    sched_sticky.serving = sched_sticky.bursts[idx];
+    
+    events = schedule_atomic_dispatch(q_ptr, 1, sched_q);
+    
+    sched_sticky.serving = 0;
+    sched_sticky.stats.stash_bursts++;
+  }
+  
+  return events;
+}
 
-        count      = em.shm->core_sched_add_counts[core].add_count.atomic_add_cnt[group].q_grp_cnt;
-        qidx_count = em.shm->core_sched_add_counts[core].add_count.atomic_add_cnt[group].qidx_cnt[qidx];
 
-        // Decrease qidx count and if needed clear associated bit to remove from scheduling
-        if(qidx_count > 1)
-        {
-          em.shm->core_sched_add_counts[core].add_count.atomic_add_cnt[group].qidx_cnt[qidx] = qidx_count - 1;
-        }
-        else if(qidx_count == 1)
-        {
-          em.shm->core_sched_add_counts[core].add_count.atomic_add_cnt[group].qidx_cnt[qidx] = 0;
-          
-          qidx_mask_bit = (uint16_t) (1 << qidx);
-          em.shm->core_sched_masks[core].sched_masks_prio.atomic_masks.qidx_mask[group] &= (~qidx_mask_bit);
-        }
-        
-        // Decrease sched obj count and if needed disable scheduling for this group by clearing the bit
-        if(count > 1)
-        {
-          em.shm->core_sched_add_counts[core].add_count.atomic_add_cnt[group].q_grp_cnt = count - 1;
-        }
-        else if(count == 1)
-        {
-          em.shm->core_sched_add_counts[core].add_count.atomic_add_cnt[group].q_grp_cnt = 0;
-          group_mask_clr(&em.shm->core_sched_masks[core].sched_masks_prio.atomic_masks.q_grp_mask, group);
-        }
-        
-      }
-      else if(type == EM_QUEUE_TYPE_PARALLEL)
-      {
-        sched_q_parallel_t *const sched_q_obj = &em.shm->sched_qs_prio.sched_q_parallel[group];
-        
-        qidx = queue & (sched_q_obj->queue_mask);
 
-        count      = em.shm->core_sched_add_counts[core].add_count.parallel_add_cnt[group].q_grp_cnt;
-        qidx_count = em.shm->core_sched_add_counts[core].add_count.parallel_add_cnt[group].qidx_cnt[qidx];
+/**
+ * Give all stashed atomic queues back to the other cores, called before leaving the dispatcher
+ */
+static void
+sched_sticky_flush(void)
+{
+  while(sched_sticky.head != sched_sticky.tail)
+  {
+    const uint32_t idx = sched_sticky.head & (SCHED_STICKY_STASH - 1);
+    
+    sched_sticky.head++;
+    
+    sched_sticky_release(sched_sticky.q_elem[idx], sched_sticky.sched_q[idx]);
+  }
+}
 
-        // Decrease qidx count and if needed clear associated bit to remove from scheduling
-        if(qidx_count > 1)
-        {
-          em.shm->core_sched_add_counts[core].add_count.parallel_add_cnt[group].qidx_cnt[qidx] = qidx_count - 1;
-        }
-        else if(qidx_count == 1)
-        {
-          em.shm->core_sched_add_counts[core].add_count.parallel_add_cnt[group].qidx_cnt[qidx] = 0;
-          
-          qidx_mask_bit = (uint16_t) (1 << qidx);
-          em.shm->core_sched_masks[core].sched_masks_prio.parallel_masks.qidx_mask[group] &= (~qidx_mask_bit);
-        }
-        
-        // Decrease sched obj count and if needed disable scheduling for this group by clearing the bit
-        if(count > 1)
-        {
-          em.shm->core_sched_add_counts[core].add_count.parallel_add_cnt[group].q_grp_cnt = count - 1;
-        }
-        else if(count == 1)
-        {
-          em.shm->core_sched_add_counts[core].add_count.parallel_add_cnt[group].q_grp_cnt = 0;
-          group_mask_clr(&em.shm->core_sched_masks[core].sched_masks_prio.parallel_masks.q_grp_mask, group);
-        }
-        
+
+
+/**
+ * Read the cache-affine atomic scheduling counters of the calling core (HW specific addition)
+ */
+void
+em_sched_sticky_stats(em_sched_sticky_stats_t *const stats)
+{
+  *stats = sched_sticky.stats;
+}
+
+
+
+/**
+ * Print the cache-affine atomic scheduling counters of the calling core (HW specific addition)
+ */
+void
+em_sched_sticky_stats_print(void)
+{
+  const em_sched_sticky_stats_t *const stats = &sched_sticky.stats;
+  
+  
+  printf("EM-core%02i cache-affine atomic scheduling (max bursts %u, stash %i):\n", em_core_id(),
+         sched_sticky.max_bursts, SCHED_STICKY_STASH);
+  
+  printf("  stashed:%"PRIu64" stash-bursts:%"PRIu64" stash-full:%"PRIu64" expired:%"PRIu64" released:%"PRIu64" migrations:%"PRIu64"\n",
+         stats->stashed, stats->stash_bursts, stats->stash_full, stats->expired, stats->released, stats->migrations);
+}
+
+
+
+
+/**
+ * Select and schedule events from an atomic scheduling queue.
+ *
+ * The scheduling queues contain q_elems (not events!). Once a schedulable q_elem is dequeued
+ * then an event associated with it is dequeued from q_elem->rte_ring.
+ *
+ * Only the scheduling queues marked in 'ready' are polled, ready=NULL (no hints) polls them round-robin.
+ */
+static inline int
+em_schedule_atomic(sched_q_atomic_t              sched_q_atomic[],
+                   sched_qs_info_local_t *const  sched_qs_info,
+                   sched_type_mask_t     *const  sched_masks,
+                   sched_ready_type_t    *const  ready)
+{
+  struct multiring* sched_q;
+
+  uint32_t         sched_idx;
+  uint16_t         qidx, next_qidx;
+
+  uint16_t         qidx_mask;  
+
+  int              q_count;
+  void* *const     q_ptr = bulk_dequeue_bufs.buf1;
+  sched_burst_t   *const burst = &sched_burst.type[SCHED_TYPE_ATOMIC];
+  uint64_t         start;
+  int              events_dispatched; // Return value
+
+  
+
+#if SCHED_READY_HINTS == 1
+  IF_LIKELY(ready != NULL)
+  {
+    if(!sched_ready_select(ready, &sched_masks->q_grp_mask, sched_masks->qidx_mask,
+                           &sched_qs_info->sched_q_atomic_idx, sched_qs_info->atomic_qidx)) {
+      return 0;
+    }
+  }
+#endif
+
+  sched_idx  = sched_qs_info->sched_q_atomic_idx;
+  
+  qidx_mask  = sched_masks->qidx_mask[sched_idx];
+  
+  qidx = sched_qs_info->atomic_qidx[sched_idx];
+  
+  sched_q = sched_q_atomic[sched_idx].sched_q[qidx];
+
+
+
+  /*
+   * Dequeue q_elems from the sched-queue. Use the same sched-q up to
+   * 'revisit_max' times if there's a lot of events in this sched-q.
+   */
+  start   = sched_burst_start();
+  q_count = mring_dequeue_mp_burst(sched_q, q_ptr, burst->burst);
+  
+#if SCHED_READY_HINTS == 1
+  IF_UNLIKELY((q_count == 0) && (ready != NULL)) {
+    sched_ready_clear(ready, sched_idx, qidx, sched_q);
+  }
+#endif
+
+  if((q_count != burst->burst) ||
+     (++(sched_qs_info->sched_q_atomic_cnt)) >= burst->revisit_max) // 'expr2' evaluated only if 'expr1' is false
+  {
+      next_qidx = sched_q_get_next_qidx(qidx, qidx_mask);
+
+      IF_UNLIKELY(next_qidx <= qidx) // Wrap
+      {
+        sched_qs_info->sched_q_atomic_idx = group_mask_next(&sched_masks->q_grp_mask, sched_idx); // Increment core/thread local var
       }
-      else if(type == EM_QUEUE_TYPE_PARALLEL_ORDERED)
+
+      sched_qs_info->atomic_qidx[sched_idx] = next_qidx;
+      sched_qs_info->sched_q_atomic_cnt     = 0;
+  }
+
+
+  events_dispatched = schedule_atomic_dispatch(q_ptr, q_count, sched_q);
+  
+  sched_burst_update(burst, q_count, start);
+
+
+  return events_dispatched;
+}
+
+
+
+/**
+ * Select and schedule events from a parallel scheduling queue.
+ *
+ * The scheduling queues contain events in this case (cmp to atomic or parallel-ordered sched queues).
+ *
+ * Only the scheduling queues marked in 'ready' are polled, ready=NULL (no hints) polls them round-robin.
+ */
+static inline int
+em_schedule_parallel(sched_q_parallel_t           sched_q_parallel[],
+                     sched_qs_info_local_t *const sched_qs_info,
+                     sched_type_mask_t     *const sched_masks,
+                     sched_ready_type_t    *const ready)
+{
+  struct multiring   *sched_q;
+
+  uint32_t            sched_idx;
+  uint16_t            qidx, next_qidx;
+
+  uint16_t            qidx_mask;
+
+  int                 ev_hdr_count;
+  void* *const        ev_hdr_ptr        = bulk_dequeue_bufs.buf;
+  sched_burst_t      *const burst       = &sched_burst.type[SCHED_TYPE_PARALLEL];
+  uint64_t            start;
+  int                 events_dispatched; // Return value
+
+
+
+#if SCHED_READY_HINTS == 1
+  IF_LIKELY(ready != NULL)
+  {
+    if(!sched_ready_select(ready, &sched_masks->q_grp_mask, sched_masks->qidx_mask,
+                           &sched_qs_info->sched_q_parallel_idx, sched_qs_info->parallel_qidx)) {
+      return 0;
+    }
+  }
+#endif
+
+  sched_idx = sched_qs_info->sched_q_parallel_idx;
+
+  qidx_mask  = sched_masks->qidx_mask[sched_idx];
+  
+  qidx = sched_qs_info->parallel_qidx[sched_idx];
+  
+  sched_q = sched_q_parallel[sched_idx].sched_q[qidx];
+
+
+  /*
+   * Get the number of events in the scheduling queue. Use the same sched-q up to
+   * 'revisit_max' times if there's a lot of events in this sched-q.
+   */
+
+  start        = sched_burst_start();
+  ev_hdr_count = mring_dequeue_mp_burst(sched_q, ev_hdr_ptr, burst->burst);
+
+#if SCHED_READY_HINTS == 1
+  IF_UNLIKELY((ev_hdr_count == 0) && (ready != NULL)) {
+    sched_ready_clear(ready, sched_idx, qidx, sched_q);
+  }
+#endif
+
+  if((ev_hdr_count != burst->burst) ||
+     (++(sched_qs_info->sched_q_parallel_cnt)) >= burst->revisit_max) // 'expr2' evaluated only if 'expr1' is false
+  {
+      next_qidx = sched_q_get_next_qidx(qidx, qidx_mask);
+
+      IF_UNLIKELY(next_qidx <= qidx) // Wrap
       {
-        sched_q_parallel_ord_t *const sched_q_obj = &em.shm->sched_qs_prio.sched_q_parallel_ord[group];
-        
-        qidx = queue & (sched_q_obj->queue_mask);
+        sched_qs_info->sched_q_parallel_idx = group_mask_next(&sched_masks->q_grp_mask, sched_idx);
+      }
 
-        count      = em.shm->core_sched_add_counts[core].add_count.parallel_ord_add_cnt[group].q_grp_cnt;
-        qidx_count = em.shm->core_sched_add_counts[core].add_count.parallel_ord_add_cnt[group].qidx_cnt[qidx];
+      sched_qs_info->parallel_qidx[sched_idx] = next_qidx;
+      sched_qs_info->sched_q_parallel_cnt     = 0;
+  }
 
-        // Decrease qidx count and if needed clear associated bit to remove from scheduling
-        if(qidx_count > 1)
-        {
-          em.shm->core_sched_add_counts[core].add_count.parallel_ord_add_cnt[group].qidx_cnt[qidx] = qidx_count - 1;
-        }
-        else if(qidx_count == 1)
-        {
-          em.shm->core_sched_add_counts[core].add_count.parallel_ord_add_cnt[group].qidx_cnt[qidx] = 0;
-          
-          qidx_mask_bit = (uint16_t) (1 << qidx);
-          em.shm->core_sched_masks[core].sched_masks_prio.parallel_ord_masks.qidx_mask[group] &= (~qidx_mask_bit);
+
+
+  events_dispatched = schedule_parallel_dispatch(ev_hdr_ptr, ev_hdr_count);
+  
+  sched_burst_update(burst, ev_hdr_count, start);
+
+
+  return events_dispatched;
+}
+
+
+
+/**
+ * Select and schedule events from a parallel-ordered scheduling queue.
+ *
+ * The scheduling queues contain event-headers (not directly events).
+ * Event headers are stored in Order-Queues before dispatch to EO processing.
+ * The order-queues maintain event input order for the output.
+ *
+ * Only the scheduling queues marked in 'ready' are polled, ready=NULL (no hints) polls them round-robin.
+ */
+static inline int
+em_schedule_parallel_ordered(sched_q_parallel_ord_t       sched_q_parallel_ord[],
+                             sched_qs_info_local_t *const sched_qs_info,
+                             sched_type_mask_t     *const sched_masks,
+                             sched_ready_type_t    *const ready)
+{
+  struct multiring *sched_q;
+  
+  uint32_t          sched_idx, next_sched_idx;
+  uint16_t          qidx, next_qidx, save_qidx;
+  uint16_t          count;
+
+  uint16_t          qidx_mask;  
+  
+  env_spinlock_t   *lock;
+  int               ev_hdr_count;
+  void* *const      ev_hdr_ptr        = bulk_dequeue_bufs.buf;
+  sched_burst_t    *const burst       = &sched_burst.type[SCHED_TYPE_PARALLEL_ORD];
+  uint64_t          start;
+  int               events_dispatched; // Return value
+
+
+
+#if SCHED_READY_HINTS == 1
+  IF_LIKELY(ready != NULL)
+  {
+    if(!sched_ready_select(ready, &sched_masks->q_grp_mask, sched_masks->qidx_mask,
+                           &sched_qs_info->sched_q_parallel_ord_idx, sched_qs_info->parallel_ord_qidx)) {
+      return 0;
+    }
+  }
+#endif
+
+  /*
+   * Instead of busy-waiting for a lock, try-locks instead.
+   * Return on empty queue to be fair to atomic and parallel queue scheduling.
+   */
+
+  next_sched_idx = sched_qs_info->sched_q_parallel_ord_idx;
+  
+  next_qidx      = sched_qs_info->parallel_ord_qidx[next_sched_idx];
+  count          = sched_qs_info->sched_q_parallel_ord_cnt;
+  
+  
+  do {
+    do {
+      sched_idx =  next_sched_idx;
+      qidx      =  next_qidx;
+
+      lock      = &sched_q_parallel_ord[sched_idx].locks[qidx].lock;
+      ENV_PREFETCH(lock);            
+      sched_q   =  sched_q_parallel_ord[sched_idx].sched_q[qidx];
+
+      sched_qs_info->sched_q_parallel_ord_cnt = count;
+      qidx_mask =  sched_masks->qidx_mask[sched_idx];
+
+      
+      next_qidx = sched_q_get_next_qidx(qidx, qidx_mask);
+      save_qidx = next_qidx;
+      count     = 0;
+
+      IF_UNLIKELY(next_qidx <= qidx) // Wrap
+      {
+        next_sched_idx = group_mask_next(&sched_masks->q_grp_mask, sched_idx);
+        next_qidx      = sched_qs_info->parallel_ord_qidx[next_sched_idx];
+      }
+      
+
+      /* Avoid accessing the spinlock if there are no events */
+      IF_UNLIKELY(mring_empty(sched_q))
+      {
+#if SCHED_READY_HINTS == 1
+        if(ready != NULL) {
+          sched_ready_clear(ready, sched_idx, qidx, sched_q);
         }
+#endif
+        sched_qs_info->sched_q_parallel_ord_idx          = next_sched_idx;
+        sched_qs_info->parallel_ord_qidx[next_sched_idx] = next_qidx;
+        sched_qs_info->parallel_ord_qidx[sched_idx]      = save_qidx;
+        sched_qs_info->sched_q_parallel_ord_cnt          = 0;
+        sched_burst_update(burst, 0, 0);
+        return (0);
+      }
+
+    } while(env_spinlock_is_locked(lock));
+
+  } while(!env_spinlock_trylock(lock));
+
+  /* Lock Taken - continue */
+
+
+  start        = sched_burst_start();
+  ev_hdr_count = mring_dequeue_mp_burst(sched_q, ev_hdr_ptr, burst->burst);
+  
+  if((ev_hdr_count < burst->burst) ||
+     ((++(sched_qs_info->sched_q_parallel_ord_cnt)) >= burst->revisit_max)) // 'expr2' evaluated only if 'expr1' is false
+  {
+      sched_qs_info->sched_q_parallel_ord_idx          = next_sched_idx;
+      sched_qs_info->parallel_ord_qidx[next_sched_idx] = next_qidx;
+      sched_qs_info->sched_q_parallel_ord_cnt          = 0;
+
+      IF_UNLIKELY(ev_hdr_count == 0)
+      {
+        // No event-hdrs - return
+        env_spinlock_unlock(lock);
+        sched_burst_update(burst, 0, 0);
+        return (0);
+      }
+  }
+
+
+
+  events_dispatched = schedule_parallel_ord_dispatch(ev_hdr_ptr, ev_hdr_count, lock);
+  
+  sched_burst_update(burst, ev_hdr_count, start);
+  
+  
+  return events_dispatched;
+}
+
+
+
+/**
+ * Dispatch events from the atomic queues (q_elems) dequeued from the scheduling queue 'sched_q'.
+ *
+ * @return The number of events dispatched
+ */
+static inline int
+schedule_atomic_dispatch(void* *const q_ptr, const int q_count, struct multiring *const sched_q)
+{
+  void* *const     e_ptr = bulk_dequeue_bufs.buf2;
+  int              events_dispatched = 0; // Return value
+  int              ret, j;
+  
+  
+  if(q_count > 0)
+  {
+    PREFETCH_Q_ELEM(q_ptr[0]);    
+
+
+    for(j = 0; j < q_count; j++)
+    {
+      em_queue_element_t *const q_elem = q_ptr[j];
+      unsigned                  e_count;
+
+
+      //e_count = rte_ring_count(q_elem->rte_ring);
+      e_count = q_elem->u.atomic.event_count;
+      
+      if(e_count > MAX_E_BULK_ATOMIC) {
+         e_count = MAX_E_BULK_ATOMIC;
+      }
+      
+      // The EO releases the atomic context early, em_atomic_processing_end(), 
+      // dequeue one event at a time to allow the release to happen immediately.
+      IF_UNLIKELY(q_elem->atomic_release) {
+         e_count = 1;
+      }
+
+
+      ret = rte_ring_dequeue_bulk(q_elem->rte_ring, e_ptr, e_count);
+
+      IF_LIKELY(ret == 0)
+      {
+        unsigned i;
+
+        // This core now holds the atomic context of the queue
+        sched_core_local.atomic_q_elem  = q_elem;
+        sched_core_local.atomic_e_count = e_count;
         
-        // Decrease sched obj count and if needed disable scheduling for this group by clearing the bit
-        if(count > 1)
+        IF_UNLIKELY(q_elem->last_core != em_core_id())
         {
-          em.shm->core_sched_add_counts[core].add_count.parallel_ord_add_cnt[group].q_grp_cnt = count - 1;
+          q_elem->last_core = em_core_id();
+          sched_sticky.stats.migrations++;
         }
-        else if(count == 1)
+
+        //
+        // Dispatch events
+        //
+        IF_LIKELY(q_elem->receive_multi_func == NULL)
         {
-          em.shm->core_sched_add_counts[core].add_count.parallel_ord_add_cnt[group].q_grp_cnt = 0;
-          group_mask_clr(&em.shm->core_sched_masks[core].sched_masks_prio.parallel_ord_masks.q_grp_mask, group);
+          for(i = 0; i < e_count; i++)
+          {
+            em_event_t            event  = e_ptr[i];
+            ENV_PREFETCH(event);
+            em_event_hdr_t *const ev_hdr = event_to_event_hdr(event);
+
+            // Mark that this event was received from an atomic queue
+            ev_hdr->src_q_type = EM_QUEUE_TYPE_ATOMIC;
+            
+            sched_core_local.atomic_e_left = e_count - 1 - i;
+
+            dispatch_event(q_elem, event, ev_hdr->event_type);
+          }
+        }
+        else
+        {
+          // EO multi-event receive: pass the whole burst at once
+          em_event_type_t *const types = multi_rcv_bufs.types;
+          
+          for(i = 0; i < e_count; i++)
+          {
+            em_event_hdr_t *const ev_hdr = event_to_event_hdr(e_ptr[i]);
+            
+            ev_hdr->src_q_type = EM_QUEUE_TYPE_ATOMIC;
+            types[i]           = ev_hdr->event_type;
+          }
+          
+          // None of the burst passed to the EO yet (updated per receive call by dispatch_event_multi())
+          sched_core_local.atomic_e_left = e_count;
+          
+          dispatch_event_multi(q_elem, (em_event_t *) e_ptr, types, e_count);
         }
         
-      }
-      else{
-        env_spinlock_unlock(&em.shm->sched_add_counts_lock.lock);
+        events_dispatched += e_count;
         
-        return EM_INTERNAL_ERROR(EM_ERR_NOT_FOUND, EM_ESCOPE_SCHED_MASKS_REM,
-                                 "Unknown EM-queue type (%u)", type);
+        
+        // Prefetch next q_elem
+        if((j+1) < q_count) {
+          PREFETCH_Q_ELEM(q_ptr[j+1])
+        }
+        
+
+        //
+        // Update counters and release the atomic context - unless already 
+        // released by em_atomic_processing_end() during the last event.
+        //
+        IF_LIKELY(sched_core_local.atomic_q_elem != NULL)
+        {
+          sched_core_local.atomic_q_elem = NULL;
+          
+          // Single event burst for em_atomic_processing_end(), but the EO did not release early: back to full bursts.
+          // Cleared while still holding the context, the next holder may request a release again.
+          IF_UNLIKELY(q_elem->atomic_release && (e_count == 1)) {
+            q_elem->atomic_release = 0;
+          }
+          
+          atomic_context_release(q_elem, sched_q, e_count, (sched_sticky.max_bursts != 0), EM_ESCOPE_SCHEDULE_ATOMIC);
+        }
+      }
+      else {
+        // Should never happen
+       (void) EM_INTERNAL_ERROR(EM_FATAL(EM_ERR_LIB_FAILED), EM_ESCOPE_SCHEDULE_ATOMIC,
+                                "Schedulable ATOMIC queue found but NO EVENTS in queue, ret=%i", ret);
       }
     }
-  } // for(;;)
-
+  }
+
+
+  return events_dispatched;
+}
+
+
+
+/**
+ * Dispatch the events (headers) dequeued from a parallel scheduling queue.
+ *
+ * @return The number of events dispatched
+ */
+static inline int
+schedule_parallel_dispatch(void* *const ev_hdr_ptr, const int ev_hdr_count)
+{
+  int events_dispatched = 0; // Return value
+  
+  
+  if(ev_hdr_count > 0) // Event hdrs dequeued:
+  {
+    em_event_hdr_t     *ev_hdr;
+    em_queue_element_t *q_elem;
+    int                 i;
+
+
+    for(i = 0; i < ev_hdr_count; i++)
+    {
+      ev_hdr = ev_hdr_ptr[i];
+      q_elem = ev_hdr->q_elem;
+
+      PREFETCH_Q_ELEM(q_elem);
+      
+      ev_hdr->src_q_type = EM_QUEUE_TYPE_PARALLEL;
+    }
+
+
+    dispatch_ev_hdrs(ev_hdr_ptr, ev_hdr_count);
+
+    events_dispatched += ev_hdr_count;
+  }
+
+
+  return events_dispatched;
+}
+
+
+
+/**
+ * Record the order of and dispatch the events (headers) dequeued from a parallel-ordered
+ * scheduling queue. Called with the scheduling queue lock 'lock' taken, releases it.
+ *
+ * @return The number of events dispatched
+ */
+static inline int
+schedule_parallel_ord_dispatch(void* *const ev_hdr_ptr, const int ev_hdr_count, env_spinlock_t *const lock)
+{
+  int events_dispatched = 0; // Return value
+  
+  
+  if(ev_hdr_count > 0)
+  {
+#if LOCKLESS_ORDERED_QUEUES == 1
+    /*
+     * Hand out reorder window tickets in dequeue order, one ticket range per run of
+     * consecutive events of the same queue. The sched-queue lock serializes the dequeue
+     * and thus the ticket order.
+     */
+    em_event_hdr_t *const *const ev_hdrs = (em_event_hdr_t *const *) ev_hdr_ptr;
+    int                          i       = 0;
+    
+    do {
+      em_queue_element_t *const q_elem = ev_hdrs[i]->q_elem;
+      int                       n      = 1;
+      
+      while(((i + n) < ev_hdr_count) && (ev_hdrs[i + n]->q_elem == q_elem)) {
+        n++;
+      }
+      
+      (void) order_window_tickets(q_elem, &ev_hdrs[i], n);
+      
+      i += n;
+    } while(i < ev_hdr_count);
+    
+#elif PARALLEL_ORDERED__USE_SCHED_Q_LOCKS == 1 // Optional
+    int  i;
+
+    /*
+     * Record/store event order before dispatch to be able to
+     * restore order after parallel processing
+     */
+    for(i = 0; i < ev_hdr_count; i++)
+    {
+      em_event_hdr_t     *const ev_hdr = ev_hdr_ptr[i];
+      em_queue_element_t *const q_elem = ev_hdr->q_elem;
+
+      (void) parallel_ordered_maintain_order(ev_hdr, q_elem, lock);
+    }
+#else // Default
+    /*
+     * Maintain queue order.
+     * Try to minimize the spinlock lock/unlock calls for events belonging to the same queue.
+     */
+    em_event_hdr_t     *ev_hdr   =  ev_hdr_ptr[0];
+    em_queue_element_t *q_elem   =  ev_hdr->q_elem;
+    env_spinlock_t     *q_lock   = &q_elem->lock;
+    env_spinlock_t     *tmp_lock =  q_lock;
+    int                 i        =  0;
+
+    env_spinlock_lock(q_lock);
+
+    do
+    {
+      ev_hdr = ev_hdr_ptr[i];
+      q_elem = ev_hdr->q_elem;
+      q_lock = &q_elem->lock;
+
+
+      if(q_lock != tmp_lock) {
+        env_spinlock_unlock(tmp_lock);
+        env_spinlock_lock(q_lock);
+        tmp_lock = q_lock;
+      }
+
+      (void) parallel_ordered_maintain_order(ev_hdr, q_elem, q_lock);
+
+      i++;
+    } while(i < ev_hdr_count);
+
+    env_spinlock_unlock(q_lock);
+
+    /********/
+#endif
+
+
+    /* Unlock the Scheduling-Queue lock */
+    env_spinlock_unlock(lock);
+
+
+    /*
+     * Dispatch - parallel processing
+     */
+    dispatch_ev_hdrs(ev_hdr_ptr, ev_hdr_count);
+
+    events_dispatched += ev_hdr_count;
+
+  }
+  else {
+    env_spinlock_unlock(lock);
+  }
+
+
+  return events_dispatched;
+}
+
+
+
+/**
+ * Strict priority scheduling: try to schedule events of priority 'prio' from the
+ * scheduling queues of queue group 'grp' and type 'sched_type'.
+ * Clears the group's non-empty hint if all its scheduling queues are empty on the level.
+ *
+ * @return The number of events dispatched
+ */
+static inline int
+em_schedule_strict_prio__grp(const int sched_type, const int grp, const uint8_t prio, const uint16_t qidx_mask)
+{
+  sched_qs_t        *const sched_qs_ptr = &em.shm->sched_qs_prio;
+  sched_prio_hint_t *const hint         = &em.shm->sched_prio_hints.hint[prio][sched_type];
+  struct multiring        *sched_q;
+  uint16_t                 mask;
+  int                      qidx;
+  int                      busy = 0;
+  int                      n;
+  
+  
+  for(mask = qidx_mask; mask != 0; mask &= (mask - 1))
+  {
+    qidx = __builtin_ctz(mask);
+    
+    if(sched_type == SCHED_TYPE_ATOMIC)
+    {
+      void* *const q_ptr = bulk_dequeue_bufs.buf1;
+      
+      sched_q = sched_qs_ptr->sched_q_atomic[grp].sched_q[qidx];
+      n       = mring_dequeue_burst(sched_q, prio, q_ptr, MAX_Q_BULK_ATOMIC);
+      
+      if(n > 0) {
+        return schedule_atomic_dispatch(q_ptr, n, sched_q);
+      }
+    }
+    else if(sched_type == SCHED_TYPE_PARALLEL)
+    {
+      void* *const ev_hdr_ptr = bulk_dequeue_bufs.buf;
+      
+      sched_q = sched_qs_ptr->sched_q_parallel[grp].sched_q[qidx];
+      n       = mring_dequeue_burst(sched_q, prio, ev_hdr_ptr, MAX_E_BULK_PARALLEL);
+      
+      if(n > 0) {
+        return schedule_parallel_dispatch(ev_hdr_ptr, n);
+      }
+    }
+    else // SCHED_TYPE_PARALLEL_ORD
+    {
+      void*          *const ev_hdr_ptr = bulk_dequeue_bufs.buf;
+      env_spinlock_t *const lock       = &sched_qs_ptr->sched_q_parallel_ord[grp].locks[qidx].lock;
+      
+      sched_q = sched_qs_ptr->sched_q_parallel_ord[grp].sched_q[qidx];
+      
+      if(mring_empty_prio(sched_q, prio)) {
+        continue;
+      }
+      
+      // Another core is dequeueing from the sched-q, the level is not known to be empty
+      if(!env_spinlock_trylock(lock)) {
+        busy = 1;
+        continue;
+      }
+      
+      n = mring_dequeue_burst(sched_q, prio, ev_hdr_ptr, MAX_E_BULK_PARALLEL_ORD);
+      
+      if(n > 0) {
+        return schedule_parallel_ord_dispatch(ev_hdr_ptr, n, lock);
+      }
+      
+      env_spinlock_unlock(lock);
+    }
+  }
+  
+  
+  if(!busy)
+  {
+    // Nothing on this level: clear the hint and re-check - a producer that saw the
+    // bit still set just before it was cleared must not be missed.
+    group_mask_clr(&hint->q_grp_mask, grp);
+    
+    for(mask = qidx_mask; mask != 0; mask &= (mask - 1))
+    {
+      qidx = __builtin_ctz(mask);
+      
+      if(sched_type == SCHED_TYPE_ATOMIC) {
+        sched_q = sched_qs_ptr->sched_q_atomic[grp].sched_q[qidx];
+      }
+      else if(sched_type == SCHED_TYPE_PARALLEL) {
+        sched_q = sched_qs_ptr->sched_q_parallel[grp].sched_q[qidx];
+      }
+      else {
+        sched_q = sched_qs_ptr->sched_q_parallel_ord[grp].sched_q[qidx];
+      }
+      
+      if(!mring_empty_prio(sched_q, prio))
+      {
+        group_mask_set(&hint->q_grp_mask, grp);
+        break;
+      }
+    }
+  }
+  
+  return 0;
+}
+
+
+
+/**
+ * Strict priority scheduling (em_conf_t.sched_strict_prio): schedule events from the highest
+ * priority level that has events in any queue group and queue type this core serves.
+ * Groups and types on the same level are served round-robin.
+ *
+ * @return The number of events dispatched, 0 if no hinted events were found
+ */
+static inline int
+em_schedule_strict_prio(void)
+{
+  sched_prio_hints_t    *const hints         = &em.shm->sched_prio_hints;
+  sched_qs_info_local_t *const sched_qs_info = &sched_core_local.sched_qs_info;
+  sched_masks_t         *const sched_masks   = &sched_core_local.sched_masks->sched_masks_prio;
+  sched_type_mask_t     *const type_masks[SCHED_TYPES] = {&sched_masks->atomic_masks,
+                                                          &sched_masks->parallel_masks,
+                                                          &sched_masks->parallel_ord_masks};
+  int                          prio;
+  
+  
+  for(prio = (SCHED_PRIO_LEVELS - 1); prio >= 0; prio--)
+  {
+    int t;
+    
+    for(t = 0; t < SCHED_TYPES; t++)
+    {
+      const int                sched_type = (sched_qs_info->strict_prio_type + t) % SCHED_TYPES;
+      sched_type_mask_t  *const type_mask  = type_masks[sched_type];
+      const group_mask_t *const hint_mask  = &hints->hint[prio][sched_type].q_grp_mask;
+      const uint32_t           start      = sched_qs_info->strict_prio_grp_idx[sched_type] + 1;
+      int                      pass;
+      
+      // Groups both hinted and served, round-robin after the last served one: [start, SCHED_QS) then [0, start)
+      for(pass = 0; pass < 2; pass++)
+      {
+        const uint32_t to = (pass == 0) ? SCHED_QS : start;
+        int            grp;
+        
+        for(grp = group_mask_find(hint_mask, &type_mask->q_grp_mask, (pass == 0) ? start : 0, to);
+            grp >= 0;
+            grp = group_mask_find(hint_mask, &type_mask->q_grp_mask, grp + 1, to))
+        {
+          const int n = em_schedule_strict_prio__grp(sched_type, grp, prio, type_mask->qidx_mask[grp]);
+          
+          if(n > 0)
+          {
+            sched_qs_info->strict_prio_grp_idx[sched_type] = grp;
+            sched_qs_info->strict_prio_type                = (sched_type + 1) % SCHED_TYPES;
+            return n;
+          }
+        }
+      }
+    }
+  }
+  
+  return 0;
+}
+
+
+
+
+/**
+ * Helper function to maintain order in parallel-ordered queues.
+ * Call must be serialized by spinlock 'lock'.
+ */
+static inline em_status_t
+parallel_ordered_maintain_order(em_event_hdr_t     *const ev_hdr,
+                                em_queue_element_t *const q_elem,
+                                env_spinlock_t     *const lock)
+{
+  int ret;
+
+
+  PREFETCH_RTE_RING(q_elem->rte_ring);
+
+  // Needed in em_send for re-ordering
+  ev_hdr->src_q_type      = EM_QUEUE_TYPE_PARALLEL_ORDERED;
+  ev_hdr->lock_p          = lock;
+  ev_hdr->processing_done = 0;
+  ev_hdr->dst_q_elem      = NULL;
+
+  if(q_elem->u.parallel_ord.order_first == NULL) {
+    q_elem->u.parallel_ord.order_first = ev_hdr;
+  }
+  else {
+    // Order-Queue
+    ret = rte_ring_enqueue(q_elem->rte_ring, ev_hdr);
+
+    IF_UNLIKELY(ret) {
+      /* On enqueue-error: clear the src_q_type=EM_QUEUE_TYPE_PARALLEL_ORDERED
+       * to avoid never being sent if em_send() is called.
+       * Order is lost for this event however...
+       */
+      if(ret == (-ENOBUFS))
+      {
+        ev_hdr->src_q_type = EM_QUEUE_TYPE_UNDEF;
+        
+        return EM_ERR_LIB_FAILED;
+        //(void) EM_INTERNAL_ERROR(EM_ERR_LIB_FAILED, EM_ESCOPE_PARALLEL_ORDERED_MAINTAIN_ORDER,
+        //                         "Order-queue enequeue failed, ret=%i", ret);
+      }
+    }
+  }
+  
+  return EM_OK;
+}
+
+
+
+
+/**
+ * Return the index of the next set bit in the mask
+ * 
+ * @param curr_idx  Index of the last used sched-queue inside a sched_q-obj
+ * @param mask      Mask bits represent sched-qs in a specific sched_q-obj that should be polled
+ */
+static inline uint16_t
+sched_q_get_next_qidx(const uint16_t curr_idx, const uint16_t mask)
+{
+  uint16_t next_idx, tmp_idx;
+  uint16_t tmp_mask1, tmp_mask2;
+
+
+  // Example: curr_idx=5 => bit(5+1) => 01000000 => -1 => 00111111 => ~ => 11000000
+  tmp_mask1 = ~(((uint16_t)(1 << ((curr_idx + 1) & 0xF))) - 1);
+  // clear bit for current index and lower
+  tmp_mask2 = mask & tmp_mask1;
+
+  if(tmp_mask2 == 0) {
+    tmp_mask2 = mask;
+  }
+
+  // Returns one plus the index of the least significant 1-bit of x, or if x is zero, returns zero.
+  tmp_idx  = (uint16_t) __builtin_ffsl(tmp_mask2);
+
+  next_idx = likely(tmp_idx > 0) ? (tmp_idx - 1) : 0;
+
+  return next_idx;
+}
+
+
+
+/**
+ * Strict priority scheduling: mark the queue group of 'q_elem' non-empty on the queue's priority level.
+ * Called after the enqueue into the scheduling queue.
+ */
+static inline void
+sched_prio_hint_set(const int sched_type, const em_queue_element_t *const q_elem)
+{
+  sched_prio_hint_t *const hint = &em.shm->sched_prio_hints.hint[q_elem->priority][sched_type];
+  
+  // Reads first to avoid bouncing the cache line when already set
+  group_mask_set(&hint->q_grp_mask, q_elem->queue_group);
+}
+
+
+
+/**
+ * Return the index of the scheduling queue of 'q_elem' inside its sched_q-obj
+ */
+static inline uint16_t
+sched_q_qidx(const int sched_type, const em_queue_element_t *const q_elem)
+{
+  uint64_t queue_mask;
+  
+  
+  if(sched_type == SCHED_TYPE_ATOMIC) {
+    queue_mask = SCHED_Q_ATOMIC_SELECT(q_elem)->queue_mask;
+  }
+  else if(sched_type == SCHED_TYPE_PARALLEL) {
+    queue_mask = SCHED_Q_PARALLEL_SELECT(q_elem)->queue_mask;
+  }
+  else {
+    queue_mask = SCHED_Q_PARALLEL_ORD_SELECT(q_elem)->queue_mask;
+  }
+  
+  return (uint16_t) (q_elem->id & queue_mask);
+}
+
+
+
+/**
+ * Enqueue an object (q_elem or event header) into a scheduling queue on the priority of 'q_elem'
+ *
+ * @return 1 if enqueued, 0 on error
+ */
+static inline int
+sched_q_enqueue(struct multiring *const sched_q, const int sched_type, em_queue_element_t *const q_elem, void *const obj)
+{
+  const int ret = mring_enqueue(sched_q, q_elem->priority, obj);
+  
+#if SCHED_READY_HINTS == 1
+  IF_LIKELY(ret > 0) {
+    sched_ready_set(&em.shm->sched_ready_hints.ready[sched_type], q_elem->queue_group, sched_q_qidx(sched_type, q_elem));
+  }
+#endif
+  
+  IF_UNLIKELY(em_internal_conf.conf.sched_strict_prio && (ret > 0)) {
+    sched_prio_hint_set(sched_type, q_elem);
+  }
+  
+  return ret;
+}
+
+
+
+/**
+ * Enqueue several objects into a scheduling queue on the priority of 'q_elem'
+ *
+ * @return The number of objects enqueued
+ */
+static inline int
+sched_q_enqueue_burst(struct multiring *const sched_q, const int sched_type, em_queue_element_t *const q_elem,
+                      void * const *obj_table, const int num)
+{
+  const int ret = mring_enqueue_burst(sched_q, q_elem->priority, obj_table, num);
+  
+#if SCHED_READY_HINTS == 1
+  IF_LIKELY(ret > 0) {
+    sched_ready_set(&em.shm->sched_ready_hints.ready[sched_type], q_elem->queue_group, sched_q_qidx(sched_type, q_elem));
+  }
+#endif
+  
+  IF_UNLIKELY(em_internal_conf.conf.sched_strict_prio && (ret > 0)) {
+    sched_prio_hint_set(sched_type, q_elem);
+  }
+  
+  return ret;
+}
+
+
+
+#if SCHED_READY_HINTS == 1
+/**
+ * Ready hints: mark the scheduling queue 'qidx' of queue group 'grp' non-empty.
+ * Called after the enqueue into the scheduling queue.
+ */
+static inline void
+sched_ready_set(sched_ready_type_t *const ready, const uint32_t grp, const uint16_t qidx)
+{
+  const uint16_t qidx_bit = (uint16_t) (1 << qidx);
+  
+  
+  // Full barrier: the enqueue must be visible before the bit is read, pairs with the locked
+  // clear & re-check of sched_ready_clear() - otherwise both could miss the event.
+  env_mem_barrier();
+  
+  // Read first to avoid bouncing the cache lines when already set.
+  // The scheduling queue bit is set before the group bit, see sched_ready_grp_clear().
+  if(!(ready->grp[grp].qidx_mask & qidx_bit)) {
+    (void) __sync_fetch_and_or(&ready->grp[grp].qidx_mask, qidx_bit);
+  }
+  
+  group_mask_set(&ready->q_grp_mask, grp);
+}
+
+
+
+/**
+ * Ready hints: clear the mark of the scheduling queue 'qidx' of queue group 'grp' after it was found empty.
+ */
+static inline void
+sched_ready_clear(sched_ready_type_t *const ready, const uint32_t grp, const uint16_t qidx, struct multiring *const sched_q)
+{
+  sched_ready_grp_t *const ready_grp = &ready->grp[grp];
+  const uint16_t           qidx_bit  = (uint16_t) (1 << qidx);
+  
+  
+  if(!(ready_grp->qidx_mask & qidx_bit)) {
+    return; // already cleared by another core
+  }
+  
+  (void) __sync_fetch_and_and(&ready_grp->qidx_mask, (uint16_t) ~qidx_bit);
+  
+  // Re-check - a producer that saw the bit still set just before it was cleared must not be missed
+  if(!mring_empty(sched_q))
+  {
+    sched_ready_set(ready, grp, qidx);
+  }
+  else if(ready_grp->qidx_mask == 0)
+  {
+    sched_ready_grp_clear(ready, grp);
+  }
+}
+
+
+
+/**
+ * Ready hints: clear the mark of queue group 'grp' if none of its scheduling queues are marked.
+ */
+static inline void
+sched_ready_grp_clear(sched_ready_type_t *const ready, const uint32_t grp)
+{
+  group_mask_clr(&ready->q_grp_mask, grp);
+  
+  // Re-check - a producer sets the scheduling queue bit before the group bit
+  if(ready->grp[grp].qidx_mask != 0) {
+    group_mask_set(&ready->q_grp_mask, grp);
+  }
+}
+
+
+
+/**
+ * Ready hints: mark every non-empty scheduling queue (of all queue types) served by the core.
+ * Run every SCHED_READY_RESCAN_ROUNDS rounds to restore hints that were missed.
+ */
+static void
+sched_ready_rescan(sched_ready_hints_t *const ready_hints, sched_qs_t *const sched_qs, sched_masks_t *const sched_masks)
+{
+  int grp;
+  
+  
+  for(grp = group_mask_find(&sched_masks->atomic_masks.q_grp_mask, NULL, 0, SCHED_QS);
+      grp >= 0;
+      grp = group_mask_find(&sched_masks->atomic_masks.q_grp_mask, NULL, grp + 1, SCHED_QS))
+  {
+    sched_ready_rescan_grp(&ready_hints->ready[SCHED_TYPE_ATOMIC], grp,
+                           sched_masks->atomic_masks.qidx_mask[grp], sched_qs->sched_q_atomic[grp].sched_q);
+  }
+  
+  for(grp = group_mask_find(&sched_masks->parallel_masks.q_grp_mask, NULL, 0, SCHED_QS);
+      grp >= 0;
+      grp = group_mask_find(&sched_masks->parallel_masks.q_grp_mask, NULL, grp + 1, SCHED_QS))
+  {
+    sched_ready_rescan_grp(&ready_hints->ready[SCHED_TYPE_PARALLEL], grp,
+                           sched_masks->parallel_masks.qidx_mask[grp], sched_qs->sched_q_parallel[grp].sched_q);
+  }
+  
+  for(grp = group_mask_find(&sched_masks->parallel_ord_masks.q_grp_mask, NULL, 0, SCHED_QS);
+      grp >= 0;
+      grp = group_mask_find(&sched_masks->parallel_ord_masks.q_grp_mask, NULL, grp + 1, SCHED_QS))
+  {
+    sched_ready_rescan_grp(&ready_hints->ready[SCHED_TYPE_PARALLEL_ORD], grp,
+                           sched_masks->parallel_ord_masks.qidx_mask[grp], sched_qs->sched_q_parallel_ord[grp].sched_q);
+  }
+}
+
+
+
+/**
+ * Ready hints: mark the non-empty scheduling queues in 'qidx_mask' of queue group 'grp'
+ */
+static inline void
+sched_ready_rescan_grp(sched_ready_type_t *const ready, const uint32_t grp, uint16_t qidx_mask,
+                       struct multiring *const sched_q[])
+{
+  uint16_t qidx;
+  
+  
+  for(qidx = 0; qidx_mask != 0; qidx++, qidx_mask >>= 1)
+  {
+    if((qidx_mask & 1) && (sched_q[qidx] != NULL) && !mring_empty(sched_q[qidx])) {
+      sched_ready_set(ready, grp, qidx);
+    }
+  }
+}
+
+
+
+/**
+ * Ready hints: move the round-robin position of a queue type, i.e. the queue group '*sched_idx' and
+ * the scheduling queue 'qidx[*sched_idx]' in it, to the next scheduling queue marked ready that
+ * the core serves. Stale queue group marks found on the way are cleared.
+ *
+ * @param ready       Ready hints of the queue type
+ * @param grp_mask    Queue groups served by the core
+ * @param qidx_masks  Scheduling queues served by the core, per queue group
+ * @param sched_idx   Core local round-robin queue group index (updated)
+ * @param qidx        Core local round-robin scheduling queue indexes per queue group (updated)
+ *
+ * @return 1 if a ready scheduling queue was selected, 0 if there are none
+ */
+static inline int
+sched_ready_select(sched_ready_type_t *const ready, const group_mask_t *const grp_mask, const volatile uint16_t qidx_masks[],
+                   uint32_t *const sched_idx, uint8_t qidx[])
+{
+  const uint32_t start = *sched_idx;
+  uint16_t       ready_qidx_mask;
+  int            pass;
+  int            idx;
+  
+  
+  // Groups both served and marked ready, round-robin from the current one: [start, SCHED_QS) then [0, start)
+  for(pass = 0; pass < 2; pass++)
+  {
+    const uint32_t to = (pass == 0) ? SCHED_QS : start;
+    
+    for(idx = group_mask_find(grp_mask, &ready->q_grp_mask, (pass == 0) ? start : 0, to);
+        idx >= 0;
+        idx = group_mask_find(grp_mask, &ready->q_grp_mask, idx + 1, to))
+    {
+      ready_qidx_mask = qidx_masks[idx] & ready->grp[idx].qidx_mask;
+      
+      IF_LIKELY(ready_qidx_mask != 0)
+      {
+        if(!(ready_qidx_mask & (1 << qidx[idx]))) {
+          qidx[idx] = (uint8_t) sched_q_get_next_qidx(qidx[idx], ready_qidx_mask);
+        }
+        
+        *sched_idx = idx;
+        return 1;
+      }
+      
+      if(ready->grp[idx].qidx_mask == 0) {
+        sched_ready_grp_clear(ready, idx);
+      }
+    }
+  }
+  
+  return 0;
+}
+#endif // SCHED_READY_HINTS == 1
+
+
+
+
+
+/**
+ * Set bits in the masks used by the scheduler.
+ * Triggered by a call to em_queue_enable(_all).
+ */
+em_status_t
+sched_masks_add_queue(const em_queue_t       queue,
+                      const em_queue_type_t  type,
+                      const em_queue_group_t group)
+{
+  em_status_t        err;
+  em_core_mask_t     core_mask;
+  char               mask_str[EM_CORE_MASK_STRLEN];
+  int                core_count;
+  int                core;
+  uint16_t           count, qidx_count;
+  uint64_t           qidx;
+  uint16_t           qidx_mask_bit;
+
+
+  err = em_queue_group_mask(group, &core_mask);
+  
+  RETURN_ERROR_IF(err != EM_OK, err, EM_ESCOPE_SCHED_MASKS_ADD,
+                  "em_queue_group_mask(group=%"PRI_QGRP", core_mask=%s) returns %u",
+                   group, em_core_mask_tostr(mask_str, sizeof(mask_str), &core_mask), err);
+
+
+  RETURN_ERROR_IF(em_core_mask_iszero(&core_mask), EM_FATAL(EM_ERR_BAD_ID), EM_ESCOPE_SCHED_MASKS_ADD,
+                  "em_queue_group_mask(group=%"PRI_QGRP", core_mask=%s) is zero!",
+                   group, em_core_mask_tostr(mask_str, sizeof(mask_str), &core_mask));
+
+  core_count = em_core_count();
+
+
+  env_spinlock_lock(&em.shm->sched_add_counts_lock.lock);
+  
+  // printf("%s(): Core:%02i QGrp:%"PRI_QGRP" CoreMask:%s\n", __func__, em_core_id(), group, em_core_mask_tostr(mask_str, sizeof(mask_str), &core_mask)); fflush(NULL);
+
+  for(core = 0; core < core_count; core++)
+  {
+    if(em_core_mask_isset(core, &core_mask))
+    {
+      if(type == EM_QUEUE_TYPE_ATOMIC)
+      {
+        sched_q_atomic_t *const sched_q_obj = &em.shm->sched_qs_prio.sched_q_atomic[group];
+          
+        qidx = queue & (sched_q_obj->queue_mask);        
+        
+        qidx_count = em.shm->core_sched_add_counts[core].add_count.atomic_add_cnt[group].qidx_cnt[qidx];
+        em.shm->core_sched_add_counts[core].add_count.atomic_add_cnt[group].qidx_cnt[qidx] = qidx_count + 1;
+        
+        if(qidx_count == 0)
+        {
+          qidx_mask_bit = (uint16_t) (1 << qidx);
+          
+          // Set the bit QIDX bit, i.e. enable scheduling for the FIFO that the EM-queue is scheduled through
+          em.shm->core_sched_masks[core].sched_masks_prio.atomic_masks.qidx_mask[group] |= qidx_mask_bit;
+        }
+        
+        // Increase the queue count for this sched object
+        count = em.shm->core_sched_add_counts[core].add_count.atomic_add_cnt[group].q_grp_cnt;
+        em.shm->core_sched_add_counts[core].add_count.atomic_add_cnt[group].q_grp_cnt = count + 1;        
+        
+        if(count == 0)
+        {
+          // Set the mask bit for this sched object, i.e. enable scheduling for this type,group
+          group_mask_set(&em.shm->core_sched_masks[core].sched_masks_prio.atomic_masks.q_grp_mask, group);
+        }
+        
+      }
+      else if(type == EM_QUEUE_TYPE_PARALLEL)
+      {
+        sched_q_parallel_t *const sched_q_obj = &em.shm->sched_qs_prio.sched_q_parallel[group];
+          
+        qidx = queue & (sched_q_obj->queue_mask);        
+        
+        qidx_count = em.shm->core_sched_add_counts[core].add_count.parallel_add_cnt[group].qidx_cnt[qidx];
+        em.shm->core_sched_add_counts[core].add_count.parallel_add_cnt[group].qidx_cnt[qidx] = qidx_count + 1;
+        
+        if(qidx_count == 0)
+        {        
+          qidx_mask_bit = (uint16_t) (1 << qidx);
+          
+          // Set the bit QIDX bit, i.e. enable scheduling for the FIFO that the EM-queue is scheduled through
+          em.shm->core_sched_masks[core].sched_masks_prio.parallel_masks.qidx_mask[group] |= qidx_mask_bit;
+        }
+        
+        // Increase the queue count for this sched object
+        count = em.shm->core_sched_add_counts[core].add_count.parallel_add_cnt[group].q_grp_cnt;
+        em.shm->core_sched_add_counts[core].add_count.parallel_add_cnt[group].q_grp_cnt = count + 1;
+
+        if(count == 0) 
+        {
+          // Set the mask bit for this sched object, i.e. enable scheduling for this type,group
+          group_mask_set(&em.shm->core_sched_masks[core].sched_masks_prio.parallel_masks.q_grp_mask, group);
+        }
+
+      }
+      else if(type == EM_QUEUE_TYPE_PARALLEL_ORDERED)
+      {
+        sched_q_parallel_ord_t *const sched_q_obj = &em.shm->sched_qs_prio.sched_q_parallel_ord[group];
+
+        qidx = queue & (sched_q_obj->queue_mask);
+        
+        qidx_count = em.shm->core_sched_add_counts[core].add_count.parallel_ord_add_cnt[group].qidx_cnt[qidx];
+        em.shm->core_sched_add_counts[core].add_count.parallel_ord_add_cnt[group].qidx_cnt[qidx] = qidx_count + 1;
+        
+        if(qidx_count == 0)
+        {                
+          qidx_mask_bit = (uint16_t) (1 << qidx);
+
+          // Set the bit QIDX bit, i.e. enable scheduling for the FIFO that the EM-queue is scheduled through
+          em.shm->core_sched_masks[core].sched_masks_prio.parallel_ord_masks.qidx_mask[group] |= qidx_mask_bit;
+        }
+
+        // Increase the queue count for this sched object
+        count = em.shm->core_sched_add_counts[core].add_count.parallel_ord_add_cnt[group].q_grp_cnt;
+        em.shm->core_sched_add_counts[core].add_count.parallel_ord_add_cnt[group].q_grp_cnt = count + 1;
+
+        if(count == 0)
+        {
+          // Set the mask bit for this sched object, i.e. enable scheduling for this type,group
+          group_mask_set(&em.shm->core_sched_masks[core].sched_masks_prio.parallel_ord_masks.q_grp_mask, group);
+        }
+
+      }
+      else
+      {
+        env_spinlock_unlock(&em.shm->sched_add_counts_lock.lock);
+        
+        return EM_INTERNAL_ERROR(EM_ERR_NOT_FOUND, EM_ESCOPE_SCHED_MASKS_ADD,
+                                 "Unknown EM-queue type (%u)", type);
+      }
+
+    }
+  } // for(;;)
+
+
+  env_spinlock_unlock(&em.shm->sched_add_counts_lock.lock);
+
+  return EM_OK;
+}
+
+
+
+/**
+ * Clear bits in the masks used by the scheduler.
+ * Triggered by a call to em_queue_disable(_all)
+ */
+em_status_t
+sched_masks_rem_queue(const em_queue_t       queue,
+                      const em_queue_type_t  type,
+                      const em_queue_group_t group)
+{
+  em_status_t        err;
+  em_core_mask_t     core_mask;
+  char               mask_str[EM_CORE_MASK_STRLEN];
+  int                core_count;
+  int                core;
+  uint16_t           count, qidx_count;
+  uint64_t           qidx;
+  uint16_t           qidx_mask_bit;
+
+
+  err = em_queue_group_mask(group, &core_mask);
+
+  RETURN_ERROR_IF(err != EM_OK, err, EM_ESCOPE_SCHED_MASKS_REM,
+                  "em_queue_group_mask(group=%"PRI_QGRP", core_mask=%s) returns %u",
+                   group, em_core_mask_tostr(mask_str, sizeof(mask_str), &core_mask), err);
+
+
+  core_count = em_core_count();
+  
+  
+  if(em_core_mask_iszero(&core_mask))
+  {
+    // The queue group is newly created or has been modified and removed from all cores.
+    // Set the core_mask to include all running cores and remove the queue from all. 
+    em_core_mask_set_count(core_count, &core_mask);
+  }
+
+
+  env_spinlock_lock(&em.shm->sched_add_counts_lock.lock);
+  
+
+  for(core = 0; core < core_count; core++)
+  {
+    if(em_core_mask_isset(core, &core_mask))
+    {
+      if(type == EM_QUEUE_TYPE_ATOMIC)
+      {
+        sched_q_atomic_t *const sched_q_obj = &em.shm->sched_qs_prio.sched_q_atomic[group];
+        
+        qidx = queue & (sched_q_obj->queue_mask);
+
+        count      = em.shm->core_sched_add_counts[core].add_count.atomic_add_cnt[group].q_grp_cnt;
+        qidx_count = em.shm->core_sched_add_counts[core].add_count.atomic_add_cnt[group].qidx_cnt[qidx];
+
+        // Decrease qidx count and if needed clear associated bit to remove from scheduling
+        if(qidx_count > 1)
+        {
+          em.shm->core_sched_add_counts[core].add_count.atomic_add_cnt[group].qidx_cnt[qidx] = qidx_count - 1;
+        }
+        else if(qidx_count == 1)
+        {
+          em.shm->core_sched_add_counts[core].add_count.atomic_add_cnt[group].qidx_cnt[qidx] = 0;
+          
+          qidx_mask_bit = (uint16_t) (1 << qidx);
+          em.shm->core_sched_masks[core].sched_masks_prio.atomic_masks.qidx_mask[group] &= (~qidx_mask_bit);
+        }
+        
+        // Decrease sched obj count and if needed disable scheduling for this group by clearing the bit
+        if(count > 1)
+        {
+          em.shm->core_sched_add_counts[core].add_count.atomic_add_cnt[group].q_grp_cnt = count - 1;
+        }
+        else if(count == 1)
+        {
+          em.shm->core_sched_add_counts[core].add_count.atomic_add_cnt[group].q_grp_cnt = 0;
+          group_mask_clr(&em.shm->core_sched_masks[core].sched_masks_prio.atomic_masks.q_grp_mask, group);
+        }
+        
+      }
+      else if(type == EM_QUEUE_TYPE_PARALLEL)
+      {
+        sched_q_parallel_t *const sched_q_obj = &em.shm->sched_qs_prio.sched_q_parallel[group];
+        
+        qidx = queue & (sched_q_obj->queue_mask);
+
+        count      = em.shm->core_sched_add_counts[core].add_count.parallel_add_cnt[group].q_grp_cnt;
+        qidx_count = em.shm->core_sched_add_counts[core].add_count.parallel_add_cnt[group].qidx_cnt[qidx];
+
+        // Decrease qidx count and if needed clear associated bit to remove from scheduling
+        if(qidx_count > 1)
+        {
+          em.shm->core_sched_add_counts[core].add_count.parallel_add_cnt[group].qidx_cnt[qidx] = qidx_count - 1;
+        }
+        else if(qidx_count == 1)
+        {
+          em.shm->core_sched_add_counts[core].add_count.parallel_add_cnt[group].qidx_cnt[qidx] = 0;
+          
+          qidx_mask_bit = (uint16_t) (1 << qidx);
+          em.shm->core_sched_masks[core].sched_masks_prio.parallel_masks.qidx_mask[group] &= (~qidx_mask_bit);
+        }
+        
+        // Decrease sched obj count and if needed disable scheduling for this group by clearing the bit
+        if(count > 1)
+        {
+          em.shm->core_sched_add_counts[core].add_count.parallel_add_cnt[group].q_grp_cnt = count - 1;
+        }
+        else if(count == 1)
+        {
+          em.shm->core_sched_add_counts[core].add_count.parallel_add_cnt[group].q_grp_cnt = 0;
+          group_mask_clr(&em.shm->core_sched_masks[core].sched_masks_prio.parallel_masks.q_grp_mask, group);
+        }
+        
+      }
+      else if(type == EM_QUEUE_TYPE_PARALLEL_ORDERED)
+      {
+        sched_q_parallel_ord_t *const sched_q_obj = &em.shm->sched_qs_prio.sched_q_parallel_ord[group];
+        
+        qidx = queue & (sched_q_obj->queue_mask);
+
+        count      = em.shm->core_sched_add_counts[core].add_count.parallel_ord_add_cnt[group].q_grp_cnt;
+        qidx_count = em.shm->core_sched_add_counts[core].add_count.parallel_ord_add_cnt[group].qidx_cnt[qidx];
+
+        // Decrease qidx count and if needed clear associated bit to remove from scheduling
+        if(qidx_count > 1)
+        {
+          em.shm->core_sched_add_counts[core].add_count.parallel_ord_add_cnt[group].qidx_cnt[qidx] = qidx_count - 1;
+        }
+        else if(qidx_count == 1)
+        {
+          em.shm->core_sched_add_counts[core].add_count.parallel_ord_add_cnt[group].qidx_cnt[qidx] = 0;
+          
+          qidx_mask_bit = (uint16_t) (1 << qidx);
+          em.shm->core_sched_masks[core].sched_masks_prio.parallel_ord_masks.qidx_mask[group] &= (~qidx_mask_bit);
+        }
+        
+        // Decrease sched obj count and if needed disable scheduling for this group by clearing the bit
+        if(count > 1)
+        {
+          em.shm->core_sched_add_counts[core].add_count.parallel_ord_add_cnt[group].q_grp_cnt = count - 1;
+        }
+        else if(count == 1)
+        {
+          em.shm->core_sched_add_counts[core].add_count.parallel_ord_add_cnt[group].q_grp_cnt = 0;
+          group_mask_clr(&em.shm->core_sched_masks[core].sched_masks_prio.parallel_ord_masks.q_grp_mask, group);
+        }
+        
+      }
+      else{
+        env_spinlock_unlock(&em.shm->sched_add_counts_lock.lock);
+        
+        return EM_INTERNAL_ERROR(EM_ERR_NOT_FOUND, EM_ESCOPE_SCHED_MASKS_REM,
+                                 "Unknown EM-queue type (%u)", type);
+      }
+    }
+  } // for(;;)
+
+  
+  env_spinlock_unlock(&em.shm->sched_add_counts_lock.lock);
+
+  return EM_OK;
+}
+
+
+
+
+/**
+ * Set bits in the scheduling masks associated with the queue group 'grp'.
+ * Triggered locally on a core by em_queue_group_modify() or em_queue_group_create()
+ */
+void
+sched_masks_add_queue_group__local(const em_queue_group_t group)
+{
+  m_list_head_t      *pos;
+  m_list_head_t      *qgrp_node;
+  em_queue_element_t *q_elem;
+  uint16_t            count, qidx_count;
+  uint64_t            qidx;
+  uint16_t            qidx_mask_bit;
+
+
+  env_spinlock_lock(&em.shm->em_queue_group_lock.lock);
+  env_spinlock_lock(&em.shm->sched_add_counts_lock.lock);
+
+  
+  /*
+   * Loop through the queues that belong to this queue group
+   * and modify scheduling information locally on this core.
+   */
+  m_list_for_each(&em.shm->em_queue_group[group].list_head, pos, qgrp_node)
+  {
+    q_elem = m_list_qgrp_node_to_queue_elem(qgrp_node);
+   
+    if(q_elem->status == EM_QUEUE_STATUS_READY)
+    {
+      em_queue_type_t type  = q_elem->scheduler_type;
+      em_queue_t      queue = q_elem->id;
+
+      
+      if(type == EM_QUEUE_TYPE_ATOMIC)
+      {
+        sched_q_atomic_t *const sched_q_obj = &em.shm->sched_qs_prio.sched_q_atomic[group];
+          
+        qidx = queue & (sched_q_obj->queue_mask);        
+        
+        qidx_mask_bit = (uint16_t) (1 << qidx);
+
+        qidx_count = sched_core_local.sched_add_counts->add_count.atomic_add_cnt[group].qidx_cnt[qidx];
+        sched_core_local.sched_add_counts->add_count.atomic_add_cnt[group].qidx_cnt[qidx] = qidx_count + 1;
+          
+        // Set the bit QIDX bit, i.e. enable scheduling for the FIFO that the EM-queue is scheduled through
+        sched_core_local.sched_masks->sched_masks_prio.atomic_masks.qidx_mask[group] |= qidx_mask_bit;
+        
+        
+        // Increase the queue count for this sched object
+        count = sched_core_local.sched_add_counts->add_count.atomic_add_cnt[group].q_grp_cnt;
+        sched_core_local.sched_add_counts->add_count.atomic_add_cnt[group].q_grp_cnt = count + 1;         
+        
+        // Set the mask bit for this sched object, i.e. enable scheduling for this type,group
+        group_mask_set(&sched_core_local.sched_masks->sched_masks_prio.atomic_masks.q_grp_mask, group);
+      }
+      else if(type == EM_QUEUE_TYPE_PARALLEL)
+      {
+        sched_q_parallel_t *const sched_q_obj = &em.shm->sched_qs_prio.sched_q_parallel[group];
+          
+        qidx = queue & (sched_q_obj->queue_mask);        
+        
+        qidx_mask_bit = (uint16_t) (1 << qidx);
+
+        qidx_count = sched_core_local.sched_add_counts->add_count.parallel_add_cnt[group].qidx_cnt[qidx];
+        sched_core_local.sched_add_counts->add_count.parallel_add_cnt[group].qidx_cnt[qidx] = qidx_count + 1;
+          
+        // Set the bit QIDX bit, i.e. enable scheduling for the FIFO that the EM-queue is scheduled through
+        sched_core_local.sched_masks->sched_masks_prio.parallel_masks.qidx_mask[group] |= qidx_mask_bit;
+
+
+        // Increase the queue count for this sched object
+        count = sched_core_local.sched_add_counts->add_count.parallel_add_cnt[group].q_grp_cnt;
+        sched_core_local.sched_add_counts->add_count.parallel_add_cnt[group].q_grp_cnt = count + 1;         
+        
+        // Set the mask bit for this sched object, i.e. enable scheduling for this type,group
+        group_mask_set(&sched_core_local.sched_masks->sched_masks_prio.parallel_masks.q_grp_mask, group);
+      }
+      else if(type == EM_QUEUE_TYPE_PARALLEL_ORDERED)
+      {
+        sched_q_parallel_ord_t *const sched_q_obj = &em.shm->sched_qs_prio.sched_q_parallel_ord[group];
+          
+        qidx = queue & (sched_q_obj->queue_mask);        
+        
+        qidx_mask_bit = (uint16_t) (1 << qidx);
+
+        qidx_count = sched_core_local.sched_add_counts->add_count.parallel_ord_add_cnt[group].qidx_cnt[qidx];
+        sched_core_local.sched_add_counts->add_count.parallel_ord_add_cnt[group].qidx_cnt[qidx] = qidx_count + 1;
+          
+        // Set the bit QIDX bit, i.e. enable scheduling for the FIFO that the EM-queue is scheduled through
+        sched_core_local.sched_masks->sched_masks_prio.parallel_ord_masks.qidx_mask[group] |= qidx_mask_bit;
+
+
+        // Increase the queue count for this sched object
+        count = sched_core_local.sched_add_counts->add_count.parallel_ord_add_cnt[group].q_grp_cnt;
+        sched_core_local.sched_add_counts->add_count.parallel_ord_add_cnt[group].q_grp_cnt = count + 1;         
+        
+        // Set the mask bit for this sched object, i.e. enable scheduling for this type,group
+        group_mask_set(&sched_core_local.sched_masks->sched_masks_prio.parallel_ord_masks.q_grp_mask, group);
+      }
+      else
+      {
+        env_spinlock_unlock(&em.shm->sched_add_counts_lock.lock);
+        env_spinlock_unlock(&em.shm->em_queue_group_lock.lock);  
+        
+        EM_INTERNAL_ERROR(EM_ERR_NOT_FOUND, EM_ESCOPE_SCHED_MASKS_ADD,
+                          "Unknown EM-queue type (%u)", type);
+        return;
+      }
+      
+    }
+  }
+  
+  env_spinlock_unlock(&em.shm->sched_add_counts_lock.lock);
+  env_spinlock_unlock(&em.shm->em_queue_group_lock.lock);
+}
+
+
+
+
+/**
+ * Clear all set bits in the scheduling masks associated with the queue group 'grp'
+ * Triggered locally on a core by em_queue_group_modify() or em_queue_group_delete()
+ */
+void
+sched_masks_rem_queue_group__local(const em_queue_group_t grp)
+{
+  int qidx;
+  
+  
+  env_spinlock_lock(&em.shm->sched_add_counts_lock.lock);
+  
+  group_mask_clr(&sched_core_local.sched_masks->sched_masks_prio.atomic_masks.q_grp_mask,       grp);
+  group_mask_clr(&sched_core_local.sched_masks->sched_masks_prio.parallel_masks.q_grp_mask,     grp);
+  group_mask_clr(&sched_core_local.sched_masks->sched_masks_prio.parallel_ord_masks.q_grp_mask, grp);
+  
+  sched_core_local.sched_add_counts->add_count.atomic_add_cnt[grp].q_grp_cnt       = 0;
+  sched_core_local.sched_add_counts->add_count.parallel_add_cnt[grp].q_grp_cnt     = 0;
+  sched_core_local.sched_add_counts->add_count.parallel_ord_add_cnt[grp].q_grp_cnt = 0;
+  
+  
+  sched_core_local.sched_masks->sched_masks_prio.atomic_masks.qidx_mask[grp]       = 0x0;
+  sched_core_local.sched_masks->sched_masks_prio.parallel_masks.qidx_mask[grp]     = 0x0;
+  sched_core_local.sched_masks->sched_masks_prio.parallel_ord_masks.qidx_mask[grp] = 0x0;
+  
+  for(qidx = 0; qidx < SCHED_Q_MAX_QUEUES; qidx++)
+  {
+    sched_core_local.sched_add_counts->add_count.atomic_add_cnt[grp].qidx_cnt[qidx]       = 0;
+    sched_core_local.sched_add_counts->add_count.parallel_add_cnt[grp].qidx_cnt[qidx]     = 0;
+    sched_core_local.sched_add_counts->add_count.parallel_ord_add_cnt[grp].qidx_cnt[qidx] = 0;
+  }
+  
+  env_spinlock_unlock(&em.shm->sched_add_counts_lock.lock);
+}
+
+
+
+
+/**
+ * Send event with group number.
+ *
+ * Any valid event and destination queue parameters can be used. Event group id
+ * indicates which event group the event belongs to. Event group has to be first
+ * created and applied.
+ *
+ * @param event    Event to send
+ * @param queue    Destination queue
+ * @param group    Event group
+ *
+ * @return EM_OK if successful.
+ *
+ * @see em_send(), em_event_group_create(), em_event_group_apply(), em_event_group_increment()
+ */
+em_status_t
+em_send_group(em_event_t event, em_queue_t queue, em_event_group_t group)
+{
+  em_queue_element_t *const q_elem = get_queue_element(queue);
+  PREFETCH_Q_ELEM(q_elem);
+  em_event_hdr_t     *const ev_hdr = event_to_event_hdr(event);
+  em_status_t               em_status;
+
+
+  // env_sync_mem();
+
+  ev_hdr->event_group = group;
+
+
+  if(ev_hdr->src_q_type == EM_QUEUE_TYPE_PARALLEL_ORDERED)
+  {
+    em_status = em_send_from_parallel_ord_q(ev_hdr, q_elem, queue, OPERATION_SEND);
+  }
+  else IF_UNLIKELY(q_elem->direct_dispatch && em_direct_dispatch_possible(q_elem))
+  {
+    /* Run-to-completion: dispatch to the destination EO on this core, nested in this receive call. */
+    em_status = em_direct_dispatch_send(ev_hdr, q_elem);
+  }
+  else
+  {
+    /* Send to queue based on the destination queue type. */
+    em_status = em_send_switch(ev_hdr, q_elem, queue);
+  }
+
+
+  return em_status;
+}
+
+
+
+/**
+ * Send multiple events with group number to the same queue.
+ *
+ * Events are enqueued in bursts: one enqueue operation (and for atomic queues one
+ * event count update) per burst instead of per event. Events originating from the same
+ * parallel-ordered queue are marked for output with one order-queue lock operation.
+ *
+ * @param events   Events to send
+ * @param num      Number of events
+ * @param queue    Destination queue
+ * @param group    Event group
+ *
+ * @return The number of events successfully sent (0...num), events[0...return-1].
+ *         The caller still owns the remaining events.
+ *
+ * @see em_send_multi(), em_send_group()
+ */
+int
+em_send_group_multi(em_event_t events[], int num, em_queue_t queue, em_event_group_t group)
+{
+  em_queue_element_t *const q_elem = get_queue_element(queue);
+  PREFETCH_Q_ELEM(q_elem);
+  em_event_hdr_t           *ev_hdrs[MAX_E_BULK_SEND];
+  int                       sent = 0;
+  
+
+  while(sent < num)
+  {
+    em_event_hdr_t     *ev_hdr = event_to_event_hdr(events[sent]);
+    // Events from a parallel-ordered queue must be sent through the order-queue of that (source) queue
+    em_queue_element_t *src_q_elem = (ev_hdr->src_q_type == EM_QUEUE_TYPE_PARALLEL_ORDERED) ? ev_hdr->q_elem : NULL;
+    em_queue_element_t *tmp_q_elem;
+    int                 n = 0;
+    int                 ret;
+    
+    // Collect consecutive events with the same origin
+    do {
+      ev_hdr->event_group = group;
+      ev_hdrs[n++]        = ev_hdr;
+      
+      if(((sent + n) == num) || (n == MAX_E_BULK_SEND)) {
+        break;
+      }
+      
+      ev_hdr     = event_to_event_hdr(events[sent + n]);
+      tmp_q_elem = (ev_hdr->src_q_type == EM_QUEUE_TYPE_PARALLEL_ORDERED) ? ev_hdr->q_elem : NULL;
+      
+    } while(tmp_q_elem == src_q_elem);
+    
+    
+    if(src_q_elem != NULL)
+    {
+      ret = em_send_from_parallel_ord_q_multi(ev_hdrs, n, q_elem, queue, OPERATION_SEND);
+    }
+    else
+    {
+      /* Send to queue based on the destination queue type. */
+      ret = em_send_switch_multi(ev_hdrs, n, q_elem, queue);
+    }
+    
+    sent += ret;
+    
+    IF_UNLIKELY(ret != n) {
+      break;
+    }
+  }
+
+
+  return sent;
+}
+
+
+
+/**
+ * Sends events ORIGINATING from a parallel-ordered queue. Alternatively handles free requests.
+ *
+ * Events are sent to the destination queue (of any type) in the order that they arrived in the
+ * source parallel-ordered queue. If an event is sent/freed before a previous event has completed
+ * then it is left to wait in he order-queue. Once the previous event(s) are done then ALL completed
+ * events are sent to the destinations queues.
+ *
+ * @param ev_hdr    the event header
+ * @param q_elem    destination queue element (or NULL   if operation==OPERATION_MARK_FREE)
+ * @param queue     destination queue (or EM_QUEUE_UNDEF if operation==OPERATION_MARK_FREE)
+ * @param operation OPERATION_SEND      - Normal send FROM parallel-ordered queue
+                    OPERATION_MARK_FREE - em_free() called for event origination from parl-ord. queue
+ *
+ * @return status EM_OK on success (OK does not guarantee
+ *                 message delivery, it only suggest the event was
+ *                 posted successfully)
+ */
+em_status_t
+em_send_from_parallel_ord_q(em_event_hdr_t     *const ev_hdr,
+                            em_queue_element_t *const q_elem,
+                            const em_queue_t          queue,
+                            const int                 operation)
+{
+#if LOCKLESS_ORDERED_QUEUES == 1
+
+  em_queue_element_t *const src_q_elem = ev_hdr->q_elem; // Stored by previous em_send_xxx()
+  order_block_t      *const blk        = ev_hdr->order_blk;
+
+
+  // Clear src_q_type - set again in em_schedule_parallell_ordered() if 'queue' is of that type.
+  ev_hdr->src_q_type      = EM_QUEUE_TYPE_UNDEF;
+  // Save the intended operation for the event: send, free or packet-output
+  ev_hdr->operation       = operation;
+  // Store the destination q_elem (can be NULL for packet-output)
+  ev_hdr->dst_q_elem      = q_elem;
+
+  // Mark event as 'processed' and ready for sending: store it into the slot of its ticket.
+  // xchg is a full barrier: the slot is visible before the release token is checked.
+  (void) __sync_lock_test_and_set(&blk->slot[ev_hdr->order_ticket - blk->base], ev_hdr);
+
+  // Output all events completed in order from the window head (unless another core is doing it)
+  return order_window_release(src_q_elem, ev_hdr);
+
+#else // LOCKLESS_ORDERED_QUEUES == 0
+
+  env_spinlock_t     *const lock = ev_hdr->lock_p;
+  em_queue_element_t *src_q_elem;  // Stored by previous em_send_xxx()
+
+
+  /* Take the lock early - another core might also be checking the order-queue */
+  env_spinlock_lock(lock);
+
+
+  // Clear src_q_type - set again in em_schedule_parallell_ordered() if 'queue' is of that type.
+  ev_hdr->src_q_type      = EM_QUEUE_TYPE_UNDEF;
+  // Mark event as 'processed' and ready for sending.
+  ev_hdr->processing_done = 1;
+  // Save the intended operation for the event: send, free or packet-output
+  ev_hdr->operation       = operation;
+  // Store the destination q_elem (can be NULL for packet-output)
+  ev_hdr->dst_q_elem      = q_elem;
+
+
+  // Store ptr to the source parallel-ordered queue
+  src_q_elem = ev_hdr->q_elem;
+
+
+  if(ev_hdr != src_q_elem->u.parallel_ord.order_first)
+  {
+    /*
+     * NOT the first ev_hdr in the order-queue, return to wait for the first to complete.
+     */
+    env_spinlock_unlock(lock);
+
+    return EM_OK;
+  }
+  else
+  {
+    em_status_t ret_status;
+    
+    /*
+     * Send HEAD EVENT - see also if other later events have completed processing,
+     * and if so, dequeue from order-queue and send all to their destination queues.
+     */
+    ret_status = order_queue_output(src_q_elem, ev_hdr, ev_hdr);
+
+    env_spinlock_unlock(lock);
+    
+    return ret_status;
+  }
+  
+#endif // LOCKLESS_ORDERED_QUEUES
+}
+
+
+
+/**
+ * Sends (or handles the free requests for) multiple events ORIGINATING from the same parallel-ordered queue.
+ *
+ * As em_send_from_parallel_ord_q() but all events are marked as processed with one order-queue
+ * lock operation (or one reorder window release). Consecutive events to the same destination
+ * are then sent in bursts.
+ *
+ * @param ev_hdrs   the event headers, all from the same parallel-ordered queue
+ * @param num       the number of event headers
+ * @param q_elem    destination queue element (or NULL   if operation==OPERATION_MARK_FREE)
+ * @param queue     destination queue (or EM_QUEUE_UNDEF if operation==OPERATION_MARK_FREE)
+ * @param operation OPERATION_SEND or OPERATION_MARK_FREE
+ *
+ * @return The number of events accepted (always 'num'). Events that cannot be enqueued 
+ *         into their destination once in order are freed, the failure is not reported
+ *         (documented for em_send_group_multi()).
+ */
+int
+em_send_from_parallel_ord_q_multi(em_event_hdr_t     *const ev_hdrs[],
+                                  const int                 num,
+                                  em_queue_element_t *const q_elem,
+                                  const em_queue_t          queue,
+                                  const int                 operation)
+{
+#if LOCKLESS_ORDERED_QUEUES == 1
+
+  em_queue_element_t *const src_q_elem = ev_hdrs[0]->q_elem; // Stored by previous em_send_xxx()
+  int                       i;
+
+
+  for(i = 0; i < num; i++)
+  {
+    em_event_hdr_t *const ev_hdr = ev_hdrs[i];
+    order_block_t  *const blk    = ev_hdr->order_blk;
+    
+    // Clear src_q_type - set again in em_schedule_parallell_ordered() if 'queue' is of that type.
+    ev_hdr->src_q_type      = EM_QUEUE_TYPE_UNDEF;
+    // Save the intended operation for the event: send or free
+    ev_hdr->operation       = operation;
+    // Store the destination q_elem
+    ev_hdr->dst_q_elem      = q_elem;
+    
+    // Mark event as 'processed', xchg is a full barrier (see em_send_from_parallel_ord_q())
+    (void) __sync_lock_test_and_set(&blk->slot[ev_hdr->order_ticket - blk->base], ev_hdr);
+  }
+  
+  (void) order_window_release(src_q_elem, NULL);
+  
+  return num;
+
+#else // LOCKLESS_ORDERED_QUEUES == 0
+
+  env_spinlock_t     *const lock       = ev_hdrs[0]->lock_p;
+  em_queue_element_t *const src_q_elem = ev_hdrs[0]->q_elem; // Stored by previous em_send_xxx()
+  em_event_hdr_t           *first_hdr  = NULL;
+  int                       i;
+
+
+  /* Take the lock early - another core might also be checking the order-queue */
+  env_spinlock_lock(lock);
+
+  for(i = 0; i < num; i++)
+  {
+    em_event_hdr_t *const ev_hdr = ev_hdrs[i];
+    
+    // Clear src_q_type - set again in em_schedule_parallell_ordered() if 'queue' is of that type.
+    ev_hdr->src_q_type      = EM_QUEUE_TYPE_UNDEF;
+    // Mark event as 'processed' and ready for sending.
+    ev_hdr->processing_done = 1;
+    // Save the intended operation for the event: send or free
+    ev_hdr->operation       = operation;
+    // Store the destination q_elem
+    ev_hdr->dst_q_elem      = q_elem;
+    
+    if(ev_hdr == src_q_elem->u.parallel_ord.order_first) {
+      first_hdr = ev_hdr;
+    }
+  }
+  
+  
+  // Output in order if the first ev_hdr in the order-queue was one of the given ones
+  if(first_hdr != NULL)
+  {
+    (void) order_queue_output(src_q_elem, first_hdr, NULL);
+  }
+
+  env_spinlock_unlock(lock);
+  
+  return num;
+  
+#endif // LOCKLESS_ORDERED_QUEUES
+}
+
+
+
+/**
+ * Output the first event in the order-queue of a parallel-ordered queue and all 
+ * following events that have completed processing. Called with the order-queue lock taken.
+ *
+ * @param src_q_elem  the parallel-ordered queue 
+ * @param first_hdr   the first event (header) in order, processing completed
+ * @param in_hdr      input event of em_send() (or NULL), the caller keeps this event on send failure
+ *
+ * @return EM_OK or the send error status of 'in_hdr'
+ */
+static inline em_status_t
+order_queue_output(em_queue_element_t *const src_q_elem,
+                   em_event_hdr_t     *const first_hdr,
+                   em_event_hdr_t     *const in_hdr)
+{
+  em_status_t         em_status;
+  em_status_t         ret_status = EM_OK;
+  // Consecutive events to the same destination queue are sent in bursts
+  em_event_hdr_t     *send_hdrs[MAX_E_BULK_SEND];
+  int                 send_num   = 0;
+  // helper vars:
+  em_event_hdr_t     *tmp_hdr;
+  int                 processing_done;
+  int                 ret;
+  
+  union {
+    em_event_hdr_t  *ev_hdr;
+    void            *ev_hdr_void;
+  } de_q;
+
+
+  /* FIRST in order - Clear ptr to first ev_hdr */
+  src_q_elem->u.parallel_ord.order_first = NULL;
+
+
+  de_q.ev_hdr = first_hdr; // initialize loop
+
+  do {
+    tmp_hdr         = de_q.ev_hdr;
+    processing_done = tmp_hdr->processing_done;
+
+    ret = 1; // 1 breaks out of loop if not changed
+    
+    if(processing_done)
+    {
+      send_num = order_queue_output__event(src_q_elem, tmp_hdr, send_hdrs, send_num, in_hdr, &ret_status);
+
+      // Dequeue next ev_hdr in order-list (if any)
+      ret = rte_ring_dequeue(src_q_elem->rte_ring, &de_q.ev_hdr_void);
+    }
+  } while(!ret);
+
+
+  if(send_num > 0)
+  {
+    em_status = order_queue_output__send(send_hdrs, send_num, in_hdr);
+    
+    IF_UNLIKELY(em_status != EM_OK) {
+      ret_status = em_status;
+    }
+  }
+
+
+  if(!processing_done)
+  {
+    // Set new head ev_hdr instead of NULL
+    src_q_elem->u.parallel_ord.order_first = tmp_hdr;
+  }
+  
+  return ret_status;
+}
+
+
+
+/**
+ * Send a burst of in-order events (headers) from an order-queue to their common destination queue.
+ * 
+ * On error: Drop the events that could not be sent, except 'in_hdr' (the input event to em_send()).
+ * Note that the packet order for the input event is lost.
+ *
+ * @return EM_OK or the send error status of 'in_hdr'
+ */
+static inline em_status_t
+order_queue_output__send(em_event_hdr_t *const send_hdrs[],
+                         const int             num,
+                         em_event_hdr_t *const in_hdr)
+{
+  em_queue_element_t *const dst_q_elem = send_hdrs[0]->dst_q_elem;
+  em_status_t               em_status  = EM_OK;
+  em_status_t               ret_status = EM_OK;
+  int                       sent;
+  int                       i;
+  
+  
+  /* Send to queue based on the destination queue type. */
+  IF_LIKELY(num == 1)
+  {
+    em_status = em_send_switch(send_hdrs[0], dst_q_elem, dst_q_elem->id);
+    sent      = (em_status == EM_OK) ? 1 : 0;
+  }
+  else
+  {
+    sent      = em_send_switch_multi(send_hdrs, num, dst_q_elem, dst_q_elem->id);
+    em_status = EM_ERR_LIB_FAILED; // Only used if sent < num
+  }
+  
+  for(i = sent; i < num; i++)
+  {
+    if(send_hdrs[i] == in_hdr) {
+      ret_status = em_status;
+    }
+    else {
+      intel_free(send_hdrs[i]);
+    }
+  }
+  
+  return ret_status;
+}
+
+
+
+/**
+ * Output one in-order event (header) of a parallel-ordered queue according to its stored operation.
+ * Events to be sent are collected into 'send_hdrs' and sent in bursts to the same destination queue,
+ * the caller sends the remaining collected events when done.
+ *
+ * @param src_q_elem  the parallel-ordered queue
+ * @param ev_hdr      the event (header) to output, processing completed
+ * @param send_hdrs   collected events waiting to be sent (max MAX_E_BULK_SEND)
+ * @param send_num    number of events in 'send_hdrs'
+ * @param in_hdr      input event of em_send() (or NULL), the caller keeps this event on send failure
+ * @param ret_status  updated with the send error status of 'in_hdr'
+ *
+ * @return The new number of events in 'send_hdrs'
+ */
+static inline int
+order_queue_output__event(em_queue_element_t *const src_q_elem,
+                          em_event_hdr_t     *const ev_hdr,
+                          em_event_hdr_t           *send_hdrs[],
+                          int                       send_num,
+                          em_event_hdr_t     *const in_hdr,
+                          em_status_t        *const ret_status)
+{
+  const int   operation = ev_hdr->operation;
+  em_status_t em_status;
+  
+  
+  // Send the collected events first if this one can't be added to the same burst 
+  if((send_num > 0) && ((operation != OPERATION_SEND) || 
+                        (ev_hdr->dst_q_elem != send_hdrs[0]->dst_q_elem) ||
+                        (send_num == MAX_E_BULK_SEND)))
+  {
+    em_status = order_queue_output__send(send_hdrs, send_num, in_hdr);
+    send_num  = 0;
+    
+    IF_UNLIKELY(em_status != EM_OK) {
+      *ret_status = em_status;
+    }
+  }
+
+  switch(operation)
+  {
+    case OPERATION_ETH_TX:
+    {
+      struct rte_mbuf *const m = (struct rte_mbuf *) (((size_t) ev_hdr) - sizeof(struct rte_mbuf));
+    
+      eth_tx_packet__ordered(m, ev_hdr->io_port, EM_QUEUE_TO_MBUF_TBL(src_q_elem->id));
+    }
+    break;
+    
+    case OPERATION_SEND:
+    {
+      send_hdrs[send_num++] = ev_hdr;
+    }
+    break;
+    
+    default:
+    {
+      // OPERATION_MARK_FREE
+      intel_free(ev_hdr);
+    }
+    break;
+    
+  } // switch(operation)
   
-  env_spinlock_unlock(&em.shm->sched_add_counts_lock.lock);
-
-  return EM_OK;
+  return send_num;
 }
 
 
 
-
+#if LOCKLESS_ORDERED_QUEUES == 1
 /**
- * Set bits in the scheduling masks associated with the queue group 'grp'.
- * Triggered locally on a core by em_queue_group_modify() or em_queue_group_create()
+ * Hand out reorder window tickets, in the given order, to events scheduled from a parallel-ordered queue.
+ * Calls for the same queue are serialized by the scheduling queue lock of the queue.
+ *
+ * Up to 'capacity' events in processing are kept in order. Beyond that the window grows
+ * (EM_ORDER_OVERFLOW_GROW, up to EM_QUEUE_PARALLEL_ORD_WINDOW_MAX) or the remaining events 
+ * get no ticket and are sent without restoring their order (EM_ORDER_OVERFLOW_UNORDERED).
+ *
+ * @return The number of events that got a ticket
  */
-void
-sched_masks_add_queue_group__local(const em_queue_group_t group)
+static inline int
+order_window_tickets(em_queue_element_t *const q_elem,
+                     em_event_hdr_t     *const ev_hdrs[],
+                     const int                 num)
 {
-  m_list_head_t      *pos;
-  m_list_head_t      *qgrp_node;
-  em_queue_element_t *q_elem;
-  uint16_t            count, qidx_count;
-  uint64_t            qidx;
-  uint16_t            qidx_mask_bit;
+  order_window_t *const win  = q_elem->u.parallel_ord.order_win;
+  order_block_t        *blk  = win->tail_blk;
+  uint32_t              tail = win->tail;
+  order_block_t        *next;
+  int                   n;
+  int                   i;
+  
+  
+  for(n = 0; n < num; n++)
+  {
+    IF_UNLIKELY((tail - win->head) >= win->capacity)
+    {
+      if(win->overflow_mode != EM_ORDER_OVERFLOW_GROW) {
+        break;
+      }
+      
+      win->overflow_events++;
+    }
+    
+    IF_UNLIKELY((tail - blk->base) == EM_QUEUE_PARALLEL_ORD_BLOCK_SIZE)
+    {
+      // Link the next block to the window
+      next = order_window_block_get(win);
+      
+      IF_UNLIKELY(next == NULL) {
+        break;
+      }
+      
+      next->base = tail;
+      next->next = NULL;
+      rte_wmb();
+      blk->next  = next;
+      blk        = next;
+    }
+    
+    // Needed in em_send for re-ordering
+    ev_hdrs[n]->src_q_type   = EM_QUEUE_TYPE_PARALLEL_ORDERED;
+    ev_hdrs[n]->order_blk    = blk;
+    ev_hdrs[n]->order_ticket = tail;
+    ev_hdrs[n]->dst_q_elem   = NULL;
+    
+    tail++;
+  }
+  
+  win->tail_blk = blk;
+  win->tail     = tail;
+  
+  
+  IF_UNLIKELY(n < num)
+  {
+    win->order_lost += num - n;
+    
+    // Window full - order is lost for these events
+    for(i = n; i < num; i++) {
+      ev_hdrs[i]->src_q_type = EM_QUEUE_TYPE_UNDEF;
+    }
+  }
+  
+  return n;
+}
 
 
-  env_spinlock_lock(&em.shm->em_queue_group_lock.lock);
-  env_spinlock_lock(&em.shm->sched_add_counts_lock.lock);
 
+/**
+ * Take a block for the reorder window: from the free list of the window or, if empty and
+ * the window may still grow, a newly allocated one. Called by the ticket side only.
+ *
+ * @return The block or NULL if the window cannot grow
+ */
+static inline order_block_t *
+order_window_block_get(order_window_t *const win)
+{
+  order_block_t *blk;
+  order_block_t *next;
   
-  /*
-   * Loop through the queues that belong to this queue group
-   * and modify scheduling information locally on this core.
-   */
-  m_list_for_each(&em.shm->em_queue_group[group].list_head, pos, qgrp_node)
+  
+  // Pop - the ticket side is the only one removing blocks, thus no ABA-problem
+  do {
+    blk = win->free_blks;
+    
+    IF_UNLIKELY(blk == NULL) {
+      break;
+    }
+    
+    next = blk->next;
+  } while(!__sync_bool_compare_and_swap(&win->free_blks, blk, next));
+  
+  
+  IF_UNLIKELY((blk == NULL) && (win->blocks < win->blocks_max))
   {
-    q_elem = m_list_qgrp_node_to_queue_elem(qgrp_node);
-   
-    if(q_elem->status == EM_QUEUE_STATUS_READY)
-    {
-      em_queue_type_t type  = q_elem->scheduler_type;
-      em_queue_t      queue = q_elem->id;
+    // Overflow: grow the window
+    blk = order_window_block_alloc();
+    
+    if(blk != NULL) {
+      win->blocks++;
+    }
+  }
+  
+  return blk;
+}
 
-      
-      if(type == EM_QUEUE_TYPE_ATOMIC)
-      {
-        sched_q_atomic_t *const sched_q_obj = &em.shm->sched_qs_prio.sched_q_atomic[group];
-          
-        qidx = queue & (sched_q_obj->queue_mask);        
-        
-        qidx_mask_bit = (uint16_t) (1 << qidx);
 
-        qidx_count = sched_core_local.sched_add_counts->add_count.atomic_add_cnt[group].qidx_cnt[qidx];
-        sched_core_local.sched_add_counts->add_count.atomic_add_cnt[group].qidx_cnt[qidx] = qidx_count + 1;
-          
-        // Set the bit QIDX bit, i.e. enable scheduling for the FIFO that the EM-queue is scheduled through
-        sched_core_local.sched_masks->sched_masks_prio.atomic_masks.qidx_mask[group] |= qidx_mask_bit;
-        
-        
-        // Increase the queue count for this sched object
-        count = sched_core_local.sched_add_counts->add_count.atomic_add_cnt[group].q_grp_cnt;
-        sched_core_local.sched_add_counts->add_count.atomic_add_cnt[group].q_grp_cnt = count + 1;         
-        
-        // Set the mask bit for this sched object, i.e. enable scheduling for this type,group
-        group_mask_set(&sched_core_local.sched_masks->sched_masks_prio.atomic_masks.q_grp_mask, group);
-      }
-      else if(type == EM_QUEUE_TYPE_PARALLEL)
-      {
-        sched_q_parallel_t *const sched_q_obj = &em.shm->sched_qs_prio.sched_q_parallel[group];
-          
-        qidx = queue & (sched_q_obj->queue_mask);        
-        
-        qidx_mask_bit = (uint16_t) (1 << qidx);
 
-        qidx_count = sched_core_local.sched_add_counts->add_count.parallel_add_cnt[group].qidx_cnt[qidx];
-        sched_core_local.sched_add_counts->add_count.parallel_add_cnt[group].qidx_cnt[qidx] = qidx_count + 1;
-          
-        // Set the bit QIDX bit, i.e. enable scheduling for the FIFO that the EM-queue is scheduled through
-        sched_core_local.sched_masks->sched_masks_prio.parallel_masks.qidx_mask[group] |= qidx_mask_bit;
+/**
+ * Return a block passed by the release side to the free list of the reorder window.
+ * All slots of the block have been cleared.
+ */
+static inline void
+order_window_block_put(order_window_t *const win, order_block_t *const blk)
+{
+  order_block_t *top;
+  
+  
+  do {
+    top       = win->free_blks;
+    blk->next = top;
+  } while(!__sync_bool_compare_and_swap(&win->free_blks, top, blk));
+}
 
 
-        // Increase the queue count for this sched object
-        count = sched_core_local.sched_add_counts->add_count.parallel_add_cnt[group].q_grp_cnt;
-        sched_core_local.sched_add_counts->add_count.parallel_add_cnt[group].q_grp_cnt = count + 1;         
-        
-        // Set the mask bit for this sched object, i.e. enable scheduling for this type,group
-        group_mask_set(&sched_core_local.sched_masks->sched_masks_prio.parallel_masks.q_grp_mask, group);
-      }
-      else if(type == EM_QUEUE_TYPE_PARALLEL_ORDERED)
-      {
-        sched_q_parallel_ord_t *const sched_q_obj = &em.shm->sched_qs_prio.sched_q_parallel_ord[group];
-          
-        qidx = queue & (sched_q_obj->queue_mask);        
-        
-        qidx_mask_bit = (uint16_t) (1 << qidx);
 
-        qidx_count = sched_core_local.sched_add_counts->add_count.parallel_ord_add_cnt[group].qidx_cnt[qidx];
-        sched_core_local.sched_add_counts->add_count.parallel_ord_add_cnt[group].qidx_cnt[qidx] = qidx_count + 1;
-          
-        // Set the bit QIDX bit, i.e. enable scheduling for the FIFO that the EM-queue is scheduled through
-        sched_core_local.sched_masks->sched_masks_prio.parallel_ord_masks.qidx_mask[group] |= qidx_mask_bit;
+/**
+ * Check if the event at the head of the reorder window has completed.
+ *
+ * May give a false result while another core is outputting events (changing head and head_blk),
+ * that core re-checks after releasing the token.
+ */
+static inline int
+order_window_ready(order_window_t *const win)
+{
+  order_block_t *const blk  = win->head_blk;
+  const uint32_t       idx  = win->head - blk->base;
+  order_block_t       *next;
+  
+  
+  IF_LIKELY(idx < EM_QUEUE_PARALLEL_ORD_BLOCK_SIZE) {
+    return (blk->slot[idx] != NULL);
+  }
+  else if(idx == EM_QUEUE_PARALLEL_ORD_BLOCK_SIZE)
+  {
+    next = blk->next;
+    return ((next != NULL) && (next->slot[0] != NULL));
+  }
+  
+  return 1; // Inconsistent snapshot, let the release token decide
+}
 
 
-        // Increase the queue count for this sched object
-        count = sched_core_local.sched_add_counts->add_count.parallel_ord_add_cnt[group].q_grp_cnt;
-        sched_core_local.sched_add_counts->add_count.parallel_ord_add_cnt[group].q_grp_cnt = count + 1;         
-        
-        // Set the mask bit for this sched object, i.e. enable scheduling for this type,group
-        group_mask_set(&sched_core_local.sched_masks->sched_masks_prio.parallel_ord_masks.q_grp_mask, group);
-      }
-      else
-      {
-        env_spinlock_unlock(&em.shm->sched_add_counts_lock.lock);
-        env_spinlock_unlock(&em.shm->em_queue_group_lock.lock);  
-        
-        EM_INTERNAL_ERROR(EM_ERR_NOT_FOUND, EM_ESCOPE_SCHED_MASKS_ADD,
-                          "Unknown EM-queue type (%u)", type);
-        return;
-      }
-      
+
+/**
+ * Output the events completed in order from the head of the reorder window of a parallel-ordered queue.
+ * 
+ * Only the core holding the release token outputs events, other cores return immediately after
+ * storing their completed events into the window. The token holder re-checks the head after
+ * releasing the token so that an event stored meanwhile is not left behind.
+ *
+ * @param src_q_elem  the parallel-ordered queue 
+ * @param in_hdr      input event of em_send() (or NULL), the caller keeps this event on send failure
+ *
+ * @return EM_OK or the send error status of 'in_hdr'
+ */
+static inline em_status_t
+order_window_release(em_queue_element_t *const src_q_elem,
+                     em_event_hdr_t     *const in_hdr)
+{
+  order_window_t *const win        = src_q_elem->u.parallel_ord.order_win;
+  em_status_t           em_status;
+  em_status_t           ret_status = EM_OK;
+  
+  
+  while(order_window_ready(win) && (__sync_lock_test_and_set(&win->releasing, 1) == 0))
+  {
+    em_status = order_window_output(src_q_elem, win, in_hdr);
+    
+    IF_UNLIKELY(em_status != EM_OK) {
+      ret_status = em_status;
     }
+    
+    // Release the token, then re-check the head (full barrier needed, store-load ordering)
+    win->releasing = 0;
+    rte_mb();
   }
   
-  env_spinlock_unlock(&em.shm->sched_add_counts_lock.lock);
-  env_spinlock_unlock(&em.shm->em_queue_group_lock.lock);
+  return ret_status;
 }
 
 
 
-
 /**
- * Clear all set bits in the scheduling masks associated with the queue group 'grp'
- * Triggered locally on a core by em_queue_group_modify() or em_queue_group_delete()
+ * Output all consecutive completed events from the head of the reorder window.
+ * Called by the release token holder only.
+ *
+ * @return EM_OK or the send error status of 'in_hdr'
  */
-void
-sched_masks_rem_queue_group__local(const em_queue_group_t grp)
+static inline em_status_t
+order_window_output(em_queue_element_t *const src_q_elem,
+                    order_window_t     *const win,
+                    em_event_hdr_t     *const in_hdr)
 {
-  int qidx;
-  
-  
-  env_spinlock_lock(&em.shm->sched_add_counts_lock.lock);
+  em_status_t     em_status;
+  em_status_t     ret_status = EM_OK;
+  // Consecutive events to the same destination queue are sent in bursts
+  em_event_hdr_t *send_hdrs[MAX_E_BULK_SEND];
+  int             send_num   = 0;
+  order_block_t  *blk        = win->head_blk;
+  uint32_t        head       = win->head;
+  order_block_t  *next;
+  em_event_hdr_t *ev_hdr;
   
-  group_mask_clr(&sched_core_local.sched_masks->sched_masks_prio.atomic_masks.q_grp_mask,       grp);
-  group_mask_clr(&sched_core_local.sched_masks->sched_masks_prio.parallel_masks.q_grp_mask,     grp);
-  group_mask_clr(&sched_core_local.sched_masks->sched_masks_prio.parallel_ord_masks.q_grp_mask, grp);
   
-  sched_core_local.sched_add_counts->add_count.atomic_add_cnt[grp].q_grp_cnt       = 0;
-  sched_core_local.sched_add_counts->add_count.parallel_add_cnt[grp].q_grp_cnt     = 0;
-  sched_core_local.sched_add_counts->add_count.parallel_ord_add_cnt[grp].q_grp_cnt = 0;
+  for(;;)
+  {
+    IF_UNLIKELY((head - blk->base) == EM_QUEUE_PARALLEL_ORD_BLOCK_SIZE)
+    {
+      // Block passed - move to the next one (if already linked by the ticket side)
+      next = blk->next;
+      
+      if(next == NULL) {
+        break;
+      }
+      
+      order_window_block_put(win, blk);
+      blk = next;
+    }
+    
+    ev_hdr = blk->slot[head - blk->base];
+    
+    if(ev_hdr == NULL) {
+      break;
+    }
+    
+    blk->slot[head - blk->base] = NULL;
+    head++;
+    
+    send_num = order_queue_output__event(src_q_elem, ev_hdr, send_hdrs, send_num, in_hdr, &ret_status);
+  }
+
+
+  if(send_num > 0)
+  {
+    em_status = order_queue_output__send(send_hdrs, send_num, in_hdr);
+    
+    IF_UNLIKELY(em_status != EM_OK) {
+      ret_status = em_status;
+    }
+  }
   
+  // Store head before head_blk, order_window_ready() reads them in the opposite order
+  win->head     = head;
+  rte_wmb();
+  win->head_blk = blk;
   
-  sched_core_local.sched_masks->sched_masks_prio.atomic_masks.qidx_mask[grp]       = 0x0;
-  sched_core_local.sched_masks->sched_masks_prio.parallel_masks.qidx_mask[grp]     = 0x0;
-  sched_core_local.sched_masks->sched_masks_prio.parallel_ord_masks.qidx_mask[grp] = 0x0;
+  return ret_status;
+}
+#endif // LOCKLESS_ORDERED_QUEUES
+
+
+
+/**
+ * Send / Enqueue the given event (header) based on the EM-queue type
+ */
+em_status_t
+em_send_switch(em_event_hdr_t     *const ev_hdr,
+               em_queue_element_t *const q_elem,
+               const em_queue_t          queue)
+{
+  em_status_t em_status = EM_ERR_LIB_FAILED;
+
+
+  switch(q_elem->scheduler_type)
+  {
+    case EM_QUEUE_TYPE_ATOMIC:
+      {
+        PREFETCH_RTE_RING(q_elem->rte_ring);
+
+        em_status = em_send_atomic(ev_hdr, q_elem, queue);
+      }
+      break;
+
+
+    case EM_QUEUE_TYPE_PARALLEL:
+      {
+        em_status = em_send_parallel(ev_hdr, q_elem, queue);
+      }
+      break;
+
+
+    case EM_QUEUE_TYPE_PARALLEL_ORDERED:
+      {
+        em_status = em_send_parallel_ordered(ev_hdr, q_elem, queue);
+      }
+      break;
+  }
   
-  for(qidx = 0; qidx < SCHED_Q_MAX_QUEUES; qidx++)
+  IF_LIKELY(em_status == EM_OK)
   {
-    sched_core_local.sched_add_counts->add_count.atomic_add_cnt[grp].qidx_cnt[qidx]       = 0;
-    sched_core_local.sched_add_counts->add_count.parallel_add_cnt[grp].qidx_cnt[qidx]     = 0;
-    sched_core_local.sched_add_counts->add_count.parallel_ord_add_cnt[grp].qidx_cnt[qidx] = 0;
+    if(group_mask_isset(&em_core_local.current_group_mask, q_elem->queue_group)) {
+      sched_core_local.events_enqueued++;
+    }
+    
+    dispatch_idle_wake_check(q_elem->queue_group);
   }
-  
-  env_spinlock_unlock(&em.shm->sched_add_counts_lock.lock);
+
+  return em_status;
 }
 
 
 
 
 /**
- * Send event with group number.
- *
- * Any valid event and destination queue parameters can be used. Event group id
- * indicates which event group the event belongs to. Event group has to be first
- * created and applied.
- *
- * @param event    Event to send
- * @param queue    Destination queue
- * @param group    Event group
- *
- * @return EM_OK if successful.
+ * Send / Enqueue multiple event (headers) to the same EM-queue based on the EM-queue type
  *
- * @see em_send(), em_event_group_create(), em_event_group_apply(), em_event_group_increment()
+ * @return The number of events sent, ev_hdrs[0...return-1]
  */
-em_status_t
-em_send_group(em_event_t event, em_queue_t queue, em_event_group_t group)
+int
+em_send_switch_multi(em_event_hdr_t     *const ev_hdrs[],
+                     const int                 num,
+                     em_queue_element_t *const q_elem,
+                     const em_queue_t          queue)
 {
-  em_queue_element_t *const q_elem = get_queue_element(queue);
-  PREFETCH_Q_ELEM(q_elem);
-  em_event_hdr_t     *const ev_hdr = event_to_event_hdr(event);
-  em_status_t               em_status;
+  int sent = 0;
 
 
-  // env_sync_mem();
+  switch(q_elem->scheduler_type)
+  {
+    case EM_QUEUE_TYPE_ATOMIC:
+      {
+        PREFETCH_RTE_RING(q_elem->rte_ring);
 
-  ev_hdr->event_group = group;
+        sent = em_send_atomic_multi(ev_hdrs, num, q_elem, queue);
+      }
+      break;
 
 
-  if(ev_hdr->src_q_type == EM_QUEUE_TYPE_PARALLEL_ORDERED)
-  {
-    em_status = em_send_from_parallel_ord_q(ev_hdr, q_elem, queue, OPERATION_SEND);
+    case EM_QUEUE_TYPE_PARALLEL:
+      {
+        sent = em_send_parallel_multi(ev_hdrs, num, q_elem, queue);
+      }
+      break;
+
+
+    case EM_QUEUE_TYPE_PARALLEL_ORDERED:
+      {
+        sent = em_send_parallel_ordered_multi(ev_hdrs, num, q_elem, queue);
+      }
+      break;
   }
-  else
+  
+  IF_LIKELY(sent > 0)
   {
-    /* Send to queue based on the destination queue type. */
-    em_status = em_send_switch(ev_hdr, q_elem, queue);
+    if(group_mask_isset(&em_core_local.current_group_mask, q_elem->queue_group)) {
+      sched_core_local.events_enqueued += sent;
+    }
+    
+    dispatch_idle_wake_check(q_elem->queue_group);
   }
 
-
-  return em_status;
+  return sent;
 }
 
 
 
+
 /**
- * Sends events ORIGINATING from a parallel-ordered queue. Alternatively handles free requests.
- *
- * Events are sent to the destination queue (of any type) in the order that they arrived in the
- * source parallel-ordered queue. If an event is sent/freed before a previous event has completed
- * then it is left to wait in he order-queue. Once the previous event(s) are done then ALL completed
- * events are sent to the destinations queues.
- *
- * @param ev_hdr    the event header
- * @param q_elem    destination queue element (or NULL   if operation==OPERATION_MARK_FREE)
- * @param queue     destination queue (or EM_QUEUE_UNDEF if operation==OPERATION_MARK_FREE)
- * @param operation OPERATION_SEND      - Normal send FROM parallel-ordered queue
-                    OPERATION_MARK_FREE - em_free() called for event origination from parl-ord. queue
- *
- * @return status EM_OK on success (OK does not guarantee
- *                 message delivery, it only suggest the event was
- *                 posted successfully)
+ * Send the event (header) to an atomic EM-queue
  */
-em_status_t
-em_send_from_parallel_ord_q(em_event_hdr_t     *const ev_hdr,
-                            em_queue_element_t *const q_elem,
-                            const em_queue_t          queue,
-                            const int                 operation)
+static inline em_status_t
+em_send_atomic(em_event_hdr_t     *const ev_hdr,
+               em_queue_element_t *const q_elem,
+               const em_queue_t          queue)
 {
-  env_spinlock_t     *const lock = ev_hdr->lock_p;
-  em_queue_element_t *src_q_elem;  // Stored by previous em_send_xxx()
-
-  union {
-    em_event_hdr_t  *ev_hdr;
-    void            *ev_hdr_void;
-  } de_q;
-
+  const em_event_t          event       = event_hdr_to_event(ev_hdr);  
+  // The atomic queue whose context this core currently holds (NULL if none or released with em_atomic_processing_end())
+  em_queue_element_t *const src_q_elem  = sched_core_local.atomic_q_elem;
 
-  /* Take the lock early - another core might also be checking the order-queue */
-  env_spinlock_lock(lock);
+  sched_q_atomic_t   *const sched_q_obj = SCHED_Q_ATOMIC_SELECT(q_elem);
+  const uint64_t            qidx        = queue & (sched_q_obj->queue_mask);
+  struct multiring   *const sched_q     = sched_q_obj->sched_q[qidx];
 
+  struct rte_ring          *event_q     = q_elem->rte_ring;
+  int                       ret;
 
-  // Clear src_q_type - set again in em_schedule_parallell_ordered() if 'queue' is of that type.
-  ev_hdr->src_q_type      = EM_QUEUE_TYPE_UNDEF;
-  // Mark event as 'processed' and ready for sending.
-  ev_hdr->processing_done = 1;
-  // Save the intended operation for the event: send, free or packet-output
-  ev_hdr->operation       = operation;
-  // Store the destination q_elem (can be NULL for packet-output)
-  ev_hdr->dst_q_elem      = q_elem;
 
+  ev_hdr->q_elem = q_elem;
 
-  // Store ptr to the source parallel-ordered queue
-  src_q_elem = ev_hdr->q_elem;
+  // Lazily bound event queue: keep it bound until the event count has been updated
+  IF_UNLIKELY(q_elem->ring_lazy)
+  {
+    event_q = atomic_ring_ref(q_elem);
+    
+    IF_UNLIKELY(event_q == NULL) {
+      return EM_ERR_ALLOC_FAILED;
+    }
+  }
 
+  // MULTI PRODUCER
+  ret = rte_ring_enqueue(event_q, event);
 
-  if(ev_hdr != src_q_elem->u.parallel_ord.order_first)
+  IF_UNLIKELY(ret != 0)
   {
-    /*
-     * NOT the first ev_hdr in the order-queue, return to wait for the first to complete.
-     */
-    env_spinlock_unlock(lock);
-
-    return EM_OK;
+    if(q_elem->ring_lazy) {
+      atomic_ring_unref(q_elem);
+    }
+    return EM_ERR_LIB_FAILED;
   }
-  else
-  {
-    em_status_t     em_status  = EM_OK;
-    em_status_t     ret_status = EM_OK;
-    // helper vars:
-    em_event_hdr_t *tmp_hdr;
-    int             processing_done;
-    int             operation;
-    int             ret;
+  // RETURN_ERROR_IF(ret != 0, EM_ERR_LIB_FAILED, EM_ESCOPE_SEND_ATOMIC,
+  //                 "Atomic: event queue enqueue failed, ret=%i", ret);
 
 
-    /* FIRST in order - Clear ptr to first ev_hdr */
-    src_q_elem->u.parallel_ord.order_first = NULL;
+#if LOCKLESS_ATOMIC_QUEUES == 1
 
+  ret = 1; // Set for later error check
 
-    /*
-     * Send HEAD EVENT - see also if other later events have completed processing,
-     * and if so, dequeue from order-queue and send all to their destination queues.
-     */
+  // If the atomic count was previously zero, we must see if we need to schedule this atomic queue
+  if((__sync_fetch_and_add(&q_elem->u.atomic.event_count, 1) == 0) && (q_elem != src_q_elem))
+  {
+    // Set the sched_count to 1, retrieving old value. If it was 0, we must enqueue to schedule
+    if(__sync_lock_test_and_set(&q_elem->u.atomic.sched_count,1) == 0)
+    {
+      ret = sched_q_enqueue(sched_q, SCHED_TYPE_ATOMIC, q_elem, q_elem);
+    }
+  }
+  
+  if(q_elem->ring_lazy) {
+    atomic_ring_unref(q_elem);
+  }
+  
+  RETURN_ERROR_IF(ret != 1, EM_FATAL(EM_ERR_LIB_FAILED), EM_ESCOPE_SEND_ATOMIC,
+                  "Atomic: sched queue enqueue failed, ret=%i", ret);      
+              
+#else // LOCKLESS_ATOMIC_QUEUES == 0
 
-    de_q.ev_hdr = ev_hdr; // initialize loop
+  ret = 1; // Set for later error check
+  
+  env_spinlock_lock(&q_elem->lock);
 
-    do {
-      tmp_hdr         = de_q.ev_hdr;
-      processing_done = tmp_hdr->processing_done;
+  q_elem->u.atomic.event_count++;
 
-      ret = 1; // 1 breaks out of loop if not changed
-      
-      if(processing_done)
-      {
-        operation = tmp_hdr->operation;
+  if(q_elem->u.atomic.sched_count == 0)
+  {
+    // Event queue not currently in sched queue, enqueue it...
 
-        switch(operation)
-        {
-          case OPERATION_ETH_TX:
-          {
-            struct rte_mbuf *const m = (struct rte_mbuf *) (((size_t) tmp_hdr) - sizeof(struct rte_mbuf));
-          
-            eth_tx_packet__ordered(m, tmp_hdr->io_port, EM_QUEUE_TO_MBUF_TBL(src_q_elem->id));
-          }
-          break;
-          
-          case OPERATION_SEND:
-          {
-            /* Send to queue based on the destination queue type.
-             * On error: Break & return to caller, next event will retry to send remaining events ready in the order-queue.
-             */
-            em_status = em_send_switch(tmp_hdr, tmp_hdr->dst_q_elem, tmp_hdr->dst_q_elem->id);
-            
-            IF_UNLIKELY(em_status != EM_OK)
-            {
-              if(tmp_hdr == ev_hdr) // Input event to em_send() and first in order
-              {
-                /* Save error status from input event and eventually return this value,
-                 * but for now continue processing loop dropping subsequent events on further errors.
-                 * Note that the packet order for the input event is lost.
-                 */
-                ret_status = em_status;
-              }
-              else {
-                intel_free(tmp_hdr);
-              }
-            }
-          }
-          break;
-          
-          default:
-          {
-            // OPERATION_MARK_FREE
-            intel_free(tmp_hdr);
-          }
-          break;
-          
-        } // switch(operation)
+    // ... except if dst-queue is the atomic src-queue,
+    // i.e. can't release atomic context yet, reschedule queue when returing from dispatch instead
+    IF_LIKELY(q_elem != src_q_elem)
+    {
+      // MULTI PRODUCER
+      ret = sched_q_enqueue(sched_q, SCHED_TYPE_ATOMIC, q_elem, q_elem);
 
-        // Dequeue next ev_hdr in order-list (if any)
-        ret = rte_ring_dequeue(src_q_elem->rte_ring, &de_q.ev_hdr_void);
+      IF_LIKELY(ret == 1) {
+        q_elem->u.atomic.sched_count = 1;
       }
-    } while(!ret);
-
-
-    if(!processing_done)
-    {
-      // Set new head ev_hdr instead of NULL
-      src_q_elem->u.parallel_ord.order_first = tmp_hdr;
     }
+  }
 
-
-    env_spinlock_unlock(lock);
-    
-    return ret_status;
+  env_spinlock_unlock(&q_elem->lock);
+  
+  if(q_elem->ring_lazy) {
+    atomic_ring_unref(q_elem);
   }
+  
+  RETURN_ERROR_IF(ret != 1, EM_FATAL(EM_ERR_LIB_FAILED), EM_ESCOPE_SEND_ATOMIC,
+                  "Atomic: sched queue enqueue failed, ret=%i", ret);
+                  
+#endif // #if LOCKLESS_ATOMIC_QUEUES == 1
+
+  
+  return EM_OK;
 }
 
 
 
 
 /**
- * Send / Enqueue the given event (header) based on the EM-queue type
+ * Send the event (header) to a parallel EM-queue
  */
-em_status_t
-em_send_switch(em_event_hdr_t     *const ev_hdr,
-               em_queue_element_t *const q_elem,
-               const em_queue_t          queue)
+static inline em_status_t
+em_send_parallel(em_event_hdr_t     *const ev_hdr,
+                 em_queue_element_t *const q_elem,
+                 const em_queue_t          queue)
 {
-  em_status_t em_status = EM_ERR_LIB_FAILED;
+  sched_q_parallel_t *sched_q_obj;
+  struct multiring   *sched_q;
+  uint64_t            qidx;
+  int                 ret;
 
 
-  switch(q_elem->scheduler_type)
+  ev_hdr->q_elem = q_elem;
+
+  sched_q_obj = SCHED_Q_PARALLEL_SELECT(q_elem);
+  qidx        = queue & (sched_q_obj->queue_mask);
+  sched_q     = sched_q_obj->sched_q[qidx]; // Spread into scheduling queues
+
+  ret = sched_q_enqueue(sched_q, SCHED_TYPE_PARALLEL, q_elem, ev_hdr);
+  
+  IF_UNLIKELY(ret != 1)
   {
-    case EM_QUEUE_TYPE_ATOMIC:
-      {
-        PREFETCH_RTE_RING(q_elem->rte_ring);
+    return EM_ERR_LIB_FAILED;
+  }
+  // RETURN_ERROR_IF(ret != 1, EM_ERR_LIB_FAILED, EM_ESCOPE_SEND_PARALLEL,
+  //                 "Parallel: sched queue enqueue failed, ret=%i", ret); 
+  
+  return EM_OK;
+}
 
-        em_status = em_send_atomic(ev_hdr, q_elem, queue);
-      }
-      break;
 
 
-    case EM_QUEUE_TYPE_PARALLEL:
-      {
-        em_status = em_send_parallel(ev_hdr, q_elem, queue);
-      }
-      break;
 
+/**
+ * Send the event (header) to a parallel-ordered EM-queue
+ */
+static inline em_status_t
+em_send_parallel_ordered(em_event_hdr_t     *const ev_hdr,
+                         em_queue_element_t *const q_elem,
+                         const em_queue_t          queue)
+{
+  sched_q_parallel_ord_t *sched_q_obj;
+  struct multiring       *sched_q;
+  uint64_t                qidx;
+  int                     ret;
+
+
+  ev_hdr->q_elem = q_elem;
+
+  sched_q_obj = SCHED_Q_PARALLEL_ORD_SELECT(q_elem);
+  qidx        = queue & (sched_q_obj->queue_mask);
+  sched_q     = sched_q_obj->sched_q[qidx]; // Spread into scheduling queues
 
-    case EM_QUEUE_TYPE_PARALLEL_ORDERED:
-      {
-        em_status = em_send_parallel_ordered(ev_hdr, q_elem, queue);
-      }
-      break;
-  }
-  
-  IF_LIKELY(em_status == EM_OK)
+  ret = sched_q_enqueue(sched_q, SCHED_TYPE_PARALLEL_ORD, q_elem, ev_hdr);
+      
+  IF_UNLIKELY(ret != 1)
   {
-    const uint64_t q_elem_mask = ((uint64_t)1) << q_elem->queue_group;
-    
-    if(q_elem_mask & (em_core_local.current_group_mask)) {
-      sched_core_local.events_enqueued++;
-    }
+    return EM_ERR_LIB_FAILED;
   }
-
-  return em_status;
+  // RETURN_ERROR_IF(ret != 1, EM_ERR_LIB_FAILED, EM_ESCOPE_SEND_PARALLEL_ORD,
+  //                 "Parallel-Ordered: sched queue enqueue failed, ret=%i", ret); 
+  
+  return EM_OK;
 }
 
 
 
-
 /**
- * Send the event (header) to an atomic EM-queue
+ * Send multiple events (headers) to an atomic EM-queue
+ * 
+ * All events are enqueued with one bulk enqueue (all or nothing) and the event count
+ * is updated once for the whole burst.
+ *
+ * @return The number of events sent (0 or num)
  */
-static inline em_status_t
-em_send_atomic(em_event_hdr_t     *const ev_hdr,
-               em_queue_element_t *const q_elem,
-               const em_queue_t          queue)
+static inline int
+em_send_atomic_multi(em_event_hdr_t     *const ev_hdrs[],
+                     const int                 num,
+                     em_queue_element_t *const q_elem,
+                     const em_queue_t          queue)
 {
-  struct rte_ring    *const event_q     = q_elem->rte_ring;
-  const em_event_t          event       = event_hdr_to_event(ev_hdr);  
-  em_queue_element_t *const src_q_elem  = ev_hdr->q_elem;  // Stored by previous em_send_xxx(), NOTE: can be NULL (packet-IO)!!!
+  // The atomic queue whose context this core currently holds (NULL if none or released with em_atomic_processing_end())
+  em_queue_element_t *const src_q_elem  = sched_core_local.atomic_q_elem;
 
   sched_q_atomic_t   *const sched_q_obj = SCHED_Q_ATOMIC_SELECT(q_elem);
   const uint64_t            qidx        = queue & (sched_q_obj->queue_mask);
   struct multiring   *const sched_q     = sched_q_obj->sched_q[qidx];
 
+  struct rte_ring          *event_q     = q_elem->rte_ring;
+  em_event_t                events[MAX_E_BULK_SEND];
   int                       ret;
+  int                       i;
 
 
-  ev_hdr->q_elem = q_elem;
+  for(i = 0; i < num; i++)
+  {
+    ev_hdrs[i]->q_elem = q_elem;
+    events[i]          = event_hdr_to_event(ev_hdrs[i]);
+  }
+
+  // Lazily bound event queue: keep it bound until the event count has been updated
+  IF_UNLIKELY(q_elem->ring_lazy)
+  {
+    event_q = atomic_ring_ref(q_elem);
+    
+    IF_UNLIKELY(event_q == NULL) {
+      return 0;
+    }
+  }
 
   // MULTI PRODUCER
-  ret = rte_ring_enqueue(event_q, event);
+  ret = rte_ring_enqueue_bulk(event_q, events, num);
 
-  IF_UNLIKELY(ret != 0)
+  IF_UNLIKELY(ret == (-ENOBUFS))
   {
-    return EM_ERR_LIB_FAILED;
+    if(q_elem->ring_lazy) {
+      atomic_ring_unref(q_elem);
+    }
+    return 0;
   }
-  // RETURN_ERROR_IF(ret != 0, EM_ERR_LIB_FAILED, EM_ESCOPE_SEND_ATOMIC,
-  //                 "Atomic: event queue enqueue failed, ret=%i", ret);
 
 
 #if LOCKLESS_ATOMIC_QUEUES == 1
 
+  ret = 1; // Set for later error check
+
   // If the atomic count was previously zero, we must see if we need to schedule this atomic queue
-  if((__sync_fetch_and_add(&q_elem->u.atomic.event_count, 1) == 0) && (q_elem != src_q_elem))
+  if((__sync_fetch_and_add(&q_elem->u.atomic.event_count, num) == 0) && (q_elem != src_q_elem))
   {
     // Set the sched_count to 1, retrieving old value. If it was 0, we must enqueue to schedule
     if(__sync_lock_test_and_set(&q_elem->u.atomic.sched_count,1) == 0)
     {
-      ret = mring_enqueue(sched_q, q_elem->priority, q_elem);
-      
-      RETURN_ERROR_IF(ret != 1, EM_FATAL(EM_ERR_LIB_FAILED), EM_ESCOPE_SEND_ATOMIC,
-                      "Atomic: sched queue enqueue failed, ret=%i", ret);      
+      ret = sched_q_enqueue(sched_q, SCHED_TYPE_ATOMIC, q_elem, q_elem);
     }
   }
               
@@ -1893,7 +4718,7 @@ em_send_atomic(em_event_hdr_t     *const ev_hdr,
   
   env_spinlock_lock(&q_elem->lock);
 
-  q_elem->u.atomic.event_count++;
+  q_elem->u.atomic.event_count += num;
 
   if(q_elem->u.atomic.sched_count == 0)
   {
@@ -1904,7 +4729,7 @@ em_send_atomic(em_event_hdr_t     *const ev_hdr,
     IF_LIKELY(q_elem != src_q_elem)
     {
       // MULTI PRODUCER
-      ret = mring_enqueue(sched_q, q_elem->priority, q_elem);
+      ret = sched_q_enqueue(sched_q, SCHED_TYPE_ATOMIC, q_elem, q_elem);
 
       IF_LIKELY(ret == 1) {
         q_elem->u.atomic.sched_count = 1;
@@ -1913,160 +4738,363 @@ em_send_atomic(em_event_hdr_t     *const ev_hdr,
   }
 
   env_spinlock_unlock(&q_elem->lock);
-  
-  RETURN_ERROR_IF(ret != 1, EM_FATAL(EM_ERR_LIB_FAILED), EM_ESCOPE_SEND_ATOMIC,
-                  "Atomic: sched queue enqueue failed, ret=%i", ret);
                   
 #endif // #if LOCKLESS_ATOMIC_QUEUES == 1
 
+  if(q_elem->ring_lazy) {
+    atomic_ring_unref(q_elem);
+  }
+
+  IF_UNLIKELY(ret != 1) {
+    // Should never happen. The events are in the event queue, report but don't fail the send
+    (void) EM_INTERNAL_ERROR(EM_FATAL(EM_ERR_LIB_FAILED), EM_ESCOPE_SEND_ATOMIC,
+                             "Atomic: sched queue enqueue failed, ret=%i", ret);
+  }
+
   
-  return EM_OK;
+  return num;
 }
 
 
 
-
 /**
- * Send the event (header) to a parallel EM-queue
+ * Send multiple events (headers) to a parallel EM-queue
+ *
+ * @return The number of events sent (0...num)
  */
-static inline em_status_t
-em_send_parallel(em_event_hdr_t     *const ev_hdr,
-                 em_queue_element_t *const q_elem,
-                 const em_queue_t          queue)
+static inline int
+em_send_parallel_multi(em_event_hdr_t     *const ev_hdrs[],
+                       const int                 num,
+                       em_queue_element_t *const q_elem,
+                       const em_queue_t          queue)
 {
   sched_q_parallel_t *sched_q_obj;
   struct multiring   *sched_q;
   uint64_t            qidx;
-  int                 ret;
+  int                 i;
 
 
-  ev_hdr->q_elem = q_elem;
+  for(i = 0; i < num; i++) {
+    ev_hdrs[i]->q_elem = q_elem;
+  }
 
   sched_q_obj = SCHED_Q_PARALLEL_SELECT(q_elem);
   qidx        = queue & (sched_q_obj->queue_mask);
   sched_q     = sched_q_obj->sched_q[qidx]; // Spread into scheduling queues
 
-  ret = mring_enqueue(sched_q, q_elem->priority, ev_hdr);
-  
-  IF_UNLIKELY(ret != 1)
-  {
-    return EM_ERR_LIB_FAILED;
-  }
-  // RETURN_ERROR_IF(ret != 1, EM_ERR_LIB_FAILED, EM_ESCOPE_SEND_PARALLEL,
-  //                 "Parallel: sched queue enqueue failed, ret=%i", ret); 
-  
-  return EM_OK;
+  return sched_q_enqueue_burst(sched_q, SCHED_TYPE_PARALLEL, q_elem, (void * const *) ev_hdrs, num);
 }
 
 
 
-
 /**
- * Send the event (header) to a parallel-ordered EM-queue
+ * Send multiple events (headers) to a parallel-ordered EM-queue
+ *
+ * @return The number of events sent (0...num)
  */
-static inline em_status_t
-em_send_parallel_ordered(em_event_hdr_t     *const ev_hdr,
-                         em_queue_element_t *const q_elem,
-                         const em_queue_t          queue)
+static inline int
+em_send_parallel_ordered_multi(em_event_hdr_t     *const ev_hdrs[],
+                               const int                 num,
+                               em_queue_element_t *const q_elem,
+                               const em_queue_t          queue)
 {
   sched_q_parallel_ord_t *sched_q_obj;
   struct multiring       *sched_q;
   uint64_t                qidx;
-  int                     ret;
+  int                     i;
 
 
-  ev_hdr->q_elem = q_elem;
+  for(i = 0; i < num; i++) {
+    ev_hdrs[i]->q_elem = q_elem;
+  }
 
   sched_q_obj = SCHED_Q_PARALLEL_ORD_SELECT(q_elem);
   qidx        = queue & (sched_q_obj->queue_mask);
   sched_q     = sched_q_obj->sched_q[qidx]; // Spread into scheduling queues
 
-  ret = mring_enqueue(sched_q, q_elem->priority, ev_hdr);
-      
-  IF_UNLIKELY(ret != 1)
+  return sched_q_enqueue_burst(sched_q, SCHED_TYPE_PARALLEL_ORD, q_elem, (void * const *) ev_hdrs, num);
+}
+
+
+
+/**
+ * Release atomic processing context.
+ *
+ * When an event was received from an atomic queue, the function can be used to 
+ * release the atomic context before receive function return. After the call,
+ * scheduler is allowed to schedule another event from the same queue
+ * to another core. This increases parallelism and may improve performance - 
+ * however the exclusive processing and ordering (!) might be lost after the call.
+ *
+ * Can only be called from within the event receive function!
+ *
+ * The call is ignored, if current event was not received from an atomic queue.
+ *
+ * If events of the same scheduling burst are still to be dispatched on this core, the release is
+ * deferred until the burst has been processed (those events must keep the atomic context).
+ * The queue is then served one event at a time, so that a call made for one of the following
+ * events releases the context immediately. Full bursts are used again once an event is
+ * processed without releasing the context early.
+ *
+ * Pseudo-code example:
+ * @code
+ *  receive_func(void* eo_ctx, em_event_t event, em_event_type_t type, em_queue_t queue, void* q_ctx);
+ *  {
+ *      if(is_my_atomic_queue(q_ctx))
+ *      {
+ *          update_sequence_number(event);  // this needs to be done atomically
+ *          em_atomic_processing_end();
+ *          ...                             // do other processing (potentially) in parallel
+ *      }
+ *   }
+ * @endcode
+ *
+ * @see em_receive_func_t()
+ */
+void
+em_atomic_processing_end(void)
+{
+  em_queue_element_t *const q_elem = sched_core_local.atomic_q_elem;
+  sched_q_atomic_t         *sched_q_obj;
+  uint64_t                  qidx;
+
+
+  // Ignore the call if not holding an atomic context (or if already released)
+  IF_UNLIKELY((q_elem == NULL) || (q_elem != em_core_local.current_q_elem))
   {
-    return EM_ERR_LIB_FAILED;
+    return;
+  }
+
+  // Events from the same atomic burst are still to be dispatched on this core and they must
+  // keep the atomic context - release deferred to the end of the burst. Dequeue only one event
+  // at a time from this queue from now on, so that the following calls can release it immediately.
+  // schedule_atomic_dispatch() clears the request when a single event burst ends without a release.
+  IF_UNLIKELY(sched_core_local.atomic_e_left > 0)
+  {
+    q_elem->atomic_release = 1;
+    return;
+  }
+  
+  sched_core_local.atomic_q_elem = NULL;
+  
+  sched_q_obj = SCHED_Q_ATOMIC_SELECT(q_elem);
+  qidx        = (q_elem->id) & (sched_q_obj->queue_mask);
+
+  // NOTE: Atomic context lost after this. Another core can schedule/dispatch from the queue.
+  atomic_context_release(q_elem, sched_q_obj->sched_q[qidx], sched_core_local.atomic_e_count, 0,
+                         EM_ESCOPE_ATOMIC_PROCESSING_END);
+}
+
+
+
+/**
+ * Release the atomic context of a queue after 'e_count' events (dequeued by the core 
+ * holding the context) have been processed: reschedule the queue if it still has events,
+ * otherwise mark it unscheduled.
+ *
+ * With 'sticky' set a rescheduled queue may be kept in the core local stash instead of the
+ * scheduling queue, see sched_sticky_put().
+ */
+static inline void
+atomic_context_release(em_queue_element_t *const q_elem,
+                       struct multiring   *const sched_q,
+                       const int32_t             e_count,
+                       const int                 sticky,
+                       const em_escope_t         escope)
+{
+  int ret;
+  
+  
+#if LOCKLESS_ATOMIC_QUEUES == 1
+
+  int32_t new_count = __sync_sub_and_fetch(&q_elem->u.atomic.event_count, e_count);
+  
+  ret = 1;
+  
+  if(new_count > 0)
+  {
+    ret = atomic_context_reschedule(q_elem, sched_q, sticky);
+  }
+  else
+  {
+    // Nothing currently to be scheduled, lets clear the sched_count using atomic cmpset
+    union {
+      struct {
+        int32_t sched_count, event_count;
+      };
+      uint64_t atomic_counts;
+    } expected_value = {{.sched_count = 1, .event_count = 0}};
+
+    // If cmpset fails, then someone has modified event_count (upwards) so reschedule the queue
+    if(!rte_atomic64_cmpset(&q_elem->u.atomic.atomic_counts_u64, expected_value.atomic_counts, 0))
+    {
+      ret = atomic_context_reschedule(q_elem, sched_q, sticky);
+    }
+    else if(q_elem->ring_lazy)
+    {
+      // Queue ran empty, give the event queue back
+      atomic_ring_unbind(q_elem);
+    }
+  }
+
+  IF_UNLIKELY(ret != 1) {
+    // Should never happen
+    (void) EM_INTERNAL_ERROR(EM_FATAL(EM_ERR_LIB_FAILED), escope,
+                             "Atomic sched queue enqueue failed, ret=%i!", ret);
+  }          
+  
+#else // LOCKLESS_ATOMIC_QUEUES == 0
+
+  env_spinlock_lock(&q_elem->lock);
+
+  if(q_elem->u.atomic.event_count > e_count)
+  {
+    // Continue scheduling.
+    q_elem->u.atomic.event_count -= e_count;
+
+    // MULTI PRODUCER
+    // NOTE: Atomic context lost after this. Another core can schedule/dispatch.
+    ret = atomic_context_reschedule(q_elem, sched_q, sticky);
+
+    IF_UNLIKELY(ret != 1) {
+      // Should never happen
+      (void) EM_INTERNAL_ERROR(EM_FATAL(EM_ERR_LIB_FAILED), escope,
+                               "Atomic sched queue enqueue failed, ret=%i!", ret);
+    }
+  }
+  else
+  {
+    // Last event. Don't schedule any more.
+    q_elem->u.atomic.sched_count = 0;          
+    q_elem->u.atomic.event_count = 0;
+    
+    ret = 0; // Unscheduled
+  }
+
+  env_spinlock_unlock(&q_elem->lock);
+  
+  if((ret == 0) && q_elem->ring_lazy)
+  {
+    // Queue ran empty, give the event queue back
+    atomic_ring_unbind(q_elem);
+  }
+  
+#endif // #if LOCKLESS_ATOMIC_QUEUES == 1
+}
+
+
+
+/**
+ * Reschedule an atomic queue that still has events: into the core local stash if 'sticky'
+ * and the stash accepts it, otherwise into its scheduling queue.
+ *
+ * @return 1 on success (as sched_q_enqueue())
+ */
+static inline int
+atomic_context_reschedule(em_queue_element_t *const q_elem, struct multiring *const sched_q, const int sticky)
+{
+  if(sticky && sched_sticky_put(q_elem, sched_q)) {
+    return 1;
+  }
+  
+  return sched_q_enqueue(sched_q, SCHED_TYPE_ATOMIC, q_elem, q_elem);
+}
+
+
+
+/**
+ * Take a reference to the event queue of a lazily bound atomic EM-queue, bind one from the
+ * size class pool if the queue currently has none.
+ * The event queue stays bound until atomic_ring_unref().
+ *
+ * @return The event queue or NULL if none available
+ */
+static inline struct rte_ring *
+atomic_ring_ref(em_queue_element_t *const q_elem)
+{
+  struct rte_ring *ring;
+  int16_t          refs;
+  
+  
+  // Wait out a possible unbind in progress (refs == -1)
+  for(;;)
+  {
+    refs = q_elem->ring_refs;
+    
+    IF_LIKELY((refs >= 0) && __sync_bool_compare_and_swap(&q_elem->ring_refs, refs, refs + 1)) {
+      break;
+    }
+    
+    rte_pause();
+  }
+  
+  ring = *((struct rte_ring * volatile *) &q_elem->rte_ring);
+  
+  IF_UNLIKELY(ring == NULL)
+  {
+    struct rte_ring *const new_ring = atomic_ring_alloc(q_elem->ring_class);
+    
+    IF_UNLIKELY(new_ring == NULL)
+    {
+      atomic_ring_unref(q_elem);
+      return NULL;
+    }
+    
+    // Several senders might bind concurrently, the first one wins
+    ring = __sync_val_compare_and_swap(&q_elem->rte_ring, NULL, new_ring);
+    
+    if(ring == NULL) {
+      ring = new_ring;
+    }
+    else {
+      (void) atomic_ring_free(new_ring, q_elem->ring_class);
+    }
   }
-  // RETURN_ERROR_IF(ret != 1, EM_ERR_LIB_FAILED, EM_ESCOPE_SEND_PARALLEL_ORD,
-  //                 "Parallel-Ordered: sched queue enqueue failed, ret=%i", ret); 
   
-  return EM_OK;
+  return ring;
 }
 
 
 
 /**
- * Release atomic processing context.
- *
- * When an event was received from an atomic queue, the function can be used to 
- * release the atomic context before receive function return. After the call,
- * scheduler is allowed to schedule another event from the same queue
- * to another core. This increases parallelism and may improve performance - 
- * however the exclusive processing and ordering (!) might be lost after the call.
- *
- * Can only be called from within the event receive function!
- *
- * The call is ignored, if current event was not received from an atomic queue.
- *
- * Pseudo-code example:
- * @code
- *  receive_func(void* eo_ctx, em_event_t event, em_event_type_t type, em_queue_t queue, void* q_ctx);
- *  {
- *      if(is_my_atomic_queue(q_ctx))
- *      {
- *          update_sequence_number(event);  // this needs to be done atomically
- *          em_atomic_processing_end();
- *          ...                             // do other processing (potentially) in parallel
- *      }
- *   }
- * @endcode
- *
- * @see em_receive_func_t()
+ * Drop a reference taken with atomic_ring_ref()
  */
-void
-em_atomic_processing_end(void)
+static inline void
+atomic_ring_unref(em_queue_element_t *const q_elem)
 {
-  return;
- 
-  // @TODO: Implementation below is not working, disable it and re-implement 
-#if 0
-  em_queue_element_t *const q_elem = em_core_local.current_q_elem;
-  sched_q_atomic_t   *sched_q_obj;
-  struct rte_ring    *sched_q;
-  uint64_t            qidx;
-  int                 ret = 0;
-
-
-  IF_LIKELY((q_elem != NULL) && (q_elem->scheduler_type == EM_QUEUE_TYPE_ATOMIC))
-  {
-    sched_q_obj = SCHED_Q_ATOMIC_SELECT(q_elem);
-    qidx        = (q_elem->id) & (sched_q_obj->queue_mask);
-    sched_q     = sched_q_obj->sched_q[qidx];
-
-    env_spinlock_lock(&q_elem->lock);
-
-    IF_LIKELY(q_elem->u.atomic.sched_count == 0)
-    {
-      // Event queue not currently in sched queue, enqueue it... (also means no events for this queue)
+  (void) __sync_fetch_and_sub(&q_elem->ring_refs, 1);
+}
 
-      // MULTI PRODUCER
-      ret = rte_ring_enqueue(sched_q, q_elem);
 
-      IF_LIKELY(ret == 0) {
-        q_elem->u.atomic.sched_count = 1;
-      }
-    }
 
-    env_spinlock_unlock(&q_elem->lock);
-    
+/**
+ * Return the event queue of a lazily bound atomic EM-queue to the size class pool if the 
+ * queue is empty and no sender is using the event queue. Called after the atomic context release 
+ * found the queue empty - if a sender is active it will reschedule the queue and the unbind is 
+ * retried on the next release.
+ */
+static inline void
+atomic_ring_unbind(em_queue_element_t *const q_elem)
+{
+  struct rte_ring *ring;
+  
+  
+  // Block new senders, fails if a send is in progress
+  IF_UNLIKELY(!__sync_bool_compare_and_swap(&q_elem->ring_refs, 0, -1)) {
+    return;
+  }
+  
+  ring = q_elem->rte_ring;
+  
+  if((ring != NULL) && (q_elem->u.atomic.event_count == 0))
+  {
+    q_elem->rte_ring = NULL;
     
-    IF_UNLIKELY(ret != 0)
-    {
-      (void) EM_INTERNAL_ERROR(EM_ERR_LIB_FAILED, EM_ESCOPE_ATOMIC_PROCESSING_END,
-                               "Atomic: sched queue enqueue failed, ret=%i", ret);
-    }
-  } 
-#endif
+    (void) atomic_ring_free(ring, q_elem->ring_class);
+  }
+  
+  rte_wmb();
+  q_elem->ring_refs = 0;
 }
 
 
@@ -2088,6 +5116,16 @@ dispatch_event(em_queue_element_t *const q_elem,
   void                *q_ctx;
 
 
+  // EO created with em_eo_create_multircv(): pass the event as a batch of one
+  IF_UNLIKELY(q_elem->receive_multi_func != NULL)
+  {
+    em_event_type_t type = event_type;
+    
+    dispatch_event_multi(q_elem, &event, &type, 1);
+    return;
+  }
+
+
   // Check if queue status ready, drop event if not
   IF_UNLIKELY(q_elem->status != EM_QUEUE_STATUS_READY)
   {
@@ -2165,67 +5203,286 @@ dispatch_event(em_queue_element_t *const q_elem,
 
 
 
+/**
+ * EM dispatcher for EOs with a multi-event receive function.
+ * 
+ * All 'num' events are from the same queue 'q_elem'. Consecutive events belonging
+ * to the same event group are passed to the EO in one receive call.
+ */
+static inline void
+dispatch_event_multi(em_queue_element_t *const q_elem,
+                     em_event_t                events[],
+                     em_event_type_t           types[],
+                     const int                 num)
+{
+  em_event_group_t         event_group;
+  em_event_group_t         next_group;
+  em_receive_multi_func_t  receive_multi_func;
+  em_queue_t               queue;
+  void                    *eo_ctx;
+  void                    *q_ctx;
+  int                      i, j, k;
+
+
+  // Check if queue status ready, drop events if not
+  IF_UNLIKELY(q_elem->status != EM_QUEUE_STATUS_READY)
+  {
+    // Consider removing the error report if dropping is accepted
+    (void) EM_INTERNAL_ERROR(EM_ERR_BAD_STATE, EM_ESCOPE_DISPATCH, 
+                             "Queue %"PRI_QUEUE" not ready (state=%u -> drop %i events\n",
+                             q_elem->id, q_elem->status, num);
+    for(i = 0; i < num; i++) {
+      em_free(events[i]);
+    }
+    return;
+  }
+  
+
+  queue              = q_elem->id;
+  receive_multi_func = q_elem->receive_multi_func;
+  eo_ctx             = q_elem->eo_ctx;
+  q_ctx              = q_elem->context;
+  
+  // Update core-local globals
+  em_core_local.current_q_elem = q_elem;
+
+
+  i = 0;
+  
+  do {
+    event_group = (types[i] == EM_EVENT_TYPE_SW) ? event_to_event_hdr(events[i])->event_group : EM_EVENT_GROUP_UNDEF;
+
+    // Find the consecutive events in the same event group 
+    for(j = i + 1; j < num; j++)
+    {
+      next_group = (types[j] == EM_EVENT_TYPE_SW) ? event_to_event_hdr(events[j])->event_group : EM_EVENT_GROUP_UNDEF;
+      
+      if(next_group != event_group) {
+        break;
+      }
+    }
+    
+    em_core_local.current_event_group = event_group;
+    
+    // Events not yet passed to the EO, needed by em_atomic_processing_end() when holding an atomic context
+    sched_core_local.atomic_e_left = num - j;
+
+
+    //
+    // Call execution object receive function. Atomic context may have been lost after this...
+    //
+    receive_multi_func(eo_ctx, &events[i], &types[i], j - i, queue, q_ctx);
+
+
+    //
+    // Events belong to an event_group, update the count once per event and if requested send notifications
+    //
+    IF_UNLIKELY(event_group != EM_EVENT_GROUP_UNDEF)
+    {
+      for(k = i; k < j; k++) {
+        event_group_count_update(event_group);
+      }
+    }
+
+    i = j;
+    
+  } while(i < num);
+
+  
+  em_core_local.current_q_elem = NULL;
+}
+
+
+
+/**
+ * Dispatch a burst of event headers dequeued from a parallel or parallel-ordered 
+ * scheduling queue. Consecutive events from the same queue are passed in one call
+ * to EOs with a multi-event receive function.
+ */
+static inline void
+dispatch_ev_hdrs(void* *const ev_hdr_ptr,
+                 const int    ev_hdr_count)
+{
+  em_event_t      *const events = multi_rcv_bufs.events;
+  em_event_type_t *const types  = multi_rcv_bufs.types;
+  int                    i      = 0;
+  
+  
+  while(i < ev_hdr_count)
+  {
+    em_event_hdr_t     *ev_hdr = ev_hdr_ptr[i];
+    em_queue_element_t *q_elem = ev_hdr->q_elem;
+    
+    IF_LIKELY(q_elem->receive_multi_func == NULL)
+    {
+      dispatch_event(q_elem, event_hdr_to_event(ev_hdr), ev_hdr->event_type);
+      i++;
+    }
+    else
+    {
+      int num = 0;
+      
+      do {
+        events[num] = event_hdr_to_event(ev_hdr);
+        types[num]  = ev_hdr->event_type;
+        num++;
+        
+        if(++i == ev_hdr_count) {
+          break;
+        }
+        
+        ev_hdr = ev_hdr_ptr[i];
+        
+      } while(ev_hdr->q_elem == q_elem);
+      
+      dispatch_event_multi(q_elem, events, types, num);
+    }
+  }
+}
+
+
+
 
-#if RX_DIRECT_DISPATCH == 1
+/**
+ * Dispatch a received event directly on this core (Eth Rx with RX_DIRECT_DISPATCH or to a
+ * direct dispatch queue), enqueue it if the core does not serve the queue group of the queue.
+ * Drops the event on errors.
+ */
 void
 em_direct_dispatch(em_event_t                event,
                    em_event_hdr_t     *const ev_hdr,
                    em_queue_element_t *const q_elem,
                    const em_queue_t          queue)
 {
-  const uint64_t q_elem_mask = ((uint64_t)1) << q_elem->queue_group;
-
-
+  em_status_t status = EM_ERR_LIB_FAILED;
+  
+  
   // Only dispatch if the queue belongs to a queue group enabled on this core, otherwise enqueue for another core to handle
-  if(q_elem_mask & (em_core_local.current_group_mask))
+  if(group_mask_isset(&em_core_local.current_group_mask, q_elem->queue_group))
   {
     switch(q_elem->scheduler_type)
     {
       case EM_QUEUE_TYPE_ATOMIC:
         // ev_hdr->q_elem = NULL;
-        em_direct_dispatch__atomic(q_elem, event, ev_hdr);
+        status = em_direct_dispatch__atomic(q_elem, event, ev_hdr);
         break;
 
       case EM_QUEUE_TYPE_PARALLEL:
         ev_hdr->q_elem = q_elem;
-        dispatch_event(q_elem, event, EM_EVENT_TYPE_PACKET);
+        dispatch_event(q_elem, event, ev_hdr->event_type);
+        status = EM_OK;
         break;
 
       case EM_QUEUE_TYPE_PARALLEL_ORDERED:
         ev_hdr->q_elem = q_elem;
-        em_direct_dispatch__parallel_ordered(q_elem, event, ev_hdr);
+        status = em_direct_dispatch__parallel_ordered(q_elem, event, ev_hdr);
         break;
     }
   }
   else
   {
     // Enqueue to an EM queue - NORMAL Operation
-    em_status_t err = em_send_switch(ev_hdr, q_elem, queue);
-    
-    IF_UNLIKELY(err != EM_OK)
-    {
-      // Drop RX event
-      em_free(event);
-    }
+    status = em_send_switch(ev_hdr, q_elem, queue);
+  }
+  
+  IF_UNLIKELY(status != EM_OK)
+  {
+    // Drop RX event
+    em_free(event);
   }
+}
 
+
+
+/**
+ * Can an event sent to the direct dispatch queue 'q_elem' be dispatched inline on this core:
+ * sent from an EO receive function, within the nesting limit, to a ready queue in a queue
+ * group served by this core.
+ */
+static inline int
+em_direct_dispatch_possible(em_queue_element_t *const q_elem)
+{
+  return (em_core_local.current_q_elem != NULL) &&
+         (direct_dispatch_depth < DIRECT_DISPATCH_DEPTH_MAX) &&
+         (q_elem->status == EM_QUEUE_STATUS_READY) &&
+         group_mask_isset(&em_core_local.current_group_mask, q_elem->queue_group);
 }
-#endif
 
 
 
+/**
+ * Dispatch an event sent from an EO receive function to a direct dispatch queue inline, nested
+ * in the receive call of the sender. The dispatch state of the sender (current queue, event group
+ * and the atomic context it holds) is restored afterwards. An atomic queue that is busy, e.g.
+ * the one of the sender, gets the event enqueued as by em_send().
+ *
+ * @return EM_OK if the event was dispatched or enqueued, otherwise the caller still owns the event
+ */
+static inline em_status_t
+em_direct_dispatch_send(em_event_hdr_t *const ev_hdr, em_queue_element_t *const q_elem)
+{
+  em_queue_element_t *const current_q_elem      = em_core_local.current_q_elem;
+  const em_event_group_t    current_event_group = em_core_local.current_event_group;
+  em_queue_element_t *const atomic_q_elem       = sched_core_local.atomic_q_elem;
+  const int32_t             atomic_e_count      = sched_core_local.atomic_e_count;
+  const int32_t             atomic_e_left       = sched_core_local.atomic_e_left;
+  const em_event_t          event               = event_hdr_to_event(ev_hdr);
+  em_status_t               status              = EM_ERR_LIB_FAILED;
+  
+  
+  direct_dispatch_depth++;
+  
+  switch(q_elem->scheduler_type)
+  {
+    case EM_QUEUE_TYPE_ATOMIC:
+      status = em_direct_dispatch__atomic(q_elem, event, ev_hdr);
+      break;
+
+    case EM_QUEUE_TYPE_PARALLEL:
+      ev_hdr->q_elem     = q_elem;
+      ev_hdr->src_q_type = EM_QUEUE_TYPE_PARALLEL;
+      dispatch_event(q_elem, event, ev_hdr->event_type);
+      status = EM_OK;
+      break;
 
-#if RX_DIRECT_DISPATCH == 1
-static inline void
+    case EM_QUEUE_TYPE_PARALLEL_ORDERED:
+      ev_hdr->q_elem = q_elem;
+      status = em_direct_dispatch__parallel_ordered(q_elem, event, ev_hdr);
+      break;
+  }
+  
+  direct_dispatch_depth--;
+  
+  // Back to the receive call of the sender
+  em_core_local.current_q_elem      = current_q_elem;
+  em_core_local.current_event_group = current_event_group;
+  sched_core_local.atomic_q_elem    = atomic_q_elem;
+  sched_core_local.atomic_e_count   = atomic_e_count;
+  sched_core_local.atomic_e_left    = atomic_e_left;
+  
+  return status;
+}
+
+
+
+
+/**
+ * Direct dispatch to an atomic queue: dispatch on this core if the queue is empty and not
+ * scheduled (takes the atomic context), otherwise enqueue the event normally.
+ *
+ * @return EM_OK if the event was dispatched or enqueued
+ */
+static inline em_status_t
 em_direct_dispatch__atomic(em_queue_element_t *const q_elem,
                            em_event_t                event,
                            em_event_hdr_t     *const ev_hdr)
 {
-  em_status_t       status;
   sched_q_atomic_t *sched_q_obj;
   uint64_t          qidx;
   struct multiring *sched_q;
-  int               ret;  
+#if LOCKLESS_ATOMIC_QUEUES == 0
+  int               ret;
+#endif
 
 
 #if LOCKLESS_ATOMIC_QUEUES == 1
@@ -2234,60 +5491,35 @@ em_direct_dispatch__atomic(em_queue_element_t *const q_elem,
      (__sync_lock_test_and_set(&q_elem->u.atomic.sched_count, 1) > 0))
   {
     // Enqueue to an EM queue - NORMAL Operation as backup.
-    status = em_send_atomic(ev_hdr, q_elem, q_elem->id);
-
-    IF_UNLIKELY(status != EM_OK) {
-      intel_free(ev_hdr);
-    }
-    return;
+    return em_send_switch(ev_hdr, q_elem, q_elem->id);
   }
 
   // For case where queue is empty, let's use a shortcut, we have used the sched
   // bit to indicate we are using the queue
   ev_hdr->q_elem     = q_elem;
   ev_hdr->src_q_type = EM_QUEUE_TYPE_ATOMIC;
+  
+  // This core now holds the atomic context, the dispatched event was never counted in event_count
+  sched_core_local.atomic_q_elem  = q_elem;
+  sched_core_local.atomic_e_count = 0;
+  sched_core_local.atomic_e_left  = 0;
 
-  dispatch_event(q_elem, event, EM_EVENT_TYPE_PACKET);
+  dispatch_event(q_elem, event, ev_hdr->event_type);
 
-  ret = 1;
-  
-  if(q_elem->u.atomic.event_count > 0)
+  // Schedule the queue for real if events were sent to it meanwhile - unless the
+  // atomic context was already released by em_atomic_processing_end()
+  IF_LIKELY(sched_core_local.atomic_q_elem != NULL)
   {
-    /* Schedule the queue for real */
+    sched_core_local.atomic_q_elem = NULL;
+    
     sched_q_obj = SCHED_Q_ATOMIC_SELECT(q_elem);
     qidx        = q_elem->id & (sched_q_obj->queue_mask);
     sched_q     = sched_q_obj->sched_q[qidx];
-
-    ret = mring_enqueue(sched_q, q_elem->priority, q_elem);
-  }
-  else
-  { 
-    /* Nothing to schedule */
-    union {
-      struct {
-        int32_t sched_count, event_count;
-      };
-      uint64_t atomic_counts;
-    } expected_value = {{.sched_count = 1, .event_count = 0}};
-
-    /* Try setting both event count and sched count to zero. If cmpset fails
-     * someone has modified event_count (upwards) so just reschedule
-     */
-    if(!rte_atomic64_cmpset(&q_elem->u.atomic.atomic_counts_u64, expected_value.atomic_counts, 0))
-    {
-      sched_q_obj = SCHED_Q_ATOMIC_SELECT(q_elem);
-      qidx        = q_elem->id & (sched_q_obj->queue_mask);
-      sched_q     = sched_q_obj->sched_q[qidx];
-
-      ret = mring_enqueue(sched_q, q_elem->priority, q_elem);
-    }
+    
+    atomic_context_release(q_elem, sched_q, 0, 0, EM_ESCOPE_DIRECT_DISPATCH__ATOMIC);
   }
   
-  IF_UNLIKELY(ret != 1) {
-    // Should never happen
-    (void) EM_INTERNAL_ERROR(EM_FATAL(EM_ERR_LIB_FAILED), EM_ESCOPE_DIRECT_DISPATCH__ATOMIC,
-                             "Atomic sched queue enqueue failed, ret=%i!", ret);
-  }
+  return EM_OK;
   
 #else // LOCKLESS_ATOMIC_QUEUES == 0
 
@@ -2314,7 +5546,7 @@ em_direct_dispatch__atomic(em_queue_element_t *const q_elem,
           //
           // Call dispatch with lock unlocked
           // 
-          dispatch_event(q_elem, event, EM_EVENT_TYPE_PACKET);
+          dispatch_event(q_elem, event, ev_hdr->event_type);
           
           
           ENV_PREFETCH(&q_elem->lock);
@@ -2328,7 +5560,7 @@ em_direct_dispatch__atomic(em_queue_element_t *const q_elem,
           if(q_elem->u.atomic.event_count > 0)
           {            
             // MULTI PRODUCER
-            ret = mring_enqueue(sched_q, q_elem->priority, q_elem);      
+            ret = sched_q_enqueue(sched_q, SCHED_TYPE_ATOMIC, q_elem, q_elem);      
             
             IF_UNLIKELY(ret != 1) {
               q_elem->u.atomic.sched_count = 0;
@@ -2340,7 +5572,7 @@ em_direct_dispatch__atomic(em_queue_element_t *const q_elem,
           
           env_spinlock_unlock(&q_elem->lock);
           
-          return;
+          return EM_OK;
         }
         
         env_spinlock_unlock(&q_elem->lock);
@@ -2350,21 +5582,21 @@ em_direct_dispatch__atomic(em_queue_element_t *const q_elem,
 
 
   // Enqueue to an EM queue - NORMAL Operation as backup.
-  status = em_send_atomic(ev_hdr, q_elem, q_elem->id);
-
-  IF_UNLIKELY(status != EM_OK) {
-    intel_free(ev_hdr);
-  }
+  return em_send_switch(ev_hdr, q_elem, q_elem->id);
   
 #endif // #if LOCKLESS_ATOMIC_QUEUES == 1
 }
-#endif
 
 
 
 
-#if RX_DIRECT_DISPATCH == 1
-static inline void
+/**
+ * Direct dispatch to a parallel-ordered queue: take the place of the event in the order of
+ * the queue and dispatch on this core, enqueue the event normally if that fails.
+ *
+ * @return EM_OK if the event was dispatched or enqueued
+ */
+static inline em_status_t
 em_direct_dispatch__parallel_ordered(em_queue_element_t *const q_elem,
                                      em_event_t                event,
                                      em_event_hdr_t     *const ev_hdr)
@@ -2372,6 +5604,21 @@ em_direct_dispatch__parallel_ordered(em_queue_element_t *const q_elem,
   const em_queue_t queue = q_elem->id;
   em_status_t      status;    
 
+#if LOCKLESS_ORDERED_QUEUES == 1
+  // Tickets are handed out under the sched-Q lock of the queue, as in em_schedule_parallel_ordered()
+  sched_q_parallel_ord_t *const sched_q_obj = SCHED_Q_PARALLEL_ORD_SELECT(q_elem); 
+  uint64_t                const qidx        = q_elem->id & (sched_q_obj->queue_mask);
+  env_spinlock_t         *const lock        = &sched_q_obj->locks[qidx].lock;  
+  em_event_hdr_t         *const ev_hdrs[1]  = {ev_hdr};
+  
+  
+  env_spinlock_lock(lock);
+  
+  status = (order_window_tickets(q_elem, ev_hdrs, 1) == 1) ? EM_OK : EM_ERR_LIB_FAILED;
+  
+  env_spinlock_unlock(lock);
+#else
+  
 #if PARALLEL_ORDERED__USE_SCHED_Q_LOCKS == 1
   // Use sched-Q locks to maintain order - worse in I/O but better in internal Queue scheduling...
   sched_q_parallel_ord_t *const sched_q_obj = SCHED_Q_PARALLEL_ORD_SELECT(q_elem); 
@@ -2388,26 +5635,21 @@ em_direct_dispatch__parallel_ordered(em_queue_element_t *const q_elem,
   status = parallel_ordered_maintain_order(ev_hdr, q_elem, lock);
 
   env_spinlock_unlock(lock);
+#endif
 
 
   IF_LIKELY(status == EM_OK)
   {
-    dispatch_event(q_elem, event, EM_EVENT_TYPE_PACKET);
+    dispatch_event(q_elem, event, ev_hdr->event_type);
   }
   else
   {
     // Enqueue to an EM queue - Fallback operation in case of error
     status = em_send_switch(ev_hdr, q_elem, queue);
-    
-    IF_UNLIKELY(status != EM_OK)
-    {
-      // Drop RX event
-      em_free(event);
-    }
   }
   
+  return status;
 }
-#endif
 
 
 
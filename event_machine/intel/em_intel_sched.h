@@ -66,20 +66,77 @@ extern "C" {
  */
 #define LOCKLESS_ATOMIC_QUEUES  (1)  // 1=On, 0=Off(can heavily impact performance)
 
+/**
+ * Poll only the scheduling queues marked ready (non-empty) by the producers (=1) or poll round-robin all
+ * scheduling queues the core serves (=0)
+ */
+#define SCHED_READY_HINTS       (1)  // 1=On, 0=Off
+
 
 // Scheduling priority levels
 #define  SCHED_PRIO_LEVELS           (EM_QUEUE_PRIO_NUM)
 COMPILE_TIME_ASSERT(EM_QUEUE_PRIO_LOWEST == 0, EM_QUEUE_PRIO_LOWEST__NOT_ZERO_ERROR);
 
 // A scheduling queue per queue group (per sched type (atomic, parallel, parallel-ordered)
+// The queue groups served are kept in two level masks (group_mask_t, em_intel.h)
 #define  SCHED_QS                    (EM_MAX_QUEUE_GROUPS)
 // Maximum number of _actual_ queues in a single scheduling queue object
 #define  SCHED_Q_MAX_QUEUES          (16) // Note: same amount as bits in uint16_t - don't change!
 
+// Default depth (per priority) of a scheduling queue, em_conf_t.sched_ring_size overrides (must be a power of 2)
+#define  SCHED_Q_RING_SIZE              (4*1024)
+// Depth (per priority) of the scheduling queues in the core local queue groups (EM internal messaging only)
+#define  SCHED_Q_CORE_LOCAL_RING_SIZE   (256)
+
+// Max number of full bursts in a row from the same scheduling queue (at the default burst sizes)
 #define SCHED_Q_ATOMIC_CNT_MAX       (4)
 #define SCHED_Q_PARALLEL_CNT_MAX     (4)
 #define SCHED_Q_PARALLEL_ORD_CNT_MAX (4)
 
+/*
+ * Adaptive burst sizes (em_conf_t.sched_burst_adaptive): the dequeue burst of each scheduling type
+ * is SCHED_BURST_MIN << level, the levels match the burst sizes mring_dequeue_mp_burst() supports.
+ * The revisit counts above double/halve with each level up/down from the default burst size.
+ */
+#define SCHED_BURST_LEVELS           (EM_SCHED_BURST_SIZES)
+#define SCHED_BURST_MIN              (8)
+#define SCHED_BURST_MAX              (SCHED_BURST_MIN << (SCHED_BURST_LEVELS - 1))
+// Number of dequeues of a scheduling type between burst size decisions
+#define SCHED_BURST_WINDOW           (256)
+// Share of full bursts in a window (percent) at or above which the burst grows, below which it shrinks
+#define SCHED_BURST_FILL_HIGH        (75)
+#define SCHED_BURST_FILL_LOW         (25)
+
+/*
+ * Hybrid poll/sleep dispatch (em_conf_t.dispatch_idle_rounds): after the idle rounds a core pauses
+ * between the empty rounds, doubling the pause up to DISPATCH_PAUSE_MAX, before going to sleep.
+ */
+#define DISPATCH_PAUSE_MAX           (256)
+// Max sleep time in microseconds when em_conf_t.dispatch_sleep_us is 0
+#define DISPATCH_SLEEP_US_DEFAULT    (1000)
+
+/*
+ * Work stealing (em_conf_t.sched_steal): an idle core checks SCHED_STEAL_VICTIMS other cores per
+ * empty scheduling round and steals at most half of a core local parallel scheduling queue holding
+ * at least the threshold of events, or one atomic queue when at least SCHED_STEAL_ATOMIC_MIN are ready.
+ */
+#define SCHED_STEAL_VICTIMS            (4)
+#define SCHED_STEAL_THRESHOLD_DEFAULT  (32)
+#define SCHED_STEAL_ATOMIC_MIN         (2)
+
+/*
+ * Cache-affine atomic scheduling (em_conf_t.sched_atomic_sticky): a core keeps up to SCHED_STICKY_STASH
+ * atomic queues it just served (and that still have events) in a private stash instead of the
+ * scheduling queue and serves one of them first in each scheduling round.
+ */
+#define SCHED_STICKY_STASH             (4)
+
+/*
+ * Direct dispatch queues (em_queue_direct_dispatch_set()): max nesting of inline dispatches
+ * from EO sends on a core, deeper sends are enqueued normally (bounds the stack use).
+ */
+#define DIRECT_DISPATCH_DEPTH_MAX      (4)
+
 
 
 /**
@@ -91,6 +148,8 @@ typedef struct
 
   uint64_t          queue_mask;
 
+  uint32_t          ring_size; // Depth of the sched_q[]'s, rings are created on first use
+
   struct multiring* sched_q[SCHED_Q_MAX_QUEUES];
 
 } sched_q_atomic_t;
@@ -105,6 +164,8 @@ typedef struct
 
   uint64_t          queue_mask;
 
+  uint32_t          ring_size; // Depth of the sched_q[]'s, rings are created on first use
+
   struct multiring* sched_q[SCHED_Q_MAX_QUEUES];
 
 } sched_q_parallel_t;
@@ -119,6 +180,8 @@ typedef struct
 
   uint64_t          queue_mask;
 
+  uint32_t          ring_size; // Depth of the sched_q[]'s, rings are created on first use
+
   struct multiring* sched_q[SCHED_Q_MAX_QUEUES];
 
 
@@ -154,6 +217,83 @@ COMPILE_TIME_ASSERT((sizeof(sched_qs_t) % ENV_CACHE_LINE_SIZE) == 0, SCHED_QS_T_
 
 
 
+/**
+ * Strict priority scheduling (em_conf_t.sched_strict_prio):
+ * A bitmap of queue groups with (possibly) non-empty scheduling queues, one per priority level and
+ * queue type. Set by the producers after enqueue, cleared by a core that finds the level empty.
+ * A bit may be set for an empty group, never clear for a group with events - except transiently.
+ */
+#define SCHED_TYPE_ATOMIC        (0)
+#define SCHED_TYPE_PARALLEL      (1)
+#define SCHED_TYPE_PARALLEL_ORD  (2)
+#define SCHED_TYPES              (3)
+
+// Cache lines for a queue group mask (group_mask_t) padded to full lines
+#define SCHED_GROUP_MASK_LINES  ((sizeof(group_mask_t) + ENV_CACHE_LINE_SIZE - 1) / ENV_CACHE_LINE_SIZE)
+
+typedef union
+{
+  group_mask_t  q_grp_mask;
+  
+  uint8_t u8[SCHED_GROUP_MASK_LINES * ENV_CACHE_LINE_SIZE];
+  
+} sched_prio_hint_t;
+
+COMPILE_TIME_ASSERT((sizeof(sched_prio_hint_t) % ENV_CACHE_LINE_SIZE) == 0, SCHED_PRIO_HINT_T__SIZE_ERROR);
+
+
+typedef struct
+{
+  sched_prio_hint_t  hint[SCHED_PRIO_LEVELS][SCHED_TYPES];
+  
+} sched_prio_hints_t  ENV_CACHE_LINE_ALIGNED;
+
+
+
+/**
+ * Ready hints (SCHED_READY_HINTS):
+ * Per queue type, a bitmap of queue groups with (possibly) non-empty scheduling queues and per queue group
+ * a bitmap of the (possibly) non-empty scheduling queues in it. Set by the producers after enqueue, cleared
+ * by a core that finds the scheduling queue empty. The hints are advisory - every SCHED_READY_RESCAN_ROUNDS
+ * rounds the scheduler checks all the scheduling queues the core serves and marks the non-empty ones.
+ */
+#define SCHED_READY_RESCAN_ROUNDS  (64)
+
+typedef union
+{
+  volatile uint16_t  qidx_mask;
+  
+  uint8_t u8[ENV_CACHE_LINE_SIZE];
+  
+} sched_ready_grp_t;
+
+COMPILE_TIME_ASSERT(sizeof(sched_ready_grp_t) == ENV_CACHE_LINE_SIZE, SCHED_READY_GRP_T__SIZE_ERROR);
+
+
+typedef struct
+{
+  union
+  {
+    group_mask_t  q_grp_mask;
+    
+    uint8_t u8[SCHED_GROUP_MASK_LINES * ENV_CACHE_LINE_SIZE];
+  };
+  
+  sched_ready_grp_t  grp[SCHED_QS];
+  
+} sched_ready_type_t;
+
+
+typedef struct
+{
+  sched_ready_type_t  ready[SCHED_TYPES];
+  
+} sched_ready_hints_t  ENV_CACHE_LINE_ALIGNED;
+
+COMPILE_TIME_ASSERT((sizeof(sched_ready_hints_t) % ENV_CACHE_LINE_SIZE) == 0, SCHED_READY_HINTS_T__SIZE_ERROR);
+
+
+
 /**
  * Scheduling Queues Info on a core
  */
@@ -182,6 +322,12 @@ typedef struct
    // Actual FIFO index inside the above indexed Sched queue object
    uint8_t             parallel_ord_qidx[SCHED_QS];
    
+   
+   // Strict priority scheduling: next queue group index to start from, per queue type
+   uint16_t            strict_prio_grp_idx[SCHED_TYPES];
+   // Strict priority scheduling: queue type to start from
+   uint8_t             strict_prio_type;
+   
 } sched_qs_info_local_t;
 
 
@@ -192,7 +338,7 @@ typedef struct
 
 typedef struct
 {
-  volatile  uint64_t  q_grp_mask;
+  group_mask_t        q_grp_mask;
   
   volatile  uint16_t  qidx_mask[SCHED_QS];
   
@@ -214,7 +360,7 @@ typedef union
 {  
   sched_masks_t sched_masks_prio;
   
-  uint8_t u8[32 * ENV_CACHE_LINE_SIZE];
+  uint8_t u8[((sizeof(sched_masks_t) + ENV_CACHE_LINE_SIZE - 1) / ENV_CACHE_LINE_SIZE) * ENV_CACHE_LINE_SIZE];
   
 } core_sched_masks_t  ENV_CACHE_LINE_ALIGNED;
 
@@ -268,6 +414,51 @@ typedef union
 
 
 
+/**
+ * Hybrid poll/sleep dispatch: sleep state of one core (em_conf_t.dispatch_idle_rounds).
+ * A sending core claims a sleeping core of the destination queue group by clearing 'sleeping'
+ * and wakes it up through the 'futex' word.
+ */
+typedef union
+{
+  struct
+  {
+    volatile int32_t   futex;     // Futex word, incremented by the waker
+    
+    volatile int32_t   sleeping;  // 1 = core sleeping (or about to), 0 = awake or claimed by a waker
+    
+    volatile uint64_t  wake_tsc;  // Time of the wakeup by the waker, for the wakeup latency
+  };
+  
+  uint8_t u8[ENV_CACHE_LINE_SIZE];
+  
+} dispatch_sleep_core_t;
+
+COMPILE_TIME_ASSERT(sizeof(dispatch_sleep_core_t) == ENV_CACHE_LINE_SIZE, DISPATCH_SLEEP_CORE_T__SIZE_ERROR);
+
+
+typedef struct
+{
+  union
+  {
+    struct
+    {
+      volatile int32_t  enabled;   // Set once any core uses the hybrid mode, senders check for sleepers only then
+      
+      volatile int32_t  sleepers;  // Number of sleeping cores
+    };
+    
+    uint8_t u8[ENV_CACHE_LINE_SIZE];
+  };
+  
+  dispatch_sleep_core_t  core[EM_MAX_CORES];
+  
+} dispatch_sleep_t  ENV_CACHE_LINE_ALIGNED;
+
+COMPILE_TIME_ASSERT((sizeof(dispatch_sleep_t) % ENV_CACHE_LINE_SIZE) == 0, DISPATCH_SLEEP_T__SIZE_ERROR);
+
+
+
 
 /*
  * Externs
@@ -279,7 +470,7 @@ typedef union
 /*
  * Functions
  */
-void em_schedule(void);
+int em_schedule(void);
 
 
 #define OPERATION_SEND      (0) // Normal send _FROM_ a parallel-ordered queue
@@ -288,6 +479,10 @@ void em_schedule(void);
 em_status_t
 em_send_from_parallel_ord_q(em_event_hdr_t *const ev_hdr, em_queue_element_t *const q_elem, const em_queue_t queue, const int operation);
 
+int
+em_send_from_parallel_ord_q_multi(em_event_hdr_t *const ev_hdrs[], const int num, em_queue_element_t *const q_elem,
+                                  const em_queue_t queue, const int operation);
+
 
 void
 em_direct_dispatch(em_event_t                event,
@@ -299,6 +494,9 @@ em_direct_dispatch(em_event_t                event,
 em_status_t                                                                                            
 em_send_switch(em_event_hdr_t *const ev_hdr, em_queue_element_t *const q_elem, const em_queue_t queue);
 
+int
+em_send_switch_multi(em_event_hdr_t *const ev_hdrs[], const int num, em_queue_element_t *const q_elem, const em_queue_t queue);
+
 
 em_status_t
 sched_masks_add_queue(const em_queue_t queue,
@@ -319,8 +517,14 @@ sched_masks_add_queue_group__local(const em_queue_group_t grp);
 void
 sched_init_global_1(void);
 
+void
+sched_qs_group_init(const em_queue_group_t group, const int nbr_queues, const uint32_t ring_size);
+
 em_status_t
-sched_init_global_2(void);
+sched_qs_create(const em_queue_type_t type, const em_queue_group_t group);
+
+void
+sched_qs_free(const em_queue_group_t group);
 
 void
 sched_init_local(void);
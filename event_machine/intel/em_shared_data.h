@@ -61,37 +61,67 @@ extern "C" {
 
 
 
+/**
+ * Sizes of the EM shared tables, set by em_init() from em_conf_t.
+ * The compile-time maximums (EM_MAX_QUEUES, EM_MAX_EOS etc.) are the upper limits.
+ */
+typedef union
+{
+  struct
+  {
+    uint32_t max_queues;          /**< Queue ids 0 ... max_queues-1, static and internal queues first */
+    uint32_t dyn_queues_per_pool; /**< Dynamic queue ids per queue id pool (DYN_QUEUE_POOLS) */
+    uint32_t max_eos;             /**< EO ids 0 ... max_eos-1 */
+    uint32_t eos_per_pool;        /**< EO ids per EO id pool (EO_POOLS) */
+    uint32_t max_event_groups;    /**< Event group ids 0 ... max_event_groups-1 */
+    uint32_t max_eth_ports;       /**< Eth ports 0 ... max_eth_ports-1 used for packet-I/O */
+  };
+  
+  uint8_t u8[ENV_CACHE_LINE_SIZE];
+  
+} em_shared_limits_t;
+
+COMPILE_TIME_ASSERT(sizeof(em_shared_limits_t) == ENV_CACHE_LINE_SIZE, EM_SHARED_LIMITS_T__SIZE_ERROR);
+
+
+
 /**
  * EM shared data
  *
  * Struct contains data that is shared between all EM-cores,
  * i.e. shared between all EM-processes or EM-threads depending on the setup.
  * 
+ * The tables sized by em_conf_t (see em_shared_limits_t) are placed after the struct in 
+ * the same shared memory region, em_init() sets the table pointers.
  */
 typedef struct
 {
+  /** Table sizes, read-mostly */
+  em_shared_limits_t      limits  ENV_CACHE_LINE_ALIGNED;
+  
+  
   /*
    * em_intel.c|h
    */
   
-  /** EO table */
-  em_eo_element_t         em_eo_element_tbl[EM_MAX_EOS]  ENV_CACHE_LINE_ALIGNED;
+  /** EO table [limits.max_eos] */
+  em_eo_element_t        *em_eo_element_tbl  ENV_CACHE_LINE_ALIGNED;
+  
+  /** Queue element table [limits.max_queues] */
+  em_queue_element_t     *em_queue_element_tbl;  // Static queues first followed by dynamic queues
+  
+  /** Queue name table [limits.max_queues] */
+  char                  (*em_queue_name_tbl)[EM_QUEUE_NAME_LEN];
   
   /** EM Pool table */
   em_pool_t               em_eo_pool[EO_POOLS]  ENV_CACHE_LINE_ALIGNED;
   
-  /** Queue element table */
-  em_queue_element_t      em_queue_element_tbl[EM_MAX_QUEUES]  ENV_CACHE_LINE_ALIGNED;  // Static queues first followed by dynamic queues
-  
   /** EM dynamic queue pool */
   em_pool_t               em_dyn_queue_pool[DYN_QUEUE_POOLS]   ENV_CACHE_LINE_ALIGNED;  // Dynamic queue ID FIFOs
   
   /** Spinlocks for the static numbered queues */
   em_spinlock_t           em_static_queue_lock[STATIC_QUEUE_LOCKS]  ENV_CACHE_LINE_ALIGNED;  // Static queue ID locks
   
-  /** Queue name table */
-  char                    em_queue_name_tbl[EM_MAX_QUEUES][EM_QUEUE_NAME_LEN]  ENV_CACHE_LINE_ALIGNED;
-  
   /** Lock used by queue_init() to serialize rte_ring_create() calls */
   em_spinlock_t           queue_create_lock  ENV_CACHE_LINE_ALIGNED;
   
@@ -113,8 +143,8 @@ typedef struct
    * em_intel_event_group.c|h
    */
 
-  /** Event group entry table (em_event_group_t used as index into table) */
-  em_event_group_entry_t           em_event_group_entry_tbl[EM_MAX_EVENT_GROUPS]  ENV_CACHE_LINE_ALIGNED;
+  /** Event group entry table [limits.max_event_groups] (em_event_group_t used as index into table) */
+  em_event_group_entry_t          *em_event_group_entry_tbl                       ENV_CACHE_LINE_ALIGNED;
   /** Event group entry table access lock */
   em_event_group_entry_tbl_lock_t  em_event_group_entry_tbl_lock                  ENV_CACHE_LINE_ALIGNED;
 
@@ -127,6 +157,8 @@ typedef struct
   em_queue_group_element_t  em_queue_group[EM_MAX_QUEUE_GROUPS]  ENV_CACHE_LINE_ALIGNED;
   /** Queue group table access lock */
   em_spinlock_t             em_queue_group_lock                  ENV_CACHE_LINE_ALIGNED;
+  /** Core local queue group of each core (EM core ID), read by work stealing */
+  em_queue_group_t          core_local_group[EM_MAX_CORES]       ENV_CACHE_LINE_ALIGNED;
   
   
   /*
@@ -140,6 +172,14 @@ typedef struct
   core_sched_masks_t       core_sched_masks[EM_MAX_CORES]      ENV_CACHE_LINE_ALIGNED;
   core_sched_add_counts_t  core_sched_add_counts[EM_MAX_CORES] ENV_CACHE_LINE_ALIGNED;
   sched_add_counts_lock_t  sched_add_counts_lock               ENV_CACHE_LINE_ALIGNED;
+  /** Lock serializing the on-demand creation and freeing of the scheduling queues */
+  em_spinlock_t            sched_qs_lock                       ENV_CACHE_LINE_ALIGNED;
+  /** Non-empty queue group hints per priority level for strict priority scheduling */
+  sched_prio_hints_t       sched_prio_hints                    ENV_CACHE_LINE_ALIGNED;
+  /** Non-empty scheduling queue hints per queue type (SCHED_READY_HINTS) */
+  sched_ready_hints_t      sched_ready_hints                   ENV_CACHE_LINE_ALIGNED;
+  /** Sleep states of the cores for the hybrid poll/sleep dispatch */
+  dispatch_sleep_t         dispatch_sleep                      ENV_CACHE_LINE_ALIGNED;
   
   
   /*
@@ -155,10 +195,10 @@ typedef struct
   eth_rx_queue_info_t  eth_rx_queue_info[MAX_ETH_RX_QUEUES]  ENV_CACHE_LINE_ALIGNED;
   
   /**
-   * Tx buffer for Eth frames that must be sent out in-order.
+   * Tx buffer for Eth frames that must be sent out in-order [limits.max_eth_ports].
    * One buffer per device (i.e. shared by all cores)
    */
-  eth_tx_mbuf_table_t  eth_tx_mbuf_tables[MAX_ETH_PORTS][MAX_ETH_TX_MBUF_TABLES]  ENV_CACHE_LINE_ALIGNED;
+  eth_tx_mbuf_table_t (*eth_tx_mbuf_tables)[MAX_ETH_TX_MBUF_TABLES]  ENV_CACHE_LINE_ALIGNED;
 
   /**
    * Packet I/O flows lookup hash
@@ -186,6 +226,10 @@ COMPILE_TIME_ASSERT((sizeof(em_shared_data_t) % ENV_CACHE_LINE_SIZE) == 0, EM_SH
 
 
 
+// Cache lines for em_data_t: the shm pointer, the per socket event pool tables and the pool sizes
+#define EM_DATA_LINES  ((sizeof(void *) + (EM_MAX_SOCKETS * EM_MAX_POOLS * sizeof(em_event_pool_t)) + \
+                         (EM_MAX_POOLS * sizeof(uint32_t)) + ENV_CACHE_LINE_SIZE - 1) / ENV_CACHE_LINE_SIZE)
+
 typedef union
 {
   struct 
@@ -193,15 +237,21 @@ typedef union
     /* EM shared data */
     em_shared_data_t *shm;
     
-    /** Event pool */
-    em_event_pool_t   event_pool;
+    /** Event pools of each socket, indexed by socket id and em_pool_id_t. EM_POOL_DEFAULT is also used for packet-I/O.
+     *  Sockets without EM cores use the pools of their home socket, see numa_home_socket() */
+    em_event_pool_t   event_pools[EM_MAX_SOCKETS][EM_MAX_POOLS];
+    
+    /** Max event size of each event pool */
+    uint32_t          event_pool_size[EM_MAX_POOLS];
   };
   
-  uint8_t u8[ENV_CACHE_LINE_SIZE];
+  uint8_t u8[EM_DATA_LINES * ENV_CACHE_LINE_SIZE];
   
 } em_data_t;
 
 COMPILE_TIME_ASSERT((sizeof(em_data_t) % ENV_CACHE_LINE_SIZE) == 0, EM_DATA_T_SIZE_ERROR);
+COMPILE_TIME_ASSERT((offsetof(em_data_t, event_pool_size) + (EM_MAX_POOLS * sizeof(uint32_t))) <=
+                    (EM_DATA_LINES * ENV_CACHE_LINE_SIZE), EM_DATA_LINES_ERROR);
 
 
 
@@ -216,4 +266,4 @@ extern em_data_t em;
 }
 #endif
 
-#endif  // EM_SHARED_DATA_H
\ No newline at end of file
+#endif  // EM_SHARED_DATA_H
\ No newline at end of file
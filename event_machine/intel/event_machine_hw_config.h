@@ -171,16 +171,16 @@ typedef enum em_queue_type_e
  * Never directly use the numerical values as they may change from
  * one platform to the next; always use the enum names instead.
  */
-#define EM_QUEUE_PRIO_NUM (4) // 4 priority levels used
+#define EM_QUEUE_PRIO_NUM (8) // 8 priority levels used: 0 (lowest) ... 7 (highest)
  
 typedef enum em_queue_prio_e
 {
   EM_QUEUE_PRIO_UNDEF    = 0xFF, // Undefined
   EM_QUEUE_PRIO_LOWEST   = 0,
-  EM_QUEUE_PRIO_LOW      = 0,
-  EM_QUEUE_PRIO_NORMAL   = 1,
-  EM_QUEUE_PRIO_HIGH     = 2,
-  EM_QUEUE_PRIO_HIGHEST  = 3  
+  EM_QUEUE_PRIO_LOW      = 1,
+  EM_QUEUE_PRIO_NORMAL   = 3,
+  EM_QUEUE_PRIO_HIGH     = 5,
+  EM_QUEUE_PRIO_HIGHEST  = 7  
 
 } em_queue_prio_e;
 
@@ -196,9 +196,10 @@ typedef enum em_queue_prio_e
 
 
 /**
- * Maximum number of EM queue groups
+ * Maximum number of EM queue groups (power of 2, max 4096).
+ * One queue group per EM core is reserved for EM internal use, one for the default group.
  */
-#define EM_MAX_QUEUE_GROUPS        64
+#define EM_MAX_QUEUE_GROUPS        256
 
 /**
  * Default queue group for EM
@@ -212,9 +213,17 @@ typedef enum em_queue_prio_e
 
 /**
  * Define default memory pool
+ *
+ * Event allocation with EM_POOL_DEFAULT selects the smallest event pool (size class) that
+ * fits the requested size. The pool with pool id EM_POOL_DEFAULT itself is also used for packet-I/O.
  */
 #define EM_POOL_DEFAULT            0
 
+/**
+ * Max number of event pools (size classes), valid pool ids are 0...EM_MAX_POOLS-1
+ */
+#define EM_MAX_POOLS               4
+
 /**
  * Fatal error mask
  */
@@ -92,6 +92,527 @@ em_dispatch(uint32_t rounds);
 
 
 
+/**
+ * Statistics of one em_dispatch_ex() call (HW specific addition)
+ */
+typedef struct
+{
+  uint64_t events;       /**< Events dispatched */
+  
+  uint64_t rounds;       /**< Scheduling rounds run */
+  
+  uint64_t cycles;       /**< Core cycles spent in the call */
+  
+  uint64_t idle_cycles;  /**< Core cycles spent in rounds that dispatched no events */
+  
+} em_dispatch_stats_t;
+
+
+
+/**
+ * Time or event budgeted event dispatch (HW specific addition)
+ *
+ * Like em_dispatch(), but runs scheduling rounds until 'cycle_budget' core cycles have
+ * passed or 'max_events' events have been dispatched, whichever comes first. Lets the
+ * application interleave its own polling (e.g. a control socket) with the dispatch loop
+ * with a bounded delay.
+ *
+ * The limits are checked after each pass over the scheduling queues: the last pass can exceed
+ * them by the events it dispatched, i.e. up to one burst per scheduling type (atomic, parallel,
+ * parallel-ordered) plus their processing time, and the Eth Rx polled before it.
+ * The call never sleeps (em_conf_t.dispatch_idle_rounds applies to em_dispatch(0) only).
+ *
+ * @param cycle_budget  Max core cycles to dispatch for, 0 = no time limit
+ * @param max_events    Max number of events to dispatch, 0 = no event limit
+ * @param stats         Statistics of the call (output), NULL if not needed
+ *
+ * @return Number of events dispatched. If both limits are 0, runs one scheduling round.
+ *
+ * @see env_core_hz() for converting time to core cycles
+ */
+uint64_t
+em_dispatch_ex(uint64_t cycle_budget, uint64_t max_events, em_dispatch_stats_t *const stats);
+
+
+
+/**
+ * Receive a batch of events (HW specific addition)
+ *
+ * Optional alternative to em_receive_func_t(), registered with em_eo_create_multircv().
+ * EM passes several events dequeued from the same queue in one call to amortize the 
+ * per-event dispatch overhead, e.g. to allow processing the events of the batch together
+ * (header parsing, hash lookups etc).
+ *
+ * All events in the batch have been dequeued from the same queue and belong to the same
+ * event group. Events are in queue order, the scheduling type of the queue applies to 
+ * the batch as a whole: events from an atomic queue are passed to one core at a time,
+ * events from parallel-ordered queues restore their order on em_send() as usual.
+ * The batch size is implementation specific and can vary from call to call (min 1).
+ *
+ * @param eo_ctx        EO context data. The pointer is passed in em_eo_create_multircv(), EM does not touch the data.
+ * @param events        Array of event handles
+ * @param types         Array of event types, types[i] is the type of events[i]
+ * @param num           Number of events in the arrays
+ * @param queue         Queue from which the events came from
+ * @param q_ctx         Queue context data. The pointer is passed in em_queue_set_context(), EM does not touch the data.
+ *
+ * @see em_eo_create_multircv(), em_receive_func_t()
+ */
+typedef void (*em_receive_multi_func_t)(void* eo_ctx, em_event_t events[], em_event_type_t types[], int num,
+                                        em_queue_t queue, void* q_ctx);
+
+
+
+/**
+ * Create Execution Object (EO) with a multi-event receive function (HW specific addition)
+ *
+ * As em_eo_create(), but EM calls the given 'receive_multi' function with a batch of
+ * events from one queue instead of calling a receive function for each event separately.
+ *
+ * @param name          Name of the EO (NULL if no name)
+ * @param start         Start function
+ * @param local_start   Core local start function (NULL if no local start)
+ * @param stop          Stop function
+ * @param local_stop    Core local stop function (NULL if no local stop)
+ * @param receive_multi Multi-event receive function
+ * @param eo_ctx        User defined EO context data, EM just passes the pointer (NULL if not context)
+ *
+ * @return New EO id if successful, otherwise EM_EO_UNDEF
+ *
+ * @see em_eo_create(), em_receive_multi_func_t()
+ */
+em_eo_t
+em_eo_create_multircv(const char*             name,
+                      em_start_func_t         start,
+                      em_start_local_func_t   local_start,
+                      em_stop_func_t          stop,
+                      em_stop_local_func_t    local_stop,
+                      em_receive_multi_func_t receive_multi,
+                      const void*             eo_ctx);
+
+
+
+/**
+ * Overflow modes of a parallel-ordered queue, see em_queue_order_conf_t
+ */
+#define EM_ORDER_OVERFLOW_UNORDERED  (0) /**< Events beyond the capacity are sent without restoring their order (default) */
+#define EM_ORDER_OVERFLOW_GROW       (1) /**< The order window grows beyond the capacity, order is kept */
+
+
+/**
+ * Order restoration config of a parallel-ordered queue (HW specific addition)
+ *
+ * @see em_queue_create_ordered()
+ */
+typedef struct
+{
+  int capacity;      /**< Max number of events in processing (scheduled but not yet sent/freed) kept in order,
+                          rounded up to the window block size, 0 = use default */
+  
+  int overflow_mode; /**< What to do with events scheduled when 'capacity' events are already in processing:
+                          EM_ORDER_OVERFLOW_UNORDERED or EM_ORDER_OVERFLOW_GROW */
+  
+} em_queue_order_conf_t;
+
+
+/**
+ * Order restoration counters of a parallel-ordered queue (HW specific addition)
+ *
+ * @see em_queue_order_stats()
+ */
+typedef struct
+{
+  uint64_t overflow_events; /**< Events scheduled beyond the capacity and kept in order (EM_ORDER_OVERFLOW_GROW) */
+  
+  uint64_t order_lost;      /**< Events scheduled beyond the capacity (or window max size) and sent without restoring their order */
+  
+  uint32_t capacity;        /**< Configured capacity (rounded up) */
+  
+  uint32_t window_size;     /**< Current window size, grows above 'capacity' on overflow with EM_ORDER_OVERFLOW_GROW */
+  
+} em_queue_order_stats_t;
+
+
+
+/**
+ * Create a parallel-ordered queue with a dynamic queue id and an order restoration config (HW specific addition)
+ *
+ * As em_queue_create() with type EM_QUEUE_TYPE_PARALLEL_ORDERED, but the number of events in processing 
+ * kept in order and the behaviour when that is exceeded are given in 'conf'.
+ *
+ * @param name          Queue name for debugging purposes (optional, NULL ok)
+ * @param prio          Queue priority
+ * @param group         Queue group for this queue
+ * @param conf          Order restoration config (NULL = use defaults)
+ *
+ * @return New queue id or EM_QUEUE_UNDEF on an error
+ *
+ * @see em_queue_create(), em_queue_order_stats()
+ */
+em_queue_t
+em_queue_create_ordered(const char* name, em_queue_prio_t prio, em_queue_group_t group, const em_queue_order_conf_t *conf);
+
+
+
+/**
+ * Read the order restoration counters of a parallel-ordered queue (HW specific addition)
+ *
+ * @param queue         Parallel-ordered queue
+ * @param stats         Counters (output)
+ *
+ * @return EM_OK if successful.
+ *
+ * @see em_queue_create_ordered()
+ */
+em_status_t
+em_queue_order_stats(em_queue_t queue, em_queue_order_stats_t *stats);
+
+
+
+/**
+ * Event queue config of an atomic queue (HW specific addition)
+ *
+ * @see em_queue_create_atomic()
+ */
+typedef struct
+{
+  int ring_size; /**< Max number of events in the queue, rounded up to a power of 2 (min 32), 0 = use default */
+  
+  int lazy_ring; /**< Bind the event queue on the first send and return it to a shared pool whenever the queue
+                      runs empty: enable=1, disable=0. Saves memory with many mostly idle queues (flows). */
+  
+} em_queue_atomic_conf_t;
+
+
+
+/**
+ * Create an atomic queue with a dynamic queue id and an event queue config (HW specific addition)
+ *
+ * As em_queue_create() with type EM_QUEUE_TYPE_ATOMIC, but the depth of the queue
+ * and when its memory is reserved are given in 'conf'.
+ *
+ * @param name          Queue name for debugging purposes (optional, NULL ok)
+ * @param prio          Queue priority
+ * @param group         Queue group for this queue
+ * @param conf          Event queue config (NULL = use defaults)
+ *
+ * @return New queue id or EM_QUEUE_UNDEF on an error
+ *
+ * @see em_queue_create()
+ */
+em_queue_t
+em_queue_create_atomic(const char* name, em_queue_prio_t prio, em_queue_group_t group, const em_queue_atomic_conf_t *conf);
+
+
+
+/**
+ * Enable or disable the direct dispatch of a queue (HW specific addition)
+ *
+ * An event sent with em_send()/em_send_group() from an EO receive function to a direct
+ * dispatch queue is passed to the receiving EO inline, on the sending core and before the
+ * send returns, if the core serves the queue group of the queue. This skips the enqueue
+ * and dequeue of the event, for latency critical pipeline stages (run-to-completion).
+ * The atomic context of an atomic queue and the event order of a parallel-ordered queue
+ * are maintained: an atomic queue already holding events or processed by any core, events
+ * sent from a parallel-ordered context and sends nested deeper than DIRECT_DISPATCH_DEPTH_MAX
+ * are enqueued normally. Event priorities are not respected by direct dispatch, keep priority
+ * sensitive queues without it. Also Eth Rx dispatches packets to direct dispatch queues inline.
+ *
+ * Default is disabled. May be changed at run-time.
+ *
+ * @param queue         Queue id
+ * @param enable        Direct dispatch: enable=1, disable=0
+ *
+ * @return EM_OK if successful.
+ */
+em_status_t
+em_queue_direct_dispatch_set(em_queue_t queue, int enable);
+
+
+
+/**
+ * Allocate multiple events (HW specific addition)
+ *
+ * As em_alloc() for each event, but the buffers are taken from the pool in bulk.
+ * Either all 'num' events are allocated or none.
+ *
+ * @param events        Array for the allocated events
+ * @param num           Number of events to allocate
+ * @param size          Event size in octets
+ * @param type          Event type to allocate
+ * @param pool_id       Event pool id 
+ *
+ * @return The number of allocated events: 'num' on success, 0 on an error
+ *
+ * @see em_alloc(), em_free_multi()
+ */
+int
+em_alloc_multi(em_event_t events[], int num, size_t size, em_event_type_t type, em_pool_id_t pool_id);
+
+
+
+/**
+ * Free multiple events (HW specific addition)
+ *
+ * As em_free() for each event, but the buffers are returned to the pool in bulk.
+ * 
+ * @param events        Events to be freed
+ * @param num           Number of events
+ *
+ * @see em_free(), em_alloc_multi()
+ */
+void
+em_free_multi(em_event_t events[], int num);
+
+
+
+/**
+ * Print the per-core event cache counters of the calling core (HW specific addition)
+ *
+ * em_alloc() and em_free() use per-core magazines of free events in front of the
+ * shared event pools. The counters show how many allocs/frees were served from the
+ * core local magazines (hits) and how many needed a bulk refill/flush from/to the pool.
+ */
+void
+em_event_cache_stats_print(void);
+
+
+
+/**
+ * Scheduling queue types of em_sched_burst_stats() (HW specific addition)
+ */
+#define EM_SCHED_BURST_ATOMIC        0
+#define EM_SCHED_BURST_PARALLEL      1
+#define EM_SCHED_BURST_PARALLEL_ORD  2
+#define EM_SCHED_BURST_TYPES         3
+
+/** Number of scheduling burst sizes: 8, 16, 32 and 64 */
+#define EM_SCHED_BURST_SIZES         4
+
+
+/**
+ * Adaptive scheduling burst counters of one scheduling queue type on one core (HW specific addition)
+ *
+ * @see em_sched_burst_stats(), em_conf_t.sched_burst_adaptive
+ */
+typedef struct
+{
+  uint32_t burst;          /**< Current dequeue burst size */
+  
+  uint32_t revisit_max;    /**< Current max number of full bursts in a row from the same scheduling queue */
+  
+  uint64_t dequeues;       /**< Dequeues from the scheduling queues, also the empty ones */
+  
+  uint64_t full;           /**< Dequeues that filled the whole burst */
+  
+  uint64_t objs;           /**< Dequeued events (atomic: queues) */
+  
+  uint64_t grow;           /**< Burst size increases: mostly full bursts, within the latency target */
+  
+  uint64_t shrink_fill;    /**< Burst size decreases: mostly partial bursts */
+  
+  uint64_t shrink_latency; /**< Burst size decreases: serving a burst took longer than the latency target */
+  
+  uint64_t windows[EM_SCHED_BURST_SIZES]; /**< Decision windows spent at each burst size */
+  
+} em_sched_burst_stats_t;
+
+
+
+/**
+ * Read the adaptive scheduling burst counters of the calling core (HW specific addition)
+ *
+ * With em_conf_t.sched_burst_adaptive each core tunes the dequeue burst size and the
+ * revisit count of each scheduling queue type from the fill of its recent dequeues and
+ * em_conf_t.sched_latency_target_us. The counters are also kept with fixed bursts.
+ *
+ * @param stats         Counters (output), indexed by EM_SCHED_BURST_ATOMIC ... EM_SCHED_BURST_PARALLEL_ORD
+ *
+ * @see em_sched_burst_stats_print()
+ */
+void
+em_sched_burst_stats(em_sched_burst_stats_t stats[EM_SCHED_BURST_TYPES]);
+
+
+
+/**
+ * Print the adaptive scheduling burst counters of the calling core (HW specific addition)
+ *
+ * @see em_sched_burst_stats()
+ */
+void
+em_sched_burst_stats_print(void);
+
+
+
+/**
+ * Cache-affine atomic scheduling counters of one core (HW specific addition)
+ *
+ * @see em_sched_sticky_stats(), em_conf_t.sched_atomic_sticky
+ */
+typedef struct
+{
+  uint64_t stashed;        /**< Atomic queues kept in the core's stash after a burst */
+  
+  uint64_t stash_bursts;   /**< Bursts served from the stash */
+  
+  uint64_t stash_full;     /**< Atomic queues given back to the other cores: stash full */
+  
+  uint64_t expired;        /**< Atomic queues given back to the other cores: max bursts in a row reached */
+  
+  uint64_t released;       /**< Stashed atomic queues given back: the core left the queue group or the queue is not ready */
+  
+  uint64_t migrations;     /**< Atomic bursts served on another core than the previous burst of the queue */
+  
+} em_sched_sticky_stats_t;
+
+
+
+/**
+ * Read the cache-affine atomic scheduling counters of the calling core (HW specific addition)
+ *
+ * With em_conf_t.sched_atomic_sticky a core keeps the atomic queues it just served in a small
+ * private stash and serves them again in the next scheduling rounds, at most the given number
+ * of bursts in a row, to keep the queue's and the EO's data in the core's caches. The
+ * migration count is kept also without stickiness.
+ *
+ * @param stats         Counters (output)
+ *
+ * @see em_sched_sticky_stats_print()
+ */
+void
+em_sched_sticky_stats(em_sched_sticky_stats_t *const stats);
+
+
+
+/**
+ * Print the cache-affine atomic scheduling counters of the calling core (HW specific addition)
+ *
+ * @see em_sched_sticky_stats()
+ */
+void
+em_sched_sticky_stats_print(void);
+
+
+
+/**
+ * Work stealing counters of one core (HW specific addition)
+ *
+ * @see em_sched_steal_stats(), em_conf_t.sched_steal
+ */
+typedef struct
+{
+  uint64_t attempts;       /**< Empty scheduling rounds that looked for work on other cores */
+  
+  uint64_t steals;         /**< Attempts that found work */
+  
+  uint64_t events;         /**< Stolen events dispatched */
+  
+  uint64_t atomic_queues;  /**< Stolen atomic queues (their events are included in 'events') */
+  
+  uint64_t put_back;       /**< EM internal atomic queues dequeued and put back to their core */
+  
+} em_sched_steal_stats_t;
+
+
+
+/**
+ * Read the work stealing counters of the calling core (HW specific addition)
+ *
+ * With em_conf_t.sched_steal the idle cores take events from the core local queue groups
+ * of the other cores (see em_sched_steal_t) once the backlog in a core local parallel
+ * scheduling queue reaches em_conf_t.sched_steal_threshold. Stolen events are processed
+ * on another core than the one the queue group names, use only for queues that allow it.
+ *
+ * @param stats         Counters (output)
+ *
+ * @see em_sched_steal_stats_print()
+ */
+void
+em_sched_steal_stats(em_sched_steal_stats_t *const stats);
+
+
+
+/**
+ * Print the work stealing counters of the calling core (HW specific addition)
+ *
+ * @see em_sched_steal_stats()
+ */
+void
+em_sched_steal_stats_print(void);
+
+
+
+/**
+ * Set the hybrid poll/sleep dispatch mode of the calling core (HW specific addition)
+ *
+ * After 'idle_rounds' empty scheduling rounds em_dispatch(0) first pauses between the rounds
+ * (for another 'idle_rounds' rounds, with growing pauses) and then sleeps until an event is sent
+ * into one of the core's queue groups, or for at most 'sleep_us' microseconds. A sleeping core
+ * polls for Eth Rx and manages the event timer only when woken up or after 'sleep_us'.
+ * Overrides em_conf_t.dispatch_idle_rounds and dispatch_sleep_us for the calling core,
+ * e.g. to keep the packet-I/O cores always polling.
+ *
+ * @param idle_rounds   Empty rounds before backing off, 0 = always poll
+ * @param sleep_us      Max sleep time in microseconds, 0 = use default
+ *
+ * @see em_dispatch_idle_stats()
+ */
+void
+em_dispatch_idle_set(uint32_t idle_rounds, uint32_t sleep_us);
+
+
+
+/**
+ * Hybrid poll/sleep dispatch counters of one core (HW specific addition)
+ *
+ * The wakeup latency is the time from the send that woke up the core until the core
+ * scheduled again, i.e. the latency added compared to always polling.
+ *
+ * @see em_dispatch_idle_stats(), em_dispatch_idle_set()
+ */
+typedef struct
+{
+  uint64_t pause_rounds;     /**< Empty scheduling rounds followed by a pause */
+  
+  uint64_t sleeps;           /**< Times the core went to sleep */
+  
+  uint64_t wakeups;          /**< Sleeps ended by a send into one of the core's queue groups */
+  
+  uint64_t timeouts;         /**< Sleeps ended by the max sleep time */
+  
+  uint64_t sleep_cycles;     /**< Total time slept in core cycles */
+  
+  uint64_t wake_cycles;      /**< Total wakeup latency in core cycles */
+  
+  uint64_t wake_cycles_max;  /**< Max wakeup latency in core cycles */
+  
+} em_dispatch_idle_stats_t;
+
+
+
+/**
+ * Read the hybrid poll/sleep dispatch counters of the calling core (HW specific addition)
+ *
+ * @param stats         Counters (output)
+ *
+ * @see em_dispatch_idle_stats_print()
+ */
+void
+em_dispatch_idle_stats(em_dispatch_idle_stats_t *const stats);
+
+
+
+/**
+ * Print the hybrid poll/sleep dispatch counters of the calling core (HW specific addition)
+ *
+ * @see em_dispatch_idle_stats()
+ */
+void
+em_dispatch_idle_stats_print(void);
+
+
+
 /**
  * Get pointer to event structure
  *
@@ -142,6 +663,54 @@ em_send(em_event_t event, em_queue_t queue)
 
 
 
+/**
+ * Send multiple events with group number to a queue (HW specific addition)
+ *
+ * As em_send_group() for each event, but the events are enqueued into the destination
+ * queue in bursts, which is considerably cheaper than sending the events one by one.
+ * Events are sent in array order.
+ *
+ * @param events        Events to be sent
+ * @param num           Number of events
+ * @param queue         Destination queue
+ * @param group         Event group
+ *
+ * @return The number of events successfully sent (accepted for delivery), starting 
+ *         from events[0]. The ownership of the remaining events stays with the caller.
+ *
+ * @note Exception: events received from a parallel-ordered queue are always accepted.
+ *       They are enqueued into the destination queue once in order, possibly later and
+ *       by another core. An event that then cannot be enqueued is freed by EM and the
+ *       failure is not reported to the caller.
+ *
+ * @see em_send_multi(), em_send_group()
+ */
+int
+em_send_group_multi(em_event_t events[], int num, em_queue_t queue, em_event_group_t group);
+
+
+
+/**
+ * Send multiple events to a queue (HW specific addition)
+ *
+ * @param events        Events to be sent
+ * @param num           Number of events
+ * @param queue         Destination queue
+ *
+ * @return The number of events successfully sent (accepted for delivery), starting 
+ *         from events[0]. The ownership of the remaining events stays with the caller.
+ *         Events received from a parallel-ordered queue are always accepted, see em_send_group_multi().
+ * 
+ * @see em_send_group_multi(), em_send()
+ */
+static inline int
+em_send_multi(em_event_t events[], int num, em_queue_t queue)
+{
+  return em_send_group_multi(events, num, queue, EM_EVENT_GROUP_UNDEF);
+}
+
+
+
 /**
  * Helper func - is this the first EM-core?
  * 
@@ -55,6 +55,32 @@ typedef void* em_event_t;
 
 
 
+/**
+ * NUMA policy, how EM-cores use resources on other CPU sockets than their own (em_conf_t.numa_policy)
+ */
+typedef enum
+{
+  EM_NUMA_LOCAL_FIRST = 0, /**< Socket local event pools and Eth Rx queues first, remote ones when the local ones are empty/idle */
+  EM_NUMA_LOCAL_ONLY  = 1  /**< Socket local event pools and Eth Rx queues only */
+  
+} em_numa_policy_t;
+
+
+
+/**
+ * Work stealing policy, what idle EM-cores may take from the core local queue groups of
+ * the other cores (em_conf_t.sched_steal)
+ */
+typedef enum
+{
+  EM_SCHED_STEAL_OFF      = 0, /**< No stealing, core local queue groups are served by their own core only */
+  EM_SCHED_STEAL_PARALLEL = 1, /**< Steal events from parallel queues */
+  EM_SCHED_STEAL_ATOMIC   = 2  /**< Steal events from parallel queues and whole atomic queues (not EM internal ones) */
+  
+} em_sched_steal_t;
+
+
+
 /**
  * Event Machine run-time configuration options given at startup to em_init()
  * 
@@ -82,7 +108,43 @@ typedef struct
   int proc_idx;         /**< EM process index (thread-mode=0, process-mode=[0 ... core_count-1]) */
 
   em_core_mask_t phys_mask;
-    
+
+  int sched_ring_size;  /**< Depth of the scheduling rings of a queue group (power of 2), 0 = use default */
+
+  int sched_strict_prio; /**< Strict priority scheduling over all queue groups & types: enable=1, disable=0 */
+
+  uint8_t sched_prio_weights[EM_QUEUE_PRIO_NUM]; /**< Share of each priority level (lowest first) in a scheduling burst
+                                                      when the scheduling queue holds more events, all 0 = use default */
+
+  int sched_burst_adaptive; /**< Per-core adaptive scheduling burst sizes & revisit counts: enable=1, disable=0 (fixed) */
+
+  int sched_latency_target_us; /**< Adaptive bursts: max time to serve one scheduling burst in microseconds, 0 = no limit */
+
+  int sched_atomic_sticky; /**< Cache-affine atomic scheduling: max number of bursts in a row a core serves an atomic
+                                queue from its private stash before giving it back to the other cores, 0 = off */
+
+  int sched_steal;      /**< Work stealing from the core local queue groups of busy cores, see em_sched_steal_t,
+                             0 = EM_SCHED_STEAL_OFF */
+
+  int sched_steal_threshold; /**< Work stealing: min number of events in a core local parallel scheduling queue
+                                  before idle cores steal from it, 0 = use default */
+
+  int dispatch_idle_rounds; /**< em_dispatch(0): empty scheduling rounds before a core backs off (pauses, then sleeps until
+                                 woken up by a send to one of its queue groups), 0 = always poll */
+
+  int dispatch_sleep_us;    /**< em_dispatch(0): max sleep time of an idle core (also the packet-I/O & timer poll interval
+                                 of a sleeping core) in microseconds, 0 = use default */
+
+  int max_queues;       /**< Number of queue ids (static, EM internal and dynamic), max EM_MAX_QUEUES, 0 = use max */
+
+  int max_eos;          /**< Number of EO ids, max EM_MAX_EOS, 0 = use max */
+
+  int max_event_groups; /**< Number of event group ids, max EM_MAX_EVENT_GROUPS, 0 = use max */
+
+  int max_eth_ports;    /**< Number of Eth ports used for packet-I/O, max 16, 0 = use max */
+
+  int numa_policy;      /**< Cross-socket event allocation and Eth Rx, see em_numa_policy_t, 0 = EM_NUMA_LOCAL_FIRST */
+
   /* Add further as needed. */
    
 } em_conf_t;
@@ -59,11 +59,7 @@
 
 
 
-#define CORE_MASK_STR_LEN (32)
-
-
-#define LOWEST_BIT(n)       ((n) & (~((n)-1)))
-#define CLEAR_LOWEST_BIT(n) ((n) &   ((n)-1) )
+#define CORE_MASK_STR_LEN (EM_CORE_MASK_STRLEN)
 
 
 
@@ -91,6 +87,9 @@ typedef struct
 static sync_t *
 init_sync(int core_count);
 
+static int
+parse_core_mask(const char *mask_str, em_core_mask_t *mask);
+
 static char *
 init_proc_core_mask(int proc_idx, em_core_mask_t phys_mask);
 
@@ -168,29 +167,25 @@ parse_args(int argc, char *argv[],
     {
       case 'c':
         {
-          unsigned long long mask;
-          char              *mask_str = optarg;
-          char              *endptr = NULL;
-
-          /* parse hexadecimal string */
-          mask = strtoull(mask_str, &endptr, 16/*base-16*/);
-          if((mask_str[0] == '\0') || (endptr == NULL) ||
-             (*endptr != '\0')     || (mask == 0))
+          char *mask_str = optarg;
+          char  print_str[EM_CORE_MASK_STRLEN];
+
+          /* parse hexadecimal string, may be wider than 64 bits */
+          if(parse_core_mask(mask_str, &em_conf->phys_mask) != 0)
           {
             APPL_EXIT_FAILURE("Invalid coremask (%s) given\n", mask_str);
           }
 
           /* Store the core mask for EM - usage depends on the process-per-core or
            * thread-per-core mode selected. */
-          em_conf->phys_mask.u64[0]  = (uint64_t) mask;
           em_conf->core_count = em_core_mask_count(&em_conf->phys_mask);
 
           appl_conf->phys_mask_idx = optind-1;
 
 
-          printf("Coremask:   0x%"PRIx64"\n"
+          printf("Coremask:   %s\n"
                  "Core Count: %i\n",
-                 (uint64_t) mask, em_conf->core_count);
+                 em_core_mask_tostr(print_str, sizeof(print_str), &em_conf->phys_mask), em_conf->core_count);
 
         }
         break;
@@ -250,11 +245,14 @@ parse_args(int argc, char *argv[],
     static struct option longopts[] = {
       {"process-per-core", no_argument, NULL, 'p'}, // return 'p'
       {"thread-per-core",  no_argument, NULL, 't'}, // return 't'
+      {"strict-prio",      no_argument, NULL, 's'}, // return 's'
+      {"steal",            no_argument, NULL, 'w'}, // return 'w'
+      {"atomic-sticky",    no_argument, NULL, 'a'}, // return 'a'
       {"help",             no_argument, NULL, 'h'}, // return 'h'
       {NULL, 0, NULL, 0}
     };
 
-    opt = getopt_long(my_argc, my_argv, "+pth", longopts, &long_index);
+    opt = getopt_long(my_argc, my_argv, "+pthswa", longopts, &long_index);
 
     if(opt == -1) {
       break; // No more options
@@ -270,6 +268,18 @@ parse_args(int argc, char *argv[],
         em_conf->thread_per_core = 1;
         break;
 
+      case 's':
+        em_conf->sched_strict_prio = 1;
+        break;
+
+      case 'w':
+        em_conf->sched_steal = EM_SCHED_STEAL_PARALLEL;
+        break;
+
+      case 'a':
+        em_conf->sched_atomic_sticky = 4; // Max bursts in a row on the same core
+        break;
+
       case 'h':
         usage(argv[0]);
         exit(EXIT_SUCCESS);
@@ -538,6 +548,64 @@ init_rt_env(int argc, char *argv[], em_conf_t *em_conf, appl_conf_t *appl_conf)
 }
 
 
+/**
+ * Parse a hexadecimal core mask string (optional "0x" prefix) of any length up to EM_CORE_MASK_SIZE bits.
+ *
+ * @param mask_str  Core mask string
+ * @param mask      Parsed core mask
+ *
+ * @return 0 on success, -1 if the string is not a valid, non-zero core mask
+ */
+static int
+parse_core_mask(const char *mask_str, em_core_mask_t *mask)
+{
+  int len, i, bit, digit, k;
+  
+  
+  em_core_mask_zero(mask);
+  
+  if((mask_str[0] == '0') && ((mask_str[1] == 'x') || (mask_str[1] == 'X'))) {
+    mask_str += 2;
+  }
+  
+  len = strlen(mask_str);
+  
+  if(len == 0) {
+    return -1;
+  }
+  
+  // From the least significant (last) hex digit upwards
+  for(i = len - 1, bit = 0; i >= 0; i--, bit += 4)
+  {
+    char c = mask_str[i];
+    
+    if((c >= '0') && (c <= '9'))      { digit = c - '0';      }
+    else if((c >= 'a') && (c <= 'f')) { digit = c - 'a' + 10; }
+    else if((c >= 'A') && (c <= 'F')) { digit = c - 'A' + 10; }
+    else {
+      return -1;
+    }
+    
+    if(digit == 0) {
+      continue;
+    }
+    
+    if((bit + 4) > EM_CORE_MASK_SIZE) {
+      return -1; // Too many cores
+    }
+    
+    for(k = 0; k < 4; k++)
+    {
+      if(digit & (1 << k)) {
+        em_core_mask_set(bit + k, mask);
+      }
+    }
+  }
+  
+  return em_core_mask_iszero(mask) ? -1 : 0;
+}
+
+
 /**
  * Create a process specific core mask (with only one bit set) from the global 
  * physical core mask (which has a bit set for each core to use)
@@ -550,12 +618,18 @@ init_rt_env(int argc, char *argv[], em_conf_t *em_conf, appl_conf_t *appl_conf)
 static char *
 init_proc_core_mask(int proc_idx, em_core_mask_t phys_mask)
 {
-  char    *core_mask_str;
-  uint64_t mask;
-  uint64_t tmp_mask;
-  int      i;
+  char          *core_mask_str;
+  em_core_mask_t mask;
+  int            phys_core;
 
 
+  phys_core = get_phys_core_idx(proc_idx, phys_mask);
+  
+  if(phys_core < 0)
+  {
+    return NULL;
+  }
+  
   core_mask_str = malloc(CORE_MASK_STR_LEN * sizeof(char));
   
   if(core_mask_str == NULL)
@@ -564,16 +638,10 @@ init_proc_core_mask(int proc_idx, em_core_mask_t phys_mask)
     return NULL;
   }
 
-  mask = phys_mask.u64[0];
-
-  for(i = 0; i <= proc_idx; i++)
-  {
-    tmp_mask = LOWEST_BIT(mask);
-    mask     = CLEAR_LOWEST_BIT(mask);
-  }
+  em_core_mask_zero(&mask);
+  em_core_mask_set(phys_core, &mask);
   
-  (void) snprintf(core_mask_str, CORE_MASK_STR_LEN, "0x%"PRIx64"", tmp_mask);
-  core_mask_str[CORE_MASK_STR_LEN-1] = '\0';
+  (void) em_core_mask_tostr(core_mask_str, CORE_MASK_STR_LEN, &mask);
   
   return core_mask_str;
 }
@@ -585,27 +653,21 @@ init_proc_core_mask(int proc_idx, em_core_mask_t phys_mask)
 static int
 get_phys_core_idx(int n, em_core_mask_t phys_mask)
 {
-  uint64_t mask;
-  int      i;
-  int      bit_idx;
+  int i;
 
 
-  mask = phys_mask.u64[0];
-
-  for(i = 0; i < n; i++)
+  for(i = 0; i < EM_CORE_MASK_SIZE; i++)
   {
-    mask = CLEAR_LOWEST_BIT(mask);
-  }
-  
-  mask = LOWEST_BIT(mask);
-  
-  for(i = -1; mask > 0; i++) {
-    mask = mask >> 1;
+    if(em_core_mask_isset(i, &phys_mask))
+    {
+      if(n == 0) {
+        return i;
+      }
+      n--;
+    }
   }
   
-  
-  bit_idx = i;
-  return bit_idx;
+  return -1;
 }
 
 
@@ -825,8 +887,10 @@ fork_em_procs(em_conf_t *em_conf, sem_t *block_child_sem)
   phys_core = get_phys_core_idx(proc_idx, em_conf->phys_mask);
   if(phys_core < 0)
   {
-    APPL_EXIT_FAILURE("get_phys_core_idx() fails (ret=%i, proc_idx=%i, phys_mask=0x%"PRIx64")",
-                      phys_core, proc_idx, em_conf->phys_mask.u64[0]);
+    char mask_str[EM_CORE_MASK_STRLEN];
+    
+    APPL_EXIT_FAILURE("get_phys_core_idx() fails (ret=%i, proc_idx=%i, phys_mask=%s)",
+                      phys_core, proc_idx, em_core_mask_tostr(mask_str, sizeof(mask_str), &em_conf->phys_mask));
   }
   
   ret = core_set_affinity(phys_core, em_conf->core_count);
@@ -930,6 +994,9 @@ usage(char *progname)
          "  Select EITHER -p OR -t, but not both!\n"
          "\n"
          "Optional [APPL&EM-OPTIONS]\n"
+         "  -s, --strict-prio       Strict priority scheduling over all queue groups.\n"
+         "  -w, --steal             Idle cores steal parallel events from the core local queue groups of busy cores.\n"
+         "  -a, --atomic-sticky     Cores keep serving the atomic queues they just served (cache affinity).\n"
          "  -h, --help              Display help and exit.\n"
          "\n"
          ,
@@ -120,6 +120,20 @@ ifeq ($(APPL),error)
 ALL_TEST_SRCS += $(EXAMPLE_DIR)/test_appl_error.c
 endif
 
+ifeq ($(APPL),prio)
+ALL_TEST_SRCS += $(EXAMPLE_DIR)/test_appl_prio.c
+endif
+
+ifeq ($(APPL),steal)
+ALL_TEST_SRCS += $(EXAMPLE_DIR)/test_appl_steal.c
+endif
+
+# perf with per-EO flow state touched by each event (cache affinity of atomic queues, see -a)
+ifeq ($(APPL),perf_flow)
+ALL_TEST_SRCS += $(EXAMPLE_DIR)/test_appl_perf.c
+CFLAGS += -DFLOW_STATE_PER_EVENT
+endif
+
 
 
 # Intel DPDK expects all sources to be in SRCS-y
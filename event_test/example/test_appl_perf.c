@@ -88,6 +88,13 @@
 /** Check sequence numbers, works only with atomic queues */
 //#define CHECK_SEQ_PER_EVENT
 
+/** Update a per EO flow state (FLOW_STATE_SIZE bytes) per event, e.g. to see the effect of 
+    the cache-affine atomic scheduling (em_conf_t.sched_atomic_sticky). Built as 'perf_flow'. */
+//#define FLOW_STATE_PER_EVENT
+
+/** Size of the per EO flow state in bytes */
+#define FLOW_STATE_SIZE   2048
+
 
 
 
@@ -143,6 +150,9 @@ typedef struct
   /** Next sequence number (used with CHECK_SEQ_PER_EVENT) */
   int next_seq;
   
+  /** Flow state (used with FLOW_STATE_PER_EVENT) */
+  uint64_t *flow_state;
+  
 } eo_context_t;
 
 
@@ -191,6 +201,11 @@ typedef struct
   /** Array of core specific data accessed by a core using its core index. */
   perf_stat_t  core_stat[MAX_NBR_OF_CORES]  ENV_CACHE_LINE_ALIGNED;  
   
+#ifdef FLOW_STATE_PER_EVENT
+  /** Flow state of each EO */
+  uint64_t  flow_state[NUM_EO][FLOW_STATE_SIZE / sizeof(uint64_t)]  ENV_CACHE_LINE_ALIGNED;
+#endif
+  
 } perf_shm_t;
 
 
@@ -217,6 +232,11 @@ perf_receive_b(void* eo_context, em_event_t event, em_event_type_t type, em_queu
 static void
 print_result(perf_stat_t *const perf_stat);
 
+#ifdef FLOW_STATE_PER_EVENT
+static inline void
+flow_state_update(uint64_t *const flow_state);
+#endif
+
 
 
 /**
@@ -274,6 +294,10 @@ test_init(appl_conf_t *const appl_conf)
          
            
   (void) memset(perf_shm->core_stat, 0, sizeof(perf_shm->core_stat));
+  
+#ifdef FLOW_STATE_PER_EVENT
+  (void) memset(perf_shm->flow_state, 0, sizeof(perf_shm->flow_state));
+#endif
 
   /*
    * Create and start application pairs
@@ -290,6 +314,10 @@ test_init(appl_conf_t *const appl_conf)
     queue_a = em_queue_create("queue A", QUEUE_TYPE, EM_QUEUE_PRIO_NORMAL, EM_QUEUE_GROUP_DEFAULT);
 
     eo_ctx->next_seq = 0;
+    
+#ifdef FLOW_STATE_PER_EVENT
+    eo_ctx->flow_state = perf_shm->flow_state[2*i];
+#endif
 
     ret = em_eo_add_queue(eo, queue_a);
     IS_ERROR(ret != EM_OK, "EO or queue creation failed (%u). EO: %"PRI_EO", queue: %"PRI_QUEUE"\n", ret, eo, queue_a);
@@ -310,6 +338,10 @@ test_init(appl_conf_t *const appl_conf)
     queue_b = em_queue_create("queue B", QUEUE_TYPE, EM_QUEUE_PRIO_NORMAL, EM_QUEUE_GROUP_DEFAULT);
 
     eo_ctx->next_seq = NUM_EVENT/2;
+    
+#ifdef FLOW_STATE_PER_EVENT
+    eo_ctx->flow_state = perf_shm->flow_state[2*i + 1];
+#endif
 
     ret = em_eo_add_queue(eo, queue_b);
     IS_ERROR(ret != EM_OK, "EO or queue creation failed (%u). EO: %"PRI_EO", queue: %"PRI_QUEUE"\n", ret, eo, queue_b);
@@ -418,6 +450,10 @@ perf_receive_a(void* eo_context, em_event_t event, em_event_type_t type, em_queu
 #ifdef CHECK_SEQ_PER_EVENT
   int           seq;
 #endif
+
+#if defined(CHECK_SEQ_PER_EVENT) || defined(FLOW_STATE_PER_EVENT)
+  eo_context_t* eo_ctx = eo_context;
+#endif
   
   core   = em_core_id();
   events = perf_shm->core_stat[core].events;
@@ -471,6 +507,12 @@ perf_receive_a(void* eo_context, em_event_t event, em_event_type_t type, em_queu
 
 
 
+#ifdef FLOW_STATE_PER_EVENT
+  flow_state_update(eo_ctx->flow_state);
+#endif
+
+
+
 #ifdef MEMCPY_PER_EVENT
   {
     uint8_t* from = &perf->data[0];
@@ -521,6 +563,9 @@ perf_receive_b(void* eo_context, em_event_t event, em_event_type_t type, em_queu
   
 #ifdef CHECK_SEQ_PER_EVENT
   int           seq;
+#endif
+
+#if defined(CHECK_SEQ_PER_EVENT) || defined(FLOW_STATE_PER_EVENT)
   eo_context_t* eo_ctx = eo_context;
 #endif
 
@@ -549,6 +594,12 @@ perf_receive_b(void* eo_context, em_event_t event, em_event_type_t type, em_queu
 
 
 
+#ifdef FLOW_STATE_PER_EVENT
+  flow_state_update(eo_ctx->flow_state);
+#endif
+
+
+
 #ifdef MEMCPY_PER_EVENT
   {
     uint8_t* from = &perf->data[DATA_SIZE/2];
@@ -585,6 +636,23 @@ perf_receive_b(void* eo_context, em_event_t event, em_event_type_t type, em_queu
 
 
 
+#ifdef FLOW_STATE_PER_EVENT
+/**
+ * Updates every cache line of the EO's flow state
+ */
+static inline void
+flow_state_update(uint64_t *const flow_state)
+{
+  unsigned i;
+  
+  for(i = 0; i < (FLOW_STATE_SIZE / sizeof(uint64_t)); i += (ENV_CACHE_LINE_SIZE / sizeof(uint64_t))) {
+    flow_state[i]++;
+  }
+}
+#endif
+
+
+
 /**
  * Prints test measurement result
  */
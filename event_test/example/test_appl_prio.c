@@ -0,0 +1,507 @@
+/*
+ *   Copyright (c) 2012, Nokia Siemens Networks
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions are met:
+ *       * Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *       * Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *       * Neither the name of Nokia Siemens Networks nor the
+ *         names of its contributors may be used to endorse or promote products
+ *         derived from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *   ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY
+ *   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ *   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ *   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/**
+ * @file
+ *
+ * Event Machine priority scheduling latency test example
+ *
+ * Measures the latency of high priority signalling events in one queue group while
+ * the cores are loaded with low priority bulk events in another queue group.
+ *
+ * Bulk:   NUM_BULK_QUEUES parallel queues (EM_QUEUE_PRIO_LOWEST) in the default queue group,
+ *         each event does BULK_WORK_CYCLES of dummy work and is sent back into its queue.
+ * Signal: one parallel queue (EM_QUEUE_PRIO_HIGHEST) in the queue group "prio_sig" (all cores).
+ *         A single signal event is sent back and forth, the cycles from em_send() until the
+ *         receive function is called are measured.
+ *
+ * Without strict priority scheduling the priority is only honored inside a queue group, the
+ * signal waits while the cores serve the bulk queue group. Compare with the EM option
+ * -s/--strict-prio (em_conf_t.sched_strict_prio), e.g.
+ *   ./build/prio -c 0xfe -n 4 -- -t
+ *   ./build/prio -c 0xfe -n 4 -- -t -s
+ */
+
+#include "event_machine.h"
+#include "environment.h"
+
+#include <inttypes.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "example.h"
+
+
+
+/*
+ * Test configuration
+ */
+
+/** Number of bulk queues */
+#define NUM_BULK_QUEUES    16
+
+/** Number of bulk events per bulk queue */
+#define NUM_BULK_EVENTS    32
+
+/** Dummy work per bulk event */
+#define BULK_WORK_CYCLES   2000
+
+/** The number of signal events to be received before printing a result */
+#define PRINT_SIG_COUNT    0x10000
+
+
+
+
+/*
+ * Note: The error macros below are NOT proper event machine error handling mechanisms.
+ * For better error handling see the API funcs: em_error(), em_register_error_handler(),  
+ * em_eo_register_error_handler() etc.
+ */
+#define ERROR_PRINT(...)      {fprintf(stderr, "\nAPPL ERROR: %s %s(line:%d) - EM-core%02i: ", __FILE__, __func__, __LINE__, em_core_id()); \
+                               fprintf(stderr, __VA_ARGS__); fprintf(stderr, "\n\n"); abort();}
+
+#define IS_ERROR(cond, ...)    \
+  if(ENV_UNLIKELY( (cond) )) { \
+    ERROR_PRINT(__VA_ARGS__);  \
+  }
+
+
+
+
+/**
+ * Test event
+ */
+typedef struct
+{
+  #define MSG_START  1
+  #define MSG_BULK   2
+  #define MSG_SIGNAL 3
+  /** Event/msg number */
+  uint64_t  msg;
+  
+  /** Cycles at the time of the em_send() (signal events) */
+  uint64_t  send_cycles;
+
+} prio_event_t;
+
+
+
+/**
+ * Signal latency statistics
+ */
+typedef union
+{
+  uint8_t u8[ENV_CACHE_LINE_SIZE] ENV_CACHE_LINE_ALIGNED;
+
+  struct
+  {
+    uint64_t count;
+    uint64_t sum_cycles;
+    uint64_t min_cycles;
+    uint64_t max_cycles;
+    uint64_t print_count;
+  };
+
+} prio_stat_t;
+
+COMPILE_TIME_ASSERT(sizeof(prio_stat_t) == ENV_CACHE_LINE_SIZE, PRIO_STAT_T_SIZE_ERROR);
+
+
+
+/**
+ * Prio test shared memory
+ */
+typedef struct
+{
+  /** Signal latency statistics, the only signal event is processed by one core at a time */
+  prio_stat_t       sig_stat  ENV_CACHE_LINE_ALIGNED;
+  
+  /** Bulk queues */
+  em_queue_t        bulk_queues[NUM_BULK_QUEUES]  ENV_CACHE_LINE_ALIGNED;
+  
+  /** Signal EO */
+  em_eo_t           sig_eo  ENV_CACHE_LINE_ALIGNED;
+  
+  /** Signal queue group */
+  em_queue_group_t  sig_group;
+  
+} prio_shm_t;
+
+
+/** EM-core local pointer to shared memory */
+static ENV_LOCAL prio_shm_t *prio_shm = NULL;
+
+
+
+/* 
+ * Local function prototypes
+ */
+static em_status_t
+prio_start(void* eo_context, em_eo_t eo);
+
+static em_status_t
+prio_stop(void* eo_context, em_eo_t eo);
+
+static void
+bulk_receive(void* eo_context, em_event_t event, em_event_type_t type, em_queue_t queue, void* q_ctx);
+
+static void
+sig_receive(void* eo_context, em_event_t event, em_event_type_t type, em_queue_t queue, void* q_ctx);
+
+static void
+sig_start(em_queue_t ctrl_queue);
+
+static void
+print_result(prio_stat_t *const stat);
+
+
+
+/**
+ * Init and startup of the Prio Test application.
+ *
+ * @see main() and application_start() for setup and dispatch.
+ */
+void
+test_init(appl_conf_t *const appl_conf)
+{
+  em_eo_t          eo;
+  em_queue_t       queue, ctrl_queue;
+  em_event_t       event;
+  prio_event_t*    prio;
+  em_core_mask_t   mask;
+  em_notif_t       notif_tbl[1];
+  em_status_t      ret;
+  int              i, j;
+  
+
+  if(em_core_id() == 0) {
+    prio_shm = env_shared_reserve("PrioSharedMem", sizeof(prio_shm_t));
+  }
+  else {
+    prio_shm = env_shared_lookup("PrioSharedMem");
+  }
+
+
+  if(prio_shm == NULL) {
+    em_error(EM_ERROR_SET_FATAL(0xec0de), 0xdead, "Prio init failed on EM-core:%u\n", em_core_id());
+  }
+    
+
+  /*
+   * Rest of the initializations only on one EM-core, return on all others.
+   */  
+  if(em_core_id() != 0)
+  {
+    return;
+  }
+  
+
+  printf("\n**********************************************************************\n"
+         "EM APPLICATION: '%s' initializing: \n"
+         "  %s: %s() - EM-core:%i \n"
+         "  Application running on %d EM-cores (procs:%d, threads:%d)."
+         "\n**********************************************************************\n"
+         "\n"
+         ,
+         appl_conf->name,
+         NO_PATH(__FILE__), __func__,
+         em_core_id(),
+         em_core_count(),
+         appl_conf->num_procs,
+         appl_conf->num_threads);
+         
+
+  (void) memset(prio_shm, 0, sizeof(prio_shm_t));
+  
+  prio_shm->sig_stat.min_cycles = UINT64_MAX;
+
+
+  /*
+   * Bulk EO and queues, load the cores
+   */
+  eo = em_eo_create("bulk", prio_start, NULL, prio_stop, NULL, bulk_receive, NULL);
+  IS_ERROR(eo == EM_EO_UNDEF, "Bulk EO creation failed\n");
+  
+  for(i = 0; i < NUM_BULK_QUEUES; i++)
+  {
+    queue = em_queue_create("bulk", EM_QUEUE_TYPE_PARALLEL, EM_QUEUE_PRIO_LOWEST, EM_QUEUE_GROUP_DEFAULT);
+    IS_ERROR(queue == EM_QUEUE_UNDEF, "Bulk queue creation failed (%i)\n", i);
+    
+    prio_shm->bulk_queues[i] = queue;
+    
+    ret = em_eo_add_queue(eo, queue);
+    IS_ERROR(ret != EM_OK, "Bulk EO add queue failed (%u). EO: %"PRI_EO", queue: %"PRI_QUEUE"\n", ret, eo, queue);
+    
+    ret = em_queue_enable(queue);
+    IS_ERROR(ret != EM_OK, "Bulk queue enable failed (%u). EO: %"PRI_EO", queue: %"PRI_QUEUE"\n", ret, eo, queue);
+  }
+  
+  ret = em_eo_start(eo, NULL, 0, NULL);
+  IS_ERROR(ret != EM_OK, "Bulk EO start failed (%u). EO: %"PRI_EO"\n", ret, eo);
+
+
+  /*
+   * Signal EO with a control queue for the queue group create notification
+   */
+  eo = em_eo_create("signal", prio_start, NULL, prio_stop, NULL, sig_receive, NULL);
+  IS_ERROR(eo == EM_EO_UNDEF, "Signal EO creation failed\n");
+  
+  prio_shm->sig_eo = eo;
+  
+  ctrl_queue = em_queue_create("sig-ctrl", EM_QUEUE_TYPE_ATOMIC, EM_QUEUE_PRIO_HIGHEST, EM_QUEUE_GROUP_DEFAULT);
+  IS_ERROR(ctrl_queue == EM_QUEUE_UNDEF, "Signal ctrl queue creation failed\n");
+  
+  ret = em_eo_add_queue(eo, ctrl_queue);
+  IS_ERROR(ret != EM_OK, "Signal EO add queue failed (%u). EO: %"PRI_EO", queue: %"PRI_QUEUE"\n", ret, eo, ctrl_queue);
+  
+  ret = em_queue_enable(ctrl_queue);
+  IS_ERROR(ret != EM_OK, "Signal ctrl queue enable failed (%u). EO: %"PRI_EO", queue: %"PRI_QUEUE"\n", ret, eo, ctrl_queue);
+  
+  ret = em_eo_start(eo, NULL, 0, NULL);
+  IS_ERROR(ret != EM_OK, "Signal EO start failed (%u). EO: %"PRI_EO"\n", ret, eo);
+
+
+  /*
+   * Signal queue group on all cores, continue in sig_start() when created
+   */
+  event = em_alloc(sizeof(prio_event_t), EM_EVENT_TYPE_SW, EM_POOL_DEFAULT);
+  IS_ERROR(event == EM_EVENT_UNDEF, "Start event allocation failed\n");
+  
+  prio      = em_event_pointer(event);
+  prio->msg = MSG_START;
+  
+  notif_tbl[0].event = event;
+  notif_tbl[0].queue = ctrl_queue;
+  
+  em_core_mask_zero(&mask);
+  em_core_mask_set_count(em_core_count(), &mask);
+  
+  prio_shm->sig_group = em_queue_group_create("prio_sig", &mask, 1, notif_tbl);
+  IS_ERROR(prio_shm->sig_group == EM_QUEUE_GROUP_UNDEF, "Signal queue group creation failed\n");
+
+
+  /*
+   * Send the bulk events
+   */
+  for(i = 0; i < NUM_BULK_QUEUES; i++)
+  {
+    queue = prio_shm->bulk_queues[i];
+    
+    for(j = 0; j < NUM_BULK_EVENTS; j++)
+    {
+      event = em_alloc(sizeof(prio_event_t), EM_EVENT_TYPE_SW, EM_POOL_DEFAULT);
+      IS_ERROR(event == EM_EVENT_UNDEF, "Bulk event allocation failed (%i, %i)\n", i, j);
+      
+      prio      = em_event_pointer(event);
+      prio->msg = MSG_BULK;
+      
+      ret = em_send(event, queue);
+      IS_ERROR(ret != EM_OK, "Bulk event send failed (%u)! Queue: %"PRI_QUEUE" \n", ret, queue);
+    }
+  }
+  
+
+  env_sync_mem();
+}
+
+
+
+/**
+ * @private
+ *
+ * EO start function.
+ *
+ */
+static em_status_t
+prio_start(void* eo_context, em_eo_t eo)
+{
+  printf("EO %"PRI_EO" starting.\n", eo);
+
+  return EM_OK;
+}
+
+
+
+/**
+ * @private
+ *
+ * EO stop function.
+ *
+ */
+static em_status_t
+prio_stop(void* eo_context, em_eo_t eo)
+{
+  printf("EO %"PRI_EO" stopping.\n", eo);
+
+  return EM_OK;
+}
+
+
+
+/**
+ * @private
+ *
+ * EO receive function for the bulk events.
+ *
+ * Does some dummy work and sends the event back into the same queue.
+ */
+static void
+bulk_receive(void* eo_context, em_event_t event, em_event_type_t type, em_queue_t queue, void* q_ctx)
+{
+  const uint64_t end_cycles = env_get_cycle() + BULK_WORK_CYCLES;
+  em_status_t    ret;
+  
+  
+  while(env_get_cycle() < end_cycles) {
+    ; // Dummy work
+  }
+  
+  ret = em_send(event, queue);
+  
+  if(ENV_UNLIKELY(ret != EM_OK)) {
+    em_free(event);
+  }
+}
+
+
+
+/**
+ * @private
+ *
+ * EO receive function for the signal EO.
+ *
+ * Starts the signalling on the queue group creation notification, then measures
+ * the send-to-receive latency of the signal event and sends it back.
+ */
+static void
+sig_receive(void* eo_context, em_event_t event, em_event_type_t type, em_queue_t queue, void* q_ctx)
+{
+  prio_event_t *const prio        = em_event_pointer(event);
+  const uint64_t      recv_cycles = env_get_cycle();
+  prio_stat_t  *const stat        = &prio_shm->sig_stat;
+  uint64_t            latency;
+  em_status_t         ret;
+  
+  
+  if(ENV_UNLIKELY(prio->msg == MSG_START))
+  {
+    em_free(event);
+    sig_start(queue);
+    return;
+  }
+  
+  
+  latency = recv_cycles - prio->send_cycles;
+  
+  stat->count      += 1;
+  stat->sum_cycles += latency;
+  
+  if(latency < stat->min_cycles) {
+    stat->min_cycles = latency;
+  }
+  if(latency > stat->max_cycles) {
+    stat->max_cycles = latency;
+  }
+  
+  if(ENV_UNLIKELY(stat->count == PRINT_SIG_COUNT))
+  {
+    stat->print_count += 1;
+    
+    print_result(stat);
+    
+    stat->count      = 0;
+    stat->sum_cycles = 0;
+    stat->min_cycles = UINT64_MAX;
+    stat->max_cycles = 0;
+  }
+  
+  
+  prio->send_cycles = env_get_cycle();
+  
+  ret = em_send(event, queue);
+  IS_ERROR(ret != EM_OK, "Signal event send failed (%u)! Queue: %"PRI_QUEUE" \n", ret, queue);
+}
+
+
+
+/**
+ * @private
+ *
+ * Create the high priority signal queue into the signal queue group and send the signal event.
+ */
+static void
+sig_start(em_queue_t ctrl_queue)
+{
+  em_queue_t    queue;
+  em_event_t    event;
+  prio_event_t *prio;
+  em_status_t   ret;
+  
+  
+  queue = em_queue_create("signal", EM_QUEUE_TYPE_PARALLEL, EM_QUEUE_PRIO_HIGHEST, prio_shm->sig_group);
+  IS_ERROR(queue == EM_QUEUE_UNDEF, "Signal queue creation failed\n");
+  
+  ret = em_eo_add_queue(prio_shm->sig_eo, queue);
+  IS_ERROR(ret != EM_OK, "Signal EO add queue failed (%u). Queue: %"PRI_QUEUE"\n", ret, queue);
+  
+  ret = em_queue_enable(queue);
+  IS_ERROR(ret != EM_OK, "Signal queue enable failed (%u). Queue: %"PRI_QUEUE"\n", ret, queue);
+  
+  
+  event = em_alloc(sizeof(prio_event_t), EM_EVENT_TYPE_SW, EM_POOL_DEFAULT);
+  IS_ERROR(event == EM_EVENT_UNDEF, "Signal event allocation failed\n");
+  
+  prio              = em_event_pointer(event);
+  prio->msg         = MSG_SIGNAL;
+  prio->send_cycles = env_get_cycle();
+  
+  ret = em_send(event, queue);
+  IS_ERROR(ret != EM_OK, "Signal event send failed (%u)! Queue: %"PRI_QUEUE" \n", ret, queue);
+  
+  printf("Signalling started (signal queue %"PRI_QUEUE", ctrl queue %"PRI_QUEUE")\n", queue, ctrl_queue);
+}
+
+
+
+/**
+ * Prints the signal latency result
+ */
+static void
+print_result(prio_stat_t *const stat)
+{
+  const uint64_t hz  = env_core_hz();
+  const double   mhz = ((double) hz) / 1000000.0;
+  
+  
+  printf("signal latency cycles: avg %.0f  min %"PRIu64"  max %"PRIu64"  @%.2f MHz (core-%02i %"PRIu64")\n",
+         ((double) stat->sum_cycles) / ((double) stat->count),
+         stat->min_cycles, stat->max_cycles,
+         mhz, em_core_id(), stat->print_count);
+}
+
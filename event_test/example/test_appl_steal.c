@@ -0,0 +1,396 @@
+/*
+ *   Copyright (c) 2012, Nokia Siemens Networks
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions are met:
+ *       * Redistributions of source code must retain the above copyright
+ *         notice, this list of conditions and the following disclaimer.
+ *       * Redistributions in binary form must reproduce the above copyright
+ *         notice, this list of conditions and the following disclaimer in the
+ *         documentation and/or other materials provided with the distribution.
+ *       * Neither the name of Nokia Siemens Networks nor the
+ *         names of its contributors may be used to endorse or promote products
+ *         derived from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ *   ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY
+ *   DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ *   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ *   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/**
+ * @file
+ *
+ * Event Machine work stealing test example
+ *
+ * Loads one core with all the work and measures how the work spreads over the cores.
+ *
+ * Heavy: NUM_HEAVY_QUEUES parallel queues in the core local queue group of EM-core 0 ("core00"),
+ *        each event does HEAVY_WORK_CYCLES of dummy work and is sent back into its queue.
+ *
+ * Without work stealing only EM-core 0 processes events and the others idle. With the EM option
+ * -w/--steal (em_conf_t.sched_steal) the idle cores take events from EM-core 0's backlog, the
+ * throughput should scale with the number of cores, e.g.
+ *   ./build/steal -c 0xfe -n 4 -- -t
+ *   ./build/steal -c 0xfe -n 4 -- -t -w
+ */
+
+#include "event_machine.h"
+#include "environment.h"
+
+#include <inttypes.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "example.h"
+
+
+
+/*
+ * Test configuration
+ */
+
+/** Number of heavy queues */
+#define NUM_HEAVY_QUEUES   4
+
+/** Number of events per heavy queue (all fit into the small scheduling queue of a core local queue group) */
+#define NUM_HEAVY_EVENTS   32
+
+/** Dummy work per heavy event */
+#define HEAVY_WORK_CYCLES  4000
+
+/** Print interval in seconds */
+#define PRINT_INTERVAL_SEC 2
+
+/** Max number of cores printed */
+#define MAX_PRINT_CORES    64
+
+
+
+
+/*
+ * Note: The error macros below are NOT proper event machine error handling mechanisms.
+ * For better error handling see the API funcs: em_error(), em_register_error_handler(),
+ * em_eo_register_error_handler() etc.
+ */
+#define ERROR_PRINT(...)      {fprintf(stderr, "\nAPPL ERROR: %s %s(line:%d) - EM-core%02i: ", __FILE__, __func__, __LINE__, em_core_id()); \
+                               fprintf(stderr, __VA_ARGS__); fprintf(stderr, "\n\n"); abort();}
+
+#define IS_ERROR(cond, ...)    \
+  if(ENV_UNLIKELY( (cond) )) { \
+    ERROR_PRINT(__VA_ARGS__);  \
+  }
+
+
+
+
+/**
+ * Test event
+ */
+typedef struct
+{
+  /** Event/msg number */
+  uint64_t  seq;
+
+} steal_event_t;
+
+
+
+/**
+ * Per core event count
+ */
+typedef union
+{
+  uint8_t u8[ENV_CACHE_LINE_SIZE] ENV_CACHE_LINE_ALIGNED;
+
+  struct
+  {
+    volatile uint64_t events;
+  };
+
+} steal_core_stat_t;
+
+COMPILE_TIME_ASSERT(sizeof(steal_core_stat_t) == ENV_CACHE_LINE_SIZE, STEAL_CORE_STAT_T_SIZE_ERROR);
+
+
+
+/**
+ * Steal test shared memory
+ */
+typedef struct
+{
+  /** Events processed by each core */
+  steal_core_stat_t  core_stat[MAX_PRINT_CORES]  ENV_CACHE_LINE_ALIGNED;
+
+  /** Events processed by each core at the previous print */
+  uint64_t           prev_events[MAX_PRINT_CORES]  ENV_CACHE_LINE_ALIGNED;
+
+  /** Time of the previous print, the core that updates it prints */
+  volatile uint64_t  print_cycles  ENV_CACHE_LINE_ALIGNED;
+
+  /** Print interval in cycles */
+  uint64_t           print_interval;
+
+} steal_shm_t;
+
+
+/** EM-core local pointer to shared memory */
+static ENV_LOCAL steal_shm_t *steal_shm = NULL;
+
+
+
+/*
+ * Local function prototypes
+ */
+static em_status_t
+steal_start(void* eo_context, em_eo_t eo);
+
+static em_status_t
+steal_stop(void* eo_context, em_eo_t eo);
+
+static void
+heavy_receive(void* eo_context, em_event_t event, em_event_type_t type, em_queue_t queue, void* q_ctx);
+
+static void
+print_result(const uint64_t cycles);
+
+
+
+/**
+ * Init and startup of the Steal Test application.
+ *
+ * @see main() and application_start() for setup and dispatch.
+ */
+void
+test_init(appl_conf_t *const appl_conf)
+{
+  em_eo_t          eo;
+  em_queue_t       queue;
+  em_queue_t       queues[NUM_HEAVY_QUEUES];
+  em_queue_group_t group;
+  em_event_t       event;
+  steal_event_t*   steal;
+  em_status_t      ret;
+  int              i, j;
+
+
+  if(em_core_id() == 0) {
+    steal_shm = env_shared_reserve("StealSharedMem", sizeof(steal_shm_t));
+  }
+  else {
+    steal_shm = env_shared_lookup("StealSharedMem");
+  }
+
+
+  if(steal_shm == NULL) {
+    em_error(EM_ERROR_SET_FATAL(0xec0de), 0xdead, "Steal init failed on EM-core:%u\n", em_core_id());
+  }
+
+
+  /*
+   * Rest of the initializations only on one EM-core, return on all others.
+   */
+  if(em_core_id() != 0)
+  {
+    return;
+  }
+
+
+  printf("\n**********************************************************************\n"
+         "EM APPLICATION: '%s' initializing: \n"
+         "  %s: %s() - EM-core:%i \n"
+         "  Application running on %d EM-cores (procs:%d, threads:%d)."
+         "\n**********************************************************************\n"
+         "\n"
+         ,
+         appl_conf->name,
+         NO_PATH(__FILE__), __func__,
+         em_core_id(),
+         em_core_count(),
+         appl_conf->num_procs,
+         appl_conf->num_threads);
+
+
+  (void) memset(steal_shm, 0, sizeof(steal_shm_t));
+
+  steal_shm->print_interval = env_core_hz() * PRINT_INTERVAL_SEC;
+  steal_shm->print_cycles   = env_get_cycle();
+
+
+  /*
+   * The core local queue group of EM-core 0
+   */
+  group = em_queue_group_find("core00");
+  IS_ERROR(group == EM_QUEUE_GROUP_UNDEF, "Core local queue group of EM-core 0 not found\n");
+
+
+  /*
+   * Heavy EO and queues, all work on EM-core 0
+   */
+  eo = em_eo_create("heavy", steal_start, NULL, steal_stop, NULL, heavy_receive, NULL);
+  IS_ERROR(eo == EM_EO_UNDEF, "Heavy EO creation failed\n");
+
+  for(i = 0; i < NUM_HEAVY_QUEUES; i++)
+  {
+    queue = em_queue_create("heavy", EM_QUEUE_TYPE_PARALLEL, EM_QUEUE_PRIO_NORMAL, group);
+    IS_ERROR(queue == EM_QUEUE_UNDEF, "Heavy queue creation failed (%i)\n", i);
+
+    ret = em_eo_add_queue(eo, queue);
+    IS_ERROR(ret != EM_OK, "Heavy EO add queue failed (%u). EO: %"PRI_EO", queue: %"PRI_QUEUE"\n", ret, eo, queue);
+
+    ret = em_queue_enable(queue);
+    IS_ERROR(ret != EM_OK, "Heavy queue enable failed (%u). EO: %"PRI_EO", queue: %"PRI_QUEUE"\n", ret, eo, queue);
+
+    queues[i] = queue;
+  }
+
+  ret = em_eo_start(eo, NULL, 0, NULL);
+  IS_ERROR(ret != EM_OK, "Heavy EO start failed (%u). EO: %"PRI_EO"\n", ret, eo);
+
+
+  /*
+   * Send the heavy events
+   */
+  for(i = 0; i < NUM_HEAVY_QUEUES; i++)
+  {
+    queue = queues[i];
+
+    for(j = 0; j < NUM_HEAVY_EVENTS; j++)
+    {
+      event = em_alloc(sizeof(steal_event_t), EM_EVENT_TYPE_SW, EM_POOL_DEFAULT);
+      IS_ERROR(event == EM_EVENT_UNDEF, "Heavy event allocation failed (%i, %i)\n", i, j);
+
+      steal      = em_event_pointer(event);
+      steal->seq = 0;
+
+      ret = em_send(event, queue);
+      IS_ERROR(ret != EM_OK, "Heavy event send failed (%u)! Queue: %"PRI_QUEUE" \n", ret, queue);
+    }
+  }
+
+
+  env_sync_mem();
+}
+
+
+
+/**
+ * @private
+ *
+ * EO start function.
+ *
+ */
+static em_status_t
+steal_start(void* eo_context, em_eo_t eo)
+{
+  printf("EO %"PRI_EO" starting.\n", eo);
+
+  return EM_OK;
+}
+
+
+
+/**
+ * @private
+ *
+ * EO stop function.
+ *
+ */
+static em_status_t
+steal_stop(void* eo_context, em_eo_t eo)
+{
+  printf("EO %"PRI_EO" stopping.\n", eo);
+
+  return EM_OK;
+}
+
+
+
+/**
+ * @private
+ *
+ * EO receive function for the heavy events.
+ *
+ * Does some dummy work, counts the event for the core and sends it back into the same queue.
+ */
+static void
+heavy_receive(void* eo_context, em_event_t event, em_event_type_t type, em_queue_t queue, void* q_ctx)
+{
+  steal_event_t *const steal      = em_event_pointer(event);
+  const int            core       = em_core_id();
+  const uint64_t       end_cycles = env_get_cycle() + HEAVY_WORK_CYCLES;
+  uint64_t             print_cycles;
+  em_status_t          ret;
+
+
+  while(env_get_cycle() < end_cycles) {
+    ; // Dummy work
+  }
+
+  steal->seq++;
+
+  if(core < MAX_PRINT_CORES) {
+    steal_shm->core_stat[core].events++;
+  }
+
+
+  print_cycles = steal_shm->print_cycles;
+
+  if(ENV_UNLIKELY((end_cycles - print_cycles) > steal_shm->print_interval))
+  {
+    // One core prints per interval
+    if(__sync_bool_compare_and_swap(&steal_shm->print_cycles, print_cycles, end_cycles)) {
+      print_result(end_cycles - print_cycles);
+    }
+  }
+
+
+  ret = em_send(event, queue);
+
+  if(ENV_UNLIKELY(ret != EM_OK)) {
+    em_free(event);
+  }
+}
+
+
+
+/**
+ * Prints the throughput and the share of each core
+ */
+static void
+print_result(const uint64_t cycles)
+{
+  const int      cores = (em_core_count() < MAX_PRINT_CORES) ? em_core_count() : MAX_PRINT_CORES;
+  const double   sec   = ((double) cycles) / ((double) env_core_hz());
+  uint64_t       diff[MAX_PRINT_CORES];
+  uint64_t       total = 0;
+  int            i;
+
+
+  for(i = 0; i < cores; i++)
+  {
+    const uint64_t events = steal_shm->core_stat[i].events;
+
+    diff[i] = events - steal_shm->prev_events[i];
+    steal_shm->prev_events[i] = events;
+    total  += diff[i];
+  }
+
+  printf("events/s: %.0f (one core max %.0f), share per core %%:", ((double) total) / sec,
+         ((double) env_core_hz()) / ((double) HEAVY_WORK_CYCLES));
+
+  for(i = 0; i < cores; i++) {
+    printf(" %02i:%.0f", i, (total > 0) ? (100.0 * diff[i]) / total : 0.0);
+  }
+
+  printf("\n");
+}
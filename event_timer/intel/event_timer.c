@@ -32,8 +32,10 @@
 #include "environment.h"
 
 #include <rte_timer.h>
+#include <rte_mempool.h>
 
 #include "em_intel.h"
+#include "intel_hw_init.h"
 
 #include "em_intel_inline.h"
 
@@ -43,10 +45,33 @@
  */
 
 
+#define EVT_TIMER_POOL_NAME  "EvtTimerPool"
+
+
 /*
  * Data Types
  */
 
+/**
+ * Timer object of a pending timeout, taken from the timer pool by evt_request_timeout() 
+ * and returned when the timeout expires or is cancelled.
+ * Keeps the timer state out of the event header.
+ */
+typedef struct
+{
+  struct rte_timer   tim;       // Keep first, the timer handle points to the object
+  
+  em_event_hdr_t    *ev_hdr;    // Event to send on timeout
+  
+  em_queue_t         dst_queue; // Destination queue of the event
+  
+  volatile uint64_t  state;     // Generation << 1 | armed, armed until the timeout is expired or cancelled
+  
+} evt_timer_obj_t  ENV_CACHE_LINE_ALIGNED;
+
+
+#define EVT_TIMER_ARMED  (1)
+
 
 /*
  * Variables
@@ -55,11 +80,15 @@ ENV_LOCAL  event_timer_local_t  event_timer_local  ENV_CACHE_LINE_ALIGNED;
 
 COMPILE_TIME_ASSERT(sizeof(event_timer_local) == ENV_CACHE_LINE_SIZE, EVENT_TIMER_LOCAL_T_SIZE_ERROR);
 
+/** Pool of timer objects (per process pointer to the shared pool) */
+static struct rte_mempool *evt_timer_pool;
+
 
 /*
  * Local Function Prototypes
  */
 static void event_timer_callback(struct rte_timer *tim, void *arg);
+static void event_timer_obj_init(struct rte_mempool *mp, void *arg, void *obj, unsigned idx);
   
 
 
@@ -74,11 +103,48 @@ evt_timer_init_global(void)
   /* Init the RTE timer library */
   rte_timer_subsystem_init();
   
+  /* Timer objects: created by the first process, looked up by the others (EM process-per-core mode) */
+  evt_timer_pool = rte_mempool_lookup(EVT_TIMER_POOL_NAME);
+  
+  if(evt_timer_pool == NULL)
+  {
+    evt_timer_pool = rte_mempool_create(EVT_TIMER_POOL_NAME, EVT_TIMER_POOL_SIZE, sizeof(evt_timer_obj_t), 
+                                        EVT_TIMER_POOL_CACHE, 0, NULL, NULL, event_timer_obj_init, NULL,
+                                        DEVICE_SOCKET, 0);
+  }
+  
+  if(evt_timer_pool == NULL)
+  {
+    EVT_ERR_PRINTF("%s(): Timer pool %s creation failed\n", __func__, EVT_TIMER_POOL_NAME);
+    return -1;
+  }
+  
   return EVT_TIMER_OK;
 }
 
 
 
+/*********************************************
+ * Timer pool object constructor, run once per object at pool creation
+ */
+static void
+event_timer_obj_init(struct rte_mempool *mp, void *arg, void *obj, unsigned idx)
+{
+  evt_timer_obj_t *const timer_obj = (evt_timer_obj_t *) obj;
+  
+  (void) mp;
+  (void) arg;
+  (void) idx;
+  
+  rte_timer_init(&timer_obj->tim);
+  
+  timer_obj->ev_hdr    = NULL;
+  timer_obj->dst_queue = EM_QUEUE_UNDEF;
+  timer_obj->state     = 0;
+}
+
+
+
 /*********************************************
  * Each EM-core runs once at startup after global init
  */
@@ -150,14 +216,30 @@ evt_request_timeout_func(evt_ticks_t ticks, em_event_t event, em_queue_t queue,
 {
   int ret;
   em_event_hdr_t   *const ev_hdr = event_to_event_hdr(event);
-  struct rte_timer *const tim    = &ev_hdr->event_timer;
+  evt_timer_obj_t  *timer_obj;
+  struct rte_timer *tim;
+  uint64_t          gen;
  
-  // ENV_PREFETCH(tim);
+ 
+  ret = rte_mempool_get(evt_timer_pool, (void **) &timer_obj);
+  
+  IF_UNLIKELY(ret != 0)
+  {
+    fprintf(stderr, "%s(): Timer pool empty, ret = %i\n", __func__, ret);
+    return EVT_TIMER_INVALID;
+  }
+  
+  tim = &timer_obj->tim;
+  
+  // New generation for each timeout, the object is not armed while in the pool
+  gen = (timer_obj->state >> 1) + 1;
 
-  ev_hdr->timer_dst_queue = queue;
+  timer_obj->ev_hdr    = ev_hdr;
+  timer_obj->dst_queue = queue;
+  timer_obj->state     = (gen << 1) | EVT_TIMER_ARMED;
   
   ret = rte_timer_reset(tim, ticks, SINGLE, rte_lcore_id(),
-  		                  event_timer_callback, (void *) ev_hdr);
+  		                  event_timer_callback, (void *) timer_obj);
   
   IF_UNLIKELY(ret != 0)
   {
@@ -169,10 +251,16 @@ evt_request_timeout_func(evt_ticks_t ticks, em_event_t event, em_queue_t queue,
     
     // abort();
     
+    timer_obj->state = gen << 1;
+    rte_mempool_put(evt_timer_pool, timer_obj);
+    
     return EVT_TIMER_INVALID;
   } 
   
-  *cancel = tim;
+  if(cancel != NULL) {
+    cancel->timer = tim;
+    cancel->gen   = gen;
+  }
   
   return (evt_timer_t) tim;
 }
@@ -187,7 +275,22 @@ evt_request_timeout_func(evt_ticks_t ticks, em_event_t event, em_queue_t queue,
 evt_timer_t
 evt_cancel_timeout(evt_timer_t handle, evt_cancel_t* cancel)
 {
-  rte_timer_stop_sync((struct rte_timer *)cancel);
+  evt_timer_obj_t *const timer_obj = (evt_timer_obj_t *) cancel->timer;
+  const uint64_t         armed     = (cancel->gen << 1) | EVT_TIMER_ARMED;
+  
+  
+  // Claim the timeout: fails if it already expired (or is just expiring on another core) or was
+  // cancelled - also when the timer object has been reused since, its generation differs then.
+  IF_UNLIKELY(!__sync_bool_compare_and_swap(&timer_obj->state, armed, armed & ~((uint64_t) EVT_TIMER_ARMED))) {
+    return EVT_TIMER_INVALID;
+  }
+  
+  // A callback running on another core gives up the claimed timeout, wait for it to return
+  while(rte_timer_stop(&timer_obj->tim) != 0) {
+    env_pause();
+  }
+  
+  rte_mempool_put(evt_timer_pool, timer_obj);
   
   return handle;
 }
@@ -198,12 +301,27 @@ evt_cancel_timeout(evt_timer_t handle, evt_cancel_t* cancel)
 static void
 event_timer_callback(struct rte_timer *tim, void *arg)
 {
- em_event_hdr_t *const ev_hdr = (em_event_hdr_t *) arg;
- em_event_t            event  = event_hdr_to_event(ev_hdr);
- em_queue_t      const queue  = ev_hdr->timer_dst_queue;
- em_status_t           status;
+ evt_timer_obj_t *const timer_obj = (evt_timer_obj_t *) arg;
+ em_event_hdr_t  *const ev_hdr    = timer_obj->ev_hdr;
+ em_event_t             event     = event_hdr_to_event(ev_hdr);
+ em_queue_t       const queue     = timer_obj->dst_queue;
+ uint64_t         const state     = timer_obj->state;
+ em_status_t            status;
  
   
+  // Claim the timeout, lost to evt_cancel_timeout() if it was cancelled meanwhile: the canceller
+  // frees the timer object after this callback has returned.
+  IF_UNLIKELY(!(state & EVT_TIMER_ARMED) ||
+              !__sync_bool_compare_and_swap(&timer_obj->state, state, state & ~((uint64_t) EVT_TIMER_ARMED))) {
+    return;
+  }
+  
+  // Stopping the timer from its own callback tells rte_timer_manage() not to touch the timer 
+  // after the callback, the timer object can be freed here.
+  (void) rte_timer_stop(tim);
+  
+  rte_mempool_put(evt_timer_pool, timer_obj);
+  
   ev_hdr->q_elem = NULL; // No source queue
   
   status = em_send(event, queue);
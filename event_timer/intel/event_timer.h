@@ -50,7 +50,13 @@ extern "C" {
 
 typedef void*        evt_timer_t;    ///< timer handle type
 typedef uint64_t     evt_ticks_t;    ///< type for ticks
-typedef evt_timer_t  evt_cancel_t;
+
+/** Cancel info of a timeout, filled in by evt_request_timeout() */
+typedef struct
+{
+  evt_timer_t  timer;  ///< timer handle
+  uint64_t     gen;    ///< generation of the timer object, cancel info of an earlier (reused) timeout does not match
+} evt_cancel_t;
 
 
 typedef union
@@ -296,7 +302,9 @@ static inline evt_ticks_t evt_timer_max_timeout(void)
  * @param    handle:    timeout handle as returned by request_timeout()
  * @param    cancel:    pointer to the memory, that was given during evt_request_timeout()
  *
- * @return   given timer handle or EVT_TIMER_INVALID on error (no more pending, too late to cancel)
+ * @return   given timer handle or EVT_TIMER_INVALID on error (no more pending, too late to cancel).
+ *           Cancel info of an expired timeout stays invalid, also after the timer object has
+ *           been reused for another timeout.
  ***************************************************************************/
 evt_timer_t evt_cancel_timeout(evt_timer_t handle, evt_cancel_t* cancel);
 
@@ -38,5 +38,9 @@
 /* DEBUG-flag: */
 //#define EVT_TIMER_DEBUG 
 
+/* Max number of simultaneously pending timeouts (timer objects, optimal mempool size is 2^n - 1) */
+#define EVT_TIMER_POOL_SIZE     ((32 * 1024) - 1)
+#define EVT_TIMER_POOL_CACHE    (64)
+
 
 #endif /* EVENT_TIMER_CONF_H_ */
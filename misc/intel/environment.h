@@ -239,6 +239,26 @@ static inline void env_sync_mem(void)
 
 
 
+/**
+ * Full memory barrier, stores before the barrier are visible before loads after it
+ */
+static inline void env_mem_barrier(void)
+{
+  rte_mb();
+}
+
+
+
+/**
+ * Spin-wait hint (PAUSE), lets the sibling hyperthread run and saves power while polling
+ */
+static inline void env_pause(void)
+{
+  rte_pause();
+}
+
+
+
 /**
  * Core cycles
  *
@@ -282,9 +302,10 @@ static inline int env_get_core_count(void)
 /**
  * Creates a mask for given number of cores starting from core 0
  */
-static inline uint64_t env_core_mask_count(int count)
+static inline void env_core_mask_count(int count, em_core_mask_t* mask)
 {
-    return (((uint64_t)1) << count) - 1;
+  em_core_mask_zero(mask);
+  em_core_mask_set_count(count, mask);
 }
 
 
@@ -312,6 +333,29 @@ static inline uint64_t env_core_hz(void)
 
 
 
+/**
+ * Sleep while *addr == val, at most 'timeout_us' microseconds (0 = no timeout)
+ *
+ * Futex in shared memory, works between EM-threads and EM-processes.
+ * 
+ * @return 0 when woken up or *addr != val, -1 on timeout or signal
+ * 
+ * @see env_futex_wake()
+ */
+int
+env_futex_wait(volatile int32_t *addr, int32_t val, uint32_t timeout_us);
+
+
+/**
+ * Wake up at most 'count' cores sleeping in env_futex_wait() on 'addr'
+ * 
+ * @return Number of woken up cores
+ */
+int
+env_futex_wake(volatile int32_t *addr, int count);
+
+
+
 /*
  * Barrier Synchronization
  */
@@ -324,14 +368,12 @@ typedef struct env_barrier_t
 } env_barrier_t;
 
 
-static inline void env_barrier_init(env_barrier_t* barrier, uint64_t core_mask)
+static inline void env_barrier_init(env_barrier_t* barrier, const em_core_mask_t* core_mask)
 {
-  em_core_mask_t  mask;
   int             core_count;
   
   
-  mask.u64[0] = core_mask;
-  core_count  = em_core_mask_count(&mask);
+  core_count  = em_core_mask_count(core_mask);
   
   (void) pthread_barrierattr_init(&barrier->pthread_barrierattr);
   (void) pthread_barrierattr_setpshared(&barrier->pthread_barrierattr, PTHREAD_PROCESS_SHARED);
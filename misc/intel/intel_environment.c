@@ -29,6 +29,10 @@
 #include "environment.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
 
 #include "intel_hw_init.h"
 
@@ -220,3 +224,49 @@ env_shared_free(void *buf)
 
 
 
+/**
+ * Sleep while *addr == val, at most 'timeout_us' microseconds (0 = no timeout)
+ *
+ * @note Non-private futex, the futex word is in shared hugepage memory and
+ *       the waker might be another EM-process.
+ */
+int
+env_futex_wait(volatile int32_t *addr, int32_t val, uint32_t timeout_us)
+{
+  struct timespec  timeout;
+  struct timespec *ts = NULL;
+  long             ret;
+  
+  if(timeout_us > 0)
+  {
+    timeout.tv_sec  = timeout_us / 1000000;
+    timeout.tv_nsec = (timeout_us % 1000000) * 1000;
+    ts = &timeout;
+  }
+  
+  ret = syscall(SYS_futex, (int32_t *) addr, FUTEX_WAIT, val, ts, NULL, 0);
+  
+  if((ret == -1) && (errno != EWOULDBLOCK)) {
+    return -1; // ETIMEDOUT or EINTR
+  }
+  
+  return 0;
+}
+
+
+
+/**
+ * Wake up at most 'count' cores sleeping in env_futex_wait() on 'addr'
+ */
+int
+env_futex_wake(volatile int32_t *addr, int count)
+{
+  long ret;
+  
+  ret = syscall(SYS_futex, (int32_t *) addr, FUTEX_WAKE, count, NULL, NULL, 0);
+  
+  return (ret > 0) ? (int) ret : 0;
+}
+
+
+
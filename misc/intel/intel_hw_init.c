@@ -68,25 +68,27 @@
 
 
 void *                
-intel_pool_init(const char *name)
+intel_pool_init(const char *name, const intel_pool_cfg_t *const cfg)
 {
   struct rte_mempool *pktmbuf_pool = NULL;
+  // Data room given to rte_pktmbuf_pool_init(): headroom (event hdr) + data
+  const uint32_t      data_room    = RTE_PKTMBUF_HEADROOM + cfg->data_size;
   
   pktmbuf_pool =
     rte_mempool_create(name,
-                       NB_MBUF,
-                       MBUF_SIZE,
-                       MBUF_CACHE_SIZE,
+                       cfg->nbr_bufs,
+                       sizeof(struct rte_mbuf) + data_room,
+                       cfg->cache_size,
                        sizeof(struct rte_pktmbuf_pool_private),
                        rte_pktmbuf_pool_init,
-                       NULL,
+                       (void *) (uintptr_t) data_room,
                        rte_pktmbuf_init,
                        NULL,
-                       DEVICE_SOCKET,
+                       cfg->socket,
                        0);
   
   if(pktmbuf_pool == NULL) {
-    rte_panic("Cannot init mbuf pool on socket 0! rte_errno:%i(%s)\n\n", rte_errno, rte_strerror(rte_errno));
+    rte_panic("Cannot init mbuf pool %s on socket %i! rte_errno:%i(%s)\n\n", name, cfg->socket, rte_errno, rte_strerror(rte_errno));
   }
 
   return pktmbuf_pool;
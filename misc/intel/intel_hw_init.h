@@ -54,10 +54,34 @@ COMPILE_TIME_ASSERT((NB_MBUF % MBUF_CACHE_SIZE) == 0, CONFIGURED_MEMPOOL_CACHE_E
 #define DEVICE_SOCKET    (SOCKET0)
 
 
+// Event pools (size classes) for em_alloc(), indexed by em_pool_id_t.
+// Pool 0 (EM_POOL_DEFAULT) is the em_event_pool above (MBUF_SIZE) - also used for packet-I/O, keep first.
+// Number of entries must equal EM_MAX_POOLS.
+// EM creates each pool on every socket with EM cores ('socket' set accordingly), 'nbr_bufs' is split between them.
+#define POOL_CACHE_SIZE  (511)
+#define INTEL_POOL_CFG_INIT                                                                     \
+{                                                                                               \
+  /* data_size, nbr_bufs,            cache_size,      socket        */                          \
+  {  2048,      NB_MBUF,             MBUF_CACHE_SIZE, DEVICE_SOCKET },                          \
+  {  128,       (256*POOL_CACHE_SIZE), POOL_CACHE_SIZE, DEVICE_SOCKET },                        \
+  {  512,       (64*POOL_CACHE_SIZE),  POOL_CACHE_SIZE, DEVICE_SOCKET },                        \
+  {  9216,      (8*POOL_CACHE_SIZE),   POOL_CACHE_SIZE, DEVICE_SOCKET }                         \
+}
+
+typedef struct
+{
+  uint32_t data_size;  // Max event size (excluding the mbuf and event headers)
+  uint32_t nbr_bufs;
+  uint32_t cache_size;
+  int      socket;
+} intel_pool_cfg_t;
+
+COMPILE_TIME_ASSERT(POOL_CACHE_SIZE <= RTE_MEMPOOL_CACHE_MAX_SIZE, CONFIGURED_POOL_CACHE_TOO_SMALL);
+
 
 
 void *                
-intel_pool_init(const char *name);
+intel_pool_init(const char *name, const intel_pool_cfg_t *const cfg);
 
 void *
 intel_pool_lookup(const char *name);
@@ -92,29 +92,46 @@ extern "C" {
 
 #include <stdint.h>
 #include <errno.h>
+#include <assert.h>
 #include <rte_common.h>
 #include <rte_memory.h>
 #include <rte_lcore.h>
 #include <rte_atomic.h>
 #include <rte_branch_prediction.h>
 #include <rte_string_fns.h>
+#include <rte_malloc.h>
 #include <xmmintrin.h>
 
 #define MRING_NAMESIZE 32 /**< The maximum length of a ring name. */
 
-#define NUM_PRIORITIES  4
+#define NUM_PRIORITIES  8
 //#define RING_SIZE 1024
-#define RING_SIZE (4*1024)
-#define RING_MASK (RING_SIZE-1)
+#define RING_SIZE (4*1024) /**< Default ring depth (per priority) */
+
+/**
+ * Max ring depth (per priority). The head/tail indexes of all priorities are
+ * 16-bit values packed into one 128-bit word, see union umultiint.
+ */
+#define MRING_SZ_MAX (1 << 15)
+
+/**
+ * Default weights of the priorities (lowest first) used by mring_dequeue_mp_burst()
+ * to share a burst between the priorities, see mring_set_quota().
+ */
+#define MRING_DEFAULT_WEIGHTS {1, 1, 2, 2, 4, 4, 9, 9}
+
+/** Number of quota tables, one per supported burst size: 8, 16, 32 and 64 */
+#define MRING_QUOTAS          4
+#define MRING_QUOTA_MIN_BURST 8
 
 /**
  * Unsigned multi-int value. Can be accessed/used as
- *  - Four 32-bit values e.g. four head/tail indexes
+ *  - Eight 16-bit values e.g. eight head/tail indexes
  *  - Single 128-bit value for SSE operations
  *  - Two 64-bit values.
  */
 union umultiint {
-  uint32_t val[NUM_PRIORITIES];
+  uint16_t val[NUM_PRIORITIES];
   __m128i mval;
   struct {
     uint64_t hiqw;
@@ -124,12 +141,12 @@ union umultiint {
 
 /**
  * Signed multi-int value. Can be accessed/used as
- *  - Four 32-bit values e.g. four head/tail indexes
+ *  - Eight 16-bit values e.g. eight head/tail index differences
  *  - Single 128-bit value for SSE operations
  *  - Two 64-bit values.
  */
 union smultiint {
-  int32_t val[NUM_PRIORITIES];
+  int16_t val[NUM_PRIORITIES];
   __m128i mval;
   struct {
     uint64_t hiqw;
@@ -142,15 +159,24 @@ union smultiint {
  *
  * The producer and the consumer have a head and a tail index. The particularity
  * of these index is that they are not between 0 and size(ring). These indexes
- * are between 0 and 2^32, and we mask their value when we access the ring[]
+ * are between 0 and 2^16, and we mask their value when we access the ring[]
  * field. Thanks to this assumption, we can do subtractions between 2 index
- * values in a modulo-32bit base: that's why the overflow of the indexes is not
- * a problem.
+ * values in a modulo-16bit base: that's why the overflow of the indexes is not
+ * a problem. The 16-bit indexes of all priorities fit into 128 bits and can be
+ * updated with one cmpxchg16b, which limits the depth to MRING_SZ_MAX.
  */
 struct multiring {
 
   char name[MRING_NAMESIZE];    /**< Name of the ring. */
   int flags;                       /**< Flags supplied at creation. */
+  uint32_t size;                   /**< Depth of each priority ring. */
+  uint32_t mask;                   /**< Mask (size-1) of each priority ring. */
+
+  /**
+   * Max number of objects per priority in a mring_dequeue_mp_burst() of
+   * MRING_QUOTA_MIN_BURST << i objects, when the ring holds more than that.
+   */
+  union umultiint quota[MRING_QUOTAS] __rte_cache_aligned;
 
   /** Ring producer status. */
   struct mprod {
@@ -167,25 +193,133 @@ struct multiring {
   } cons __rte_cache_aligned;
 
 
-  void * volatile ring[NUM_PRIORITIES][RING_SIZE] \
-      __rte_cache_aligned; /**< Memory space of ring starts here. */
+  /**
+   * Memory space of ring starts here: NUM_PRIORITIES consecutive rings
+   * of 'size' entries each, see MRING_ENTRY().
+   */
+  void * volatile ring[0] __rte_cache_aligned;
 };
 
+/** Access entry 'idx' (unmasked) of the ring with priority 'prio' */
+#define MRING_ENTRY(r, prio, idx) \
+  ((r)->ring[((prio) * (r)->size) + ((idx) & (r)->mask)])
+
 #define RING_F_SP_ENQ 0x0001 /**< The default enqueue is "single-producer". */
 #define RING_F_SC_DEQ 0x0002 /**< The default dequeue is "single-consumer". */
 #define RTE_RING_SZ_MASK  (unsigned)(0x0fffffff) /**< Ring size mask */
 
+/**
+ * Calculate the memory size needed for a ring
+ *
+ * @param count
+ *   The depth of each priority ring (must be a power of two, max MRING_SZ_MAX).
+ * @return
+ *   - The memory size needed for the ring on success.
+ *   - -EINVAL if count is not a power of 2 or too large.
+ */
+static inline ssize_t
+mring_get_memsize(unsigned count)
+{
+  ssize_t sz;
+
+  /* count must be a power of 2 */
+  if ((!POWEROF2(count)) || (count > MRING_SZ_MAX))
+    return -EINVAL;
+
+  sz = sizeof(struct multiring) + ((ssize_t)NUM_PRIORITIES * count * sizeof(void *));
+  sz = RTE_ALIGN(sz, CACHE_LINE_SIZE);
+  return sz;
+}
+
+/**
+ * Set the priority quotas of a ring from weights.
+ *
+ * The quota of priority i in a burst of *max* objects is
+ * max * weights[i] / sum(weights), but at least 1 for a nonzero weight. The
+ * rounding remainder goes to the highest priority, the excess of the minimum
+ * quotas is taken from the highest priorities first. When a ring holds more than *max* objects, mring_dequeue_mp_burst()
+ * cuts the priorities down to their quotas starting from the lowest until the
+ * burst fits: each priority with objects gets at least its quota, the highest
+ * priorities get the rest. A zero weight means that the priority only gets the
+ * room the other priorities leave.
+ *
+ * Can be called while the ring is in use.
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ * @param weights
+ *   Weights of the priorities, lowest priority first. NULL or all zero
+ *   weights select MRING_DEFAULT_WEIGHTS.
+ */
+static inline void
+mring_set_quota(struct multiring *r, const unsigned weights[NUM_PRIORITIES])
+{
+  static const unsigned default_weights[NUM_PRIORITIES] = MRING_DEFAULT_WEIGHTS;
+  uint64_t sum = 0;
+  int i, q;
+
+  if (weights != NULL)
+    for (i = 0; i < NUM_PRIORITIES; i++)
+      sum += weights[i];
+
+  if (sum == 0) {
+    weights = default_weights;
+    for (i = 0; i < NUM_PRIORITIES; i++)
+      sum += weights[i];
+  }
+
+  /* room for a quota of 1 for every priority in the smallest burst */
+  RTE_BUILD_BUG_ON(MRING_QUOTA_MIN_BURST < NUM_PRIORITIES);
+
+  for (q = 0; q < MRING_QUOTAS; q++) {
+    const unsigned max = MRING_QUOTA_MIN_BURST << q;
+    union umultiint quota;
+    unsigned used = 0;
+
+    for (i = 0; i < NUM_PRIORITIES; i++) {
+      quota.val[i] = (uint16_t)(((uint64_t)max * weights[i]) / sum);
+      if (quota.val[i] == 0 && weights[i] != 0)
+        quota.val[i] = 1; /* no starving of the low priorities */
+      used += quota.val[i];
+    }
+
+    if (used <= max)
+      quota.val[NUM_PRIORITIES-1] += (uint16_t)(max - used);
+
+    /* minimum quotas over max: take the excess from the highest priorities */
+    for (i = NUM_PRIORITIES - 1; used > max && i >= 0; i--) {
+      const unsigned keep = (weights[i] != 0) ? 1 : 0;
+      unsigned take = quota.val[i] - keep;
+
+      if (take > used - max)
+        take = used - max;
+      quota.val[i] = (uint16_t)(quota.val[i] - take);
+      used -= take;
+    }
+
+    used = 0;
+    for (i = 0; i < NUM_PRIORITIES; i++)
+      used += quota.val[i];
+    assert(used == max);
+
+    r->quota[q].mval = quota.mval;
+  }
+}
+
 /**
  * Create a new ring named *name* in memory.
  *
- * This function uses ``memzone_reserve()`` to allocate memory. Its size is
- * set to *count*, which must be a power of two. Water marking is
- * disabled by default.
- * Note that the real usable ring size is *count-1* instead of
- * *count*.
+ * This function uses ``rte_malloc_socket()`` to allocate memory so that the
+ * ring can be released with ``mring_free()`` (memzones cannot be freed).
+ * Each of the NUM_PRIORITIES rings is *count* deep, which must be a power
+ * of two (max MRING_SZ_MAX). Note that the real usable ring size is *count-1*
+ * instead of *count*. The priority quotas are set from MRING_DEFAULT_WEIGHTS,
+ * see mring_set_quota().
  *
  * @param name
  *   The name of the ring.
+ * @param count
+ *   The depth of each priority ring (must be a power of two).
  * @param socket_id
  *   The *socket_id* argument is the socket identifier in case of
  *   NUMA. The value can be *SOCKET_ID_ANY* if there is no NUMA
@@ -199,16 +333,13 @@ struct multiring {
  *      using ``mring_dequeue()`` or ``mring_dequeue_bulk()``
  *      is "single-consumer". Otherwise, it is "multi-consumers".
  * @return
- *   On success, the pointer to the new allocated ring. NULL on error with
- *    rte_errno set appropriately.
+ *   On success, the pointer to the new allocated ring. NULL on error.
  */
 static inline struct multiring *
-mring_create(const char *name, int socket_id, unsigned flags)
+mring_create(const char *name, unsigned count, int socket_id, unsigned flags)
 {
-    char mz_name[RTE_MEMZONE_NAMESIZE];
     struct multiring *r;
-    const struct rte_memzone *mz;
-    int mz_flags = 0;
+    ssize_t ring_size;
 
     /* compilation-time checks */
     RTE_BUILD_BUG_ON((sizeof(struct multiring) &
@@ -218,27 +349,41 @@ mring_create(const char *name, int socket_id, unsigned flags)
     RTE_BUILD_BUG_ON((offsetof(struct multiring, prod) &
               CACHE_LINE_MASK) != 0);
 
-    rte_snprintf(mz_name, sizeof(mz_name), "MRG_%s", name);
-
-    /* reserve a memory zone for this ring. If we can't get rte_config or
-     * we are secondary process, the memzone_reserve function will set
-     * rte_errno for us appropriately - hence no check in this this function */
-    mz = rte_memzone_reserve(mz_name, sizeof(*r), socket_id, mz_flags);
-    if (mz == NULL)
+    ring_size = mring_get_memsize(count);
+    if (ring_size < 0)
         return NULL;
 
-    r = mz->addr;
+    r = rte_malloc_socket(NULL, ring_size, CACHE_LINE_SIZE, socket_id);
+    if (r == NULL)
+        return NULL;
 
     /* init the ring structure */
-    memset(r, 0, sizeof(*r));
+    memset(r, 0, ring_size);
     rte_snprintf(r->name, sizeof(r->name), "%s", name);
     r->flags = flags;
+    r->size = count;
+    r->mask = count - 1;
     r->prod.sp_enqueue = !!(flags & RING_F_SP_ENQ);
     r->cons.sc_dequeue = !!(flags & RING_F_SC_DEQ);
+    mring_set_quota(r, NULL);
 
     return r;
 }
 
+/**
+ * Release a ring created with ``mring_create()``.
+ *
+ * The caller must ensure that no core accesses the ring any more.
+ *
+ * @param r
+ *   A pointer to the ring structure, NULL is ignored.
+ */
+static inline void
+mring_free(struct multiring *r)
+{
+    rte_free(r); /* rte_free() performs NULL check */
+}
+
 /**
  * Enqueue several objects on the ring (multi-producers safe).
  *
@@ -260,8 +405,8 @@ static inline int
 __mring_mp_do_enqueue(struct multiring *r, const uint8_t priority,
     void * const *obj_table, const unsigned max)
 {
-  uint32_t prod_head, prod_next;
-  uint32_t cons_tail, free_entries;
+  uint16_t prod_head, prod_next;
+  uint16_t cons_tail, free_entries;
   unsigned n;
   int success;
   unsigned i;
@@ -273,11 +418,11 @@ __mring_mp_do_enqueue(struct multiring *r, const uint8_t priority,
 
     prod_head = r->prod.head.val[priority];
     cons_tail = r->cons.tail.val[priority];
-    /* The subtraction is done between two unsigned 32bits value
-     * (the result is always modulo 32 bits even if we have
+    /* The subtraction is done between two unsigned 16bits value
+     * (the result is always modulo 16 bits even if we have
      * prod_head > cons_tail). So 'free_entries' is always between 0
      * and size(ring)-1. */
-    free_entries = (RING_MASK + cons_tail - prod_head);
+    free_entries = (uint16_t)(r->mask + cons_tail - prod_head);
 
     /* check that we have enough room in ring */
     if (unlikely(n > free_entries))
@@ -286,14 +431,14 @@ __mring_mp_do_enqueue(struct multiring *r, const uint8_t priority,
     if (unlikely(n == 0))
       return 0;
 
-    prod_next = prod_head + n;
-    success = rte_atomic32_cmpset(&r->prod.head.val[priority], prod_head,
-                prod_next);
+    prod_next = (uint16_t)(prod_head + n);
+    success = __sync_bool_compare_and_swap(&r->prod.head.val[priority],
+                prod_head, prod_next);
   } while (unlikely(success == 0));
 
   /* write entries in ring */
   for (i = 0; likely(i < n); i++)
-    r->ring[priority][(prod_head + i) & RING_MASK] = obj_table[i];
+    MRING_ENTRY(r, priority, prod_head + i) = obj_table[i];
   rte_wmb();
 
   /*
@@ -325,17 +470,17 @@ static inline int
 __mring_sp_do_enqueue(struct multiring *r, const uint8_t priority,
     void * const *obj_table, unsigned n)
 {
-  uint32_t prod_head, cons_tail;
-  uint32_t prod_next, free_entries;
+  uint16_t prod_head, cons_tail;
+  uint16_t prod_next, free_entries;
   unsigned i;
 
   prod_head = r->prod.head.val[priority];
   cons_tail = r->cons.tail.val[priority];
-  /* The subtraction is done between two unsigned 32bits value
-   * (the result is always modulo 32 bits even if we have
+  /* The subtraction is done between two unsigned 16bits value
+   * (the result is always modulo 16 bits even if we have
    * prod_head > cons_tail). So 'free_entries' is always between 0
    * and size(ring)-1. */
-  free_entries = RING_MASK + cons_tail - prod_head;
+  free_entries = (uint16_t)(r->mask + cons_tail - prod_head);
 
   /* check that we have enough room in ring */
   if (unlikely(n > free_entries))
@@ -344,12 +489,12 @@ __mring_sp_do_enqueue(struct multiring *r, const uint8_t priority,
   if (unlikely(n == 0))
     return 0;
 
-  prod_next = prod_head + n;
+  prod_next = (uint16_t)(prod_head + n);
   r->prod.head.val[priority] = prod_next;
 
   /* write entries in ring */
   for (i = 0; likely(i < n); i++)
-    r->ring[priority][(prod_head + i) & RING_MASK] = obj_table[i];
+    MRING_ENTRY(r, priority, prod_head + i) = obj_table[i];
   rte_wmb();
 
   r->prod.tail.val[priority] = prod_next;
@@ -380,8 +525,8 @@ static inline int
 __mring_mc_do_dequeue(struct multiring *r, const uint8_t priority,
     void **obj_table, unsigned n)
 {
-  uint32_t cons_head, prod_tail;
-  uint32_t cons_next, entries;
+  uint16_t cons_head, prod_tail;
+  uint16_t cons_next, entries;
   const unsigned max = n;
   int success;
   unsigned i;
@@ -393,11 +538,11 @@ __mring_mc_do_dequeue(struct multiring *r, const uint8_t priority,
 
     cons_head = r->cons.head.val[priority];
     prod_tail = r->prod.tail.val[priority];
-    /* The subtraction is done between two unsigned 32bits value
-     * (the result is always modulo 32 bits even if we have
+    /* The subtraction is done between two unsigned 16bits value
+     * (the result is always modulo 16 bits even if we have
      * cons_head > prod_tail). So 'entries' is always between 0
      * and size(ring)-1. */
-    entries = (prod_tail - cons_head);
+    entries = (uint16_t)(prod_tail - cons_head);
 
     /* Set the actual entries for dequeue */
     if (unlikely(n > entries))
@@ -405,15 +550,15 @@ __mring_mc_do_dequeue(struct multiring *r, const uint8_t priority,
     if (unlikely(n == 0))
       return 0;
 
-    cons_next = cons_head + n;
-    success = rte_atomic32_cmpset(&r->cons.head.val[priority], cons_head,
-                cons_next);
+    cons_next = (uint16_t)(cons_head + n);
+    success = __sync_bool_compare_and_swap(&r->cons.head.val[priority],
+                cons_head, cons_next);
   } while (unlikely(success == 0));
 
   /* copy in table */
   rte_rmb();
   for (i = 0; likely(i < n); i++) {
-    obj_table[i] = r->ring[priority][(cons_head + i) & RING_MASK];
+    obj_table[i] = MRING_ENTRY(r, priority, cons_head + i);
   }
 
   /*
@@ -448,30 +593,30 @@ static inline int
 __mring_sc_do_dequeue(struct multiring *r, const uint8_t priority,
     void **obj_table, unsigned n)
 {
-  uint32_t cons_head, prod_tail;
-  uint32_t cons_next, entries;
+  uint16_t cons_head, prod_tail;
+  uint16_t cons_next, entries;
   unsigned i;
 
   cons_head = r->cons.head.val[priority];
   prod_tail = r->prod.tail.val[priority];
-  /* The subtraction is done between two unsigned 32bits value
-   * (the result is always modulo 32 bits even if we have
+  /* The subtraction is done between two unsigned 16bits value
+   * (the result is always modulo 16 bits even if we have
    * cons_head > prod_tail). So 'entries' is always between 0
    * and size(ring)-1. */
-  entries = prod_tail - cons_head;
+  entries = (uint16_t)(prod_tail - cons_head);
 
   if (unlikely(n > entries))
     n = entries;
   if (unlikely(n == 0))
     return 0;
 
-  cons_next = cons_head + n;
+  cons_next = (uint16_t)(cons_head + n);
   r->cons.head.val[priority] = cons_next;
 
   /* copy in table */
   rte_rmb();
   for (i = 0; likely(i < n); i++) {
-    obj_table[i] = r->ring[priority][(cons_head + i) & RING_MASK];
+    obj_table[i] = MRING_ENTRY(r, priority, cons_head + i);
   }
 
   r->cons.tail.val[priority] = cons_next;
@@ -584,28 +729,22 @@ mring_dequeue(struct multiring *r, const uint8_t priority, void **obj_p)
 
 /**
  * Dequeue multiple objects from a ring, taking objects from the queues
- * of different priorities with different weightings.
+ * of different priorities with different weightings (see mring_set_quota()).
+ * The objects are returned highest priority first.
  *
  * @param r
  *   A pointer to the ring structure.
  * @param obj_p
  *   A pointer to void * pointers (object) that will be filled.
  * @param max
- *   Max number of items to dequeue, limited to 16, 32 or 64.
+ *   Max number of items to dequeue, limited to 8, 16, 32 or 64.
  * @return
  *   - Number of objects dequeued.
  */ 
 static inline int
 mring_dequeue_mp_burst(struct multiring *r, void **obj_p, const int max)
 {
-  //union umultiint quota_4  = {.val = {1, 1, 1, 1}};
-  union umultiint quota_8   = {.val = {1,  2,  2,  3}};
-  union umultiint quota_16  = {.val = {1,  2,  4,  9}};
-  union umultiint quota_32  = {.val = {2,  4,  8, 18}};
-  union umultiint quota_64  = {.val = {4,  8, 16, 36}};
-  //union umultiint quota_128 = {.val = {8, 16, 32, 72}};
-  
-  union umultiint *quota_ptr;
+  const union umultiint *quota_ptr;
   
   union umultiint cons_head, prod_tail;
   union umultiint cons_next, entries;
@@ -615,12 +754,10 @@ mring_dequeue_mp_burst(struct multiring *r, void **obj_p, const int max)
 
 
   switch (max) {
-    //case  4: quota_ptr = &quota_4;  break;
-    case  8 : quota_ptr = &quota_8;   break;
-    case 16 : quota_ptr = &quota_16;  break;
-    case 32 : quota_ptr = &quota_32;  break;
-    case 64 : quota_ptr = &quota_64;  break;
-    //case 128: quota_ptr = &quota_128; break;
+    case  8 : quota_ptr = &r->quota[0];  break;
+    case 16 : quota_ptr = &r->quota[1];  break;
+    case 32 : quota_ptr = &r->quota[2];  break;
+    case 64 : quota_ptr = &r->quota[3];  break;
     default: return 0;
   }
 
@@ -629,14 +766,17 @@ mring_dequeue_mp_burst(struct multiring *r, void **obj_p, const int max)
     cons_head.mval = r->cons.head.mval;
     prod_tail.mval = r->prod.tail.mval;
 
-    entries.mval = _mm_sub_epi32(prod_tail.mval, cons_head.mval);
+    entries.mval = _mm_sub_epi16(prod_tail.mval, cons_head.mval);
     if (entries.hiqw == 0 && entries.loqw == 0)
       return 0;
 
-    n = entries.val[0] + entries.val[1] + entries.val[2] + entries.val[3];
+    n = 0;
+    for (i = 0; i < NUM_PRIORITIES; i++)
+      n += entries.val[i];
+
     if (n > max) {
       union smultiint diff;
-      diff.mval = _mm_sub_epi32(entries.mval, quota_ptr->mval);
+      diff.mval = _mm_sub_epi16(entries.mval, quota_ptr->mval);
       for (i = 0; i < NUM_PRIORITIES && n > max; i++) {
         if (diff.val[i] > 0) {
           const int delta = (n-max) < diff.val[i] \
@@ -644,11 +784,17 @@ mring_dequeue_mp_burst(struct multiring *r, void **obj_p, const int max)
           n -= delta, entries.val[i] -= delta;
         }
       }
+      /* quotas changed under us (mring_set_quota()) - never exceed max */
+      for (i = 0; i < NUM_PRIORITIES && n > max; i++) {
+        const int delta = (n-max) < entries.val[i] \
+            ? (n-max) : entries.val[i];
+        n -= delta, entries.val[i] -= delta;
+      }
     }
 
-    cons_next.mval = _mm_add_epi32(cons_head.mval, entries.mval);
+    cons_next.mval = _mm_add_epi16(cons_head.mval, entries.mval);
 
-    // atomically update the four head pointers in one operation
+    // atomically update the head pointers of all priorities in one operation
     asm volatile ("lock cmpxchg16b %0; "
         "setz %1"
         : "+m" (r->cons.head), "=r" (success),
@@ -667,7 +813,7 @@ mring_dequeue_mp_burst(struct multiring *r, void **obj_p, const int max)
     if (entries.val[i] == 0)
       continue;
     for (j = 0; j < entries.val[i]; j++)
-      obj_p[buf_idx++] = r->ring[i][(cons_head.val[i] + j) & RING_MASK];
+      obj_p[buf_idx++] = MRING_ENTRY(r, i, cons_head.val[i] + j);
     while (unlikely(r->cons.tail.val[i] != cons_head.val[i]))
       rte_pause();
     r->cons.tail.val[i] = cons_next.val[i];
@@ -691,10 +837,48 @@ static inline int
 mring_empty(struct multiring *r)
 {
   union umultiint entries;
-  entries.mval = _mm_sub_epi32(r->prod.tail.mval, r->cons.head.mval);
+  entries.mval = _mm_sub_epi16(r->prod.tail.mval, r->cons.head.mval);
   return (entries.hiqw == 0 && entries.loqw == 0);
 }
 
+/**
+ * Return the number of entries in a ring (all priorities)
+ *
+ * @param r
+ *   The multiring to query
+ * @return
+ *   The number of entries, a snapshot if other cores use the ring.
+ */
+static inline unsigned
+mring_count(struct multiring *r)
+{
+  union umultiint entries;
+  unsigned count = 0;
+  int i;
+
+  entries.mval = _mm_sub_epi16(r->prod.tail.mval, r->cons.head.mval);
+  for (i = 0; i < NUM_PRIORITIES; i++)
+    count += entries.val[i];
+
+  return count;
+}
+
+/**
+ * Determine if the ring of one priority is empty or not
+ *
+ * @param r
+ *   The multiring to query
+ * @param priority
+ *   The ring within the multi-ring to query
+ * @return
+ *   non-zero if the ring is empty, zero otherwise.
+ */
+static inline int
+mring_empty_prio(struct multiring *r, const uint8_t priority)
+{
+  return (r->prod.tail.val[priority] == r->cons.head.val[priority]);
+}
+
 
 #ifdef __cplusplus
 }